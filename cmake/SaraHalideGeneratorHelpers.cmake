@@ -232,9 +232,12 @@ function(sara_add_halide_library TARGET)
         set_target_properties("${TARGET}" PROPERTIES
             IMPORTED_LOCATION "${CMAKE_CURRENT_BINARY_DIR}/${GENERATOR_SOURCES}")
     else ()
-      list(APPEND TARGET_OBJECT_FILES
-        ${CMAKE_CURRENT_BINARY_DIR}/${TARGET}${object_suffix}
-        ${CMAKE_CURRENT_BINARY_DIR}/${TARGET}.runtime${object_suffix})
+      # With multiple targets, there is one object file per target plus the
+      # wrapper object file which dispatches to them.
+      set(TARGET_OBJECT_FILES
+        ${GENERATOR_SOURCES}
+        ${TARGET}.runtime${object_suffix})
+      list(TRANSFORM TARGET_OBJECT_FILES PREPEND "${CMAKE_CURRENT_BINARY_DIR}/")
       set_target_properties("${TARGET}" PROPERTIES
             POSITION_INDEPENDENT_CODE ON
             IMPORTED_OBJECTS "${TARGET_OBJECT_FILES}"
@@ -29,6 +29,20 @@ if (NOT SHAKTI_HALIDE_GPU_TARGETS)
   endif ()
 endif ()
 
+# Ahead-of-time CPU targets. On x86-64, Halide generates one object file per
+# instruction set and a wrapper which dispatches at runtime to the best one
+# supported by the CPU. The last target is the fallback.
+if (NOT SHAKTI_HALIDE_CPU_TARGETS)
+  if (Halide_HOST_TARGET MATCHES "^x86-64")
+    set (SHAKTI_HALIDE_CPU_TARGETS
+      ${Halide_HOST_TARGET}-avx512_skylake
+      ${Halide_HOST_TARGET}-avx2-fma-f16c
+      ${Halide_HOST_TARGET}-sse41)
+  else ()
+    set (SHAKTI_HALIDE_CPU_TARGETS host)
+  endif ()
+endif ()
+
 
 function (shakti_halide_library _source_filepath)
   get_filename_component(_source_filename ${_source_filepath} NAME_WE)
@@ -135,3 +149,45 @@ function (shakti_halide_library_v2)
     PRIVATE
     cxx_std_17)
 endfunction ()
+
+
+# Same as `shakti_halide_library_v2` but compiled for the CPU targets in
+# `SHAKTI_HALIDE_CPU_TARGETS`. `GENERATOR` is the name of the registered
+# generator, so that the same generator can be compiled for the GPU and the
+# CPU.
+function (shakti_halide_cpu_library)
+  set(_options OPTIONS)
+  set(_single_value_args NAME GENERATOR SRCS)
+  set(_multiple_value_args DEPS)
+  cmake_parse_arguments(generator
+    "${_options}" "${_single_value_args}" "${_multiple_value_args}" ${ARGN})
+
+  if (NOT TARGET ${generator_GENERATOR}.generator)
+    add_executable(${generator_GENERATOR}.generator ${generator_SRCS})
+    target_include_directories(${generator_GENERATOR}.generator
+      PRIVATE
+      ${DO_Sara_DIR}/cpp/src
+      ${DO_Sara_ThirdParty_DIR}
+      ${DO_Sara_ThirdParty_DIR}/eigen)
+    target_link_libraries(${generator_GENERATOR}.generator
+      PRIVATE Halide::Generator)
+    target_compile_features(${generator_GENERATOR}.generator
+      PRIVATE
+      cxx_std_17)
+  endif ()
+
+  sara_add_halide_library(${generator_NAME}
+    FROM ${generator_GENERATOR}.generator
+    GENERATOR ${generator_GENERATOR}
+    TARGETS ${SHAKTI_HALIDE_CPU_TARGETS})
+
+  foreach (suffix IN ITEMS ""
+                           .runtime
+                           .update)
+    if (TARGET ${generator_NAME}${suffix})
+      set_target_properties(${generator_NAME}${suffix}
+        PROPERTIES
+        FOLDER "Halide/${generator_NAME}")
+    endif ()
+  endforeach ()
+endfunction ()
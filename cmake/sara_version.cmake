@@ -0,0 +1 @@
+set(DO_Sara_VERSION 1.2.r69297d1)
@@ -0,0 +1,215 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+//! @brief Synthetic inputs shared by the benchmarks.
+//!
+//! The inputs only depend on the seeds: the random numbers are drawn from
+//! the raw output of std::mt19937, whose sequence is specified by the
+//! standard, rather than from the standard distributions, whose
+//! implementation differs between standard libraries.
+
+#pragma once
+
+#include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/Pixel.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+#include <DO/Sara/Features/Feature.hpp>
+#include <DO/Sara/Features/KeypointList.hpp>
+
+#include <benchmark/benchmark.h>
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace DO::Sara::Synthetic {
+
+  //! @brief Uniform random number generator in [a, b).
+  class Uniform
+  {
+  public:
+    explicit Uniform(std::uint32_t seed)
+      : _gen{seed}
+    {
+    }
+
+    auto operator()(double a = 0, double b = 1) -> double
+    {
+      return a + (b - a) * (_gen() / 4294967296.);
+    }
+
+    auto index(int n) -> int
+    {
+      return static_cast<int>(_gen() % static_cast<std::uint32_t>(n));
+    }
+
+  private:
+    std::mt19937 _gen;
+  };
+
+  //! @brief Image of random Gaussian blobs with a small uniform noise.
+  //!
+  //! The blobs have a range of scales, so that the image has scale-space
+  //! extrema at every octave.
+  inline auto blob_image(int w, int h, int num_blobs = 1000,
+                         std::uint32_t seed = 0) -> Image<float>
+  {
+    auto uniform = Uniform{seed};
+
+    auto image = Image<float>{w, h};
+    for (auto& v : image)
+      v = static_cast<float>(uniform(0.45, 0.55));
+
+    for (auto b = 0; b < num_blobs; ++b)
+    {
+      const auto cx = uniform(0, w);
+      const auto cy = uniform(0, h);
+      const auto sigma = uniform(1, 12);
+      const auto amplitude = uniform(-0.4, 0.4);
+
+      const auto r = static_cast<int>(3 * sigma);
+      const auto xmin = std::max(0, static_cast<int>(cx) - r);
+      const auto xmax = std::min(w - 1, static_cast<int>(cx) + r);
+      const auto ymin = std::max(0, static_cast<int>(cy) - r);
+      const auto ymax = std::min(h - 1, static_cast<int>(cy) + r);
+      for (auto y = ymin; y <= ymax; ++y)
+        for (auto x = xmin; x <= xmax; ++x)
+        {
+          const auto d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+          image(x, y) += static_cast<float>(
+              amplitude * std::exp(-d2 / (2 * sigma * sigma)));
+        }
+    }
+
+    return image;
+  }
+
+  //! @brief Color version of the blob image.
+  inline auto blob_image_rgb(int w, int h, std::uint32_t seed = 0)
+      -> Image<Rgb8>
+  {
+    const auto r = blob_image(w, h, 1000, seed);
+    const auto g = blob_image(w, h, 1000, seed + 1);
+    const auto b = blob_image(w, h, 1000, seed + 2);
+
+    auto to_byte = [](float v) {
+      return static_cast<std::uint8_t>(std::clamp(v, 0.f, 1.f) * 255);
+    };
+
+    auto image = Image<Rgb8>{w, h};
+    for (auto y = 0; y < h; ++y)
+      for (auto x = 0; x < w; ++x)
+        image(x, y) =
+            Rgb8{to_byte(r(x, y)), to_byte(g(x, y)), to_byte(b(x, y))};
+    return image;
+  }
+
+  //! @brief Keypoints with random positions in a (w, h) image and random
+  //! descriptors in [0, 255).
+  inline auto keypoints(int num_keypoints, int dim = 128, int w = 1920,
+                        int h = 1080, std::uint32_t seed = 0)
+      -> KeypointList<OERegion, float>
+  {
+    auto uniform = Uniform{seed};
+
+    auto keys = KeypointList<OERegion, float>{};
+    resize(keys, num_keypoints, dim);
+
+    auto& f = features(keys);
+    auto& d = descriptors(keys);
+    for (auto i = 0; i < num_keypoints; ++i)
+    {
+      f[i] = OERegion{Point2f(uniform(0, w), uniform(0, h)),
+                      static_cast<float>(uniform(1, 5))};
+      f[i].orientation = static_cast<float>(uniform(-M_PI, M_PI));
+      for (auto k = 0; k < dim; ++k)
+        d(i, k) = static_cast<float>(uniform(0, 255));
+    }
+
+    return keys;
+  }
+
+  //! @brief Shuffle the keypoints and perturb their positions and their
+  //! descriptors, so that each keypoint has one true match.
+  inline auto perturbed(const KeypointList<OERegion, float>& keys,
+                        double descriptor_noise = 10,
+                        std::uint32_t seed = 1)
+      -> KeypointList<OERegion, float>
+  {
+    auto uniform = Uniform{seed};
+
+    const auto n = static_cast<int>(size(keys));
+    const auto dim = descriptors(keys).size(1);
+
+    auto order = std::vector<int>(n);
+    for (auto i = 0; i < n; ++i)
+      order[i] = i;
+    for (auto i = n - 1; i > 0; --i)
+      std::swap(order[i], order[uniform.index(i + 1)]);
+
+    auto out = KeypointList<OERegion, float>{};
+    resize(out, n, dim);
+    for (auto i = 0; i < n; ++i)
+    {
+      auto& f = features(out)[i];
+      f = features(keys)[order[i]];
+      f.center() += Point2f(static_cast<float>(uniform(-1, 1)),
+                            static_cast<float>(uniform(-1, 1)));
+      for (auto k = 0; k < dim; ++k)
+        descriptors(out)(i, k) =
+            descriptors(keys)(order[i], k) +
+            static_cast<float>(uniform(-descriptor_noise, descriptor_noise));
+    }
+
+    return out;
+  }
+
+  //! @brief Maximum number of OpenMP threads, 1 without OpenMP.
+  inline auto max_num_threads() -> int
+  {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+  }
+
+}  // namespace DO::Sara::Synthetic
+
+
+//! @brief Entry point of the benchmark programs.
+//!
+//! Besides the machine description of Google Benchmark, the JSON output
+//! records the library version and the number of OpenMP threads.
+#define SARA_BENCHMARK_MAIN()                                                  \
+  int main(int argc, char** argv)                                              \
+  {                                                                            \
+    ::benchmark::Initialize(&argc, argv);                                      \
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))                  \
+      return 1;                                                                \
+    ::benchmark::AddCustomContext("sara_version", DO_SARA_VERSION);            \
+    ::benchmark::AddCustomContext(                                             \
+        "omp_max_threads",                                                     \
+        std::to_string(::DO::Sara::Synthetic::max_num_threads()));             \
+    ::benchmark::RunSpecifiedBenchmarks();                                     \
+    ::benchmark::Shutdown();                                                   \
+    return 0;                                                                  \
+  }                                                                            \
+  int main(int, char**)
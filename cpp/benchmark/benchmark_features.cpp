@@ -0,0 +1,148 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/FeatureDescriptors.hpp>
+#include <DO/Sara/FeatureDetectors.hpp>
+#include <DO/Sara/FeatureMatching.hpp>
+
+#include "SyntheticData.hpp"
+
+
+using namespace DO::Sara;
+
+
+static void image_sizes(benchmark::internal::Benchmark* b)
+{
+  b->Args({640, 480})->Args({1920, 1080})->Unit(benchmark::kMillisecond);
+}
+
+static void keypoint_counts(benchmark::internal::Benchmark* b)
+{
+  b->Arg(1000)->Arg(5000)->Unit(benchmark::kMillisecond);
+}
+
+
+static void BM_DoGExtrema(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  auto compute_DoGs = ComputeDoGExtrema{};
+
+  auto num_extrema = std::size_t{};
+  for (auto _ : state)
+  {
+    auto scale_octave_pairs = std::vector<Point2i>{};
+    const auto DoGs = compute_DoGs(image, &scale_octave_pairs);
+    num_extrema = DoGs.size();
+  }
+  state.counters["extrema"] = static_cast<double>(num_extrema);
+}
+BENCHMARK(BM_DoGExtrema)->Apply(image_sizes);
+
+
+//! @brief DoG extrema and gradients of the synthetic image, which are the
+//! inputs of the SIFT description.
+struct SIFTInputs
+{
+  explicit SIFTInputs(const ImageView<float>& image)
+  {
+    DoGs = compute_DoGs(image, &scale_octave_pairs);
+    nabla_G = gradient_polar_coordinates(compute_DoGs.gaussians());
+  }
+
+  ComputeDoGExtrema compute_DoGs;
+  std::vector<OERegion> DoGs;
+  std::vector<Point2i> scale_octave_pairs;
+  ImagePyramid<Vector2f> nabla_G;
+};
+
+static void BM_DominantOrientations(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  const auto inputs = SIFTInputs{image};
+  auto assign_dominant_orientations = ComputeDominantOrientations{};
+
+  for (auto _ : state)
+  {
+    auto DoGs = inputs.DoGs;
+    auto scale_octave_pairs = inputs.scale_octave_pairs;
+    assign_dominant_orientations(inputs.nabla_G, DoGs, scale_octave_pairs);
+    benchmark::DoNotOptimize(DoGs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.DoGs.size());
+}
+BENCHMARK(BM_DominantOrientations)->Apply(image_sizes);
+
+static void BM_SIFTDescription(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(1920, 1080);
+  const auto inputs = SIFTInputs{image};
+  const auto parallel = state.range(0) != 0;
+  const auto compute_sift = ComputeSIFTDescriptor<>{};
+
+  for (auto _ : state)
+  {
+    const auto sifts = compute_sift(inputs.DoGs, inputs.scale_octave_pairs,
+                                    inputs.nabla_G, parallel);
+    benchmark::DoNotOptimize(sifts.data());
+  }
+  state.SetItemsProcessed(state.iterations() * inputs.DoGs.size());
+}
+BENCHMARK(BM_SIFTDescription)
+    ->ArgName("parallel")
+    ->Arg(0)
+    ->Arg(1)
+    ->Unit(benchmark::kMillisecond);
+
+
+template <typename Matcher>
+static auto run_matcher(benchmark::State& state, Matcher&& make_matcher)
+{
+  const auto keys1 = Synthetic::keypoints(state.range(0));
+  const auto keys2 = Synthetic::perturbed(keys1);
+
+  auto num_matches = std::size_t{};
+  for (auto _ : state)
+  {
+    auto matcher = make_matcher(keys1, keys2);
+    num_matches = matcher.compute_matches().size();
+  }
+  state.counters["matches"] = static_cast<double>(num_matches);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AnnMatcher(benchmark::State& state)
+{
+  run_matcher(state, [](const auto& keys1, const auto& keys2) {
+    return AnnMatcher{keys1, keys2, 0.8f};
+  });
+}
+BENCHMARK(BM_AnnMatcher)->Apply(keypoint_counts);
+
+static void BM_BruteForceMatcher_Float32(benchmark::State& state)
+{
+  run_matcher(state, [](const auto& keys1, const auto& keys2) {
+    return BruteForceMatcher{keys1, keys2, 0.8f,
+                             BruteForceMatcher::DescriptorMode::Float32};
+  });
+}
+BENCHMARK(BM_BruteForceMatcher_Float32)->Apply(keypoint_counts);
+
+static void BM_BruteForceMatcher_Int8(benchmark::State& state)
+{
+  run_matcher(state, [](const auto& keys1, const auto& keys2) {
+    return BruteForceMatcher{keys1, keys2, 0.8f,
+                             BruteForceMatcher::DescriptorMode::Int8};
+  });
+}
+BENCHMARK(BM_BruteForceMatcher_Int8)->Apply(keypoint_counts);
+
+
+SARA_BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/Geometry/Algorithms/EllipseIntersection.hpp>
+
+#include "SyntheticData.hpp"
+
+
+using namespace DO::Sara;
+
+
+//! @brief Pairs of random overlapping ellipses.
+static auto ellipse_pairs(int num_pairs, std::uint32_t seed = 0)
+    -> std::vector<std::pair<Ellipse, Ellipse>>
+{
+  auto uniform = Synthetic::Uniform{seed};
+  auto random_ellipse = [&]() {
+    return Ellipse{uniform(10, 100), uniform(10, 100), uniform(0, 2 * M_PI),
+                   Point2d{uniform(200, 300), uniform(200, 300)}};
+  };
+
+  auto pairs = std::vector<std::pair<Ellipse, Ellipse>>(num_pairs);
+  for (auto& p : pairs)
+  {
+    p.first = random_ellipse();
+    p.second = random_ellipse();
+  }
+  return pairs;
+}
+
+
+//! The approximate computation clips polygons approximating the ellipses with
+//! the Sutherland-Hodgman method. An 8-sided polygon is already a good
+//! approximation in practice, a 36-sided polygon a very precise one.
+static void BM_ApproximateJaccardSimilarity(benchmark::State& state)
+{
+  const auto pairs = ellipse_pairs(1000);
+  const auto discretization = static_cast<int>(state.range(0));
+
+  for (auto _ : state)
+    for (const auto& [e1, e2] : pairs)
+      benchmark::DoNotOptimize(
+          approximate_jaccard_similarity(e1, e2, discretization));
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+BENCHMARK(BM_ApproximateJaccardSimilarity)
+    ->ArgName("discretization")
+    ->Arg(8)
+    ->Arg(36)
+    ->Unit(benchmark::kMicrosecond);
+
+static void BM_AnalyticJaccardSimilarity(benchmark::State& state)
+{
+  const auto pairs = ellipse_pairs(1000);
+
+  for (auto _ : state)
+    for (const auto& [e1, e2] : pairs)
+      benchmark::DoNotOptimize(analytic_jaccard_similarity(e1, e2));
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+BENCHMARK(BM_AnalyticJaccardSimilarity)->Unit(benchmark::kMicrosecond);
+
+
+SARA_BENCHMARK_MAIN();
@@ -0,0 +1,105 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/ImageProcessing.hpp>
+
+#include "SyntheticData.hpp"
+
+
+using namespace DO::Sara;
+
+
+// Image sizes: VGA and full HD.
+static void image_sizes(benchmark::internal::Benchmark* b)
+{
+  b->Args({640, 480})->Args({1920, 1080})->Unit(benchmark::kMillisecond);
+}
+
+static auto set_pixels_processed(benchmark::State& state) -> void
+{
+  state.SetItemsProcessed(state.iterations() * state.range(0) *
+                          state.range(1));
+}
+
+
+static void BM_GaussianFilter(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  auto blurred = Image<float>{image.sizes()};
+
+  for (auto _ : state)
+  {
+    apply_gaussian_filter(image, blurred, 1.6f);
+    benchmark::DoNotOptimize(blurred.data());
+  }
+  set_pixels_processed(state);
+}
+BENCHMARK(BM_GaussianFilter)->Apply(image_sizes);
+
+static void BM_DericheBlur(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  auto blurred = Image<float>{image.sizes()};
+
+  for (auto _ : state)
+  {
+    blurred = image;
+    inplace_deriche_blur(blurred, 1.6f);
+    benchmark::DoNotOptimize(blurred.data());
+  }
+  set_pixels_processed(state);
+}
+BENCHMARK(BM_DericheBlur)->Apply(image_sizes);
+
+static void BM_SobelFilter(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  auto gradient = Image<float>{image.sizes()};
+
+  for (auto _ : state)
+  {
+    apply_sobel_filter(image, gradient);
+    benchmark::DoNotOptimize(gradient.data());
+  }
+  set_pixels_processed(state);
+}
+BENCHMARK(BM_SobelFilter)->Apply(image_sizes);
+
+static void BM_GaussianPyramid(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  auto G = ImagePyramid<float>{};
+
+  for (auto _ : state)
+  {
+    gaussian_pyramid(image, G);
+    benchmark::DoNotOptimize(&G);
+  }
+  set_pixels_processed(state);
+}
+BENCHMARK(BM_GaussianPyramid)->Apply(image_sizes);
+
+static void BM_DifferenceOfGaussiansPyramid(benchmark::State& state)
+{
+  const auto image = Synthetic::blob_image(state.range(0), state.range(1));
+  const auto G = gaussian_pyramid(image);
+
+  for (auto _ : state)
+  {
+    auto D = difference_of_gaussians_pyramid(G);
+    benchmark::DoNotOptimize(&D);
+  }
+  set_pixels_processed(state);
+}
+BENCHMARK(BM_DifferenceOfGaussiansPyramid)->Apply(image_sizes);
+
+
+SARA_BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/Core/HDF5.hpp>
+#include <DO/Sara/ImageIO.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include "SyntheticData.hpp"
+
+
+namespace fs = boost::filesystem;
+
+using namespace DO::Sara;
+
+
+//! @brief Temporary directory removed at the end of the benchmark.
+struct TemporaryDirectory
+{
+  TemporaryDirectory()
+    : path{fs::temp_directory_path() / fs::unique_path("sara-%%%%-%%%%")}
+  {
+    fs::create_directories(path);
+  }
+
+  ~TemporaryDirectory()
+  {
+    fs::remove_all(path);
+  }
+
+  auto file(const std::string& name) const -> std::string
+  {
+    return (path / name).string();
+  }
+
+  fs::path path;
+};
+
+//! @brief (N, 128) tensor of SIFT-like descriptors.
+static auto descriptor_tensor(int num_descriptors) -> Tensor_<float, 2>
+{
+  auto keys = Synthetic::keypoints(num_descriptors);
+  return std::move(descriptors(keys));
+}
+
+
+static void descriptor_counts(benchmark::internal::Benchmark* b)
+{
+  b->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+}
+
+static void BM_HDF5_WriteDescriptors(benchmark::State& state)
+{
+  const auto tmp = TemporaryDirectory{};
+  const auto d = descriptor_tensor(state.range(0));
+
+  for (auto _ : state)
+  {
+    auto h5_file = H5File{tmp.file("descriptors.h5"), H5F_ACC_TRUNC};
+    h5_file.write_dataset("descriptors", d, true);
+  }
+  state.SetBytesProcessed(state.iterations() * d.size() * sizeof(float));
+}
+BENCHMARK(BM_HDF5_WriteDescriptors)->Apply(descriptor_counts);
+
+static void BM_HDF5_ReadDescriptors(benchmark::State& state)
+{
+  const auto tmp = TemporaryDirectory{};
+  const auto filepath = tmp.file("descriptors.h5");
+  const auto d = descriptor_tensor(state.range(0));
+  {
+    auto h5_file = H5File{filepath, H5F_ACC_TRUNC};
+    h5_file.write_dataset("descriptors", d, true);
+  }
+
+  auto d_read = Tensor_<float, 2>{};
+  for (auto _ : state)
+  {
+    auto h5_file = H5File{filepath, H5F_ACC_RDONLY};
+    h5_file.read_dataset("descriptors", d_read);
+    benchmark::DoNotOptimize(d_read.data());
+  }
+  state.SetBytesProcessed(state.iterations() * d.size() * sizeof(float));
+}
+BENCHMARK(BM_HDF5_ReadDescriptors)->Apply(descriptor_counts);
+
+
+static void image_formats(benchmark::internal::Benchmark* b)
+{
+  b->ArgName("png")->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+}
+
+static auto image_filename(const benchmark::State& state) -> std::string
+{
+  return state.range(0) != 0 ? "image.png" : "image.jpg";
+}
+
+static void BM_ImageWrite(benchmark::State& state)
+{
+  const auto tmp = TemporaryDirectory{};
+  const auto filepath = tmp.file(image_filename(state));
+  const auto image = Synthetic::blob_image_rgb(1920, 1080);
+
+  for (auto _ : state)
+    imwrite(image, filepath, 90);
+  state.SetItemsProcessed(state.iterations() * image.size());
+}
+BENCHMARK(BM_ImageWrite)->Apply(image_formats);
+
+static void BM_ImageRead(benchmark::State& state)
+{
+  const auto tmp = TemporaryDirectory{};
+  const auto filepath = tmp.file(image_filename(state));
+  imwrite(Synthetic::blob_image_rgb(1920, 1080), filepath, 90);
+
+  for (auto _ : state)
+  {
+    const auto image = imread<Rgb8>(filepath);
+    benchmark::DoNotOptimize(image.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 1920 * 1080);
+}
+BENCHMARK(BM_ImageRead)->Apply(image_formats);
+
+
+SARA_BENCHMARK_MAIN();
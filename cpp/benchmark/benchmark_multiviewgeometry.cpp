@@ -0,0 +1,184 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/MultiViewGeometry/Estimators/ErrorMeasures.hpp>
+#include <DO/Sara/MultiViewGeometry/Estimators/EssentialMatrixEstimators.hpp>
+#include <DO/Sara/MultiViewGeometry/Estimators/FundamentalMatrixEstimators.hpp>
+#include <DO/Sara/MultiViewGeometry/Estimators/HomographyEstimator.hpp>
+#include <DO/Sara/MultiViewGeometry/Estimators/Triangulation.hpp>
+#include <DO/Sara/MultiViewGeometry/RANSAC.hpp>
+#include <DO/Sara/MultiViewGeometry/Utilities.hpp>
+
+#include "SyntheticData.hpp"
+
+
+using namespace DO::Sara;
+
+
+//! @brief Correspondences between two views of a synthetic scene.
+//!
+//! The point coordinates are homogeneous and stored row-wise. The first
+//! (1 - outlier_ratio) * N correspondences are inliers.
+struct TwoViews
+{
+  Matrix34d P1;
+  Matrix34d P2;
+  Tensor_<double, 2> u1;
+  Tensor_<double, 2> u2;
+  Tensor_<int, 2> matches;
+};
+
+//! @param planar whether the scene points lie on a plane.
+//! @param normalized whether the coordinates are normalized camera
+//! coordinates or pixel coordinates.
+auto make_two_views(int num_points, double outlier_ratio, bool planar,
+                    bool normalized, std::uint32_t seed = 0) -> TwoViews
+{
+  auto uniform = Synthetic::Uniform{seed};
+
+  auto K = Matrix3d{};
+  if (normalized)
+    K.setIdentity();
+  else
+    K << 1000, 0, 960,  //
+        0, 1000, 540,   //
+        0, 0, 1;
+
+  auto views = TwoViews{};
+  views.P1 = K * normalized_camera(Matrix3d::Identity(), Vector3d::Zero())
+                     .matrix();
+  views.P2 = K * normalized_camera(rotation_y(0.1) * rotation_x(0.02),
+                                   Vector3d{-1., 0.05, 0.1})
+                     .matrix();
+
+  views.u1 = Tensor_<double, 2>{num_points, 3};
+  views.u2 = Tensor_<double, 2>{num_points, 3};
+  views.matches = Tensor_<int, 2>{num_points, 2};
+
+  const auto num_inliers =
+      static_cast<int>(std::round((1 - outlier_ratio) * num_points));
+  for (auto i = 0; i < num_points; ++i)
+  {
+    const auto X = Vector4d{uniform(-2, 2), uniform(-2, 2),
+                            planar ? 5. : uniform(4, 8), 1.};
+    views.u1.matrix().row(i) = (views.P1 * X).hnormalized().homogeneous();
+    if (i < num_inliers)
+      views.u2.matrix().row(i) = (views.P2 * X).hnormalized().homogeneous();
+    else
+    {
+      const auto Y =
+          Vector4d{uniform(-2, 2), uniform(-2, 2), uniform(4, 8), 1.};
+      views.u2.matrix().row(i) = (views.P2 * Y).hnormalized().homogeneous();
+    }
+    views.matches(i, 0) = i;
+    views.matches(i, 1) = i;
+  }
+
+  return views;
+}
+
+template <typename Estimator, typename Distance>
+auto run_ransac(benchmark::State& state, bool planar, bool normalized,
+                double err_threshold) -> void
+{
+  const auto num_points = static_cast<int>(state.range(0));
+  const auto num_samples = static_cast<int>(state.range(1));
+  const auto views = make_two_views(num_points, 0.3, planar, normalized);
+
+  auto num_inliers = 0;
+  for (auto _ : state)
+  {
+    const auto [model, inliers, sample] =
+        ransac(views.matches, views.u1, views.u2, Estimator{}, Distance{},
+               num_samples, err_threshold);
+    num_inliers = static_cast<int>(inliers.flat_array().count());
+    benchmark::DoNotOptimize(&model);
+  }
+  state.counters["inlier_ratio"] = double(num_inliers) / num_points;
+  state.SetItemsProcessed(state.iterations() * num_samples);
+}
+
+static void ransac_sizes(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"points", "samples"})
+      ->Args({1000, 100})
+      ->Args({5000, 500})
+      ->Unit(benchmark::kMillisecond);
+}
+
+static void BM_RANSAC_EightPointAlgorithm(benchmark::State& state)
+{
+  run_ransac<EightPointAlgorithm, EpipolarDistance>(state, false, false, 1e-2);
+}
+BENCHMARK(BM_RANSAC_EightPointAlgorithm)->Apply(ransac_sizes);
+
+static void BM_RANSAC_FourPointAlgorithm(benchmark::State& state)
+{
+  run_ransac<FourPointAlgorithm, SymmetricTransferError>(state, true, false,
+                                                         2.);
+}
+BENCHMARK(BM_RANSAC_FourPointAlgorithm)->Apply(ransac_sizes);
+
+static void BM_RANSAC_NisterFivePointAlgorithm(benchmark::State& state)
+{
+  run_ransac<NisterFivePointAlgorithm, EpipolarDistance>(state, false, true,
+                                                         5e-3);
+}
+BENCHMARK(BM_RANSAC_NisterFivePointAlgorithm)->Apply(ransac_sizes);
+
+static void BM_RANSAC_SteweniusFivePointAlgorithm(benchmark::State& state)
+{
+  run_ransac<SteweniusFivePointAlgorithm, EpipolarDistance>(state, false, true,
+                                                            5e-3);
+}
+BENCHMARK(BM_RANSAC_SteweniusFivePointAlgorithm)->Apply(ransac_sizes);
+
+
+static void point_counts(benchmark::internal::Benchmark* b)
+{
+  b->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+}
+
+static void BM_TriangulateLinearEigen(benchmark::State& state)
+{
+  const auto views = make_two_views(state.range(0), 0., false, true);
+  const MatrixXd u1 = views.u1.colmajor_view().matrix();
+  const MatrixXd u2 = views.u2.colmajor_view().matrix();
+
+  for (auto _ : state)
+  {
+    const auto X = triangulate_linear_eigen(views.P1, views.P2, u1, u2);
+    benchmark::DoNotOptimize(X.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TriangulateLinearEigen)->Apply(point_counts);
+
+static void BM_TriangulateBatched(benchmark::State& state)
+{
+  const auto n = static_cast<int>(state.range(0));
+  const auto views = make_two_views(n, 0., false, true);
+
+  auto X = Tensor_<double, 2>{n, 4};
+  auto cheirality = Tensor_<bool, 1>{n};
+  auto errors = Tensor_<double, 1>{n};
+  for (auto _ : state)
+  {
+    triangulate(views.P1, views.P2, views.u1, views.u2, X, cheirality,
+                errors);
+    benchmark::DoNotOptimize(X.data());
+  }
+  state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TriangulateBatched)->Apply(point_counts);
+
+
+SARA_BENCHMARK_MAIN();
@@ -0,0 +1,99 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/ImageIO.hpp>
+#include <DO/Sara/VideoIO.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <fstream>
+
+#include "SyntheticData.hpp"
+
+
+namespace fs = boost::filesystem;
+
+using namespace DO::Sara;
+
+
+constexpr auto num_frames = 50;
+
+/*!
+  @brief Synthetic Motion JPEG video, i.e., a concatenation of JPEG images,
+  which FFmpeg demuxes without a container.
+
+  The video is generated once with the JPEG encoder of the ImageIO module so
+  that the benchmark does not depend on any video file or video encoder.
+ */
+struct SyntheticVideo
+{
+  SyntheticVideo(int w, int h)
+    : dirpath{fs::temp_directory_path() / fs::unique_path("sara-%%%%-%%%%")}
+  {
+    fs::create_directories(dirpath);
+    filepath = (dirpath / "video.mjpeg").string();
+
+    const auto frame_filepath = (dirpath / "frame.jpg").string();
+    auto video = std::ofstream{filepath, std::ios::binary};
+
+    // The frames are translated crops of a larger image.
+    const auto image = Synthetic::blob_image_rgb(w + num_frames, h);
+    for (auto f = 0; f < num_frames; ++f)
+    {
+      imwrite(crop(image, Vector2i(f, 0), Vector2i(f + w, h)), frame_filepath,
+              90);
+
+      auto jpeg = std::ifstream{frame_filepath, std::ios::binary};
+      video << jpeg.rdbuf();
+    }
+  }
+
+  ~SyntheticVideo()
+  {
+    fs::remove_all(dirpath);
+  }
+
+  fs::path dirpath;
+  std::string filepath;
+};
+
+
+static void BM_VideoDecode(benchmark::State& state)
+{
+  const auto w = static_cast<int>(state.range(0));
+  const auto h = static_cast<int>(state.range(1));
+  const auto pixel_format = static_cast<VideoPixelFormat>(state.range(2));
+  const auto video = SyntheticVideo{w, h};
+
+  auto num_decoded_frames = 0;
+  for (auto _ : state)
+  {
+    auto stream = VideoStream{video.filepath};
+    stream.set_output_format(pixel_format);
+    num_decoded_frames = 0;
+    while (stream.read())
+      ++num_decoded_frames;
+  }
+
+  if (num_decoded_frames != num_frames)
+    state.SkipWithError("The synthetic video was not fully decoded!");
+  state.SetItemsProcessed(state.iterations() * num_decoded_frames);
+}
+BENCHMARK(BM_VideoDecode)
+    ->ArgNames({"w", "h", "format"})
+    ->Args({640, 480, static_cast<int>(VideoPixelFormat::Rgb8)})
+    ->Args({1920, 1080, static_cast<int>(VideoPixelFormat::Rgb8)})
+    ->Args({1920, 1080, static_cast<int>(VideoPixelFormat::Gray8)})
+    ->Args({1920, 1080, static_cast<int>(VideoPixelFormat::Gray32f)})
+    ->Unit(benchmark::kMillisecond);
+
+
+SARA_BENCHMARK_MAIN();
@@ -197,17 +197,21 @@ namespace DO { namespace Shakti { namespace HalideBackend {
       // CPU schedule.
       else
       {
+        // Use the full SIMD width, i.e., 8 floats with AVX2 and 16 floats
+        // with AVX-512.
+        const auto vector_size = target.natural_vector_size<float>();
+
         // 1st pass: transpose and convolve the columns
         conv_y_t.compute_root();
         conv_y_t.split(y, yo, yi, 8)
             .parallel(yo)
-            .vectorize(x, 8, Halide::TailStrategy::GuardWithIf);
+            .vectorize(x, vector_size, Halide::TailStrategy::GuardWithIf);
 
         // 2nd pass: transpose and convolve the rows.
         conv_y.compute_root();
         conv_x.split(y, yo, yi, 8)
             .parallel(yo)
-            .vectorize(x, 8, Halide::TailStrategy::GuardWithIf);
+            .vectorize(x, vector_size, Halide::TailStrategy::GuardWithIf);
       }
     }
   };
@@ -91,7 +91,8 @@ namespace v2 {
       {
         out.split(y, yo, yi, 8)
             .parallel(yo)
-            .vectorize(x, 8, TailStrategy::GuardWithIf);
+            .vectorize(x, get_target().template natural_vector_size<T>(),
+                       TailStrategy::GuardWithIf);
       }
     }
   };
@@ -172,7 +173,8 @@ namespace v2 {
       {
         out.split(y, yo, yi, 8)
             .parallel(yo)
-            .vectorize(x, 8, TailStrategy::GuardWithIf);
+            .vectorize(x, get_target().template natural_vector_size<T>(),
+                       TailStrategy::GuardWithIf);
       }
     }
   };
@@ -252,7 +254,8 @@ namespace v3 {
       {
         out.split(y, yo, yi, 8)
             .parallel(yo)
-            .vectorize(x, 8, TailStrategy::GuardWithIf);
+            .vectorize(x, get_target().template natural_vector_size<T>(),
+                       TailStrategy::GuardWithIf);
       }
     }
   };
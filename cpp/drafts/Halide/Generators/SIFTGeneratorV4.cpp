@@ -105,35 +105,73 @@ namespace {
 
     void schedule()
     {
-      // GPU schedule.
-      if (!get_target().has_gpu_feature())
-        throw std::runtime_error{"GPU implementation only!"};
-
       gradient_weight_fn.compute_root();
       spatial_weight_fn.compute_root();
 
-      normalized_gradient_fn.compute_root();
-      normalized_gradient_fn.gpu_tile(  //
-          u, v, k,                      //
-          uo, vo, ko,                   //
-          ui, vi, ki,                   //
-          tile_u, tile_v, tile_k,       //
-          Halide::TailStrategy::GuardWithIf);
+      // GPU schedule.
+      if (get_target().has_gpu_feature())
+      {
+        normalized_gradient_fn.compute_root();
+        normalized_gradient_fn.gpu_tile(  //
+            u, v, k,                      //
+            uo, vo, ko,                   //
+            ui, vi, ki,                   //
+            tile_u, tile_v, tile_k,       //
+            Halide::TailStrategy::GuardWithIf);
+
+#ifdef NORMALIZE_SIFT
+        descriptors_unnormalized.compute_root();
+        descriptors_unnormalized.gpu_tile(o, ji, k,                 //
+                                          oo, jio, ko,              //
+                                          oi, jii, ki,              //
+                                          tile_o, tile_ji, tile_k,  //
+                                          TailStrategy::GuardWithIf);
+#endif
+
+        descriptors.gpu_tile(o, ji, k,                 //
+                             oo, jio, ko,              //
+                             oi, jii, ki,              //
+                             tile_o, tile_ji, tile_k,  //
+                             TailStrategy::GuardWithIf);
+      }
+
+      // CPU schedule.
+      //
+      // The keypoints are independent so we distribute blocks of keypoints
+      // on the cores. The inner loops are vectorized with the natural vector
+      // width of the target, i.e., 8 floats for AVX2 and 16 for AVX-512.
+      else
+      {
+        const auto vector_size = natural_vector_size<float>();
+
+        normalized_gradient_fn.compute_root()
+            .split(k, ko, ki, tile_k, TailStrategy::GuardWithIf)
+            .parallel(ko)
+            .vectorize(u, vector_size, TailStrategy::GuardWithIf);
 
 #ifdef NORMALIZE_SIFT
-      descriptors_unnormalized.compute_root();
-      descriptors_unnormalized.gpu_tile(o, ji, k,                 //
-                                        oo, jio, ko,              //
-                                        oi, jii, ki,              //
-                                        tile_o, tile_ji, tile_k,  //
-                                        TailStrategy::GuardWithIf);
+        descriptors_unnormalized.compute_root()
+            .split(k, ko, ki, tile_k, TailStrategy::GuardWithIf)
+            .parallel(ko)
+            .vectorize(o, tile_o, TailStrategy::GuardWithIf);
+        // The histogram bins are accumulated with scattered writes along the
+        // orientation axis, so only the keypoint axis is parallelized.
+        for (auto i = 0; i < descriptors_unnormalized.num_update_definitions();
+             ++i)
+          descriptors_unnormalized.update(i).parallel(k);
+
+        sift.contrast_norm.parallel(k);
+        sift.hist_contrast_invariant.parallel(k).vectorize(o, tile_o);
+        sift.hist_clamped.parallel(k).vectorize(o, tile_o);
+        sift.illumination_norm.parallel(k);
+        sift.hist_illumination_invariant.parallel(k).vectorize(o, tile_o);
 #endif
 
-      descriptors.gpu_tile(o, ji, k,                 //
-                           oo, jio, ko,              //
-                           oi, jii, ki,              //
-                           tile_o, tile_ji, tile_k,  //
-                           TailStrategy::GuardWithIf);
+        descriptors
+            .split(k, ko, ki, tile_k, TailStrategy::GuardWithIf)
+            .parallel(ko)
+            .vectorize(o, tile_o, TailStrategy::GuardWithIf);
+      }
     }
   };
 
@@ -0,0 +1,75 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @example
+//!
+//! Stream synthetic RGB frames through the shared-memory frame ring.
+//!
+//! The frames can be consumed from Python with:
+//!   python/do/sara/pybind11/examples/shared_frames_example.py
+
+#include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/SharedFrameRing.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+
+namespace sara = DO::Sara;
+
+
+static std::atomic<bool> stop{false};
+
+
+int main(int argc, char** argv)
+{
+  const auto name = std::string{argc > 1 ? argv[1] : "sara_frames"};
+  const auto w = argc > 2 ? std::stoi(argv[2]) : 1920;
+  const auto h = argc > 3 ? std::stoi(argv[3]) : 1080;
+  const auto fps = argc > 4 ? std::stod(argv[4]) : 30.;
+
+  std::signal(SIGINT, [](int) { stop = true; });
+
+  // Keep one second of frames in the ring.
+  const auto num_slots = std::max(static_cast<int>(fps), 2);
+  auto producer = sara::SharedFrameProducer{name, num_slots,
+                                            w * h * sizeof(sara::Rgb8)};
+  std::cout << "[C++] Streaming " << w << "x" << h << " frames to '" << name
+            << "', press Ctrl+C to stop" << std::endl;
+
+  const auto period = std::chrono::duration<double>{1. / fps};
+  auto next_time = std::chrono::steady_clock::now();
+
+  while (!stop)
+  {
+    // Write the frame directly in the shared memory.
+    auto frame = producer.begin_frame<sara::Rgb8>(sara::Vector2i(w, h));
+    const auto t = static_cast<int>(producer.num_published());
+#pragma omp parallel for
+    for (auto y = 0; y < h; ++y)
+      for (auto x = 0; x < w; ++x)
+        frame(x, y) = sara::Rgb8(static_cast<std::uint8_t>(x + t),
+                                 static_cast<std::uint8_t>(y + t),
+                                 static_cast<std::uint8_t>(t));
+    const auto sequence = producer.end_frame();
+
+    if (sequence % num_slots == 0)
+      std::cout << "[C++] Published frame " << sequence << std::endl;
+
+    next_time += std::chrono::duration_cast<std::chrono::nanoseconds>(period);
+    std::this_thread::sleep_until(next_time);
+  }
+
+  return 0;
+}
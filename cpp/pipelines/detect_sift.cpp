@@ -33,6 +33,9 @@ int __main(int argc, char **argv)
         ("out_h5_file", po::value<std::string>(), "Output HDF5 file")  //
         ("overwrite", "Overwrite keypoints")                           //
         ("read", "Visualize detected keypoints")                       //
+        ("profile", po::value<std::string>(),
+         "Write the profile of the run to <prefix>.trace.json and "
+         "<prefix>.summary.json")  //
         ;
 
     po::variables_map vm;
@@ -45,6 +48,14 @@ int __main(int argc, char **argv)
       return 0;
     }
 
+    if (vm.count("profile") && !sara::Profiler::enabled)
+    {
+      std::cerr << "Sara must be configured with SARA_USE_PROFILING=ON to "
+                   "profile the run"
+                << std::endl;
+      return 1;
+    }
+
     if (!vm.count("dirpath"))
     {
       std::cout << "Missing image directory path" << std::endl;
@@ -65,6 +76,14 @@ int __main(int argc, char **argv)
     else
       sara::detect_keypoints(dirpath, h5_filepath, overwrite);
 
+    if (vm.count("profile"))
+    {
+      const auto prefix = vm["profile"].as<std::string>();
+      const auto& profiler = sara::Profiler::instance();
+      profiler.write_chrome_trace(prefix + ".trace.json");
+      profiler.write_summary(prefix + ".summary.json");
+    }
+
     return 0;
   }
   catch (const po::error& e)
@@ -41,6 +41,9 @@ int __main(int argc, char **argv)
          "Draw correspondences every multiple of the display step")    //
         ("wait_key",                                                   //
          "Wait for key press upon fundamental matrix inspection")      //
+        ("profile", po::value<std::string>(),
+         "Write the profile of the run to <prefix>.trace.json and "
+         "<prefix>.summary.json")  //
         ;
 
     po::variables_map vm;
@@ -53,6 +56,14 @@ int __main(int argc, char **argv)
       return 0;
     }
 
+    if (vm.count("profile") && !sara::Profiler::enabled)
+    {
+      std::cerr << "Sara must be configured with SARA_USE_PROFILING=ON to "
+                   "profile the run"
+                << std::endl;
+      return 1;
+    }
+
     if (!vm.count("dirpath"))
     {
       std::cout << "Missing image directory path" << std::endl;
@@ -80,6 +91,14 @@ int __main(int argc, char **argv)
       sara::estimate_fundamental_matrices(dirpath, h5_filepath, overwrite,
                                           debug, wait_key);
 
+    if (vm.count("profile"))
+    {
+      const auto prefix = vm["profile"].as<std::string>();
+      const auto& profiler = sara::Profiler::instance();
+      profiler.write_chrome_trace(prefix + ".trace.json");
+      profiler.write_summary(prefix + ".summary.json");
+    }
+
     return 0;
   }
   catch (const po::error& e)
@@ -28,7 +28,7 @@ using namespace DO::Sara;
 
 auto perform_bundle_adjustment(const std::string& dirpath,
                                const std::string& h5_filepath,
-                               bool /* overwrite */,
+                               bool overwrite,
                                bool /* debug */)
 {
   // Create a backup.
@@ -136,19 +136,45 @@ auto perform_bundle_adjustment(const std::string& dirpath,
 
   write_pose_graph(pose_graph, h5_file, "pose_graph");
 
-  // TODO: Perform incremental bundle adjustment using a Dijkstra growing
-  // scheme.
-  //
-  // Let's just choose a heuristics for the incremental bundle adjustment even
-  // if Bundler does not do like this.
-  view_attributes.cameras.resize(num_vertices);
-
-  // Reload the point tracks.
-  const auto feature_graph = read_feature_graph(h5_file, "feature_graph");
-
-  // TODO: bundle adjustment.
-
-  // TODO: save the point cloud.
+  // Load the internal camera matrices from Strecha dataset.
+  // N.B.: this is an ad-hoc code.
+  SARA_DEBUG << "Reading internal camera matrices in Strecha's data format"
+             << std::endl;
+  std::for_each(
+      std::begin(view_attributes.image_paths),
+      std::end(view_attributes.image_paths), [&](const auto& image_path) {
+        const auto K_filepath = dirpath + "/" + basename(image_path) + ".png.K";
+        view_attributes.cameras.push_back(normalized_camera());
+        view_attributes.cameras.back().K =
+            read_internal_camera_parameters(K_filepath);
+      });
+
+  // Recalculate the point tracks.
+  const auto [feature_graph, components] =
+      populate_feature_tracks(view_attributes, edge_attributes);
+  const auto feature_tracks =
+      filter_feature_tracks(feature_graph, components, view_attributes);
+
+  // Incremental bundle adjustment grown from the maximum spanning tree of the
+  // pose graph.
+  auto options = IncrementalReconstructionOptions{};
+  options.verbose = true;
+  auto reconstruction = IncrementalReconstruction{
+      view_attributes, edge_attributes, pose_graph, feature_tracks, options};
+  reconstruction.run();
+
+  SARA_CHECK(reconstruction.num_registered_views());
+  SARA_CHECK(reconstruction.rms_reprojection_error());
+
+  // Save the point cloud and the cameras.
+  const auto& cameras = reconstruction.cameras();
+  auto camera_tensor = Tensor_<PinholeCamera, 1>{num_vertices};
+  std::copy(cameras.begin(), cameras.end(), camera_tensor.begin());
+
+  h5_file.get_group("reconstruction");
+  h5_file.write_dataset("reconstruction/point_cloud",
+                        reconstruction.point_cloud(), overwrite);
+  h5_file.write_dataset("reconstruction/cameras", camera_tensor, overwrite);
 
   // TODO: display the cameras on OpenGL
 }
@@ -165,6 +191,9 @@ int __main(int argc, char** argv)
         ("out_h5_file", po::value<std::string>(), "Output HDF5 file")  //
         ("debug", "Inspect visually the epipolar geometry")            //
         ("overwrite", "Overwrite triangulation")                       //
+        ("profile", po::value<std::string>(),
+         "Write the profile of the run to <prefix>.trace.json and "
+         "<prefix>.summary.json")  //
         ;
 
     po::variables_map vm;
@@ -177,6 +206,14 @@ int __main(int argc, char** argv)
       return 0;
     }
 
+    if (vm.count("profile") && !Profiler::enabled)
+    {
+      std::cerr << "Sara must be configured with SARA_USE_PROFILING=ON to "
+                   "profile the run"
+                << std::endl;
+      return 1;
+    }
+
     if (!vm.count("dirpath"))
     {
       std::cout << "[--dirpath]: missing image directory path" << std::endl;
@@ -197,6 +234,14 @@ int __main(int argc, char** argv)
 
     perform_bundle_adjustment(dirpath, h5_filepath, overwrite, debug);
 
+    if (vm.count("profile"))
+    {
+      const auto prefix = vm["profile"].as<std::string>();
+      const auto& profiler = Profiler::instance();
+      profiler.write_chrome_trace(prefix + ".trace.json");
+      profiler.write_summary(prefix + ".summary.json");
+    }
+
     return 0;
   }
   catch (const po::error& e)
@@ -24,6 +24,8 @@
 #include <DO/Sara/Core/ArrayIterators.hpp>
 #include <DO/Sara/Core/MultiArray.hpp>
 #include <DO/Sara/Core/Tensor.hpp>
+// Memory pool for N-dimensional arrays
+#include <DO/Sara/Core/MemoryPool.hpp>
 // Sparse N-dimensional array
 #include <DO/Sara/Core/SparseMultiArray.hpp>
 // Image and color data structures
@@ -33,6 +35,8 @@
 #include <DO/Sara/Core/Tree.hpp>
 // Timer classes
 #include <DO/Sara/Core/Timer.hpp>
+// Profiling
+#include <DO/Sara/Core/Profiler.hpp>
 // Miscellaneous
 #include <DO/Sara/Core/DebugUtilities.hpp>
 #include <DO/Sara/Core/StdVectorHelpers.hpp>
@@ -25,6 +25,7 @@
 #include <array>
 #include <iostream>
 #include <memory>
+#include <vector>
 
 
 namespace DO::Sara {
@@ -53,6 +54,15 @@ namespace DO::Sara {
     };
   };
 
+  template <>
+  struct CalculateH5Type<unsigned char>
+  {
+    static inline auto value()
+    {
+      return H5::PredType::NATIVE_UINT8;
+    };
+  };
+
   template <>
   struct CalculateH5Type<unsigned short>
   {
@@ -131,6 +141,31 @@ namespace DO::Sara {
 
 namespace DO::Sara {
 
+  //! @brief Dataset creation options.
+  //!
+  //! By default, datasets are contiguous and uncompressed. Compression and
+  //! extendible datasets both require a chunked layout: if no chunk sizes are
+  //! specified, chunks of about 1 MB spanning full rows are used.
+  struct H5DatasetOptions
+  {
+    //! @brief Chunk sizes, one per dimension.
+    std::vector<hsize_t> chunk_sizes;
+    //! @brief Deflate (gzip) compression level in [1, 9], 0 to disable it.
+    int deflate_level = 0;
+    //! @brief Byte shuffling before compression, which helps a lot for
+    //! floating-point data.
+    bool shuffle = false;
+    //! @brief Unlimited first dimension so that rows can be appended.
+    bool extendible = false;
+
+    auto chunked() const -> bool
+    {
+      return !chunk_sizes.empty() || deflate_level > 0 || shuffle ||
+             extendible;
+    }
+  };
+
+
   //! @brief HDF5 file API.
   struct H5File
   {
@@ -204,7 +239,8 @@ namespace DO::Sara {
     template <typename T, int Rank>
     auto write_dataset(const std::string& dataset_name,
                        const DO::Sara::TensorView_<T, Rank>& data,
-                       bool overwrite = false)
+                       bool overwrite = false,
+                       const H5DatasetOptions& options = {})
     {
       const auto data_type = CalculateH5Type<T>::value();
 
@@ -212,7 +248,12 @@ namespace DO::Sara {
       std::transform(data.sizes().data(),
                      data.sizes().data() + data.sizes().size(),
                      data_dims.data(), [](auto val) { return hsize_t(val); });
-      const auto data_space = H5::DataSpace{Rank, data_dims.data()};
+
+      auto max_dims = data_dims;
+      if (options.extendible)
+        max_dims[0] = H5S_UNLIMITED;
+      const auto data_space =
+          H5::DataSpace{Rank, data_dims.data(), max_dims.data()};
 
       auto dataset = find_dataset(dataset_name);
       if (dataset != nullptr && overwrite)
@@ -222,9 +263,79 @@ namespace DO::Sara {
         throw std::runtime_error{"Error: dataset \"" + dataset_name +
                                  "\" exists but overwriting is not permitted!"};
 
+      const auto plist =
+          make_dataset_creation_property_list<T, Rank>(data_dims, options);
       dataset.reset(new H5::DataSet{
-          file->createDataSet(dataset_name, data_type, data_space)});
-      dataset->write(data.data(), data_type);
+          file->createDataSet(dataset_name, data_type, data_space, plist)});
+      if (data.size() > 0)
+        dataset->write(data.data(), data_type);
+
+      return dataset;
+    }
+
+    /*!
+      @brief Append rows at the end of an extendible dataset.
+
+      The dataset is created with the specified options if it does not exist
+      yet. In that case, the dataset is always made extendible.
+     */
+    template <typename T, int Rank>
+    auto append_dataset(const std::string& dataset_name,
+                        const DO::Sara::TensorView_<T, Rank>& data,
+                        H5DatasetOptions options = {})
+    {
+      auto dataset = find_dataset(dataset_name);
+      if (dataset == nullptr)
+      {
+        options.extendible = true;
+        return write_dataset(dataset_name, data, false, options);
+      }
+
+      // Check the dimensions.
+      auto file_data_space = dataset->getSpace();
+      if (file_data_space.getSimpleExtentNdims() != Rank)
+        throw std::runtime_error{"Error: the rank of dataset \"" +
+                                 dataset_name +
+                                 "\" differs from the rank of the data!"};
+
+      auto file_data_dims = fixed_vector_type<Rank>{};
+      auto file_max_dims = fixed_vector_type<Rank>{};
+      file_data_space.getSimpleExtentDims(file_data_dims.data(),
+                                          file_max_dims.data());
+      if (file_max_dims(0) != H5S_UNLIMITED &&
+          file_data_dims(0) + hsize_t(data.size(0)) > file_max_dims(0))
+        throw std::runtime_error{"Error: dataset \"" + dataset_name +
+                                 "\" is not extendible!"};
+      for (auto i = 1; i < Rank; ++i)
+        if (file_data_dims(i) != hsize_t(data.size(i)))
+          throw std::runtime_error{"Error: the row sizes of dataset \"" +
+                                   dataset_name +
+                                   "\" differ from the row sizes of the data!"};
+
+      if (data.size() == 0)
+        return dataset;
+
+      // Extend the dataset.
+      auto offset = fixed_vector_type<Rank>{};
+      offset.setZero();
+      offset(0) = file_data_dims(0);
+
+      auto count = fixed_vector_type<Rank>{};
+      std::transform(data.sizes().data(),
+                     data.sizes().data() + data.sizes().size(), count.data(),
+                     [](auto val) { return hsize_t(val); });
+
+      fixed_vector_type<Rank> new_dims = file_data_dims;
+      new_dims(0) += count(0);
+      dataset->extend(new_dims.data());
+
+      // Write the new rows.
+      file_data_space = dataset->getSpace();
+      file_data_space.selectHyperslab(H5S_SELECT_SET, count.data(),
+                                      offset.data());
+      const auto src_space = H5::DataSpace{Rank, count.data()};
+      dataset->write(data.data(), CalculateH5Type<T>::value(), src_space,
+                     file_data_space);
 
       return dataset;
     }
@@ -458,6 +569,104 @@ namespace DO::Sara {
                    file_data_space);
     }
 
+    /*!
+      @brief Read a range of rows of a dataset into a preallocated tensor.
+
+      The rows [first_row, first_row + data.size(0)) are read and the other
+      dimensions of the tensor must match the ones of the dataset. Only the
+      chunks overlapping the range of rows are read from the file.
+     */
+    template <typename T, int Rank>
+    auto read_dataset_rows(const std::string& dataset_name,
+                           hsize_t first_row, TensorView_<T, Rank> data)
+    {
+      auto dataset = H5::DataSet(file->openDataSet(dataset_name));
+
+      // File data space.
+      auto file_data_space = dataset.getSpace();
+      if (file_data_space.getSimpleExtentNdims() != Rank)
+        throw std::runtime_error{"Error: the rank of dataset \"" +
+                                 dataset_name +
+                                 "\" differs from the rank of the data!"};
+
+      auto file_data_dims = fixed_vector_type<Rank>{};
+      file_data_space.getSimpleExtentDims(file_data_dims.data(), nullptr);
+
+      auto count = fixed_vector_type<Rank>{};
+      std::transform(data.sizes().data(),
+                     data.sizes().data() + data.sizes().size(), count.data(),
+                     [](auto val) { return hsize_t(val); });
+
+      if (first_row + count(0) > file_data_dims(0))
+        throw std::out_of_range{"Error: reading rows out of the range of "
+                                "dataset \"" + dataset_name + "\"!"};
+      for (auto i = 1; i < Rank; ++i)
+        if (file_data_dims(i) != count(i))
+          throw std::runtime_error{"Error: the row sizes of dataset \"" +
+                                   dataset_name +
+                                   "\" differ from the row sizes of the data!"};
+
+      if (data.size() == 0)
+        return;
+
+      // Select the rows in the file data.
+      auto file_offset = fixed_vector_type<Rank>{};
+      file_offset.setZero();
+      file_offset(0) = first_row;
+      file_data_space.selectHyperslab(H5S_SELECT_SET, count.data(),
+                                      file_offset.data());
+
+      // Read the data.
+      const auto dst_space = H5::DataSpace{Rank, count.data()};
+      dataset.read(data.data(), calculate_h5_type<T>(), dst_space,
+                   file_data_space);
+    }
+
+    //! @brief Make the dataset creation property list from the options.
+    template <typename T, int Rank>
+    static auto make_dataset_creation_property_list(
+        const std::array<hsize_t, Rank>& data_dims,
+        const H5DatasetOptions& options) -> H5::DSetCreatPropList
+    {
+      auto plist = H5::DSetCreatPropList{};
+      if (!options.chunked())
+        return plist;
+
+      auto chunk_dims = std::array<hsize_t, Rank>{};
+      if (!options.chunk_sizes.empty())
+      {
+        if (options.chunk_sizes.size() != Rank)
+          throw std::runtime_error{
+              "Error: the number of chunk sizes must be the dataset rank!"};
+        std::copy(options.chunk_sizes.begin(), options.chunk_sizes.end(),
+                  chunk_dims.begin());
+      }
+      else
+      {
+        // Chunks of about 1 MB spanning full rows.
+        auto row_bytes = hsize_t(sizeof(T));
+        for (auto i = 1; i < Rank; ++i)
+        {
+          chunk_dims[i] = std::max(data_dims[i], hsize_t(1));
+          row_bytes *= chunk_dims[i];
+        }
+        const auto rows_per_chunk =
+            std::max(hsize_t(1), hsize_t(1 << 20) / row_bytes);
+        chunk_dims[0] = options.extendible
+                            ? rows_per_chunk
+                            : std::max(hsize_t(1), std::min(rows_per_chunk,
+                                                            data_dims[0]));
+      }
+
+      plist.setChunk(Rank, chunk_dims.data());
+      if (options.shuffle)
+        plist.setShuffle();
+      if (options.deflate_level > 0)
+        plist.setDeflate(options.deflate_level);
+
+      return plist;
+    }
+
     auto delete_dataset(const std::string& dataset_name) -> void
     {
       int result = H5Ldelete(file->getId(), dataset_name.c_str(), H5P_DEFAULT);
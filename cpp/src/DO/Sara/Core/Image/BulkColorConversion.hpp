@@ -0,0 +1,237 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <DO/Sara/Core/Pixel/PixelTraits.hpp>
+#include <DO/Sara/Core/Pixel/SmartColorConversion.hpp>
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+
+// Lookup tables for 8-bit channels.
+//
+// An 8-bit channel can only take 256 values, so every conversion that starts
+// by normalizing 8-bit channels can be tabulated once and for all. The tables
+// are filled with the very same channel and color conversion functions used
+// by 'smart_convert_color', which guarantees bit-exact results.
+namespace DO { namespace Sara { namespace detail {
+
+  //! @brief Normalized values of 8-bit channels.
+  template <typename Float>
+  inline auto normalized_uint8_lut() -> const std::array<Float, 256>&
+  {
+    static const auto lut = []() {
+      auto lut = std::array<Float, 256>{};
+      for (auto v = 0; v < 256; ++v)
+        lut[v] = to_normalized_float_channel<unsigned char, Float>(
+            static_cast<unsigned char>(v));
+      return lut;
+    }();
+    return lut;
+  }
+
+  //! @brief Converted values of 8-bit grayscale values.
+  template <typename DstPixel>
+  inline auto uint8_gray_lut() -> const std::array<DstPixel, 256>&
+  {
+    static const auto lut = []() {
+      auto lut = std::array<DstPixel, 256>{};
+      for (auto v = 0; v < 256; ++v)
+        smart_convert_color(static_cast<unsigned char>(v), lut[v]);
+      return lut;
+    }();
+    return lut;
+  }
+
+  //! @brief Weighted normalized values of the R, G, B channels.
+  //!
+  //! The weights are those of 'rgb_to_gray', which is always evaluated in
+  //! double precision when the source channels are 8-bit.
+  inline auto weighted_rgb_uint8_lut() -> const std::array<double, 3 * 256>&
+  {
+    static const auto lut = []() {
+      const auto& normalized = normalized_uint8_lut<double>();
+      auto lut = std::array<double, 3 * 256>{};
+      for (auto v = 0; v < 256; ++v)
+      {
+        lut[v] = double(0.2125) * normalized[v];
+        lut[256 + v] = double(0.7154) * normalized[v];
+        lut[512 + v] = double(0.0721) * normalized[v];
+      }
+      return lut;
+    }();
+    return lut;
+  }
+
+  //! @{
+  //! @brief Store the double grayscale value as 'smart_convert_color' does.
+  inline void store_gray(double src, double& dst)
+  {
+    dst = src;
+  }
+
+  template <typename T>
+  inline void store_gray(double src, T& dst)
+  {
+    convert_channel(src, dst);
+  }
+  //! @}
+
+  //! @{
+  //! @brief Convert floating-point pixels to the destination colorspace.
+  template <typename T, typename ColorSpace>
+  inline void convert_float_color(const Pixel<T, ColorSpace>& src,
+                                  Pixel<T, ColorSpace>& dst)
+  {
+    dst = src;
+  }
+
+  template <typename T, typename SrcColorSpace, typename DstColorSpace>
+  inline void convert_float_color(const Pixel<T, SrcColorSpace>& src,
+                                  Pixel<T, DstColorSpace>& dst)
+  {
+    convert_color(src, dst);
+  }
+  //! @}
+
+  template <typename Pixel>
+  using channel_type_t = typename PixelTraits<Pixel>::channel_type;
+
+  template <typename Pixel>
+  using is_uint8_pixel =
+      std::is_same<channel_type_t<Pixel>, unsigned char>;
+
+  template <typename Pixel>
+  using is_floating_point_pixel =
+      std::is_floating_point<channel_type_t<Pixel>>;
+
+}}}  // namespace DO::Sara::detail
+
+
+// Bulk color conversion of contiguous pixel arrays.
+namespace DO { namespace Sara {
+
+  //! @addtogroup Image
+  //! @{
+
+  /*!
+    @brief Dispatch table for bulk color conversion.
+
+    The primary template is the generic per-pixel path. Each specialization
+    below registers a faster kernel for a given pair of pixel types.
+    Specializations must produce bit-exact results with respect to
+    'smart_convert_color'.
+   */
+  template <typename SrcPixel, typename DstPixel, typename Enable = void>
+  struct BulkConvertColor
+  {
+    static inline void apply(const SrcPixel* src, DstPixel* dst, int size)
+    {
+      std::transform(src, src + size, dst, [](const auto& src_pixel) {
+        auto dst_pixel = DstPixel{};
+        smart_convert_color(src_pixel, dst_pixel);
+        return dst_pixel;
+      });
+    }
+  };
+
+  //! @brief 8-bit grayscale to any pixel type: lookup table.
+  template <typename DstPixel>
+  struct BulkConvertColor<
+      unsigned char, DstPixel,
+      std::enable_if_t<!std::is_same<DstPixel, unsigned char>::value>>
+  {
+    static inline void apply(const unsigned char* src, DstPixel* dst,
+                             int size)
+    {
+      const auto& lut = detail::uint8_gray_lut<DstPixel>();
+#pragma omp parallel for
+      for (int i = 0; i < size; ++i)
+        dst[i] = lut[src[i]];
+    }
+  };
+
+  //! @brief 8-bit RGB or RGBA to grayscale: weighted lookup tables.
+  template <typename ColorSpace, typename Gray>
+  struct BulkConvertColor<
+      Pixel<unsigned char, ColorSpace>, Gray,
+      std::enable_if_t<(std::is_same<ColorSpace, Rgb>::value ||
+                        std::is_same<ColorSpace, Rgba>::value) &&
+                       (std::is_floating_point<Gray>::value ||
+                        std::is_same<Gray, unsigned char>::value)>>
+  {
+    static inline void apply(const Pixel<unsigned char, ColorSpace>* src,
+                             Gray* dst, int size)
+    {
+      const auto lut = detail::weighted_rgb_uint8_lut().data();
+#pragma omp parallel for
+      for (int i = 0; i < size; ++i)
+      {
+        const auto gray = lut[src[i][0]] +          //
+                          lut[256 + src[i][1]] +    //
+                          lut[512 + src[i][2]];
+        detail::store_gray(gray, dst[i]);
+      }
+    }
+  };
+
+  //! @brief 8-bit pixels to floating-point pixels: channel lookup table.
+  template <typename SrcColorSpace, typename T, typename DstColorSpace>
+  struct BulkConvertColor<Pixel<unsigned char, SrcColorSpace>,
+                          Pixel<T, DstColorSpace>,
+                          std::enable_if_t<std::is_floating_point<T>::value>>
+  {
+    static inline void apply(const Pixel<unsigned char, SrcColorSpace>* src,
+                             Pixel<T, DstColorSpace>* dst, int size)
+    {
+      const auto& lut = detail::normalized_uint8_lut<T>();
+#pragma omp parallel for
+      for (int i = 0; i < size; ++i)
+      {
+        auto float_src = Pixel<T, SrcColorSpace>{};
+        for (auto c = 0; c < SrcColorSpace::size; ++c)
+          float_src[c] = lut[src[i][c]];
+        detail::convert_float_color(float_src, dst[i]);
+      }
+    }
+  };
+
+  /*!
+    @brief Floating-point sources: parallel per-pixel conversion.
+
+    Channel casts, colorspace changes and rescaling to 8-bit channels are
+    cheap arithmetic for floating-point pixels, so we simply distribute the
+    reference conversion across threads.
+   */
+  template <typename SrcPixel, typename DstPixel>
+  struct BulkConvertColor<
+      SrcPixel, DstPixel,
+      std::enable_if_t<detail::is_floating_point_pixel<SrcPixel>::value &&
+                       (detail::is_floating_point_pixel<DstPixel>::value ||
+                        detail::is_uint8_pixel<DstPixel>::value)>>
+  {
+    static inline void apply(const SrcPixel* src, DstPixel* dst, int size)
+    {
+#pragma omp parallel for
+      for (int i = 0; i < size; ++i)
+        smart_convert_color(src[i], dst[i]);
+    }
+  };
+
+  //! @}
+
+} /* namespace Sara */
+} /* namespace DO */
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <DO/Sara/Core/Image/BulkColorConversion.hpp>
 #include <DO/Sara/Core/Image/Image.hpp>
 #include <DO/Sara/Core/Pixel/PixelTraits.hpp>
 #include <DO/Sara/Core/Pixel/SmartColorConversion.hpp>
@@ -66,7 +67,13 @@ namespace DO { namespace Sara {
   //! @addtogroup Image
   //! @{
 
-  //! @brief Convert color of image.
+  /*!
+    @brief Convert color of image.
+
+    The conversion is dispatched to a bulk conversion kernel when one is
+    registered in 'BulkConvertColor' for the pair of pixel types, and falls
+    back to the generic per-pixel conversion otherwise.
+   */
   template <typename SrcImageBase, typename DstImageBase>
   void convert(const SrcImageBase& src, DstImageBase& dst)
   {
@@ -75,13 +82,10 @@ namespace DO { namespace Sara {
         "Color conversion error: image sizes are not equal!"
       };
 
+    using src_pixel_type = typename SrcImageBase::value_type;
     using dst_pixel_type = typename DstImageBase::value_type;
-    std::transform(src.begin(), src.end(), dst.begin(),
-                   [](const auto& src_pixel) {
-                     auto dst_pixel = dst_pixel_type{};
-                     smart_convert_color(src_pixel, dst_pixel);
-                     return dst_pixel;
-                   });
+    BulkConvertColor<src_pixel_type, dst_pixel_type>::apply(
+        src.begin(), dst.begin(), static_cast<int>(src.end() - src.begin()));
   }
 
   //! @}
@@ -0,0 +1,153 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#ifdef _WIN32
+# include <malloc.h>
+#else
+# include <stdlib.h>
+#endif
+
+#include <DO/Sara/Core/MemoryPool.hpp>
+
+#include <stdexcept>
+
+
+namespace DO { namespace Sara {
+
+  static auto aligned_malloc(std::size_t num_bytes, std::size_t alignment)
+      -> void*
+  {
+#ifdef _WIN32
+    auto ptr = _aligned_malloc(num_bytes, alignment);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, alignment, num_bytes) != 0)
+      ptr = nullptr;
+#endif
+    if (ptr == nullptr)
+      throw std::bad_alloc{};
+    return ptr;
+  }
+
+  static auto aligned_free(void* ptr) -> void
+  {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+  }
+
+
+  MemoryPool::~MemoryPool()
+  {
+    release();
+  }
+
+  auto MemoryPool::allocate(std::size_t num_bytes) -> void*
+  {
+    const auto c = size_class(num_bytes);
+
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      auto& free_blocks = _free_blocks[c];
+      if (!free_blocks.empty())
+      {
+        auto ptr = free_blocks.back();
+        free_blocks.pop_back();
+        _cached_bytes -= block_size(c);
+        ++_num_reused_blocks;
+        return ptr;
+      }
+      ++_num_system_allocations;
+    }
+
+    // Allocate outside the critical section.
+    return aligned_malloc(block_size(c), block_alignment(c));
+  }
+
+  auto MemoryPool::deallocate(void* ptr, std::size_t num_bytes) -> void
+  {
+    if (ptr == nullptr)
+      return;
+
+    const auto c = size_class(num_bytes);
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    _free_blocks[c].push_back(ptr);
+    _cached_bytes += block_size(c);
+  }
+
+  auto MemoryPool::release() -> void
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    for (auto& free_blocks : _free_blocks)
+    {
+      for (auto ptr : free_blocks)
+        aligned_free(ptr);
+      free_blocks.clear();
+      free_blocks.shrink_to_fit();
+    }
+    _cached_bytes = 0;
+  }
+
+  auto MemoryPool::cached_bytes() const -> std::size_t
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _cached_bytes;
+  }
+
+  auto MemoryPool::num_reused_blocks() const -> std::size_t
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _num_reused_blocks;
+  }
+
+  auto MemoryPool::num_system_allocations() const -> std::size_t
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    return _num_system_allocations;
+  }
+
+  auto MemoryPool::size_class(std::size_t num_bytes) -> int
+  {
+    auto c = 0;
+    while (block_size(c) < num_bytes)
+    {
+      ++c;
+      if (c == num_size_classes)
+        throw std::bad_alloc{};
+    }
+    return c;
+  }
+
+  auto MemoryPool::block_size(int size_class) -> std::size_t
+  {
+    return min_block_size << size_class;
+  }
+
+  auto MemoryPool::block_alignment(int size_class) -> std::size_t
+  {
+    return block_size(size_class) >= page_size ? page_size : cache_line_size;
+  }
+
+  auto MemoryPool::global() -> MemoryPool&
+  {
+    // The pool is intentionally never destroyed so that arrays with static
+    // storage duration can still return their blocks at exit.
+    static auto pool = new MemoryPool{};
+    return *pool;
+  }
+
+} /* namespace Sara */
+} /* namespace DO */
@@ -0,0 +1,154 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+
+namespace DO { namespace Sara {
+
+  //! @ingroup Core
+  //! @defgroup MemoryPool Memory Pool
+  //! @{
+
+  /*!
+    @brief Thread-safe memory pool with size-class buckets.
+
+    Requested sizes are rounded up to the next power of two, and freed blocks
+    are cached in the free list of their size class instead of being returned
+    to the system. This avoids the repeated calls to 'malloc' and the page
+    faults when the same image buffers are allocated and freed frame after
+    frame.
+
+    Blocks are aligned on cache lines, and on memory pages for blocks that
+    span at least one page.
+   */
+  class DO_SARA_EXPORT MemoryPool
+  {
+  public:
+    //! @brief Cache line size.
+    static constexpr std::size_t cache_line_size = 64;
+    //! @brief Memory page size.
+    static constexpr std::size_t page_size = 4096;
+    //! @brief Smallest size class.
+    static constexpr std::size_t min_block_size = cache_line_size;
+    //! @brief Number of size classes, i.e., from 64 bytes up to 2^47 bytes.
+    static constexpr int num_size_classes = 42;
+
+    //! @brief Default constructor.
+    MemoryPool() = default;
+
+    //! @brief The pool owns its blocks and cannot be copied.
+    MemoryPool(const MemoryPool&) = delete;
+
+    //! @brief Free all cached blocks.
+    ~MemoryPool();
+
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    //! @brief Return a block of at least the requested number of bytes.
+    auto allocate(std::size_t num_bytes) -> void*;
+
+    //! @brief Put the block back in the free list of its size class.
+    auto deallocate(void* ptr, std::size_t num_bytes) -> void;
+
+    //! @brief Return all cached blocks to the system.
+    auto release() -> void;
+
+    //! @brief Number of bytes held in the free lists.
+    auto cached_bytes() const -> std::size_t;
+
+    //! @brief Number of allocation requests served from the free lists.
+    auto num_reused_blocks() const -> std::size_t;
+
+    //! @brief Number of allocation requests forwarded to the system.
+    auto num_system_allocations() const -> std::size_t;
+
+    //! @brief Size class of a block.
+    static auto size_class(std::size_t num_bytes) -> int;
+
+    //! @brief Size in bytes of the blocks of a size class.
+    static auto block_size(int size_class) -> std::size_t;
+
+    //! @brief Alignment of the blocks of a size class.
+    static auto block_alignment(int size_class) -> std::size_t;
+
+    //! @brief Process-wide memory pool.
+    static auto global() -> MemoryPool&;
+
+  private:
+    mutable std::mutex _mutex;
+    std::array<std::vector<void*>, num_size_classes> _free_blocks;
+    std::size_t _cached_bytes = 0;
+    std::size_t _num_reused_blocks = 0;
+    std::size_t _num_system_allocations = 0;
+  };
+
+
+  /*!
+    @brief Allocator drawing its memory from the global memory pool.
+
+    It can be used as the allocator of any N-dimensional array, e.g.:
+    @code
+    auto image = Image<float, 2, PooledAllocator>{w, h};
+    @endcode
+   */
+  template <typename T>
+  class PooledAllocator
+  {
+  public:
+    using value_type = T;
+
+    PooledAllocator() = default;
+
+    template <typename U>
+    PooledAllocator(const PooledAllocator<U>&) noexcept
+    {
+    }
+
+    inline auto allocate(std::size_t count) -> T*
+    {
+      return static_cast<T*>(MemoryPool::global().allocate(count * sizeof(T)));
+    }
+
+    inline auto deallocate(T* ptr, std::size_t count) -> void
+    {
+      MemoryPool::global().deallocate(ptr, count * sizeof(T));
+    }
+  };
+
+  template <typename T, typename U>
+  inline auto operator==(const PooledAllocator<T>&, const PooledAllocator<U>&)
+      -> bool
+  {
+    return true;
+  }
+
+  template <typename T, typename U>
+  inline auto operator!=(const PooledAllocator<T>&, const PooledAllocator<U>&)
+      -> bool
+  {
+    return false;
+  }
+
+  //! @}
+
+} /* namespace Sara */
+} /* namespace DO */
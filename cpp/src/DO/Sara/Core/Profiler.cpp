@@ -0,0 +1,385 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#include <DO/Sara/Core/Profiler.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+
+namespace DO::Sara {
+
+  //! @brief Metrics recorded by one thread.
+  //!
+  //! The mutex is only contended when the registry is exported or reset.
+  struct Profiler::ThreadBuffer
+  {
+    int thread_index;
+    //! Whether a running thread owns the buffer, guarded by the registry
+    //! mutex.
+    bool in_use = true;
+    std::mutex mutex;
+    //! Zones kept for the trace.
+    std::vector<ProfileZone> zones;
+    std::int64_t num_dropped_zones = 0;
+    //! Statistics of all the zones, including the dropped ones.
+    std::unordered_map<std::string_view, ProfileZoneStats> zone_stats;
+    std::unordered_map<std::string_view, std::int64_t> counters;
+    std::unordered_map<std::string_view, ProfileHistogram> histograms;
+  };
+
+
+  namespace {
+
+    auto write_json_string(std::ostream& os, std::string_view s) -> void
+    {
+      os << '"';
+      for (const auto c : s)
+      {
+        if (c == '"' || c == '\\')
+          os << '\\' << c;
+        else if (static_cast<unsigned char>(c) < 0x20)
+          os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast<int>(c) << std::dec << std::setfill(' ');
+        else
+          os << c;
+      }
+      os << '"';
+    }
+
+    // JSON does not have infinite values.
+    auto finite_or_zero(double x) -> double
+    {
+      return std::isfinite(x) ? x : 0.;
+    }
+
+    auto open_file(const std::string& filepath) -> std::ofstream
+    {
+      auto file = std::ofstream{filepath};
+      if (!file)
+        throw std::runtime_error{"Cannot open file: " + filepath};
+      return file;
+    }
+
+  }  // namespace
+
+
+  auto ProfileZoneStats::add(double duration_ms) -> void
+  {
+    ++count;
+    total_ms += duration_ms;
+    min_ms = std::min(min_ms, duration_ms);
+    max_ms = std::max(max_ms, duration_ms);
+  }
+
+  auto ProfileZoneStats::merge(const ProfileZoneStats& other) -> void
+  {
+    count += other.count;
+    total_ms += other.total_ms;
+    min_ms = std::min(min_ms, other.min_ms);
+    max_ms = std::max(max_ms, other.max_ms);
+  }
+
+
+  auto ProfileHistogram::bin(double value) -> int
+  {
+    if (!(value > 0))
+      return 0;
+    const auto k = std::ilogb(value) + 32;
+    return std::clamp(k, 0, num_bins - 1);
+  }
+
+  auto ProfileHistogram::add(double value) -> void
+  {
+    ++count;
+    sum += value;
+    min = std::min(min, value);
+    max = std::max(max, value);
+    ++bins[bin(value)];
+  }
+
+  auto ProfileHistogram::merge(const ProfileHistogram& other) -> void
+  {
+    count += other.count;
+    sum += other.sum;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+    for (auto k = 0; k < num_bins; ++k)
+      bins[k] += other.bins[k];
+  }
+
+
+  auto Profiler::instance() -> Profiler&
+  {
+    static auto profiler = Profiler{};
+    return profiler;
+  }
+
+  Profiler::Profiler()
+    : _epoch{std::chrono::steady_clock::now()}
+  {
+  }
+
+  Profiler::~Profiler() = default;
+
+  //! @brief Give the buffer back to the registry when the thread exits.
+  struct Profiler::ThreadBufferLease
+  {
+    ThreadBuffer* buffer = nullptr;
+
+    ~ThreadBufferLease()
+    {
+      if (buffer != nullptr)
+        Profiler::instance().release(*buffer);
+    }
+  };
+
+  auto Profiler::thread_buffer() -> ThreadBuffer&
+  {
+    // The buffers are owned by the registry and outlive their threads, so
+    // that their metrics can still be exported. A new thread reuses the
+    // buffer of an exited thread: the metrics of short-lived threads, e.g.,
+    // the workers of a data loader, are then merged in the same trace row.
+    thread_local ThreadBufferLease lease;
+    if (lease.buffer == nullptr)
+    {
+      std::lock_guard<std::mutex> lock{_mutex};
+      const auto free_buffer =
+          std::find_if(_buffers.begin(), _buffers.end(),
+                       [](const auto& buffer) { return !buffer->in_use; });
+      if (free_buffer != _buffers.end())
+      {
+        lease.buffer = free_buffer->get();
+        lease.buffer->in_use = true;
+      }
+      else
+      {
+        _buffers.emplace_back(new ThreadBuffer{});
+        lease.buffer = _buffers.back().get();
+        lease.buffer->thread_index = static_cast<int>(_buffers.size()) - 1;
+      }
+    }
+    return *lease.buffer;
+  }
+
+  auto Profiler::release(ThreadBuffer& buffer) -> void
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    buffer.in_use = false;
+  }
+
+  auto Profiler::record_zone(const char* name, std::int64_t begin,
+                             std::int64_t end) -> void
+  {
+    auto& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock{buffer.mutex};
+    buffer.zone_stats[name].add((end - begin) * 1e-6);
+    if (buffer.zones.size() < _max_zones_per_thread)
+      buffer.zones.push_back({name, begin, end});
+    else
+      ++buffer.num_dropped_zones;
+  }
+
+  auto Profiler::add_counter(const char* name, std::int64_t value) -> void
+  {
+    auto& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock{buffer.mutex};
+    buffer.counters[name] += value;
+  }
+
+  auto Profiler::add_sample(const char* name, double value) -> void
+  {
+    auto& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock{buffer.mutex};
+    buffer.histograms[name].add(value);
+  }
+
+  auto Profiler::reset() -> void
+  {
+    std::lock_guard<std::mutex> lock{_mutex};
+    for (auto& buffer : _buffers)
+    {
+      std::lock_guard<std::mutex> buffer_lock{buffer->mutex};
+      buffer->zones.clear();
+      buffer->zones.shrink_to_fit();
+      buffer->num_dropped_zones = 0;
+      buffer->zone_stats.clear();
+      buffer->counters.clear();
+      buffer->histograms.clear();
+    }
+    _epoch = std::chrono::steady_clock::now();
+  }
+
+  auto Profiler::summary() const -> ProfileSummary
+  {
+    auto summary = ProfileSummary{};
+    summary.wall_time_ms = now() * 1e-6;
+
+    std::lock_guard<std::mutex> lock{_mutex};
+    for (const auto& buffer : _buffers)
+    {
+      std::lock_guard<std::mutex> buffer_lock{buffer->mutex};
+      if (buffer->zone_stats.empty() && buffer->counters.empty() &&
+          buffer->histograms.empty())
+        continue;
+      ++summary.num_threads;
+      summary.num_dropped_zones += buffer->num_dropped_zones;
+
+      for (const auto& [name, stats] : buffer->zone_stats)
+        summary.zones[std::string{name}].merge(stats);
+
+      for (const auto& [name, value] : buffer->counters)
+        summary.counters[std::string{name}] += value;
+
+      for (const auto& [name, histogram] : buffer->histograms)
+        summary.histograms[std::string{name}].merge(histogram);
+    }
+
+    return summary;
+  }
+
+  auto Profiler::write_chrome_trace(std::ostream& os) const -> void
+  {
+    const auto end = now();
+
+    os << std::setprecision(15);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    auto first = true;
+    auto separator = [&]() -> std::ostream& {
+      if (!first)
+        os << ",";
+      first = false;
+      return os << "\n";
+    };
+
+    std::lock_guard<std::mutex> lock{_mutex};
+
+    // The timestamps are in microseconds.
+    auto counters = std::map<std::string_view, std::int64_t>{};
+    for (const auto& buffer : _buffers)
+    {
+      std::lock_guard<std::mutex> buffer_lock{buffer->mutex};
+      const auto tid = buffer->thread_index;
+
+      separator() << R"({"name":"thread_name","ph":"M","pid":0,"tid":)" << tid
+                  << R"(,"args":{"name":"Thread )" << tid << "\"}}";
+
+      for (const auto& zone : buffer->zones)
+      {
+        separator() << R"({"name":)";
+        write_json_string(os, zone.name);
+        os << R"(,"cat":"sara","ph":"X","pid":0,"tid":)" << tid
+           << R"(,"ts":)" << zone.begin * 1e-3            //
+           << R"(,"dur":)" << (zone.end - zone.begin) * 1e-3 << "}";
+      }
+
+      for (const auto& [name, value] : buffer->counters)
+        counters[name] += value;
+    }
+
+    // The counters are only known in total.
+    for (const auto& [name, value] : counters)
+    {
+      separator() << R"({"name":)";
+      write_json_string(os, name);
+      os << R"(,"ph":"C","pid":0,"tid":0,"ts":)" << end * 1e-3
+         << R"(,"args":{"value":)" << value << "}}";
+    }
+
+    os << "\n]}\n";
+  }
+
+  auto Profiler::write_chrome_trace(const std::string& filepath) const -> void
+  {
+    auto file = open_file(filepath);
+    write_chrome_trace(file);
+  }
+
+  auto Profiler::write_summary(std::ostream& os) const -> void
+  {
+    const auto s = summary();
+
+    os << std::setprecision(15);
+    os << "{\n";
+    os << "  \"wall_time_ms\": " << s.wall_time_ms << ",\n";
+    os << "  \"num_threads\": " << s.num_threads << ",\n";
+    os << "  \"num_dropped_zones\": " << s.num_dropped_zones << ",\n";
+
+    os << "  \"zones\": {";
+    auto first = true;
+    for (const auto& [name, stats] : s.zones)
+    {
+      os << (first ? "\n    " : ",\n    ");
+      first = false;
+      write_json_string(os, name);
+      os << ": {\"count\": " << stats.count            //
+         << ", \"total_ms\": " << stats.total_ms       //
+         << ", \"mean_ms\": " << stats.total_ms / stats.count  //
+         << ", \"min_ms\": " << stats.min_ms           //
+         << ", \"max_ms\": " << stats.max_ms << "}";
+    }
+    os << (first ? "},\n" : "\n  },\n");
+
+    os << "  \"counters\": {";
+    first = true;
+    for (const auto& [name, value] : s.counters)
+    {
+      os << (first ? "\n    " : ",\n    ");
+      first = false;
+      write_json_string(os, name);
+      os << ": " << value;
+    }
+    os << (first ? "},\n" : "\n  },\n");
+
+    // Only the nonempty bins are written as [lower bound, count] pairs.
+    os << "  \"histograms\": {";
+    first = true;
+    for (const auto& [name, h] : s.histograms)
+    {
+      os << (first ? "\n    " : ",\n    ");
+      first = false;
+      write_json_string(os, name);
+      os << ": {\"count\": " << h.count                        //
+         << ", \"mean\": " << (h.count > 0 ? h.sum / h.count : 0.)  //
+         << ", \"min\": " << finite_or_zero(h.min)             //
+         << ", \"max\": " << finite_or_zero(h.max)             //
+         << ", \"bins\": [";
+      auto first_bin = true;
+      for (auto k = 0; k < ProfileHistogram::num_bins; ++k)
+      {
+        if (h.bins[k] == 0)
+          continue;
+        os << (first_bin ? "" : ", ") << "["
+           << (k == 0 ? 0. : ProfileHistogram::lower_bound(k)) << ", "
+           << h.bins[k] << "]";
+        first_bin = false;
+      }
+      os << "]}";
+    }
+    os << (first ? "}\n" : "\n  }\n");
+
+    os << "}\n";
+  }
+
+  auto Profiler::write_summary(const std::string& filepath) const -> void
+  {
+    auto file = open_file(filepath);
+    write_summary(file);
+  }
+
+} /* namespace DO::Sara */
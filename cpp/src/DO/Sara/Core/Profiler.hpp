@@ -0,0 +1,272 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+
+namespace DO::Sara {
+
+  //! @ingroup Utility
+  //! @{
+
+  //! @brief Time interval in nanoseconds recorded by a thread.
+  struct ProfileZone
+  {
+    const char* name;
+    std::int64_t begin;
+    std::int64_t end;
+  };
+
+  //! @brief Aggregated durations of the zones with the same name.
+  struct ProfileZoneStats
+  {
+    std::int64_t count = 0;
+    double total_ms = 0;
+    double min_ms = std::numeric_limits<double>::infinity();
+    double max_ms = 0;
+
+    DO_SARA_EXPORT
+    auto add(double duration_ms) -> void;
+
+    DO_SARA_EXPORT
+    auto merge(const ProfileZoneStats& other) -> void;
+  };
+
+  //! @brief Histogram with power-of-two bins.
+  //!
+  //! The bin k counts the values in [2^(k - 32), 2^(k - 31)). The first bin
+  //! also counts the smaller values, including the nonpositive ones, and the
+  //! last bin the larger values.
+  struct ProfileHistogram
+  {
+    static constexpr auto num_bins = 64;
+
+    std::int64_t count = 0;
+    double sum = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    std::array<std::int64_t, num_bins> bins{};
+
+    DO_SARA_EXPORT
+    static auto bin(double value) -> int;
+
+    //! @brief Lower bound of the bin k.
+    static auto lower_bound(int k) -> double
+    {
+      return std::ldexp(1., k - 32);
+    }
+
+    DO_SARA_EXPORT
+    auto add(double value) -> void;
+
+    DO_SARA_EXPORT
+    auto merge(const ProfileHistogram& other) -> void;
+  };
+
+  //! @brief Metrics merged over all the threads.
+  struct ProfileSummary
+  {
+    //! @brief Elapsed time since the last reset.
+    double wall_time_ms = 0;
+    //! @brief Number of thread buffers with metrics. The buffer of an exited
+    //! thread is reused by the next new thread.
+    int num_threads = 0;
+    //! @brief Number of zones missing from the trace because of the limit
+    //! per thread. They are still counted in the zone statistics.
+    std::int64_t num_dropped_zones = 0;
+    std::map<std::string, ProfileZoneStats> zones;
+    std::map<std::string, std::int64_t> counters;
+    std::map<std::string, ProfileHistogram> histograms;
+  };
+
+  /*!
+    @brief Registry of the zones, counters and histograms of the program.
+
+    Each thread records its metrics in its own buffer, so that threads only
+    contend when the registry is exported. The memory stays bounded in long
+    runs:
+    - a buffer keeps at most 'max_zones_per_thread()' zones for the trace,
+      while the zone statistics account for all of them,
+    - the buffer of an exited thread is reused by the next new thread.
+
+    The metric names are not copied and must be string literals.
+
+    The library code is instrumented with the macros SARA_PROFILE_SCOPE,
+    SARA_PROFILE_COUNTER and SARA_PROFILE_HISTOGRAM, which expand to nothing
+    unless Sara is configured with the CMake option SARA_USE_PROFILING.
+
+    Usage:
+    @code
+    Profiler::instance().reset();
+    run_pipeline();
+    Profiler::instance().write_chrome_trace("run.trace.json");
+    Profiler::instance().write_summary("run.summary.json");
+    @endcode
+
+    The trace is viewed in chrome://tracing or in https://ui.perfetto.dev.
+   */
+  class DO_SARA_EXPORT Profiler
+  {
+  public:
+    //! @brief Whether the library code is instrumented.
+#ifdef DO_SARA_USE_PROFILING
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    static auto instance() -> Profiler&;
+
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    auto operator=(const Profiler&) -> Profiler& = delete;
+
+    //! @brief Return the elapsed time in nanoseconds since the last reset.
+    auto now() const -> std::int64_t
+    {
+      return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                 std::chrono::steady_clock::now() - _epoch)
+          .count();
+    }
+
+    //! @{
+    //! @brief Record a metric in the buffer of the calling thread.
+    auto record_zone(const char* name, std::int64_t begin, std::int64_t end)
+        -> void;
+    auto add_counter(const char* name, std::int64_t value) -> void;
+    auto add_sample(const char* name, double value) -> void;
+    //! @}
+
+    //! @{
+    //! @brief Maximum number of zones kept per thread for the trace.
+    static constexpr std::size_t default_max_zones_per_thread = 1 << 16;
+
+    auto max_zones_per_thread() const -> std::size_t
+    {
+      return _max_zones_per_thread;
+    }
+
+    auto set_max_zones_per_thread(std::size_t n) -> void
+    {
+      _max_zones_per_thread = n;
+    }
+    //! @}
+
+    //! @brief Clear the metrics of all the threads and restart the clock.
+    //!
+    //! No thread must be recording metrics meanwhile.
+    auto reset() -> void;
+
+    //! @brief Merge the metrics of all the threads.
+    auto summary() const -> ProfileSummary;
+
+    //! @{
+    //! @brief Write the zones and the counters in the Chrome trace event
+    //! format.
+    auto write_chrome_trace(std::ostream& os) const -> void;
+    auto write_chrome_trace(const std::string& filepath) const -> void;
+    //! @}
+
+    //! @{
+    //! @brief Write the summary in JSON.
+    auto write_summary(std::ostream& os) const -> void;
+    auto write_summary(const std::string& filepath) const -> void;
+    //! @}
+
+  private:
+    struct ThreadBuffer;
+    struct ThreadBufferLease;
+
+    Profiler();
+
+    auto thread_buffer() -> ThreadBuffer&;
+    auto release(ThreadBuffer& buffer) -> void;
+
+  private:
+    std::chrono::steady_clock::time_point _epoch;
+    std::atomic<std::size_t> _max_zones_per_thread{
+        default_max_zones_per_thread};
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+  };
+
+  //! @brief Record the lifetime of the object as a zone.
+  class ProfileScope
+  {
+  public:
+    explicit ProfileScope(const char* name)
+      : _name{name}
+      , _begin{Profiler::instance().now()}
+    {
+    }
+
+    ~ProfileScope()
+    {
+      auto& profiler = Profiler::instance();
+      profiler.record_zone(_name, _begin, profiler.now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    auto operator=(const ProfileScope&) -> ProfileScope& = delete;
+
+  private:
+    const char* _name;
+    std::int64_t _begin;
+  };
+
+  //! @}
+
+} /* namespace DO::Sara */
+
+
+#define SARA_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SARA_PROFILE_CONCAT(a, b) SARA_PROFILE_CONCAT_IMPL(a, b)
+
+#ifdef DO_SARA_USE_PROFILING
+//! @brief Record the rest of the enclosing scope as a zone.
+# define SARA_PROFILE_SCOPE(name)                                              \
+  ::DO::Sara::ProfileScope SARA_PROFILE_CONCAT(_sara_profile_scope_,          \
+                                               __LINE__)                      \
+  {                                                                           \
+    name                                                                      \
+  }
+//! @brief Add a value to a counter.
+# define SARA_PROFILE_COUNTER(name, value)                                     \
+  ::DO::Sara::Profiler::instance().add_counter(                               \
+      name, static_cast<std::int64_t>(value))
+//! @brief Add a value to a histogram.
+# define SARA_PROFILE_HISTOGRAM(name, value)                                   \
+  ::DO::Sara::Profiler::instance().add_sample(name,                           \
+                                              static_cast<double>(value))
+#else
+// The arguments are not evaluated.
+# define SARA_PROFILE_SCOPE(name) static_cast<void>(0)
+# define SARA_PROFILE_COUNTER(name, value) static_cast<void>(0)
+# define SARA_PROFILE_HISTOGRAM(name, value) static_cast<void>(0)
+#endif
@@ -0,0 +1,322 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#include <DO/Sara/Core/SharedFrameRing.hpp>
+
+#include <atomic>
+#include <new>
+#include <thread>
+
+
+namespace bip = boost::interprocess;
+
+
+namespace DO { namespace Sara {
+
+  // The ring is shared between processes, so the sequence numbers must be
+  // genuinely lock-free and not emulated with a process-local mutex.
+  static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                "64-bit atomics must be lock-free!");
+
+  namespace {
+
+    constexpr std::uint64_t ring_magic = 0x314d524641524153;  // "SARAFRM1"
+    constexpr std::uint32_t ring_version = 1;
+
+    constexpr std::size_t cache_line_size = 64;
+    constexpr std::size_t page_size = 4096;
+
+    constexpr auto round_up(std::size_t n, std::size_t alignment)
+        -> std::size_t
+    {
+      return (n + alignment - 1) / alignment * alignment;
+    }
+
+    //! The memory layout of the segment is:
+    //! - the ring header, padded to a memory page,
+    //! - the slots, each of them made of a slot header padded to a cache line
+    //!   and followed by the frame data, padded to a memory page.
+    struct alignas(cache_line_size) RingHeader
+    {
+      //! Written last by the producer once the ring is initialized.
+      std::atomic<std::uint64_t> magic;
+      std::uint32_t version;
+      std::int32_t num_slots;
+      std::uint64_t slot_capacity;
+      std::uint64_t slot_stride;
+      //! Separate cache line since it is polled by every consumer.
+      alignas(cache_line_size) std::atomic<std::uint64_t> num_published;
+    };
+
+    //! Frame n is written in slot (n % num_slots). The sequence number of the
+    //! slot is 2n + 1 while the frame is being written and 2n + 2 once it is
+    //! published. 0 means that the slot has never been written.
+    struct alignas(cache_line_size) SlotHeader
+    {
+      std::atomic<std::uint64_t> sequence;
+      FrameLayout layout;
+    };
+
+    constexpr auto header_size = round_up(sizeof(RingHeader), page_size);
+    constexpr auto slot_data_offset =
+        round_up(sizeof(SlotHeader), cache_line_size);
+
+    inline auto writing(std::uint64_t n) -> std::uint64_t
+    {
+      return 2 * n + 1;
+    }
+
+    inline auto published(std::uint64_t n) -> std::uint64_t
+    {
+      return 2 * n + 2;
+    }
+
+    inline auto ring_header(const bip::mapped_region& region) -> RingHeader&
+    {
+      return *reinterpret_cast<RingHeader*>(region.get_address());
+    }
+
+    inline auto slot_header(const bip::mapped_region& region, std::uint64_t n)
+        -> SlotHeader&
+    {
+      const auto& header = ring_header(region);
+      auto address = reinterpret_cast<std::uint8_t*>(region.get_address()) +
+                     header_size + (n % header.num_slots) * header.slot_stride;
+      return *reinterpret_cast<SlotHeader*>(address);
+    }
+
+    inline auto slot_data(const bip::mapped_region& region, std::uint64_t n)
+        -> void*
+    {
+      return reinterpret_cast<std::uint8_t*>(&slot_header(region, n)) +
+             slot_data_offset;
+    }
+
+  }  // namespace
+
+
+  auto element_size(FrameElementType type) -> std::size_t
+  {
+    switch (type)
+    {
+    case FrameElementType::UInt8:
+      return 1;
+    case FrameElementType::UInt16:
+      return 2;
+    case FrameElementType::Int32:
+    case FrameElementType::Float32:
+      return 4;
+    case FrameElementType::Float64:
+      return 8;
+    default:
+      throw std::runtime_error{"Invalid frame element type!"};
+    }
+  }
+
+  auto FrameLayout::size() const -> std::int64_t
+  {
+    auto n = std::int64_t{1};
+    for (auto i = 0; i < num_dims; ++i)
+      n *= shape[i];
+    return n;
+  }
+
+  auto FrameLayout::num_bytes() const -> std::size_t
+  {
+    return static_cast<std::size_t>(size()) * element_size(element_type);
+  }
+
+
+  SharedFrameProducer::SharedFrameProducer(const std::string& name,
+                                           int num_slots,
+                                           std::size_t slot_capacity)
+    : _name{name}
+  {
+    if (num_slots < 2)
+      throw std::runtime_error{"The ring must have at least two slots!"};
+
+    const auto slot_stride =
+        round_up(slot_data_offset + slot_capacity, page_size);
+    const auto segment_size = header_size + num_slots * slot_stride;
+
+    bip::shared_memory_object::remove(name.c_str());
+    _shm = bip::shared_memory_object{bip::create_only, name.c_str(),
+                                     bip::read_write};
+    _shm.truncate(static_cast<bip::offset_t>(segment_size));
+    _region = bip::mapped_region{_shm, bip::read_write};
+
+    // The truncated segment is zero-filled, so all the slots start with a
+    // null sequence number.
+    auto& header = *new (_region.get_address()) RingHeader{};
+    header.version = ring_version;
+    header.num_slots = num_slots;
+    header.slot_capacity = slot_capacity;
+    header.slot_stride = slot_stride;
+    header.num_published.store(0, std::memory_order_relaxed);
+    for (auto n = 0; n < num_slots; ++n)
+      new (&slot_header(_region, n)) SlotHeader{};
+    header.magic.store(ring_magic, std::memory_order_release);
+  }
+
+  SharedFrameProducer::~SharedFrameProducer()
+  {
+    bip::shared_memory_object::remove(_name.c_str());
+  }
+
+  auto SharedFrameProducer::begin_frame(const FrameLayout& layout) -> void*
+  {
+    if (layout.num_dims < 0 || layout.num_dims > FrameLayout::max_dims)
+      throw std::runtime_error{"Invalid number of frame dimensions!"};
+    if (layout.num_bytes() > slot_capacity())
+      throw std::runtime_error{"The frame exceeds the slot capacity!"};
+
+    const auto n = num_published();
+    auto& slot = slot_header(_region, n);
+    slot.sequence.store(writing(n), std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.layout = layout;
+
+    _frame_reserved = true;
+    return slot_data(_region, n);
+  }
+
+  auto SharedFrameProducer::end_frame() -> std::uint64_t
+  {
+    if (!_frame_reserved)
+      throw std::runtime_error{"No frame was reserved with begin_frame!"};
+    _frame_reserved = false;
+
+    auto& header = ring_header(_region);
+    const auto n = num_published();
+    slot_header(_region, n).sequence.store(published(n),
+                                           std::memory_order_release);
+    header.num_published.store(n + 1, std::memory_order_release);
+    return n;
+  }
+
+  auto SharedFrameProducer::num_slots() const -> int
+  {
+    return ring_header(_region).num_slots;
+  }
+
+  auto SharedFrameProducer::slot_capacity() const -> std::size_t
+  {
+    return ring_header(_region).slot_capacity;
+  }
+
+  auto SharedFrameProducer::num_published() const -> std::uint64_t
+  {
+    return ring_header(_region).num_published.load(std::memory_order_relaxed);
+  }
+
+
+  SharedFrameConsumer::SharedFrameConsumer(const std::string& name)
+  {
+    try
+    {
+      _shm = bip::shared_memory_object{bip::open_only, name.c_str(),
+                                       bip::read_only};
+      _region = bip::mapped_region{_shm, bip::read_only};
+    }
+    catch (const bip::interprocess_exception& e)
+    {
+      throw std::runtime_error{"Could not open the shared frame ring '" +
+                               name + "': " + e.what()};
+    }
+
+    if (_region.get_size() < header_size)
+      throw std::runtime_error{"The shared frame ring is not initialized!"};
+
+    const auto& header = ring_header(_region);
+    if (header.magic.load(std::memory_order_acquire) != ring_magic)
+      throw std::runtime_error{"The shared frame ring is not initialized!"};
+    if (header.version != ring_version)
+      throw std::runtime_error{"Unsupported shared frame ring version!"};
+    if (_region.get_size() < header_size + header.num_slots * header.slot_stride)
+      throw std::runtime_error{"The shared frame ring is truncated!"};
+
+    _next_sequence = header.num_published.load(std::memory_order_acquire);
+  }
+
+  auto SharedFrameConsumer::next(std::chrono::microseconds timeout)
+      -> std::optional<SharedFrame>
+  {
+    const auto& header = ring_header(_region);
+    const auto N = static_cast<std::uint64_t>(header.num_slots);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    for (auto num_polls = 0;; ++num_polls)
+    {
+      const auto num_published =
+          header.num_published.load(std::memory_order_acquire);
+
+      if (_next_sequence < num_published)
+      {
+        // The producer may already be writing frame 'num_published' in the
+        // slot of frame 'num_published - N', so only the last N - 1 published
+        // frames are guaranteed to be readable.
+        const auto oldest = num_published + 1 > N ? num_published + 1 - N : 0;
+        if (_next_sequence < oldest)
+        {
+          _num_dropped += oldest - _next_sequence;
+          _next_sequence = oldest;
+        }
+
+        const auto n = _next_sequence;
+        const auto& slot = slot_header(_region, n);
+        const auto s1 = slot.sequence.load(std::memory_order_acquire);
+        auto frame = SharedFrame{n, slot.layout, slot_data(_region, n)};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto s2 = slot.sequence.load(std::memory_order_relaxed);
+
+        // Otherwise the producer lapped us in the meantime: try again with
+        // the updated number of published frames.
+        if (s1 == published(n) && s1 == s2)
+        {
+          ++_next_sequence;
+          return frame;
+        }
+        continue;
+      }
+
+      if (std::chrono::steady_clock::now() >= deadline)
+        return std::nullopt;
+
+      // Spin briefly for low latency, then back off to spare the CPU.
+      if (num_polls < 64)
+        std::this_thread::yield();
+      else
+        std::this_thread::sleep_for(std::chrono::microseconds{50});
+    }
+  }
+
+  auto SharedFrameConsumer::is_valid(std::uint64_t sequence) const -> bool
+  {
+    // Order the reads of the frame data before the check.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot_header(_region, sequence)
+               .sequence.load(std::memory_order_relaxed) == published(sequence);
+  }
+
+  auto SharedFrameConsumer::num_slots() const -> int
+  {
+    return ring_header(_region).num_slots;
+  }
+
+  auto SharedFrameConsumer::slot_capacity() const -> std::size_t
+  {
+    return ring_header(_region).slot_capacity;
+  }
+
+} /* namespace Sara */
+} /* namespace DO */
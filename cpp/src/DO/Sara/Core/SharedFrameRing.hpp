@@ -0,0 +1,339 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+
+namespace DO { namespace Sara {
+
+  //! @ingroup Core
+  //! @defgroup SharedFrameRing Shared-Memory Frame Transport
+  //! @{
+
+  //! @brief Element type of the frames, i.e., the NumPy dtype.
+  enum class FrameElementType : std::int32_t
+  {
+    UInt8 = 0,
+    UInt16 = 1,
+    Int32 = 2,
+    Float32 = 3,
+    Float64 = 4
+  };
+
+  template <typename T>
+  struct FrameElementTypeOf;
+
+  template <>
+  struct FrameElementTypeOf<std::uint8_t>
+  {
+    static constexpr auto value = FrameElementType::UInt8;
+  };
+
+  template <>
+  struct FrameElementTypeOf<std::uint16_t>
+  {
+    static constexpr auto value = FrameElementType::UInt16;
+  };
+
+  template <>
+  struct FrameElementTypeOf<std::int32_t>
+  {
+    static constexpr auto value = FrameElementType::Int32;
+  };
+
+  template <>
+  struct FrameElementTypeOf<float>
+  {
+    static constexpr auto value = FrameElementType::Float32;
+  };
+
+  template <>
+  struct FrameElementTypeOf<double>
+  {
+    static constexpr auto value = FrameElementType::Float64;
+  };
+
+  //! @brief Size in bytes of a frame element.
+  DO_SARA_EXPORT
+  auto element_size(FrameElementType type) -> std::size_t;
+
+
+  //! @brief Metadata of a frame, stored in the header of its slot.
+  struct FrameLayout
+  {
+    //! @brief Maximum number of dimensions of a frame.
+    static constexpr int max_dims = 6;
+
+    FrameElementType element_type = FrameElementType::UInt8;
+    int num_dims = 0;
+    //! @brief Shape in row-major order, e.g., (h, w, 3) for an RGB image.
+    std::array<std::int64_t, max_dims> shape = {};
+
+    //! @brief Number of elements of the frame.
+    auto size() const -> std::int64_t;
+
+    //! @brief Number of bytes of the frame.
+    auto num_bytes() const -> std::size_t;
+
+    //! @brief Layout of an image: (h, w) or (h, w, c) for multichannel
+    //! pixels.
+    template <typename PixelType>
+    static auto of_image(const Vector2i& sizes) -> FrameLayout
+    {
+      using channel_type = typename PixelTraits<PixelType>::channel_type;
+      constexpr auto num_channels = PixelTraits<PixelType>::num_channels;
+      static_assert(sizeof(PixelType) == num_channels * sizeof(channel_type),
+                    "The pixel type must be packed!");
+
+      auto layout = FrameLayout{};
+      layout.element_type = FrameElementTypeOf<channel_type>::value;
+      layout.num_dims = num_channels == 1 ? 2 : 3;
+      layout.shape[0] = sizes.y();
+      layout.shape[1] = sizes.x();
+      layout.shape[2] = num_channels;
+      return layout;
+    }
+
+    //! @brief Layout of a row-major tensor.
+    template <typename T, int N>
+    static auto of_tensor(const Matrix<int, N, 1>& sizes) -> FrameLayout
+    {
+      static_assert(N <= max_dims, "Too many dimensions!");
+      auto layout = FrameLayout{};
+      layout.element_type = FrameElementTypeOf<T>::value;
+      layout.num_dims = N;
+      for (auto i = 0; i < N; ++i)
+        layout.shape[i] = sizes[i];
+      return layout;
+    }
+  };
+
+
+  /*!
+    @brief Frame read from the ring.
+
+    The frame data is not copied: it points directly to the slot in the
+    shared memory. The producer overwrites the slot once it has wrapped around
+    the ring, so a consumer should check with 'SharedFrameConsumer::is_valid'
+    that the frame is still intact after processing it.
+   */
+  struct SharedFrame
+  {
+    //! @brief Index of the frame in the stream.
+    std::uint64_t sequence = 0;
+    FrameLayout layout;
+    //! @brief Read-only data in the shared memory.
+    const void* data = nullptr;
+
+    //! @brief Zero-copy image view.
+    //!
+    //! The view must not be modified since the shared memory is mapped as
+    //! read-only in the consumer processes.
+    template <typename PixelType>
+    auto image_view() const -> ImageView<PixelType>
+    {
+      const auto expected = FrameLayout::of_image<PixelType>(Vector2i::Zero());
+      if (layout.element_type != expected.element_type ||
+          layout.num_dims != expected.num_dims ||
+          (expected.num_dims == 3 && layout.shape[2] != expected.shape[2]))
+        throw std::runtime_error{
+            "The frame layout does not match the pixel type!"};
+
+      const auto sizes = Vector2i(static_cast<int>(layout.shape[1]),
+                                  static_cast<int>(layout.shape[0]));
+      return ImageView<PixelType>{
+          reinterpret_cast<PixelType*>(const_cast<void*>(data)), sizes};
+    }
+
+    //! @brief Zero-copy row-major tensor view.
+    //!
+    //! The same restriction as 'image_view' applies.
+    template <typename T, int N>
+    auto tensor_view() const -> TensorView_<T, N>
+    {
+      if (layout.element_type != FrameElementTypeOf<T>::value ||
+          layout.num_dims != N)
+        throw std::runtime_error{
+            "The frame layout does not match the tensor type!"};
+
+      auto sizes = Matrix<int, N, 1>{};
+      for (auto i = 0; i < N; ++i)
+        sizes[i] = static_cast<int>(layout.shape[i]);
+      return TensorView_<T, N>{
+          reinterpret_cast<T*>(const_cast<void*>(data)), sizes};
+    }
+  };
+
+
+  /*!
+    @brief Producer end of a single-producer/multiple-consumer ring of frames
+    in shared memory.
+
+    The ring is a fixed number of fixed-capacity slots. Each slot is guarded by
+    a sequence lock: the producer never waits for the consumers, and a
+    consumer detects that it was lapped by the producer by reading the
+    sequence number of the slot again.
+
+    Frames are either copied into the ring with 'publish', or written in place
+    without any copy:
+    @code
+    auto frame = producer.begin_frame<Rgb8>(sizes);
+    decode_into(frame);
+    producer.end_frame();
+    @endcode
+   */
+  class DO_SARA_EXPORT SharedFrameProducer
+  {
+  public:
+    //! @brief Create the shared memory segment.
+    //!
+    //! A stale segment with the same name, e.g., left over by a crashed
+    //! producer, is replaced.
+    SharedFrameProducer(const std::string& name, int num_slots,
+                        std::size_t slot_capacity);
+
+    SharedFrameProducer(const SharedFrameProducer&) = delete;
+
+    //! @brief Remove the shared memory segment.
+    //!
+    //! The consumers which are already attached keep their mapping.
+    ~SharedFrameProducer();
+
+    SharedFrameProducer& operator=(const SharedFrameProducer&) = delete;
+
+    //! @brief Reserve the next slot and return a pointer to its data.
+    auto begin_frame(const FrameLayout& layout) -> void*;
+
+    //! @brief Reserve the next slot and return an image view on its data.
+    template <typename PixelType>
+    auto begin_frame(const Vector2i& sizes) -> ImageView<PixelType>
+    {
+      const auto layout = FrameLayout::of_image<PixelType>(sizes);
+      return ImageView<PixelType>{
+          reinterpret_cast<PixelType*>(begin_frame(layout)), sizes};
+    }
+
+    //! @brief Publish the frame written in the reserved slot and return its
+    //! sequence number.
+    auto end_frame() -> std::uint64_t;
+
+    //! @brief Copy the image into the next slot and publish it.
+    template <typename PixelType>
+    auto publish(const ImageView<PixelType>& image) -> std::uint64_t
+    {
+      auto frame = begin_frame<PixelType>(image.sizes());
+      std::copy(image.begin(), image.end(), frame.begin());
+      return end_frame();
+    }
+
+    //! @brief Copy the row-major tensor into the next slot and publish it.
+    template <typename T, int N>
+    auto publish(const TensorView_<T, N>& tensor) -> std::uint64_t
+    {
+      const auto layout = FrameLayout::of_tensor<T, N>(tensor.sizes());
+      auto data = reinterpret_cast<T*>(begin_frame(layout));
+      std::copy(tensor.begin(), tensor.end(), data);
+      return end_frame();
+    }
+
+    //! @brief Name of the shared memory segment.
+    auto name() const -> const std::string&
+    {
+      return _name;
+    }
+
+    auto num_slots() const -> int;
+
+    //! @brief Maximum number of bytes of a frame.
+    auto slot_capacity() const -> std::size_t;
+
+    //! @brief Number of frames published so far.
+    auto num_published() const -> std::uint64_t;
+
+  private:
+    std::string _name;
+    boost::interprocess::shared_memory_object _shm;
+    boost::interprocess::mapped_region _region;
+    bool _frame_reserved = false;
+  };
+
+
+  /*!
+    @brief Consumer end of the shared-memory frame ring.
+
+    Any number of consumers, in any number of processes, can attach to the
+    same producer. Each consumer reads the frames in order; a consumer which
+    falls behind by more than the ring size skips the overwritten frames and
+    counts them as dropped.
+   */
+  class DO_SARA_EXPORT SharedFrameConsumer
+  {
+  public:
+    //! @brief Attach to the shared memory segment created by the producer.
+    //!
+    //! Only the frames published after the consumer is attached are read.
+    explicit SharedFrameConsumer(const std::string& name);
+
+    //! @brief Wait for the next frame.
+    //!
+    //! Return std::nullopt if no frame was published before the timeout.
+    auto next(std::chrono::microseconds timeout = std::chrono::seconds{1})
+        -> std::optional<SharedFrame>;
+
+    //! @brief Check that the slot of the frame has not been overwritten by
+    //! the producer yet.
+    auto is_valid(std::uint64_t sequence) const -> bool;
+
+    auto is_valid(const SharedFrame& frame) const -> bool
+    {
+      return is_valid(frame.sequence);
+    }
+
+    auto num_slots() const -> int;
+
+    //! @brief Maximum number of bytes of a frame.
+    auto slot_capacity() const -> std::size_t;
+
+    //! @brief Number of frames that the consumer skipped because they were
+    //! overwritten before it could read them.
+    auto num_dropped() const -> std::uint64_t
+    {
+      return _num_dropped;
+    }
+
+  private:
+    boost::interprocess::shared_memory_object _shm;
+    boost::interprocess::mapped_region _region;
+    std::uint64_t _next_sequence = 0;
+    std::uint64_t _num_dropped = 0;
+  };
+
+  //! @}
+
+} /* namespace Sara */
+} /* namespace DO */
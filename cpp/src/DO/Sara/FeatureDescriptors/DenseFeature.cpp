@@ -10,5 +10,13 @@ namespace DO { namespace Sara {
     return compute_dense_feature(image, local_patch_size);
   }
 
+  Image<DenseSIFTComputer<>::descriptor_type>
+  compute_fast_dense_sift(const ImageView<float>& image, int local_patch_size,
+                          int stride)
+  {
+    const auto compute_dense_sift = DenseSIFTComputer<>{};
+    return compute_dense_sift(image, local_patch_size, stride);
+  }
+
 } /* namespace Sara */
 } /* namespace DO */
@@ -15,11 +15,16 @@
 
 #include <DO/Sara/Core/EigenExtension.hpp>
 #include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
 
 #include <DO/Sara/FeatureDescriptors/Orientation.hpp>
 #include <DO/Sara/FeatureDescriptors/SIFT.hpp>
 
 #include <DO/Sara/ImageProcessing/Deriche.hpp>
+#include <DO/Sara/ImageProcessing/LinearFiltering.hpp>
+
+#include <cmath>
+#include <vector>
 
 
 namespace DO { namespace Sara {
@@ -57,6 +62,7 @@ namespace DO { namespace Sara {
 
       auto features = Image<descriptor_type>{image.sizes()};
       features.flat_array().fill(descriptor_type::Zero());
+#pragma omp parallel for
       for (auto y = patch_radius; y < image.height() - patch_radius; ++y)
         for (auto x = patch_radius; x < image.width() - patch_radius; ++x)
           features(x, y) =
@@ -71,6 +77,226 @@ namespace DO { namespace Sara {
   };
 
 
+  /*!
+    @brief Dense upright SIFT computed from shared histogram cells.
+
+    Neighbouring dense descriptors overlap and computing them independently
+    accumulates the same gradients over and over. Instead, as in DAISY and in
+    VLFeat's dense SIFT:
+    1. the gradient magnitudes are distributed in one map per orientation bin
+       with the linear interpolation weights of SIFT,
+    2. each map is convolved with the triangular kernel, which is exactly the
+       bilinear spatial interpolation weight of SIFT,
+    3. each descriptor bin is then read from the smoothed maps at the center
+       of its histogram cell.
+
+    The only departure from 'ComputeSIFTDescriptor' is that the Gaussian
+    window weight is evaluated at the cell centers instead of each pixel.
+   */
+  template <int N = 4, int O = 8>
+  class DenseSIFTComputer
+  {
+  public:
+    static constexpr auto Dim = N * N * O;
+
+    using descriptor_type = Matrix<float, Dim, 1>;
+
+    //! @brief Constructor.
+    inline DenseSIFTComputer(float bin_scale_unit_length = 3.f,
+                             float max_bin_value = 0.2f)
+      : _bin_scale_unit_length{bin_scale_unit_length}
+      , _max_bin_value{max_bin_value}
+    {
+    }
+
+    //! @brief Compute the descriptors on the image grid sampled every
+    //! 'stride' pixels with the same scale and blur as
+    //! 'DenseFeatureComputer'.
+    auto operator()(const ImageView<float>& image, int patch_size = 8,
+                    int stride = 1) const -> Image<descriptor_type>
+    {
+      const auto blurred_image = image.compute<DericheBlur>(1.6f);
+      const auto gradients = gradient_polar_coordinates(blurred_image);
+      return this->operator()(gradients, static_cast<float>(patch_size / 2),
+                              stride);
+    }
+
+    //! @brief Compute the descriptors with scale 'sigma' on the image grid
+    //! sampled every 'stride' pixels.
+    auto operator()(const ImageView<Vector2f>& grad_polar_coords, float sigma,
+                    int stride = 1) const -> Image<descriptor_type>
+    {
+      if (stride < 1)
+        throw std::domain_error{"The stride must be positive!"};
+
+      const auto l = _bin_scale_unit_length * sigma;
+      const auto margin = padding_margin(l);
+      const auto maps = orientation_maps(grad_polar_coords, l);
+      const auto map_width = maps.size(1);
+
+      // Geometry of the histogram cells, which is the same for every
+      // descriptor.
+      struct Cell
+      {
+        int dx, dy;
+        float fx, fy;
+        float weight;
+      };
+      auto cells = std::vector<Cell>(N * N);
+      for (auto i = 0; i < N; ++i)
+      {
+        for (auto j = 0; j < N; ++j)
+        {
+          const auto u = j - N / 2.f + 0.5f;
+          const auto v = i - N / 2.f + 0.5f;
+          const auto cx = u * l + margin;
+          const auto cy = v * l + margin;
+
+          auto& cell = cells[N * i + j];
+          cell.dx = static_cast<int>(std::floor(cx));
+          cell.dy = static_cast<int>(std::floor(cy));
+          cell.fx = cx - cell.dx;
+          cell.fy = cy - cell.dy;
+          cell.weight = std::exp(-(u * u + v * v) /
+                                 (2.f * (N / 2.f) * (N / 2.f)));
+        }
+      }
+
+      const auto w = grad_polar_coords.width();
+      const auto h = grad_polar_coords.height();
+      auto descriptors = Image<descriptor_type>{(w + stride - 1) / stride,
+                                                (h + stride - 1) / stride};
+
+#pragma omp parallel for
+      for (auto gy = 0; gy < descriptors.height(); ++gy)
+      {
+        for (auto gx = 0; gx < descriptors.width(); ++gx)
+        {
+          const auto x = gx * stride;
+          const auto y = gy * stride;
+
+          auto& d = descriptors(gx, gy);
+          for (auto c = 0; c < N * N; ++c)
+          {
+            const auto& cell = cells[c];
+            const auto p00 = &maps(y + cell.dy, x + cell.dx, 0);
+            const auto p01 = p00 + O;
+            const auto p10 = p00 + map_width * O;
+            const auto p11 = p10 + O;
+
+            const auto w00 = (1 - cell.fx) * (1 - cell.fy) * cell.weight;
+            const auto w01 = cell.fx * (1 - cell.fy) * cell.weight;
+            const auto w10 = (1 - cell.fx) * cell.fy * cell.weight;
+            const auto w11 = cell.fx * cell.fy * cell.weight;
+            for (auto o = 0; o < O; ++o)
+              d[c * O + o] =
+                  w00 * p00[o] + w01 * p01[o] + w10 * p10[o] + w11 * p11[o];
+          }
+
+          normalize(d);
+        }
+      }
+
+      return descriptors;
+    }
+
+    /*!
+      @brief Orientation maps smoothed with the bilinear weights of the
+      histogram cells of width 'l'.
+
+      The maps are interleaved and padded with zeros: the values for pixel
+      (x, y) are at (y + margin, x + margin, 0..O-1) where 'margin' is
+      'padding_margin(l)'.
+     */
+    auto orientation_maps(const ImageView<Vector2f>& grad_polar_coords,
+                          float l) const -> Tensor_<float, 3>
+    {
+      constexpr auto pi = static_cast<float>(M_PI);
+
+      const auto w = grad_polar_coords.width();
+      const auto h = grad_polar_coords.height();
+      const auto margin = padding_margin(l);
+      const auto padded_sizes = Vector2i{w + 2 * margin, h + 2 * margin};
+
+      // Distribute the gradient magnitudes in the orientation bins.
+      auto maps = std::vector<Image<float>>(O);
+      for (auto& map : maps)
+      {
+        map.resize(padded_sizes);
+        map.flat_array().fill(0.f);
+      }
+
+#pragma omp parallel for
+      for (auto y = 0; y < h; ++y)
+      {
+        for (auto x = 0; x < w; ++x)
+        {
+          const auto& mag = grad_polar_coords(x, y)(0);
+          auto ori = grad_polar_coords(x, y)(1);
+
+          // Rescale the orientation to the interval [0, O[.
+          ori = ori < 0.f ? ori + 2.f * pi : ori;
+          ori *= static_cast<float>(O) / (2.f * pi);
+
+          float oriif;
+          const auto orifrac = std::modf(ori, &oriif);
+          const auto orii = int(oriif);
+
+          maps[orii % O](x + margin, y + margin) += (1 - orifrac) * mag;
+          maps[(orii + 1) % O](x + margin, y + margin) += orifrac * mag;
+        }
+      }
+
+      // Triangular kernel of half-width l.
+      const auto kernel_radius = static_cast<int>(std::ceil(l)) - 1;
+      auto kernel = std::vector<float>(2 * kernel_radius + 1);
+      for (auto k = -kernel_radius; k <= kernel_radius; ++k)
+        kernel[k + kernel_radius] = 1.f - std::abs(k) / l;
+
+      // The zero padding is wide enough so that replicating the borders is
+      // the same as zero padding.
+      const auto kernel_size = static_cast<int>(kernel.size());
+      for (auto& map : maps)
+      {
+        apply_row_based_filter(map, map, kernel.data(), kernel_size);
+        apply_column_based_filter(map, map, kernel.data(), kernel_size);
+      }
+
+      // Interleave the orientation maps.
+      auto interleaved_maps = Tensor_<float, 3>{padded_sizes.y(),
+                                                padded_sizes.x(), O};
+#pragma omp parallel for
+      for (auto y = 0; y < padded_sizes.y(); ++y)
+        for (auto x = 0; x < padded_sizes.x(); ++x)
+          for (auto o = 0; o < O; ++o)
+            interleaved_maps(y, x, o) = maps[o](x, y);
+
+      return interleaved_maps;
+    }
+
+    //! @brief Zero padding of the orientation maps.
+    static auto padding_margin(float l) -> int
+    {
+      // The farthest cell center plus one pixel for the bilinear sampling.
+      return static_cast<int>(std::ceil((N / 2.f - 0.5f) * l)) + 2;
+    }
+
+  private:
+    //! @brief Same normalization as 'ComputeSIFTDescriptor'.
+    void normalize(descriptor_type& h) const
+    {
+      h.normalize();
+      h = h.cwiseMin(descriptor_type::Ones() * _max_bin_value);
+      h.normalize();
+      h = (h * 512.f).cwiseMin(descriptor_type::Ones() * 255.f);
+    }
+
+  private:
+    float _bin_scale_unit_length;
+    float _max_bin_value;
+  };
+
+
   /*!
     Helper function that computes the SIFT descriptor at each image pixel
     with scale equal to 'local_patch_size / 2'.
@@ -79,6 +305,16 @@ namespace DO { namespace Sara {
   Image<ComputeSIFTDescriptor<>::descriptor_type>
   compute_dense_sift(const ImageView<float>& image, int local_patch_size = 8);
 
+  /*!
+    Helper function that computes the dense SIFT descriptors from shared
+    histogram cells every 'stride' pixels with scale equal to
+    'local_patch_size / 2'.
+   */
+  DO_SARA_EXPORT
+  Image<DenseSIFTComputer<>::descriptor_type>
+  compute_fast_dense_sift(const ImageView<float>& image,
+                          int local_patch_size = 8, int stride = 1);
+
   //! @}
 
 } /* namespace Sara */
@@ -22,6 +22,7 @@
 
 #include <DO/Sara/Geometry/Tools/Utilities.hpp>
 
+#include <DO/Sara/ImageProcessing/Differential.hpp>
 #include <DO/Sara/ImageProcessing/ImagePyramid.hpp>
 
 
@@ -222,9 +222,13 @@ namespace DO { namespace Sara {
     void accumulate(descriptor_type& h, const Vector2f& pos, float ori,
                     float weight, float mag) const
     {
-      float xif, yif, oriif;
-      const auto xfrac = std::modf(pos.x(), &xif);
-      const auto yfrac = std::modf(pos.y(), &yif);
+      // The spatial coordinates can be in ]-1, 0[ so round them down instead
+      // of truncating them, otherwise the interpolation weights are wrong.
+      const auto xif = std::floor(pos.x());
+      const auto yif = std::floor(pos.y());
+      float oriif;
+      const auto xfrac = pos.x() - xif;
+      const auto yfrac = pos.y() - yif;
       const auto orifrac = std::modf(ori, &oriif);
       const auto xi = int(xif);
       const auto yi = int(yif);
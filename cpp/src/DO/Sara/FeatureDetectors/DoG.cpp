@@ -21,10 +21,12 @@ namespace DO { namespace Sara {
   ComputeDoGExtrema::operator()(const ImageView<float>& image,
                                 vector<Point2i> *scale_octave_pairs)
   {
+    // Rebuild the pyramids in place to reuse their image buffers when the
+    // detector is called on successive frames.
     auto& G = _gaussians;
     auto& D = _diff_of_gaussians;
-    G = gaussian_pyramid(image, _pyramid_params);
-    D = difference_of_gaussians_pyramid(G);
+    gaussian_pyramid(image, G, _pyramid_params);
+    difference_of_gaussians_pyramid(G, D);
 
     auto extrema = vector<OERegion>{};
     extrema.reserve(int(1e4));
@@ -48,17 +48,22 @@ namespace DO::Sara {
                      const Rgb8& color, const Point& offset = Point::Zero(),
                      float scale = 1)
   {
-    auto remap = [&](const auto& p) { return offset + scale * p; };
+    auto remap = [&](const auto& p) {
+      return (offset + scale * p).template cast<int>().template cast<float>();
+    };
 
-    for (auto i = 0u; i < edge.size() - 1; ++i)
+    auto draw_list = ImageDrawList{};
+    draw_list.reserve(2 * edge.size());
+    for (auto i = 0u; i + 1 < edge.size(); ++i)
     {
-      const auto& a = remap(edge[i]).template cast<int>();
-      const auto& b = remap(edge[i + 1]).template cast<int>();
-      draw_line(image, a.x(), a.y(), b.x(), b.y(), color, 1, true);
-      draw_circle(image, a.x(), a.y(), 2, color);
+      const Point2f a = remap(edge[i]);
+      const Point2f b = remap(edge[i + 1]);
+      draw_list.draw_line(a, b, color, 1, true);
+      draw_list.draw_circle(a, 2, color);
       if (i == edge.size() - 2)
-        draw_circle(image, b.x(), b.y(), 2, color);
+        draw_list.draw_circle(b, 2, color);
     }
+    draw_list.render(image);
   }
 
 }  // namespace DO::Sara
@@ -20,6 +20,10 @@
 
 // Basic feature matching
 #include "FeatureMatching/AnnMatcher.hpp"
+#include "FeatureMatching/BruteForceMatcher.hpp"
+
+// Descriptor compression and large-scale search
+#include "FeatureMatching/ProductQuantization.hpp"
 
 
 //! @defgroup FeatureMatching Feature Matching
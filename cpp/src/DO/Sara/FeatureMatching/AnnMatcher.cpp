@@ -15,7 +15,7 @@
 #endif
 
 #include <DO/Sara/Core/DebugUtilities.hpp>
-#include <DO/Sara/Core/Timer.hpp>
+#include <DO/Sara/Core/Profiler.hpp>
 
 #include <DO/Sara/FeatureMatching.hpp>
 
@@ -208,7 +208,7 @@ namespace DO { namespace Sara {
   //! Compute candidate matches using the Euclidean distance.
   auto AnnMatcher::compute_matches() -> vector<Match>
   {
-    auto t = Timer{};
+    SARA_PROFILE_SCOPE("AnnMatcher");
 
     const auto& dmat1 = descriptors(_keys1);
     const auto& dmat2 = descriptors(_keys2);
@@ -219,14 +219,17 @@ namespace DO { namespace Sara {
 
     flann::Index<flann::L2<float>> tree1(data1, params);
     flann::Index<flann::L2<float>> tree2(data2, params);
-    tree1.buildIndex();
-    tree2.buildIndex();
-    SARA_DEBUG << "Built trees in " << t.elapsed() << " seconds." << endl;
+    {
+      SARA_PROFILE_SCOPE("AnnMatcher/Build index");
+      tree1.buildIndex();
+      tree2.buildIndex();
+    }
+
+    SARA_PROFILE_SCOPE("AnnMatcher/Match");
 
     auto matches = vector<Match>{};
     matches.reserve(1e5);
 
-    t.restart();
     for (auto i1 = 0; i1 < dmat1.rows(); ++i1)
       append_nearest_neighbors(
           i1, _keys1, _keys2, matches, data2, tree2, _squared_ratio_thres,
@@ -262,8 +265,8 @@ namespace DO { namespace Sara {
       return m1.score() < m2.score();
     });
 
-    SARA_DEBUG << "Computed " << matches.size() << " matches in " << t.elapsed()
-               << " seconds." << endl;
+    SARA_PROFILE_COUNTER("matches", matches.size());
+    SARA_PROFILE_HISTOGRAM("matches_per_pair", matches.size());
 
     return matches;
   }
@@ -0,0 +1,509 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/Core/DebugUtilities.hpp>
+#include <DO/Sara/Core/Profiler.hpp>
+
+#include <DO/Sara/FeatureMatching/BruteForceMatcher.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+
+using namespace std;
+
+
+namespace DO { namespace Sara {
+
+  namespace {
+
+    //! Row-major descriptor matrix with the squared norms of its rows.
+    //!
+    //! 8-bit descriptors are multiplied with exact arithmetic on 32-bit
+    //! integers.
+    template <typename T>
+    struct DescriptorMatrix
+    {
+      using accumulator_type =
+          std::conditional_t<std::is_integral_v<T>, std::int32_t, T>;
+      using matrix_type = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic,
+                                        Eigen::RowMajor>;
+      using norm_vector_type =
+          Eigen::Matrix<accumulator_type, Eigen::Dynamic, 1>;
+
+      DescriptorMatrix(const TensorView_<T, 2>& descriptors)
+        : data{descriptors.data(), descriptors.rows(), descriptors.cols()}
+        , squared_norms{
+              data.template cast<accumulator_type>().rowwise().squaredNorm()}
+      {
+      }
+
+      auto rows() const -> int
+      {
+        return static_cast<int>(data.rows());
+      }
+
+      Eigen::Map<const matrix_type> data;
+      norm_vector_type squared_norms;
+    };
+
+    //! Quantize the descriptors on 8 bits with a given scale.
+    auto quantize(const TensorView_<float, 2>& descriptors, float scale)
+        -> Tensor_<std::int8_t, 2>
+    {
+      auto quantized = Tensor_<std::int8_t, 2>{descriptors.sizes()};
+      std::transform(descriptors.begin(), descriptors.end(), quantized.begin(),
+                     [scale](float x) {
+                       const auto q = std::round(x * scale);
+                       return static_cast<std::int8_t>(
+                           std::clamp(q, -127.f, 127.f));
+                     });
+      return quantized;
+    }
+
+    //! Dot products between the rows [i0, i0 + m) of 'a' and the rows
+    //! [j0, j0 + n) of 'b'.
+    template <typename DotTile>
+    auto compute_dots(const DescriptorMatrix<float>& a, int i0, int m,
+                      const DescriptorMatrix<float>& b, int j0, int n,
+                      DotTile& dots) -> void
+    {
+      dots.noalias() =
+          a.data.middleRows(i0, m) * b.data.middleRows(j0, n).transpose();
+    }
+
+    //! Eigen would accumulate the products of 8-bit integers on 8 bits, so
+    //! they are accumulated on 32-bit integers here. The tiles are widened to
+    //! 16 bits, which the compiler multiplies and adds pairwise in SIMD
+    //! registers, and each row of 'b' is loaded once for 4 rows of 'a'.
+    template <typename DotTile>
+    auto compute_dots(const DescriptorMatrix<std::int8_t>& a, int i0, int m,
+                      const DescriptorMatrix<std::int8_t>& b, int j0, int n,
+                      DotTile& dots) -> void
+    {
+      using widened_matrix_type =
+          Eigen::Matrix<std::int16_t, Eigen::Dynamic, Eigen::Dynamic,
+                        Eigen::RowMajor>;
+      const widened_matrix_type a16 =
+          a.data.middleRows(i0, m).template cast<std::int16_t>();
+      const widened_matrix_type b16 =
+          b.data.middleRows(j0, n).template cast<std::int16_t>();
+      const auto dim = static_cast<std::ptrdiff_t>(a16.cols());
+
+      dots.resize(m, n);
+
+      auto r = 0;
+      for (; r + 4 <= m; r += 4)
+      {
+        const auto* a0 = a16.data() + r * dim;
+        const auto* a1 = a0 + dim;
+        const auto* a2 = a1 + dim;
+        const auto* a3 = a2 + dim;
+        for (auto c = 0; c < n; ++c)
+        {
+          const auto* bc = b16.data() + c * dim;
+          auto d0 = std::int32_t{};
+          auto d1 = std::int32_t{};
+          auto d2 = std::int32_t{};
+          auto d3 = std::int32_t{};
+#pragma omp simd reduction(+ : d0, d1, d2, d3)
+          for (auto k = 0; k < dim; ++k)
+          {
+            const auto x = std::int32_t{bc[k]};
+            d0 += a0[k] * x;
+            d1 += a1[k] * x;
+            d2 += a2[k] * x;
+            d3 += a3[k] * x;
+          }
+          dots(r, c) = d0;
+          dots(r + 1, c) = d1;
+          dots(r + 2, c) = d2;
+          dots(r + 3, c) = d3;
+        }
+      }
+
+      for (; r < m; ++r)
+      {
+        const auto* ar = a16.data() + r * dim;
+        for (auto c = 0; c < n; ++c)
+        {
+          const auto* bc = b16.data() + c * dim;
+          auto dot = std::int32_t{};
+#pragma omp simd reduction(+ : dot)
+          for (auto k = 0; k < dim; ++k)
+            dot += ar[k] * std::int32_t{bc[k]};
+          dots(r, c) = dot;
+        }
+      }
+    }
+
+    //! Visit the squared distances between the rows of 'a' and the rows of
+    //! 'b' tile by tile. The visitor is called with the first row index, the
+    //! first column index and the tile of distances.
+    //!
+    //! The row tiles are distributed over the threads, so each row of 'a' is
+    //! visited by one thread only, in increasing order of columns.
+    template <typename T, typename Visitor>
+    auto for_each_distance_tile(const DescriptorMatrix<T>& a,
+                                const DescriptorMatrix<T>& b, Visitor&& visit)
+        -> void
+    {
+      using tile_type =
+          Eigen::Matrix<typename DescriptorMatrix<T>::accumulator_type,
+                        Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+      using distance_tile_type =
+          Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+      constexpr auto tile_rows = BruteForceMatcher::tile_rows;
+      constexpr auto tile_cols = BruteForceMatcher::tile_cols;
+      const auto num_row_tiles = (a.rows() + tile_rows - 1) / tile_rows;
+
+#pragma omp parallel
+      {
+        auto dots = tile_type{};
+        auto distances = distance_tile_type{};
+
+#pragma omp for schedule(dynamic)
+        for (auto t = 0; t < num_row_tiles; ++t)
+        {
+          const auto i0 = t * tile_rows;
+          const auto m = std::min(tile_rows, a.rows() - i0);
+
+          for (auto j0 = 0; j0 < b.rows(); j0 += tile_cols)
+          {
+            const auto n = std::min(tile_cols, b.rows() - j0);
+
+            compute_dots(a, i0, m, b, j0, n, dots);
+
+            distances.resize(m, n);
+            for (auto r = 0; r < m; ++r)
+              for (auto c = 0; c < n; ++c)
+              {
+                const auto d = a.squared_norms(i0 + r) +
+                               b.squared_norms(j0 + c) - 2 * dots(r, c);
+                // Clamp the rounding errors of the floating-point expansion.
+                distances(r, c) = std::max(static_cast<float>(d), 0.f);
+              }
+
+            visit(i0, j0, distances);
+          }
+        }
+      }
+    }
+
+    //! The two nearest neighbors of each row.
+    struct TwoNearestNeighbors
+    {
+      std::vector<int> index;
+      std::vector<float> first_distance;
+      std::vector<float> second_distance;
+    };
+
+    template <typename T>
+    auto find_two_nearest_neighbors(const DescriptorMatrix<T>& a,
+                                    const DescriptorMatrix<T>& b,
+                                    bool self_matching) -> TwoNearestNeighbors
+    {
+      constexpr auto inf = std::numeric_limits<float>::infinity();
+      auto nn = TwoNearestNeighbors{std::vector<int>(a.rows(), -1),
+                                    std::vector<float>(a.rows(), inf),
+                                    std::vector<float>(a.rows(), inf)};
+
+      for_each_distance_tile(a, b, [&](int i0, int j0, const auto& distances) {
+        for (auto r = 0; r < distances.rows(); ++r)
+        {
+          const auto i = i0 + r;
+          for (auto c = 0; c < distances.cols(); ++c)
+          {
+            const auto j = j0 + c;
+            if (self_matching && i == j)
+              continue;
+
+            // Strict comparisons keep the smallest index in case of ties.
+            const auto d = distances(r, c);
+            if (d < nn.first_distance[i])
+            {
+              nn.second_distance[i] = nn.first_distance[i];
+              nn.first_distance[i] = d;
+              nn.index[i] = j;
+            }
+            else if (d < nn.second_distance[i])
+              nn.second_distance[i] = d;
+          }
+        }
+      });
+
+      return nn;
+    }
+
+    //! Neighbors sorted by increasing distance and then by increasing index.
+    using NeighborList = std::vector<std::pair<float, int>>;
+
+    template <typename T>
+    auto find_neighbors_within(const DescriptorMatrix<T>& a,
+                               const DescriptorMatrix<T>& b,
+                               const std::vector<float>& squared_radii,
+                               bool self_matching) -> std::vector<NeighborList>
+    {
+      auto neighbors = std::vector<NeighborList>(a.rows());
+
+      for_each_distance_tile(a, b, [&](int i0, int j0, const auto& distances) {
+        for (auto r = 0; r < distances.rows(); ++r)
+        {
+          const auto i = i0 + r;
+          for (auto c = 0; c < distances.cols(); ++c)
+          {
+            const auto j = j0 + c;
+            if (self_matching && i == j)
+              continue;
+            if (distances(r, c) <= squared_radii[i])
+              neighbors[i].emplace_back(distances(r, c), j);
+          }
+        }
+      });
+
+      for (auto& n : neighbors)
+        std::sort(n.begin(), n.end());
+
+      return neighbors;
+    }
+
+    //! Append the matches of the source keypoints to the target keypoints.
+    auto append_matches(const KeypointList<OERegion, float>& keys_src,
+                        const KeypointList<OERegion, float>& keys_dst,
+                        const TwoNearestNeighbors& nn,
+                        const std::vector<NeighborList>* neighbors,
+                        const TwoNearestNeighbors* reverse_nn,
+                        float squared_ratio_thres, Match::Direction dir,
+                        bool self_matching, const KeyProximity& is_redundant,
+                        std::vector<Match>& matches) -> void
+    {
+      const auto& f_src = features(keys_src);
+      const auto& f_dst = features(keys_dst);
+
+      auto append = [&](int i, int j, float score, int rank) {
+        auto m = Match{&f_src[i], &f_dst[j], score, dir, i, j};
+        m.rank() = rank;
+        if (dir == Match::Direction::TargetToSource)
+        {
+          swap(m.x_pointer(), m.y_pointer());
+          swap(m.x_index(), m.y_index());
+        }
+        matches.push_back(m);
+      };
+
+      for (auto i = 0; i < static_cast<int>(nn.index.size()); ++i)
+      {
+        const auto j1 = nn.index[i];
+        if (j1 == -1)
+          continue;
+
+        // As in 'AnnMatcher', the ratio test is passed by default when there
+        // is no second nearest neighbor.
+        const auto d1 = nn.first_distance[i];
+        const auto d2 = nn.second_distance[i];
+        const auto top1_score =
+            std::isinf(d2) ? 1.f : (d2 > 0.f ? d1 / d2 : 0.f);
+
+        if (reverse_nn != nullptr && reverse_nn->index[j1] != i)
+          continue;
+
+        if (neighbors == nullptr)
+        {
+          if (top1_score > squared_ratio_thres)
+            continue;
+          if (self_matching && is_redundant(f_src[i], f_dst[j1]))
+            continue;
+          append(i, j1, top1_score, 1);
+          continue;
+        }
+
+        const auto& n = (*neighbors)[i];
+        for (auto rank = 0; rank < static_cast<int>(n.size()); ++rank)
+        {
+          const auto& [d, j] = n[rank];
+          const auto score =
+              rank == 0 ? top1_score : (d1 > 0.f ? d / d1 : 0.f);
+          if (score > squared_ratio_thres)
+            break;
+          if (self_matching && is_redundant(f_src[i], f_dst[j]))
+            continue;
+          append(i, j, score, rank + 1);
+        }
+      }
+    }
+
+    template <typename T>
+    auto compute_matches_impl(const KeypointList<OERegion, float>& keys1,
+                              const KeypointList<OERegion, float>& keys2,
+                              const DescriptorMatrix<T>& d1,
+                              const DescriptorMatrix<T>& d2,
+                              float squared_ratio_thres, bool mutual_check,
+                              bool self_matching,
+                              const KeyProximity& is_redundant)
+        -> std::vector<Match>
+    {
+      const auto nn12 = find_two_nearest_neighbors(d1, d2, self_matching);
+      const auto nn21 = self_matching
+                            ? nn12
+                            : find_two_nearest_neighbors(d2, d1, self_matching);
+
+      auto matches = std::vector<Match>{};
+
+      // With the mutual check, only the best matches are kept and both
+      // directions yield the same matches.
+      if (mutual_check)
+      {
+        append_matches(keys1, keys2, nn12, nullptr, &nn21,
+                       squared_ratio_thres, Match::Direction::SourceToTarget,
+                       self_matching, is_redundant, matches);
+        return matches;
+      }
+
+      // The other candidate matches are retrieved with a second pass.
+      auto neighbors12 = std::vector<NeighborList>{};
+      auto neighbors21 = std::vector<NeighborList>{};
+      if (squared_ratio_thres > 1.f)
+      {
+        auto radii = [&](const TwoNearestNeighbors& nn) {
+          auto r = nn.first_distance;
+          for (auto& ri : r)
+            ri *= squared_ratio_thres;
+          return r;
+        };
+        neighbors12 =
+            find_neighbors_within(d1, d2, radii(nn12), self_matching);
+        neighbors21 =
+            self_matching
+                ? neighbors12
+                : find_neighbors_within(d2, d1, radii(nn21), self_matching);
+      }
+      const auto has_candidates = squared_ratio_thres > 1.f;
+
+      append_matches(keys1, keys2, nn12,
+                     has_candidates ? &neighbors12 : nullptr, nullptr,
+                     squared_ratio_thres, Match::Direction::SourceToTarget,
+                     self_matching, is_redundant, matches);
+      append_matches(keys2, keys1, nn21,
+                     has_candidates ? &neighbors21 : nullptr, nullptr,
+                     squared_ratio_thres, Match::Direction::TargetToSource,
+                     self_matching, is_redundant, matches);
+
+      return matches;
+    }
+
+  }  // namespace
+
+
+  BruteForceMatcher::BruteForceMatcher(
+      const KeypointList<OERegion, float>& keys1,
+      const KeypointList<OERegion, float>& keys2, float sift_ratio_thres,
+      DescriptorMode mode, bool mutual_check)
+    : _keys1(keys1)
+    , _keys2(keys2)
+    , _squared_ratio_thres(sift_ratio_thres * sift_ratio_thres)
+    , _mode(mode)
+    , _mutual_check(mutual_check)
+    , _self_matching(false)
+  {
+    if (!size_consistency_predicate(_keys1) ||
+        !size_consistency_predicate(_keys2))
+      throw std::runtime_error{
+          "The list of keypoints are inconsistent in size!"};
+    if (descriptors(_keys1).cols() != descriptors(_keys2).cols())
+      throw std::runtime_error{"The descriptor dimensions are different!"};
+  }
+
+  BruteForceMatcher::BruteForceMatcher(
+      const KeypointList<OERegion, float>& keys, float sift_ratio_thres,
+      float min_max_metric_dist_thres, float pixel_dist_thres,
+      DescriptorMode mode, bool mutual_check)
+    : _keys1(keys)
+    , _keys2(keys)
+    , _squared_ratio_thres(sift_ratio_thres * sift_ratio_thres)
+    , _mode(mode)
+    , _mutual_check(mutual_check)
+    , _is_too_close(min_max_metric_dist_thres, pixel_dist_thres)
+    , _self_matching(true)
+  {
+    if (!size_consistency_predicate(_keys1))
+      throw std::runtime_error{
+          "The list of keypoints are inconsistent in size!"};
+  }
+
+  auto BruteForceMatcher::compute_matches() -> vector<Match>
+  {
+    SARA_PROFILE_SCOPE("BruteForceMatcher");
+
+    const auto& dmat1 = descriptors(_keys1);
+    const auto& dmat2 = descriptors(_keys2);
+
+    auto matches = vector<Match>{};
+    if (_mode == DescriptorMode::Float32)
+      matches = compute_matches_impl(
+          _keys1, _keys2, DescriptorMatrix<float>{dmat1},
+          DescriptorMatrix<float>{dmat2}, _squared_ratio_thres, _mutual_check,
+          _self_matching, _is_too_close);
+    else
+    {
+      // Use a common scale so that the distances remain comparable.
+      auto max_abs_value = 0.f;
+      for (const auto* d : {&dmat1, &dmat2})
+        if (d->size() > 0)
+          max_abs_value =
+              std::max(max_abs_value, d->matrix().cwiseAbs().maxCoeff());
+      const auto scale = max_abs_value > 0.f ? 127.f / max_abs_value : 1.f;
+
+      const auto qmat1 = quantize(dmat1, scale);
+      const auto qmat2 = _self_matching ? Tensor_<std::int8_t, 2>{}
+                                        : quantize(dmat2, scale);
+      const auto& qmat2_ref = _self_matching ? qmat1 : qmat2;
+      matches = compute_matches_impl(
+          _keys1, _keys2, DescriptorMatrix<std::int8_t>{qmat1},
+          DescriptorMatrix<std::int8_t>{qmat2_ref}, _squared_ratio_thres,
+          _mutual_check, _self_matching, _is_too_close);
+    }
+
+    // Lexicographical comparison between matches.
+    auto compare_match = [](const Match& m1, const Match& m2) {
+      if (m1.x_index() < m2.x_index())
+        return true;
+      if (m1.x_index() == m2.x_index() && m1.y_index() < m2.y_index())
+        return true;
+      if (m1.x_index() == m2.x_index() && m1.y_index() == m2.y_index() &&
+          m1.score() < m2.score())
+        return true;
+      return false;
+    };
+    sort(matches.begin(), matches.end(), compare_match);
+
+    // Remove redundant matches in each consecutive group of identical matches.
+    // We keep the one with the best Lowe score.
+    matches.resize(unique(matches.begin(), matches.end()) - matches.begin());
+
+    // Reorder the matches again.
+    stable_sort(matches.begin(), matches.end(),
+                [&](const Match& m1, const Match& m2) {
+                  return m1.score() < m2.score();
+                });
+
+    SARA_PROFILE_COUNTER("matches", matches.size());
+    SARA_PROFILE_HISTOGRAM("matches_per_pair", matches.size());
+
+    return matches;
+  }
+
+} /* namespace Sara */
+} /* namespace DO */
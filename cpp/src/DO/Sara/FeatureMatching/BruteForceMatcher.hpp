@@ -0,0 +1,115 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <DO/Sara/Features/KeypointList.hpp>
+
+#include <DO/Sara/FeatureMatching/KeyProximity.hpp>
+
+#include <DO/Sara/Match/Match.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace DO { namespace Sara {
+
+  /*!
+   *  @addtogroup FeatureMatching
+   *  @{
+   */
+
+  /*!
+    @brief Exact feature matcher computing all the descriptor distances.
+
+    The squared Euclidean distances are computed tile by tile as
+    @f$ \|a\|^2 + \|b\|^2 - 2 a^T b @f$, where the dot products are evaluated
+    with a matrix product. Only one tile of distances per thread is kept in
+    memory.
+
+    Contrary to 'AnnMatcher', the nearest neighbors are exact and the matches
+    are deterministic. This is the faster option for image pairs with up to a
+    few ten thousands of keypoints.
+
+    The matcher returns the same candidate matches as 'AnnMatcher':
+    - the best match of each keypoint passing Lowe's ratio test, scored by its
+      squared distance ratio,
+    - if the ratio threshold is greater than one, the other neighbors whose
+      squared distances are within the threshold of the best one.
+    With the mutual check, the matcher only returns the best matches passing
+    the ratio test that are also the best matches in the other direction.
+   */
+  class DO_SARA_EXPORT BruteForceMatcher
+  {
+  public:
+    //! @brief Descriptor representation used in the distance computations.
+    enum class DescriptorMode : std::uint8_t
+    {
+      //! @brief Single-precision descriptors.
+      Float32,
+      //! @brief Descriptors quantized on 8 bits with a common scale.
+      //!
+      //! The quantized descriptors are stored on 8 bits and their products
+      //! are accumulated on 32-bit integers, so the distances are exact
+      //! integers and the matches are reproducible on every platform, but the
+      //! products are slower than in single precision.
+      Int8
+    };
+
+    //! @brief Size of the distance tiles.
+    static constexpr int tile_rows = 256;
+    static constexpr int tile_cols = 2048;
+
+    //! @brief Constructors.
+    //! @{
+    BruteForceMatcher(const KeypointList<OERegion, float>& keys1,
+                      const KeypointList<OERegion, float>& keys2,
+                      float sift_ratio_thres = 1.2f,
+                      DescriptorMode mode = DescriptorMode::Float32,
+                      bool mutual_check = false);
+
+    BruteForceMatcher(const KeypointList<OERegion, float>& keys,
+                      float sift_ratio_thres = 1.2f,
+                      float min_max_metric_dist_thres = 0.5f,
+                      float pixel_dist_thres = 10.f,
+                      DescriptorMode mode = DescriptorMode::Float32,
+                      bool mutual_check = false);
+    //! @}
+
+    //! @{
+    //! @brief Return matches.
+    std::vector<Match> compute_matches();
+
+    std::vector<Match> compute_self_matches()
+    {
+      return compute_matches();
+    }
+    //! @}
+
+  private: /* data members */
+    //! Input parameters.
+    const KeypointList<OERegion, float>& _keys1;
+    const KeypointList<OERegion, float>& _keys2;
+    float _squared_ratio_thres;
+    DescriptorMode _mode;
+    bool _mutual_check;
+    //! Internals.
+    KeyProximity _is_too_close;
+    bool _self_matching;
+  };
+
+  //! @}
+
+} /* namespace Sara */
+} /* namespace DO */
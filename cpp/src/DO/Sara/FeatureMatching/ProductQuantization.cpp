@@ -0,0 +1,551 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/FeatureMatching/ProductQuantization.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+
+namespace DO { namespace Sara {
+
+  namespace {
+
+    inline auto squared_distance(const float* a, const float* b, int d)
+        -> float
+    {
+      auto s = 0.f;
+      for (auto i = 0; i < d; ++i)
+        s += (a[i] - b[i]) * (a[i] - b[i]);
+      return s;
+    }
+
+    //! Index of the nearest row of 'centroids'.
+    inline auto nearest_centroid(const float* centroids, int num_centroids,
+                                 int d, const float* x) -> int
+    {
+      auto best = 0;
+      auto best_distance = std::numeric_limits<float>::max();
+      for (auto c = 0; c < num_centroids; ++c)
+      {
+        const auto dc = squared_distance(centroids + c * d, x, d);
+        if (dc < best_distance)
+        {
+          best_distance = dc;
+          best = c;
+        }
+      }
+      return best;
+    }
+
+    //! Lloyd's k-means algorithm initialized with a random subset of the data.
+    //! Empty clusters are reseeded with random data points.
+    auto kmeans(const TensorView_<float, 2>& data, int k, int num_iterations,
+                unsigned int seed) -> Tensor_<float, 2>
+    {
+      const auto n = data.rows();
+      const auto d = data.cols();
+      if (n < k)
+        throw std::domain_error{
+            "Not enough training data: there must be at least as many data "
+            "points as centroids!"};
+
+      auto gen = std::mt19937{seed};
+
+      auto indices = std::vector<int>(n);
+      std::iota(indices.begin(), indices.end(), 0);
+      std::shuffle(indices.begin(), indices.end(), gen);
+
+      auto centroids = Tensor_<float, 2>{k, d};
+      for (auto c = 0; c < k; ++c)
+        std::copy(data[indices[c]].begin(), data[indices[c]].end(),
+                  centroids[c].begin());
+
+      auto assignments = std::vector<int>(n);
+      auto sums = std::vector<double>(static_cast<std::size_t>(k) * d);
+      auto counts = std::vector<int>(k);
+      auto random_point = std::uniform_int_distribution<int>{0, n - 1};
+
+      for (auto iter = 0; iter < num_iterations; ++iter)
+      {
+#pragma omp parallel for
+        for (auto i = 0; i < n; ++i)
+          assignments[i] =
+              nearest_centroid(centroids.data(), k, d, data[i].data());
+
+        std::fill(sums.begin(), sums.end(), 0.);
+        std::fill(counts.begin(), counts.end(), 0);
+        for (auto i = 0; i < n; ++i)
+        {
+          const auto c = assignments[i];
+          const auto x = data[i].data();
+          for (auto j = 0; j < d; ++j)
+            sums[c * d + j] += x[j];
+          ++counts[c];
+        }
+
+        for (auto c = 0; c < k; ++c)
+        {
+          if (counts[c] == 0)
+          {
+            const auto i = random_point(gen);
+            std::copy(data[i].begin(), data[i].end(), centroids[c].begin());
+            continue;
+          }
+          for (auto j = 0; j < d; ++j)
+            centroids(c, j) = static_cast<float>(sums[c * d + j] / counts[c]);
+        }
+      }
+
+      return centroids;
+    }
+
+    //! Sorted list of the k nearest neighbors found so far, stored in the
+    //! output rows.
+    struct NearestNeighborList
+    {
+      NearestNeighborList(int k, int* indices, float* distances)
+        : k{k}
+        , indices{indices}
+        , distances{distances}
+      {
+        std::fill(indices, indices + k, -1);
+        std::fill(distances, distances + k,
+                  std::numeric_limits<float>::infinity());
+      }
+
+      inline auto push(float d, int index) -> void
+      {
+        if (!(d < distances[k - 1]))
+          return;
+
+        auto i = k - 1;
+        for (; i > 0 && distances[i - 1] > d; --i)
+        {
+          distances[i] = distances[i - 1];
+          indices[i] = indices[i - 1];
+        }
+        distances[i] = d;
+        indices[i] = index;
+      }
+
+      int k;
+      int* indices;
+      float* distances;
+    };
+
+    auto check_knn_outputs(int num_queries, int num_nearest_neighbors,
+                           const TensorView_<int, 2>& nn_indices,
+                           const TensorView_<float, 2>& nn_squared_distances)
+        -> void
+    {
+      if (num_nearest_neighbors < 1)
+        throw std::domain_error{"Invalid number of nearest neighbors!"};
+      if (nn_indices.rows() != num_queries ||
+          nn_squared_distances.rows() != num_queries ||
+          nn_indices.cols() < num_nearest_neighbors ||
+          nn_squared_distances.cols() < num_nearest_neighbors)
+        throw std::domain_error{"Invalid sizes for the output tensors!"};
+    }
+
+  }  // namespace
+
+
+  // ======================================================================== //
+  // Product quantizer.
+  ProductQuantizer::ProductQuantizer(int dimension, int num_subspaces,
+                                     int num_bits)
+    : _dimension{dimension}
+    , _num_subspaces{num_subspaces}
+    , _num_bits{num_bits}
+  {
+    if (num_subspaces < 1 || dimension % num_subspaces != 0)
+      throw std::domain_error{"The dimension must be a multiple of the number "
+                              "of subspaces!"};
+    if (num_bits < 1 || num_bits > 8)
+      throw std::domain_error{"The number of bits must be in [1, 8]!"};
+  }
+
+  auto ProductQuantizer::train(const TensorView_<float, 2>& data,
+                               int num_iterations, unsigned int seed) -> void
+  {
+    if (data.cols() != _dimension)
+      throw std::domain_error{"Invalid descriptor dimension!"};
+
+    const auto M = _num_subspaces;
+    const auto K = num_centroids();
+    const auto ds = subspace_dimension();
+    const auto n = data.rows();
+
+    auto codebooks = Tensor_<float, 3>{M, K, ds};
+
+    // The subspaces are independent: train them in parallel.
+    auto errors = std::vector<std::exception_ptr>(M);
+#pragma omp parallel for
+    for (auto m = 0; m < M; ++m)
+    {
+      try
+      {
+        auto subvectors = Tensor_<float, 2>{n, ds};
+        for (auto i = 0; i < n; ++i)
+          std::copy(data[i].data() + m * ds, data[i].data() + (m + 1) * ds,
+                    subvectors[i].data());
+
+        const auto centroids =
+            kmeans(subvectors, K, num_iterations, seed + m);
+        std::copy(centroids.begin(), centroids.end(), codebooks[m].data());
+      }
+      catch (...)
+      {
+        errors[m] = std::current_exception();
+      }
+    }
+    for (const auto& error : errors)
+      if (error)
+        std::rethrow_exception(error);
+
+    _codebooks = std::move(codebooks);
+  }
+
+  auto ProductQuantizer::encode(const TensorView_<float, 2>& data,
+                                TensorView_<std::uint8_t, 2>& codes) const
+      -> void
+  {
+    if (!trained())
+      throw std::runtime_error{"The product quantizer is not trained!"};
+    if (data.cols() != _dimension)
+      throw std::domain_error{"Invalid descriptor dimension!"};
+    if (codes.rows() != data.rows() || codes.cols() != code_size())
+      throw std::domain_error{"Invalid sizes for the codes!"};
+
+    const auto M = _num_subspaces;
+    const auto K = num_centroids();
+    const auto ds = subspace_dimension();
+
+#pragma omp parallel for
+    for (auto i = 0; i < data.rows(); ++i)
+      for (auto m = 0; m < M; ++m)
+        codes(i, m) = static_cast<std::uint8_t>(nearest_centroid(
+            _codebooks[m].data(), K, ds, data[i].data() + m * ds));
+  }
+
+  auto ProductQuantizer::encode(const TensorView_<float, 2>& data) const
+      -> Tensor_<std::uint8_t, 2>
+  {
+    auto codes = Tensor_<std::uint8_t, 2>{data.rows(), code_size()};
+    encode(data, codes);
+    return codes;
+  }
+
+  auto ProductQuantizer::decode(const TensorView_<std::uint8_t, 2>& codes) const
+      -> Tensor_<float, 2>
+  {
+    if (!trained())
+      throw std::runtime_error{"The product quantizer is not trained!"};
+    if (codes.cols() != code_size())
+      throw std::domain_error{"Invalid code size!"};
+
+    const auto ds = subspace_dimension();
+
+    auto data = Tensor_<float, 2>{codes.rows(), _dimension};
+    for (auto i = 0; i < codes.rows(); ++i)
+      for (auto m = 0; m < _num_subspaces; ++m)
+      {
+        const auto centroid = _codebooks[m][codes(i, m)];
+        std::copy(centroid.begin(), centroid.end(), data[i].data() + m * ds);
+      }
+    return data;
+  }
+
+  auto ProductQuantizer::compute_distance_table(const float* query,
+                                                float* table) const -> void
+  {
+    const auto K = num_centroids();
+    const auto ds = subspace_dimension();
+    for (auto m = 0; m < _num_subspaces; ++m)
+      for (auto k = 0; k < K; ++k)
+        table[m * K + k] =
+            squared_distance(query + m * ds, _codebooks[m][k].data(), ds);
+  }
+
+  auto ProductQuantizer::knn_search(
+      const TensorView_<float, 2>& queries,
+      const TensorView_<std::uint8_t, 2>& codes, int num_nearest_neighbors,
+      TensorView_<int, 2>& nn_indices,
+      TensorView_<float, 2>& nn_squared_distances) const -> void
+  {
+    if (!trained())
+      throw std::runtime_error{"The product quantizer is not trained!"};
+    if (queries.cols() != _dimension || codes.cols() != code_size())
+      throw std::domain_error{"Invalid descriptor dimension or code size!"};
+    check_knn_outputs(queries.rows(), num_nearest_neighbors, nn_indices,
+                      nn_squared_distances);
+
+#pragma omp parallel
+    {
+      auto table = std::vector<float>(_num_subspaces * num_centroids());
+
+#pragma omp for
+      for (auto q = 0; q < queries.rows(); ++q)
+      {
+        compute_distance_table(queries[q].data(), table.data());
+
+        auto nn = NearestNeighborList{num_nearest_neighbors,
+                                      nn_indices[q].data(),
+                                      nn_squared_distances[q].data()};
+        for (auto i = 0; i < codes.rows(); ++i)
+          nn.push(adc_distance(table.data(), codes[i].data()), i);
+      }
+    }
+  }
+
+  auto ProductQuantizer::write(H5File& file,
+                               const std::string& group_name) const -> void
+  {
+    file.get_group(group_name);
+
+    auto parameters = Tensor_<int, 1>{3};
+    parameters(0) = _dimension;
+    parameters(1) = _num_subspaces;
+    parameters(2) = _num_bits;
+    file.write_dataset(group_name + "/parameters", parameters, true);
+    file.write_dataset(group_name + "/codebooks", _codebooks, true);
+  }
+
+  auto ProductQuantizer::read(H5File& file, const std::string& group_name)
+      -> void
+  {
+    auto parameters = Tensor_<int, 1>{};
+    file.read_dataset(group_name + "/parameters", parameters);
+    if (parameters.size() != 3)
+      throw std::runtime_error{"Invalid product quantizer parameters!"};
+
+    *this = ProductQuantizer{parameters(0), parameters(1), parameters(2)};
+    file.read_dataset(group_name + "/codebooks", _codebooks);
+
+    if (_codebooks.size(0) != _num_subspaces ||
+        _codebooks.size(1) != num_centroids() ||
+        _codebooks.size(2) != subspace_dimension())
+      throw std::runtime_error{"Invalid product quantizer codebooks!"};
+  }
+
+
+  // ======================================================================== //
+  // Inverted file index.
+  IVFPQIndex::IVFPQIndex(int dimension, int num_lists, int num_subspaces,
+                         int num_bits)
+    : _pq{dimension, num_subspaces, num_bits}
+    , _list_codes(num_lists)
+    , _list_ids(num_lists)
+    , _num_lists{num_lists}
+  {
+    if (num_lists < 1)
+      throw std::domain_error{"The number of lists must be positive!"};
+  }
+
+  auto IVFPQIndex::assign(const float* x) const -> int
+  {
+    return nearest_centroid(_coarse_centroids.data(), _num_lists,
+                            dimension(), x);
+  }
+
+  auto IVFPQIndex::train(const TensorView_<float, 2>& data, int num_iterations,
+                         unsigned int seed) -> void
+  {
+    if (data.cols() != dimension())
+      throw std::domain_error{"Invalid descriptor dimension!"};
+
+    _coarse_centroids = kmeans(data, _num_lists, num_iterations, seed);
+
+    // The product quantizer encodes the residuals to the coarse centroids.
+    auto residuals = Tensor_<float, 2>{data.sizes()};
+#pragma omp parallel for
+    for (auto i = 0; i < data.rows(); ++i)
+    {
+      const auto c = _coarse_centroids[assign(data[i].data())];
+      for (auto j = 0; j < data.cols(); ++j)
+        residuals(i, j) = data(i, j) - c(j);
+    }
+
+    _pq.train(residuals, num_iterations, seed + 1);
+  }
+
+  auto IVFPQIndex::add(const TensorView_<float, 2>& data) -> void
+  {
+    if (!_pq.trained())
+      throw std::runtime_error{"The index is not trained!"};
+    if (data.cols() != dimension())
+      throw std::domain_error{"Invalid descriptor dimension!"};
+
+    const auto n = data.rows();
+
+    auto lists = std::vector<int>(n);
+    auto residuals = Tensor_<float, 2>{data.sizes()};
+#pragma omp parallel for
+    for (auto i = 0; i < n; ++i)
+    {
+      lists[i] = assign(data[i].data());
+      const auto c = _coarse_centroids[lists[i]];
+      for (auto j = 0; j < data.cols(); ++j)
+        residuals(i, j) = data(i, j) - c(j);
+    }
+
+    const auto codes = _pq.encode(residuals);
+
+    for (auto i = 0; i < n; ++i)
+    {
+      auto& list_codes = _list_codes[lists[i]];
+      list_codes.insert(list_codes.end(), codes[i].begin(), codes[i].end());
+      _list_ids[lists[i]].push_back(_size + i);
+    }
+    _size += n;
+  }
+
+  auto IVFPQIndex::knn_search(const TensorView_<float, 2>& queries,
+                              int num_nearest_neighbors,
+                              TensorView_<int, 2>& nn_indices,
+                              TensorView_<float, 2>& nn_squared_distances,
+                              int num_probes) const -> void
+  {
+    if (!_pq.trained())
+      throw std::runtime_error{"The index is not trained!"};
+    if (queries.cols() != dimension())
+      throw std::domain_error{"Invalid descriptor dimension!"};
+    check_knn_outputs(queries.rows(), num_nearest_neighbors, nn_indices,
+                      nn_squared_distances);
+
+    num_probes = std::clamp(num_probes, 1, _num_lists);
+    const auto d = dimension();
+    const auto code_size = _pq.code_size();
+
+#pragma omp parallel
+    {
+      auto coarse_distances = std::vector<std::pair<float, int>>(_num_lists);
+      auto residual = std::vector<float>(d);
+      auto table = std::vector<float>(code_size * _pq.num_centroids());
+
+#pragma omp for
+      for (auto q = 0; q < queries.rows(); ++q)
+      {
+        const auto query = queries[q].data();
+
+        // Find the nearest lists.
+        for (auto l = 0; l < _num_lists; ++l)
+          coarse_distances[l] = {
+              squared_distance(_coarse_centroids[l].data(), query, d), l};
+        std::partial_sort(coarse_distances.begin(),
+                          coarse_distances.begin() + num_probes,
+                          coarse_distances.end());
+
+        auto nn = NearestNeighborList{num_nearest_neighbors,
+                                      nn_indices[q].data(),
+                                      nn_squared_distances[q].data()};
+
+        for (auto p = 0; p < num_probes; ++p)
+        {
+          const auto l = coarse_distances[p].second;
+          const auto& ids = _list_ids[l];
+          if (ids.empty())
+            continue;
+
+          const auto c = _coarse_centroids[l].data();
+          for (auto j = 0; j < d; ++j)
+            residual[j] = query[j] - c[j];
+          _pq.compute_distance_table(residual.data(), table.data());
+
+          const auto codes = _list_codes[l].data();
+          for (auto i = 0u; i < ids.size(); ++i)
+            nn.push(_pq.adc_distance(table.data(), codes + i * code_size),
+                    ids[i]);
+        }
+      }
+    }
+  }
+
+  auto IVFPQIndex::write(H5File& file, const std::string& group_name) const
+      -> void
+  {
+    file.get_group(group_name);
+    _pq.write(file, group_name + "/product_quantizer");
+    file.write_dataset(group_name + "/coarse_centroids", _coarse_centroids,
+                       true);
+
+    // Concatenate the inverted lists.
+    auto list_offsets = Tensor_<int, 1>{_num_lists + 1};
+    list_offsets(0) = 0;
+    for (auto l = 0; l < _num_lists; ++l)
+      list_offsets(l + 1) = list_offsets(l) + list_size(l);
+
+    auto codes = Tensor_<std::uint8_t, 2>{_size, _pq.code_size()};
+    auto ids = Tensor_<int, 1>{_size};
+    for (auto l = 0; l < _num_lists; ++l)
+    {
+      std::copy(_list_codes[l].begin(), _list_codes[l].end(),
+                codes.data() + list_offsets(l) * _pq.code_size());
+      std::copy(_list_ids[l].begin(), _list_ids[l].end(),
+                ids.data() + list_offsets(l));
+    }
+
+    file.write_dataset(group_name + "/list_offsets", list_offsets, true);
+    file.write_dataset(group_name + "/codes", codes, true);
+    file.write_dataset(group_name + "/ids", ids, true);
+  }
+
+  auto IVFPQIndex::read(H5File& file, const std::string& group_name) -> void
+  {
+    auto pq = ProductQuantizer{};
+    pq.read(file, group_name + "/product_quantizer");
+
+    auto coarse_centroids = Tensor_<float, 2>{};
+    auto list_offsets = Tensor_<int, 1>{};
+    auto codes = Tensor_<std::uint8_t, 2>{};
+    auto ids = Tensor_<int, 1>{};
+    file.read_dataset(group_name + "/coarse_centroids", coarse_centroids);
+    file.read_dataset(group_name + "/list_offsets", list_offsets);
+    file.read_dataset(group_name + "/codes", codes);
+    file.read_dataset(group_name + "/ids", ids);
+
+    const auto num_lists = coarse_centroids.rows();
+    const auto size = ids.size(0);
+    if (coarse_centroids.cols() != pq.dimension() ||
+        list_offsets.size(0) != num_lists + 1 || codes.rows() != size ||
+        codes.cols() != pq.code_size())
+      throw std::runtime_error{"Invalid inverted file index!"};
+
+    // The inverted lists must partition the codes, otherwise they would be
+    // read out of bounds.
+    const auto offsets_begin = list_offsets.data();
+    const auto offsets_end = offsets_begin + num_lists + 1;
+    if (list_offsets(0) != 0 || list_offsets(num_lists) != size ||
+        std::is_sorted_until(offsets_begin, offsets_end) != offsets_end)
+      throw std::runtime_error{"Invalid inverted lists!"};
+
+    _pq = std::move(pq);
+    _coarse_centroids = std::move(coarse_centroids);
+    _num_lists = num_lists;
+    _size = size;
+    _list_codes.assign(num_lists, {});
+    _list_ids.assign(num_lists, {});
+    for (auto l = 0; l < num_lists; ++l)
+    {
+      const auto begin = list_offsets(l);
+      const auto end = list_offsets(l + 1);
+      _list_codes[l].assign(codes.data() + begin * _pq.code_size(),
+                            codes.data() + end * _pq.code_size());
+      _list_ids[l].assign(ids.data() + begin, ids.data() + end);
+    }
+  }
+
+}}  // namespace DO::Sara
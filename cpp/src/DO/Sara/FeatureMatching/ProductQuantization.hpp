@@ -0,0 +1,246 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <DO/Sara/Core/HDF5.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+namespace DO { namespace Sara {
+
+  /*!
+   *  @addtogroup FeatureMatching
+   *  @{
+   */
+
+  //! @name Product quantization
+  //! @{
+
+  /*!
+    @brief Product quantizer of descriptors.
+
+    The descriptor space is split into M subspaces of equal dimension and each
+    subspace is quantized with its own k-means codebook of at most 256
+    centroids. A descriptor is thus encoded with M bytes: with 128-dimensional
+    SIFT descriptors, M = 32 divides the memory by 16 and M = 8 by 64.
+
+    The nearest neighbors of a query are searched with the asymmetric distance
+    computation (ADC): the query is not quantized, and the squared distance to
+    a code is the sum of M entries of a precomputed distance table.
+
+    Reference: "Product quantization for nearest neighbor search", Jégou et
+    al., PAMI 2011.
+   */
+  class DO_SARA_EXPORT ProductQuantizer
+  {
+  public:
+    ProductQuantizer() = default;
+
+    //! @brief The dimension must be a multiple of the number of subspaces.
+    ProductQuantizer(int dimension, int num_subspaces, int num_bits = 8);
+
+    //! @{
+    //! @brief Parameters.
+    auto dimension() const -> int
+    {
+      return _dimension;
+    }
+
+    auto num_subspaces() const -> int
+    {
+      return _num_subspaces;
+    }
+
+    auto subspace_dimension() const -> int
+    {
+      return _num_subspaces == 0 ? 0 : _dimension / _num_subspaces;
+    }
+
+    auto num_centroids() const -> int
+    {
+      return 1 << _num_bits;
+    }
+
+    //! @brief Number of bytes per code.
+    auto code_size() const -> int
+    {
+      return _num_subspaces;
+    }
+    //! @}
+
+    auto trained() const -> bool
+    {
+      return !_codebooks.empty();
+    }
+
+    //! @brief Codebooks of sizes (M, K, D / M).
+    auto codebooks() const -> const Tensor_<float, 3>&
+    {
+      return _codebooks;
+    }
+
+    //! @brief Learn the codebooks with k-means on each subspace.
+    auto train(const TensorView_<float, 2>& data, int num_iterations = 25,
+               unsigned int seed = 0) -> void;
+
+    //! @{
+    //! @brief Encode the rows of the data matrix.
+    auto encode(const TensorView_<float, 2>& data,
+                TensorView_<std::uint8_t, 2>& codes) const -> void;
+
+    auto encode(const TensorView_<float, 2>& data) const
+        -> Tensor_<std::uint8_t, 2>;
+    //! @}
+
+    //! @brief Reconstruct approximately the encoded data.
+    auto decode(const TensorView_<std::uint8_t, 2>& codes) const
+        -> Tensor_<float, 2>;
+
+    //! @brief Compute the M x K table of squared distances between the
+    //! subvectors of the query and the centroids.
+    auto compute_distance_table(const float* query, float* table) const
+        -> void;
+
+    //! @brief Asymmetric squared distance given a distance table.
+    inline auto adc_distance(const float* table,
+                             const std::uint8_t* code) const -> float
+    {
+      const auto K = num_centroids();
+      auto d = 0.f;
+      for (auto m = 0; m < _num_subspaces; ++m)
+        d += table[m * K + code[m]];
+      return d;
+    }
+
+    /*!
+      @brief Exhaustive k-NN search over codes with the asymmetric distance.
+
+      The output tensors must have as many rows as queries and at least
+      'num_nearest_neighbors' columns. Missing neighbors have index -1 and an
+      infinite distance.
+     */
+    auto knn_search(const TensorView_<float, 2>& queries,
+                    const TensorView_<std::uint8_t, 2>& codes,
+                    int num_nearest_neighbors,
+                    TensorView_<int, 2>& nn_indices,
+                    TensorView_<float, 2>& nn_squared_distances) const -> void;
+
+    //! @{
+    //! @brief Save and load the codebooks in an HDF5 group.
+    auto write(H5File& file, const std::string& group_name) const -> void;
+
+    auto read(H5File& file, const std::string& group_name) -> void;
+    //! @}
+
+  private:
+    int _dimension = 0;
+    int _num_subspaces = 0;
+    int _num_bits = 8;
+    Tensor_<float, 3> _codebooks;
+  };
+
+
+  /*!
+    @brief Inverted file index with product-quantized residuals (IVFADC).
+
+    A coarse k-means quantizer partitions the descriptor space into lists.
+    Each descriptor is stored in the list of its nearest coarse centroid,
+    and its residual to this centroid is encoded by a product quantizer.
+
+    A query only scans the lists of its 'num_probes' nearest coarse
+    centroids, which makes the search sublinear in the number of stored
+    descriptors. Increasing 'num_probes' trades speed for recall.
+   */
+  class DO_SARA_EXPORT IVFPQIndex
+  {
+  public:
+    IVFPQIndex() = default;
+
+    IVFPQIndex(int dimension, int num_lists, int num_subspaces,
+               int num_bits = 8);
+
+    auto dimension() const -> int
+    {
+      return _pq.dimension();
+    }
+
+    auto num_lists() const -> int
+    {
+      return _num_lists;
+    }
+
+    //! @brief Number of stored descriptors.
+    auto size() const -> int
+    {
+      return _size;
+    }
+
+    auto list_size(int list) const -> int
+    {
+      return static_cast<int>(_list_ids[list].size());
+    }
+
+    auto product_quantizer() const -> const ProductQuantizer&
+    {
+      return _pq;
+    }
+
+    //! @brief Learn the coarse quantizer and the residual product quantizer.
+    auto train(const TensorView_<float, 2>& data, int num_iterations = 25,
+               unsigned int seed = 0) -> void;
+
+    //! @brief Store descriptors, which get the ids size(), size() + 1, ...
+    auto add(const TensorView_<float, 2>& data) -> void;
+
+    //! @brief Approximate k-NN search in the 'num_probes' nearest lists.
+    //!
+    //! The output conventions are the same as
+    //! 'ProductQuantizer::knn_search'.
+    auto knn_search(const TensorView_<float, 2>& queries,
+                    int num_nearest_neighbors,
+                    TensorView_<int, 2>& nn_indices,
+                    TensorView_<float, 2>& nn_squared_distances,
+                    int num_probes = 8) const -> void;
+
+    //! @{
+    //! @brief Save and load the index in an HDF5 group.
+    auto write(H5File& file, const std::string& group_name) const -> void;
+
+    auto read(H5File& file, const std::string& group_name) -> void;
+    //! @}
+
+  private:
+    auto assign(const float* x) const -> int;
+
+  private:
+    //! @brief Coarse centroids of sizes (L, D).
+    Tensor_<float, 2> _coarse_centroids;
+    ProductQuantizer _pq;
+    std::vector<std::vector<std::uint8_t>> _list_codes;
+    std::vector<std::vector<int>> _list_ids;
+    int _size = 0;
+    int _num_lists = 0;
+  };
+
+  //! @}
+
+  //! @}
+
+}}  // namespace DO::Sara
@@ -24,5 +24,6 @@
 #include <DO/Sara/Features/Utilities.hpp>
 #include <DO/Sara/Features/Draw.hpp>
 #include <DO/Sara/Features/IO.hpp>
+#include <DO/Sara/Features/KeypointStore.hpp>
 
 //! @defgroup Features Features
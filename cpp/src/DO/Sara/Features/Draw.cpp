@@ -19,13 +19,17 @@ using namespace std;
 
 namespace DO { namespace Sara {
 
-  void OERegion::draw(const Color3ub& color, float scale,
-                      const Point2f& offset) const
+  //! Draw the region either in the active window or in a draw list, the
+  //! geometry being the same.
+  template <typename DrawLine, typename DrawEllipse>
+  static void draw_oe_region(const OERegion& f, const Color3ub& color,
+                             float scale, const Point2f& offset,
+                             DrawLine draw_line, DrawEllipse draw_ellipse)
   {
     const auto& z = scale;
 
     // Solve characteristic equation to find eigenvalues
-    auto svd = JacobiSVD<Matrix2f>{shape_matrix, ComputeFullU};
+    auto svd = JacobiSVD<Matrix2f>{f.shape_matrix, ComputeFullU};
     const Vector2f& D = svd.singularValues();
     const Matrix2f& U = svd.matrixU();
 
@@ -47,8 +51,8 @@ namespace DO { namespace Sara {
                             180 / static_cast<float>(M_PI);
 
     // Start and end points of orientation line.
-    const Matrix2f& L = affinity().block(0, 0, 2, 2);
-    const Vector2f& p1 = z * (center() + offset);
+    const Matrix2f& L = f.affinity().block(0, 0, 2, 2);
+    const Vector2f& p1 = z * (f.center() + offset);
     const Vector2f& p2 = p1 + z * sqrt_two * L * Vector2f::UnitX();
 
     // Draw.
@@ -65,10 +69,8 @@ namespace DO { namespace Sara {
     }
     else
     {
-      const auto& z = scale;
       const auto cross_offset = 3.0f;
 
-      const Vector2f& p1 = z * (center() + offset);
       const Vector2f& c1 = p1 - cross_offset * Vector2f::UnitX();
       const Vector2f& c2 = p1 + cross_offset * Vector2f::UnitX();
       const Vector2f& c3 = p1 - cross_offset * Vector2f::UnitY();
@@ -81,4 +83,48 @@ namespace DO { namespace Sara {
     }
   }
 
+  void OERegion::draw(const Color3ub& color, float scale,
+                      const Point2f& offset) const
+  {
+    draw_oe_region(
+        *this, color, scale, offset,
+        [](const Point2f& p1, const Point2f& p2, const Color3ub& c, int w) {
+          Sara::draw_line(p1, p2, c, w);
+        },
+        [](const Point2f& center, float r1, float r2, float degree,
+           const Color3ub& c, int w) {
+          Sara::draw_ellipse(center, r1, r2, degree, c, w);
+        });
+  }
+
+  void draw_oe_regions(ImageDrawList& draw_list, const OERegion* begin,
+                       const OERegion* end, const Color3ub& color, float scale,
+                       const Point2f& offset)
+  {
+    // Each region is drawn with at most 4 primitives.
+    draw_list.reserve(draw_list.size() + 4 * std::distance(begin, end));
+
+    std::for_each(begin, end, [&](const auto& f) {
+      draw_oe_region(
+          f, color, scale, offset,
+          [&](const Point2f& p1, const Point2f& p2, const Color3ub& c,
+              int w) { draw_list.draw_line(p1, p2, c, w); },
+          [&](const Point2f& center, float r1, float r2, float degree,
+              const Color3ub& c, int w) {
+            draw_list.draw_ellipse(center, r1, r2, degree, c, w);
+          });
+    });
+  }
+
+  void draw_oe_regions(ImageView<Rgb8>& image,
+                       const std::vector<OERegion>& features,
+                       const Color3ub& color, float scale,
+                       const Point2f& offset)
+  {
+    auto draw_list = ImageDrawList{};
+    draw_oe_regions(draw_list, features.data(),
+                    features.data() + features.size(), color, scale, offset);
+    draw_list.render(image);
+  }
+
 }}  // namespace DO::Sara
@@ -15,11 +15,14 @@
 
 #include <DO/Sara/Defines.hpp>
 
+#include <DO/Sara/Core/Image.hpp>
 #include <DO/Sara/Features/Feature.hpp>
 
 
 namespace DO { namespace Sara {
 
+  class ImageDrawList;
+
   /*!
    *  @addtogroup Features
    *  @{
@@ -40,6 +43,21 @@ namespace DO { namespace Sara {
                     scale, offset);
   }
 
+  //! @brief Record the regions in a draw list, to draw them at once on an
+  //! image.
+  DO_SARA_EXPORT
+  void draw_oe_regions(ImageDrawList& draw_list, const OERegion* begin,
+                       const OERegion* end, const Color3ub& color,
+                       float scale = 1.f,
+                       const Point2f& offset = Point2f::Zero());
+
+  //! @brief Draw the regions on an image with a single draw list.
+  DO_SARA_EXPORT
+  void draw_oe_regions(ImageView<Rgb8>& image,
+                       const std::vector<OERegion>& features,
+                       const Color3ub& color, float scale = 1.f,
+                       const Point2f& offset = Point2f::Zero());
+
 
   //! @}
 
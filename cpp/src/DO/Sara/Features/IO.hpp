@@ -157,14 +157,37 @@ namespace DO { namespace Sara {
     return {features, descriptors};
   }
 
+  //! @brief Read only the keypoints in the range [first, first + count).
+  inline auto read_keypoints(H5File& h5_file, const std::string& group_name,
+                             int first, int count)
+      -> KeypointList<OERegion, float>
+  {
+    const auto descriptor_dim = static_cast<int>(
+        h5_file.read_dataset_sizes(
+            H5::DataSet{h5_file.file->openDataSet(group_name + "/" +
+                                                  "descriptors")})(1));
+
+    auto features = std::vector<OERegion>(count);
+    auto descriptors = Tensor_<float, 2>{count, descriptor_dim};
+
+    h5_file.read_dataset_rows(group_name + "/" + "features", first,
+                              tensor_view(features));
+    h5_file.read_dataset_rows(group_name + "/" + "descriptors", first,
+                              descriptors);
+
+    return {features, descriptors};
+  }
+
   inline auto write_keypoints(H5File& h5_file, const std::string& group_name,
                               const KeypointList<OERegion, float>& keys,
-                              bool overwrite = false)
+                              bool overwrite = false,
+                              const H5DatasetOptions& options = {})
   {
     const auto& [f, v] = keys;
     h5_file.write_dataset(group_name + "/" + "features", tensor_view(f),
-                          overwrite);
-    h5_file.write_dataset(group_name + "/" + "descriptors", v, overwrite);
+                          overwrite, options);
+    h5_file.write_dataset(group_name + "/" + "descriptors", v, overwrite,
+                          options);
   }
   //! @}
 
@@ -0,0 +1,492 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <DO/Sara/Features/IO.hpp>
+#include <DO/Sara/Features/KeypointStore.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+
+namespace DO { namespace Sara {
+
+  static constexpr char keypoint_store_magic[8] = {'S', 'A', 'R', 'A',
+                                                   'K', 'P', 'S', '\0'};
+  static constexpr std::uint32_t keypoint_store_version = 1;
+
+  static_assert(sizeof(KeypointStoreHeader) == 64,
+                "The keypoint store header must span exactly 64 bytes!");
+  static_assert(sizeof(KeypointStoreIndexEntry) % 8 == 0,
+                "The index entries must be 8-byte aligned!");
+
+
+  // ======================================================================== //
+  // Keypoint list view.
+  auto KeypointListView::feature(int i) const -> OERegion
+  {
+    auto f = OERegion{};
+    f.coords << coords(i, 0), coords(i, 1);
+    std::copy(&shape_matrices(i, 0), &shape_matrices(i, 0) + 4,
+              f.shape_matrix.data());
+    f.orientation = orientations(i);
+    f.extremum_value = extremum_values(i);
+    f.type = static_cast<OERegion::Type>(types(i));
+    f.extremum_type = static_cast<OERegion::ExtremumType>(extremum_types(i));
+    return f;
+  }
+
+  auto KeypointListView::features() const -> std::vector<OERegion>
+  {
+    auto f = std::vector<OERegion>(size());
+    for (auto i = 0; i < size(); ++i)
+      f[i] = feature(i);
+    return f;
+  }
+
+  auto KeypointListView::float_descriptors() const -> Tensor_<float, 2>
+  {
+    auto d = Tensor_<float, 2>{size(), descriptor_dimension()};
+    if (!quantized())
+    {
+      std::copy(descriptors.begin(), descriptors.end(), d.begin());
+      return d;
+    }
+
+    const auto q = quantized_descriptors.data();
+    const auto n = static_cast<int>(quantized_descriptors.size());
+#pragma omp parallel for
+    for (int i = 0; i < n; ++i)
+      d.data()[i] = descriptor_offset + descriptor_scale * q[i];
+    return d;
+  }
+
+
+  // ======================================================================== //
+  // Keypoint store writer.
+  KeypointStoreWriter::KeypointStoreWriter(const std::string& filepath,
+                                           bool quantize_descriptors)
+    : _file{filepath, std::ios::binary | std::ios::trunc}
+    , _quantize_descriptors{quantize_descriptors}
+  {
+    if (!_file.is_open())
+      throw std::runtime_error{"Error: cannot create keypoint store \"" +
+                               filepath + "\"!"};
+
+    // Reserve the header, which is written when the file is closed.
+    const auto header = KeypointStoreHeader{};
+    write_section(&header, sizeof(header));
+  }
+
+  KeypointStoreWriter::~KeypointStoreWriter()
+  {
+    try
+    {
+      close();
+    }
+    catch (const std::exception& e)
+    {
+      std::cerr << e.what() << std::endl;
+    }
+  }
+
+  auto KeypointStoreWriter::write(const std::string& name,
+                                  const KeypointList<OERegion, float>& keys)
+      -> void
+  {
+    if (!_file.is_open())
+      throw std::runtime_error{"Error: the keypoint store is closed!"};
+    if (_name_to_index.find(name) != _name_to_index.end())
+      throw std::runtime_error{"Error: keypoints of \"" + name +
+                               "\" are already stored!"};
+
+    const auto& [f, d] = keys;
+    const auto n = static_cast<int>(f.size());
+    if (n != d.rows())
+      throw std::runtime_error{
+          "Error: the numbers of features and descriptors differ!"};
+
+    auto entry = KeypointStoreIndexEntry{};
+    entry.name_offset = _names.size();
+    entry.name_length = static_cast<std::uint32_t>(name.size());
+    entry.num_keypoints = static_cast<std::uint32_t>(n);
+    entry.descriptor_dim = static_cast<std::uint32_t>(d.cols());
+    entry.descriptor_scale = 1.f;
+
+    // Split the features into sections.
+    auto coords = std::vector<float>(2 * n);
+    auto shape_matrices = std::vector<float>(4 * n);
+    auto orientations = std::vector<float>(n);
+    auto extremum_values = std::vector<float>(n);
+    auto types = std::vector<std::uint8_t>(n);
+    auto extremum_types = std::vector<std::int8_t>(n);
+    for (auto i = 0; i < n; ++i)
+    {
+      coords[2 * i] = f[i].x();
+      coords[2 * i + 1] = f[i].y();
+      std::copy(f[i].shape_matrix.data(), f[i].shape_matrix.data() + 4,
+                &shape_matrices[4 * i]);
+      orientations[i] = f[i].orientation;
+      extremum_values[i] = f[i].extremum_value;
+      types[i] = static_cast<std::uint8_t>(f[i].type);
+      extremum_types[i] = static_cast<std::int8_t>(f[i].extremum_type);
+    }
+
+    entry.coords_offset = write_section(coords.data(), 2 * n * sizeof(float));
+    entry.shape_matrices_offset =
+        write_section(shape_matrices.data(), 4 * n * sizeof(float));
+    entry.orientations_offset =
+        write_section(orientations.data(), n * sizeof(float));
+    entry.extremum_values_offset =
+        write_section(extremum_values.data(), n * sizeof(float));
+    entry.types_offset = write_section(types.data(), n);
+    entry.extremum_types_offset = write_section(extremum_types.data(), n);
+
+    if (!_quantize_descriptors)
+    {
+      entry.descriptor_type = KeypointStoreIndexEntry::Float32;
+      entry.descriptors_offset =
+          write_section(d.data(), d.size() * sizeof(float));
+    }
+    else
+    {
+      // Affine quantization on the value range of the image descriptors.
+      const auto [min_it, max_it] = std::minmax_element(d.begin(), d.end());
+      const auto vmin = d.size() > 0 ? *min_it : 0.f;
+      const auto vmax = d.size() > 0 ? *max_it : 0.f;
+
+      entry.descriptor_type = KeypointStoreIndexEntry::UInt8;
+      entry.descriptor_offset = vmin;
+      entry.descriptor_scale = vmax > vmin ? (vmax - vmin) / 255.f : 1.f;
+
+      const auto inv_scale = 1.f / entry.descriptor_scale;
+      auto q = std::vector<std::uint8_t>(d.size());
+      std::transform(d.begin(), d.end(), q.begin(), [&](float v) {
+        const auto code = std::lround((v - vmin) * inv_scale);
+        return static_cast<std::uint8_t>(std::clamp(code, 0l, 255l));
+      });
+      entry.descriptors_offset = write_section(q.data(), q.size());
+    }
+
+    _name_to_index[name] = static_cast<int>(_index.size());
+    _names += name;
+    _index.push_back(entry);
+  }
+
+  auto KeypointStoreWriter::close() -> void
+  {
+    if (!_file.is_open())
+      return;
+
+    auto header = KeypointStoreHeader{};
+    std::memcpy(header.magic, keypoint_store_magic, sizeof(header.magic));
+    header.version = keypoint_store_version;
+    header.num_images = static_cast<std::uint32_t>(_index.size());
+    header.names_offset = write_section(_names.data(), _names.size());
+    header.index_offset = write_section(
+        _index.data(), _index.size() * sizeof(KeypointStoreIndexEntry));
+    header.file_size = _offset;
+
+    _file.seekp(0);
+    _file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    _file.close();
+    if (_file.fail())
+      throw std::runtime_error{"Error: failed to write the keypoint store!"};
+  }
+
+  auto KeypointStoreWriter::pad() -> void
+  {
+    static const char zeros[alignment] = {};
+    const auto padding = (alignment - _offset % alignment) % alignment;
+    _file.write(zeros, padding);
+    _offset += padding;
+  }
+
+  auto KeypointStoreWriter::write_section(const void* data,
+                                          std::uint64_t num_bytes)
+      -> std::uint64_t
+  {
+    pad();
+    const auto offset = _offset;
+    _file.write(reinterpret_cast<const char*>(data), num_bytes);
+    if (_file.fail())
+      throw std::runtime_error{"Error: failed to write the keypoint store!"};
+    _offset += num_bytes;
+    return offset;
+  }
+
+
+  // ======================================================================== //
+  // Keypoint store reader.
+  KeypointStore::KeypointStore(const std::string& filepath)
+  {
+#ifdef _WIN32
+    _file_handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                               nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (_file_handle == INVALID_HANDLE_VALUE)
+    {
+      _file_handle = nullptr;
+      throw std::runtime_error{"Error: cannot open keypoint store \"" +
+                               filepath + "\"!"};
+    }
+
+    auto file_size = LARGE_INTEGER{};
+    GetFileSizeEx(_file_handle, &file_size);
+    _size = static_cast<std::uint64_t>(file_size.QuadPart);
+
+    _mapping_handle = CreateFileMappingA(_file_handle, nullptr, PAGE_WRITECOPY,
+                                         0, 0, nullptr);
+    if (_mapping_handle != nullptr)
+      _data = reinterpret_cast<std::uint8_t*>(
+          MapViewOfFile(_mapping_handle, FILE_MAP_COPY, 0, 0, 0));
+    if (_data == nullptr)
+    {
+      unmap();
+      throw std::runtime_error{"Error: cannot map keypoint store \"" +
+                               filepath + "\"!"};
+    }
+#else
+    const auto fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw std::runtime_error{"Error: cannot open keypoint store \"" +
+                               filepath + "\"!"};
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+    {
+      ::close(fd);
+      throw std::runtime_error{"Error: cannot read keypoint store \"" +
+                               filepath + "\"!"};
+    }
+    _size = static_cast<std::uint64_t>(file_stat.st_size);
+
+    auto ptr = mmap(nullptr, _size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // The mapping stays valid after the file descriptor is closed.
+    ::close(fd);
+    if (ptr == MAP_FAILED)
+    {
+      _size = 0;
+      throw std::runtime_error{"Error: cannot map keypoint store \"" +
+                               filepath + "\"!"};
+    }
+    _data = reinterpret_cast<std::uint8_t*>(ptr);
+#endif
+
+    // Validate the header and the index before exposing any view.
+    auto header = KeypointStoreHeader{};
+    if (_size >= sizeof(header))
+      std::memcpy(&header, _data, sizeof(header));
+
+    const auto index_bytes =
+        std::uint64_t{header.num_images} * sizeof(KeypointStoreIndexEntry);
+    if (_size < sizeof(header) ||
+        std::memcmp(header.magic, keypoint_store_magic,
+                    sizeof(header.magic)) != 0 ||
+        header.version != keypoint_store_version ||
+        header.file_size != _size || header.index_offset > _size ||
+        index_bytes > _size - header.index_offset ||
+        header.names_offset > _size)
+    {
+      unmap();
+      throw std::runtime_error{"Error: \"" + filepath +
+                               "\" is not a valid keypoint store!"};
+    }
+
+    _index.resize(header.num_images);
+    std::memcpy(_index.data(), _data + header.index_offset, index_bytes);
+
+    _names.reserve(_index.size());
+    for (auto i = 0u; i < _index.size(); ++i)
+    {
+      const auto& e = _index[i];
+      const auto n = std::uint64_t{e.num_keypoints};
+      const auto descriptor_bytes =
+          n * e.descriptor_dim *
+          (e.descriptor_type == KeypointStoreIndexEntry::UInt8 ? 1
+                                                               : sizeof(float));
+      const auto in_bounds = [this](std::uint64_t offset,
+                                    std::uint64_t num_bytes) {
+        return offset <= _size && num_bytes <= _size - offset;
+      };
+      if (!in_bounds(header.names_offset + e.name_offset, e.name_length) ||
+          !in_bounds(e.coords_offset, 2 * n * sizeof(float)) ||
+          !in_bounds(e.shape_matrices_offset, 4 * n * sizeof(float)) ||
+          !in_bounds(e.orientations_offset, n * sizeof(float)) ||
+          !in_bounds(e.extremum_values_offset, n * sizeof(float)) ||
+          !in_bounds(e.types_offset, n) ||
+          !in_bounds(e.extremum_types_offset, n) ||
+          !in_bounds(e.descriptors_offset, descriptor_bytes))
+      {
+        unmap();
+        throw std::runtime_error{"Error: the index of keypoint store \"" +
+                                 filepath + "\" is corrupted!"};
+      }
+
+      _names.emplace_back(
+          reinterpret_cast<const char*>(_data + header.names_offset +
+                                        e.name_offset),
+          e.name_length);
+      _name_to_index[_names.back()] = static_cast<int>(i);
+    }
+  }
+
+  KeypointStore::KeypointStore(KeypointStore&& other) noexcept
+  {
+    swap(other);
+  }
+
+  KeypointStore::~KeypointStore()
+  {
+    unmap();
+  }
+
+  KeypointStore& KeypointStore::operator=(KeypointStore&& other) noexcept
+  {
+    unmap();
+    swap(other);
+    return *this;
+  }
+
+  auto KeypointStore::operator[](int i) const -> KeypointListView
+  {
+    if (i < 0 || i >= size())
+      throw std::out_of_range{"Error: keypoint store index out of range!"};
+
+    const auto& e = _index[i];
+    const auto n = static_cast<int>(e.num_keypoints);
+    const auto d = static_cast<int>(e.descriptor_dim);
+
+    const auto section = [this](std::uint64_t offset) {
+      return _data + offset;
+    };
+
+    const auto descriptors =
+        e.descriptor_type == KeypointStoreIndexEntry::Float32
+            ? reinterpret_cast<float*>(section(e.descriptors_offset))
+            : nullptr;
+    const auto quantized_descriptors =
+        e.descriptor_type == KeypointStoreIndexEntry::UInt8
+            ? section(e.descriptors_offset)
+            : nullptr;
+
+    // N.B.: views must be constructed in place since the assignment operator
+    // of views copies the data.
+    return KeypointListView{
+        TensorView_<float, 2>{
+            reinterpret_cast<float*>(section(e.coords_offset)), {n, 2}},
+        TensorView_<float, 2>{
+            reinterpret_cast<float*>(section(e.shape_matrices_offset)),
+            {n, 4}},
+        TensorView_<float, 1>{
+            reinterpret_cast<float*>(section(e.orientations_offset)), n},
+        TensorView_<float, 1>{
+            reinterpret_cast<float*>(section(e.extremum_values_offset)), n},
+        TensorView_<std::uint8_t, 1>{section(e.types_offset), n},
+        TensorView_<std::int8_t, 1>{
+            reinterpret_cast<std::int8_t*>(section(e.extremum_types_offset)),
+            n},
+        descriptors != nullptr ? TensorView_<float, 2>{descriptors, {n, d}}
+                               : TensorView_<float, 2>{},
+        quantized_descriptors != nullptr
+            ? TensorView_<std::uint8_t, 2>{quantized_descriptors, {n, d}}
+            : TensorView_<std::uint8_t, 2>{},
+        e.descriptor_offset, e.descriptor_scale};
+  }
+
+  auto KeypointStore::operator[](const std::string& name) const
+      -> KeypointListView
+  {
+    const auto it = _name_to_index.find(name);
+    if (it == _name_to_index.end())
+      throw std::out_of_range{"Error: no keypoints stored for \"" + name +
+                              "\"!"};
+    return (*this)[it->second];
+  }
+
+  auto KeypointStore::swap(KeypointStore& other) noexcept -> void
+  {
+    std::swap(_data, other._data);
+    std::swap(_size, other._size);
+#ifdef _WIN32
+    std::swap(_file_handle, other._file_handle);
+    std::swap(_mapping_handle, other._mapping_handle);
+#endif
+    _index.swap(other._index);
+    _names.swap(other._names);
+    _name_to_index.swap(other._name_to_index);
+  }
+
+  auto KeypointStore::unmap() -> void
+  {
+#ifdef _WIN32
+    if (_data != nullptr)
+      UnmapViewOfFile(_data);
+    if (_mapping_handle != nullptr)
+      CloseHandle(_mapping_handle);
+    if (_file_handle != nullptr)
+      CloseHandle(_file_handle);
+    _mapping_handle = nullptr;
+    _file_handle = nullptr;
+#else
+    if (_data != nullptr)
+      munmap(_data, _size);
+#endif
+    _data = nullptr;
+    _size = 0;
+    _index.clear();
+    _names.clear();
+    _name_to_index.clear();
+  }
+
+
+  auto read_keypoints(H5File& h5_file,
+                      const std::vector<std::string>& group_names)
+      -> std::vector<KeypointList<OERegion, float>>
+  {
+    auto keypoints = std::vector<KeypointList<OERegion, float>>{};
+    keypoints.reserve(group_names.size());
+
+    const auto store_path = keypoint_store_path(h5_file.file->getFileName());
+    if (std::ifstream{store_path}.good())
+    {
+      const auto store = KeypointStore{store_path};
+      const auto complete = std::all_of(
+          group_names.begin(), group_names.end(),
+          [&](const auto& group_name) { return store.contains(group_name); });
+      if (complete)
+      {
+        for (const auto& group_name : group_names)
+          keypoints.push_back(store[group_name].keypoint_list());
+        return keypoints;
+      }
+    }
+
+    for (const auto& group_name : group_names)
+      keypoints.push_back(read_keypoints(h5_file, group_name));
+    return keypoints;
+  }
+
+}}  // namespace DO::Sara
@@ -0,0 +1,288 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <DO/Sara/Core/HDF5.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+
+#include <DO/Sara/Features/Feature.hpp>
+#include <DO/Sara/Features/KeypointList.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace DO { namespace Sara {
+
+  /*!
+   *  @addtogroup Features
+   *  @{
+   */
+
+  //! @name Memory-mapped keypoint store
+  //! @{
+
+  /*!
+    @brief Keypoint store file header.
+
+    The file layout is:
+    - the header,
+    - for each image, the 64-byte aligned sections of its keypoints in
+      structure-of-arrays layout: coordinates, shape matrices, orientations,
+      extremum values, types, extremum types and descriptors,
+    - the string table of the image names,
+    - the index, i.e., one entry per image.
+
+    All values are stored in native byte order.
+   */
+  struct KeypointStoreHeader
+  {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t num_images;
+    std::uint64_t index_offset;
+    std::uint64_t names_offset;
+    std::uint64_t file_size;
+    std::uint8_t reserved[24];
+  };
+
+  //! @brief Keypoint store index entry.
+  struct KeypointStoreIndexEntry
+  {
+    enum DescriptorType : std::uint32_t
+    {
+      Float32 = 0,
+      UInt8 = 1
+    };
+
+    std::uint64_t name_offset;
+    std::uint32_t name_length;
+    std::uint32_t num_keypoints;
+    std::uint32_t descriptor_dim;
+    std::uint32_t descriptor_type;
+    //! @brief Affine dequantization: value = offset + scale * code.
+    float descriptor_offset;
+    float descriptor_scale;
+
+    std::uint64_t coords_offset;
+    std::uint64_t shape_matrices_offset;
+    std::uint64_t orientations_offset;
+    std::uint64_t extremum_values_offset;
+    std::uint64_t types_offset;
+    std::uint64_t extremum_types_offset;
+    std::uint64_t descriptors_offset;
+  };
+
+
+  /*!
+    @brief View on the keypoints of one image stored in a keypoint store.
+
+    The tensor views point directly into the file mapping and are only valid
+    as long as the store is alive. Exactly one of 'descriptors' and
+    'quantized_descriptors' is non-empty, unless the image has no keypoints.
+   */
+  struct KeypointListView
+  {
+    //! @brief N x 2 keypoint coordinates.
+    TensorView_<float, 2> coords;
+    //! @brief N x 4 shape matrices in column-major order.
+    TensorView_<float, 2> shape_matrices;
+    TensorView_<float, 1> orientations;
+    TensorView_<float, 1> extremum_values;
+    TensorView_<std::uint8_t, 1> types;
+    TensorView_<std::int8_t, 1> extremum_types;
+
+    //! @brief N x D float descriptors.
+    TensorView_<float, 2> descriptors;
+    //! @brief N x D uint8-quantized descriptors.
+    TensorView_<std::uint8_t, 2> quantized_descriptors;
+    float descriptor_offset = 0.f;
+    float descriptor_scale = 1.f;
+
+    //! @brief Number of keypoints.
+    auto size() const -> int
+    {
+      return coords.rows();
+    }
+
+    //! @brief Descriptor dimension.
+    auto descriptor_dimension() const -> int
+    {
+      return descriptors.empty() ? quantized_descriptors.cols()
+                                 : descriptors.cols();
+    }
+
+    auto quantized() const -> bool
+    {
+      return !quantized_descriptors.empty();
+    }
+
+    //! @brief Assemble the i-th feature.
+    DO_SARA_EXPORT
+    auto feature(int i) const -> OERegion;
+
+    //! @brief Assemble all the features.
+    DO_SARA_EXPORT
+    auto features() const -> std::vector<OERegion>;
+
+    //! @brief Copy or dequantize the descriptors.
+    DO_SARA_EXPORT
+    auto float_descriptors() const -> Tensor_<float, 2>;
+
+    //! @brief Copy the keypoints into an owning keypoint list.
+    auto keypoint_list() const -> KeypointList<OERegion, float>
+    {
+      return {features(), float_descriptors()};
+    }
+  };
+
+
+  //! @brief Write keypoints sequentially into a keypoint store file.
+  class DO_SARA_EXPORT KeypointStoreWriter
+  {
+  public:
+    static constexpr std::uint64_t alignment = 64;
+
+    //! @brief Create the file. Descriptors can optionally be quantized on 8
+    //! bits, which divides their storage by four.
+    KeypointStoreWriter(const std::string& filepath,
+                        bool quantize_descriptors = false);
+
+    KeypointStoreWriter(const KeypointStoreWriter&) = delete;
+
+    //! @brief Finalize the file if needed.
+    ~KeypointStoreWriter();
+
+    KeypointStoreWriter& operator=(const KeypointStoreWriter&) = delete;
+
+    //! @brief Append the keypoints of an image.
+    auto write(const std::string& name,
+               const KeypointList<OERegion, float>& keys) -> void;
+
+    //! @brief Write the name table and the index and close the file.
+    auto close() -> void;
+
+  private:
+    auto pad() -> void;
+    auto write_section(const void* data, std::uint64_t num_bytes)
+        -> std::uint64_t;
+
+  private:
+    std::ofstream _file;
+    std::uint64_t _offset = 0;
+    bool _quantize_descriptors = false;
+    std::string _names;
+    std::vector<KeypointStoreIndexEntry> _index;
+    std::unordered_map<std::string, int> _name_to_index;
+  };
+
+
+  /*!
+    @brief Read-only keypoint store loaded with a memory mapping.
+
+    Opening the store only parses the header and the index: the keypoint
+    data is paged in lazily by the operating system when it is accessed.
+
+    The mapping is private and copy-on-write, so writing through the views
+    never modifies the file.
+   */
+  class DO_SARA_EXPORT KeypointStore
+  {
+  public:
+    KeypointStore() = default;
+
+    //! @brief Map the file in memory.
+    explicit KeypointStore(const std::string& filepath);
+
+    KeypointStore(const KeypointStore&) = delete;
+
+    KeypointStore(KeypointStore&& other) noexcept;
+
+    //! @brief Unmap the file.
+    ~KeypointStore();
+
+    KeypointStore& operator=(const KeypointStore&) = delete;
+
+    KeypointStore& operator=(KeypointStore&& other) noexcept;
+
+    //! @brief Number of images.
+    auto size() const -> int
+    {
+      return static_cast<int>(_index.size());
+    }
+
+    //! @brief Image names in writing order.
+    auto names() const -> const std::vector<std::string>&
+    {
+      return _names;
+    }
+
+    auto contains(const std::string& name) const -> bool
+    {
+      return _name_to_index.find(name) != _name_to_index.end();
+    }
+
+    //! @{
+    //! @brief Keypoints of an image.
+    auto operator[](int i) const -> KeypointListView;
+
+    auto operator[](const std::string& name) const -> KeypointListView;
+    //! @}
+
+  private:
+    auto swap(KeypointStore& other) noexcept -> void;
+    auto unmap() -> void;
+
+  private:
+    std::uint8_t* _data = nullptr;
+    std::uint64_t _size = 0;
+#ifdef _WIN32
+    void* _file_handle = nullptr;
+    void* _mapping_handle = nullptr;
+#endif
+    std::vector<KeypointStoreIndexEntry> _index;
+    std::vector<std::string> _names;
+    std::unordered_map<std::string, int> _name_to_index;
+  };
+
+
+  //! @brief Path of the keypoint store written next to an HDF5 file.
+  inline auto keypoint_store_path(const std::string& h5_filepath)
+      -> std::string
+  {
+    return h5_filepath + ".keys";
+  }
+
+  /*!
+    @brief Read the keypoints of the images.
+
+    The keypoints are read from the keypoint store written next to the HDF5
+    file if it contains all the images, which is much faster than decoding
+    the HDF5 datasets. Otherwise they are read from the HDF5 file.
+   */
+  DO_SARA_EXPORT
+  auto read_keypoints(H5File& h5_file,
+                      const std::vector<std::string>& group_names)
+      -> std::vector<KeypointList<OERegion, float>>;
+
+  //! @}
+
+  //! @}
+
+}}  // namespace DO::Sara
@@ -26,6 +26,7 @@ namespace DO { namespace Sara {
     // Register painting data types.
     qRegisterMetaType<PaintingWindow *>("PaintingWindow *");
     qRegisterMetaType<QPolygonF>("QPolygonF");
+    qRegisterMetaType<WindowCommandBatch>("WindowCommandBatch");
 
     // Register mesh data structure.
     qRegisterMetaType<SimpleTriangleMesh3f>("SimpleTriangleMesh3f");
@@ -25,6 +25,7 @@ namespace DO::Sara {
     // Register painting data types.
     qRegisterMetaType<PaintingWindow*>("PaintingWindow *");
     qRegisterMetaType<QPolygonF>("QPolygonF");
+    qRegisterMetaType<WindowCommandBatch>("WindowCommandBatch");
 
     // Register mesh data structure.
     qRegisterMetaType<SimpleTriangleMesh3f>("SimpleTriangleMesh3f");
@@ -68,6 +68,12 @@ namespace DO { namespace Sara {
           ));
   }
 
+  void GraphicsView::runCommands(const WindowCommandBatch& batch)
+  {
+    for (const auto& command : *batch.commands)
+      command(this);
+  }
+
   void GraphicsView::waitForEvent(int ms)
   {
     m_eventListeningTimer.setInterval(ms);
@@ -19,6 +19,7 @@
 #include <DO/Sara/Defines.hpp>
 
 #include "../Events.hpp"
+#include "WindowCommandBatch.hpp"
 
 
 namespace DO { namespace Sara {
@@ -44,6 +45,7 @@ namespace DO { namespace Sara {
   public slots:
     void addItem(QGraphicsItem *item, QGraphicsItem *parent = 0);
     void addPixmapItem(const QImage& image, bool randomPos = false);
+    void runCommands(const WindowCommandBatch& batch);
     void waitForEvent(int ms);
     void eventListeningTimerStopped();
 
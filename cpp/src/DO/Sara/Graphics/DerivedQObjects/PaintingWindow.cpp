@@ -378,6 +378,14 @@ namespace DO { namespace Sara {
     m_scrollArea->resize(width+2, height+2);
   }
 
+  void PaintingWindow::runCommands(const WindowCommandBatch& batch)
+  {
+    // Each drawing slot only schedules a repaint, so the window is repainted
+    // once for the whole batch.
+    for (const auto& command : *batch.commands)
+      command(this);
+  }
+
   void PaintingWindow::waitForEvent(int ms)
   {
     m_eventListeningTimer.setInterval(ms);
@@ -21,6 +21,7 @@
 
 #include <DO/Sara/Defines.hpp>
 #include <DO/Sara/Graphics/Events.hpp>
+#include <DO/Sara/Graphics/DerivedQObjects/WindowCommandBatch.hpp>
 
 
 class QPixmap;
@@ -120,6 +121,9 @@ namespace DO { namespace Sara {
     // Resize screen.
     void resizeScreen(int width, int height);
 
+    // Run the painting commands batched by the user thread.
+    void runCommands(const WindowCommandBatch& batch);
+
   public slots: /* event management slots */
     void waitForEvent(int ms);
     void eventListeningTimerStopped();
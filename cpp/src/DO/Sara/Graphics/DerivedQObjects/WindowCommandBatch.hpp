@@ -0,0 +1,52 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <QMetaType>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+
+class QWidget;
+
+
+namespace DO { namespace Sara {
+
+  /*!
+    \addtogroup GraphicsInternal
+
+    @{
+   */
+
+  //! @brief Commands issued by the user thread to a window, which the window
+  //! runs in one go in the GUI thread.
+  struct WindowCommandBatch
+  {
+    using Command = std::function<void(QWidget *)>;
+
+    //! The commands are shared so that the Qt event loop does not copy them
+    //! when queuing the batch.
+    std::shared_ptr<std::vector<Command>> commands =
+        std::make_shared<std::vector<Command>>();
+  };
+
+  //! @}
+
+} /* namespace Sara */
+} /* namespace DO */
+
+
+Q_DECLARE_METATYPE(DO::Sara::WindowCommandBatch)
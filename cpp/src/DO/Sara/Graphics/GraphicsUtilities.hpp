@@ -61,6 +61,12 @@ namespace DO { namespace Sara {
   }
   //! @}
 
+  //! @brief Run the command on the window in the GUI thread.
+  //!
+  //! The command is queued right away, unless the calling thread is batching
+  //! its commands, in which case it is recorded until the next flush_batch().
+  bool run_command(Window w, WindowCommandBatch::Command command);
+
   //! @}
 
 } /* namespace Sara */
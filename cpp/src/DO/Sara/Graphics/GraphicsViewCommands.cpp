@@ -38,6 +38,15 @@ namespace DO { namespace Sara {
 
   QGraphicsPixmapItem *add_pixmap(const Image<Rgb8>& image, bool random_pos)
   {
+    if (is_batching())
+    {
+      const auto qimage = as_QImage(image).copy();
+      run_command(view(), [qimage, random_pos](QWidget *w) {
+        static_cast<GraphicsView *>(w)->addPixmapItem(qimage, random_pos);
+      });
+      return nullptr;
+    }
+
     QImage qimage{as_QImage(image)};
     QMetaObject::invokeMethod(view(), "addPixmapItem",
                               Qt::BlockingQueuedConnection,
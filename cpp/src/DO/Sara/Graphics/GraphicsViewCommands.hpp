@@ -32,6 +32,10 @@ namespace DO { namespace Sara {
   //! The added window can be:
   //! - rescaled by hitting key \b + or key \b -,
   //! - selected and moved in the GraphicsView window using the mouse.
+  //!
+  //! If the calling thread batches its commands (cf. begin_batch()), the
+  //! image is copied and added at the next flush_batch(): the function then
+  //! returns a null pointer.
   DO_SARA_EXPORT
   QGraphicsPixmapItem * add_pixmap(const Image<Rgb8>& I,
                                    bool random_pos = false);
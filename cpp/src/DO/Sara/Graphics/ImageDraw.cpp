@@ -14,6 +14,13 @@
 #include <DO/Sara/Graphics.hpp>
 #include <DO/Sara/Graphics/GraphicsUtilities.hpp>
 
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
 
 namespace DO { namespace Sara {
 
@@ -74,5 +81,184 @@ namespace DO { namespace Sara {
     p.fillPath(path, to_QColor(c));
   }
 
+
+  void ImageDrawList::draw_point(int x, int y, const Color3ub& c)
+  {
+    _primitives.push_back({Primitive::Point, Point2f(x, y), Point2f::Zero(),
+                           0.f, c, 1, false});
+  }
+
+  void ImageDrawList::draw_line(const Point2f& p1, const Point2f& p2,
+                                const Color3ub& c, int pen_width,
+                                bool antialiasing)
+  {
+    _primitives.push_back(
+        {Primitive::Line, p1, p2, 0.f, c, pen_width, antialiasing});
+  }
+
+  void ImageDrawList::draw_circle(const Point2f& center, float r,
+                                  const Color3ub& c, int pen_width,
+                                  bool antialiasing)
+  {
+    draw_ellipse(center, r, r, 0.f, c, pen_width, antialiasing);
+  }
+
+  void ImageDrawList::draw_ellipse(const Point2f& center, float r1, float r2,
+                                   float degree, const Color3ub& c,
+                                   int pen_width, bool antialiasing)
+  {
+    _primitives.push_back({Primitive::Ellipse, center, Point2f(r1, r2),
+                           degree, c, pen_width, antialiasing});
+  }
+
+  void ImageDrawList::draw_rect(int x, int y, int w, int h, const Color3ub& c,
+                                int pen_width)
+  {
+    _primitives.push_back({Primitive::Rect, Point2f(x, y), Point2f(w, h), 0.f,
+                           c, pen_width, false});
+  }
+
+  void ImageDrawList::fill_rect(int x, int y, int w, int h, const Color3ub& c)
+  {
+    _primitives.push_back({Primitive::FilledRect, Point2f(x, y),
+                           Point2f(w, h), 0.f, c, 0, false});
+  }
+
+  void ImageDrawList::fill_circle(const Point2f& center, float r,
+                                  const Color3ub& c, bool antialiasing)
+  {
+    _primitives.push_back({Primitive::FilledEllipse, center, Point2f(r, r),
+                           0.f, c, 0, antialiasing});
+  }
+
+
+  //! @brief Vertical extent [ymin, ymax] of the pixels a primitive may touch,
+  //! including the pen width and the antialiasing.
+  static auto vertical_extent(const ImageDrawList::Primitive& p)
+      -> std::pair<float, float>
+  {
+    const auto margin = p.pen_width / 2.f + 1.f;
+
+    switch (p.type)
+    {
+    case ImageDrawList::Primitive::Line:
+      return {std::min(p.a.y(), p.b.y()) - margin,
+              std::max(p.a.y(), p.b.y()) + margin};
+    case ImageDrawList::Primitive::Ellipse:
+    case ImageDrawList::Primitive::FilledEllipse:
+    {
+      // Use the larger radius as a bound whatever the orientation.
+      const auto r = std::max(std::abs(p.b.x()), std::abs(p.b.y()));
+      return {p.a.y() - r - margin, p.a.y() + r + margin};
+    }
+    case ImageDrawList::Primitive::Rect:
+    case ImageDrawList::Primitive::FilledRect:
+      return {std::min(p.a.y(), p.a.y() + p.b.y()) - margin,
+              std::max(p.a.y(), p.a.y() + p.b.y()) + margin};
+    case ImageDrawList::Primitive::Point:
+    default:
+      return {p.a.y() - margin, p.a.y() + margin};
+    }
+  }
+
+  static auto paint(QPainter& painter, const ImageDrawList::Primitive& p)
+      -> void
+  {
+    painter.setRenderHint(QPainter::Antialiasing, p.antialiasing);
+
+    const auto color = to_QColor(p.color);
+    switch (p.type)
+    {
+    case ImageDrawList::Primitive::Point:
+      painter.setPen(color);
+      painter.drawPoint(int(p.a.x()), int(p.a.y()));
+      break;
+    case ImageDrawList::Primitive::Line:
+      painter.setPen(QPen(color, p.pen_width));
+      painter.drawLine(QPointF(p.a.x(), p.a.y()), QPointF(p.b.x(), p.b.y()));
+      break;
+    case ImageDrawList::Primitive::Ellipse:
+      painter.setPen(QPen(color, p.pen_width));
+      painter.setBrush(Qt::NoBrush);
+      painter.save();
+      painter.translate(p.a.x(), p.a.y());
+      painter.rotate(p.degree);
+      painter.drawEllipse(QPointF(0, 0), p.b.x(), p.b.y());
+      painter.restore();
+      break;
+    case ImageDrawList::Primitive::Rect:
+      painter.setPen(QPen(color, p.pen_width));
+      painter.setBrush(Qt::NoBrush);
+      painter.drawRect(int(p.a.x()), int(p.a.y()), int(p.b.x()),
+                       int(p.b.y()));
+      break;
+    case ImageDrawList::Primitive::FilledRect:
+      painter.fillRect(int(p.a.x()), int(p.a.y()), int(p.b.x()),
+                       int(p.b.y()), color);
+      break;
+    case ImageDrawList::Primitive::FilledEllipse:
+    {
+      QPainterPath path;
+      path.addEllipse(QPointF(p.a.x(), p.a.y()), p.b.x(), p.b.y());
+      painter.fillPath(path, color);
+      break;
+    }
+    }
+  }
+
+  void ImageDrawList::render(ImageView<Rgb8>& image, int num_bands) const
+  {
+    if (_primitives.empty() || image.width() <= 0 || image.height() <= 0)
+      return;
+
+    if (num_bands <= 0)
+    {
+#ifdef _OPENMP
+      num_bands = omp_get_max_threads();
+#else
+      num_bands = 1;
+#endif
+    }
+    num_bands = std::min(num_bands, image.height());
+    const auto band_height = (image.height() + num_bands - 1) / num_bands;
+    num_bands = (image.height() + band_height - 1) / band_height;
+
+    // Dispatch the primitives to the bands they overlap, in order.
+    auto bands = std::vector<std::vector<int>>(num_bands);
+    for (auto i = 0; i < static_cast<int>(_primitives.size()); ++i)
+    {
+      const auto [ymin, ymax] = vertical_extent(_primitives[i]);
+      if (ymax < 0 || ymin >= image.height())
+        continue;
+
+      const auto b0 = std::max(int(std::floor(ymin)) / band_height, 0);
+      const auto b1 =
+          std::min(int(std::floor(ymax)) / band_height, num_bands - 1);
+      for (auto b = b0; b <= b1; ++b)
+        bands[b].push_back(i);
+    }
+
+    // Each band wraps its rows of the image and the painter is translated so
+    // that the primitives are expressed in the image coordinates.
+#pragma omp parallel for
+    for (auto b = 0; b < num_bands; ++b)
+    {
+      if (bands[b].empty())
+        continue;
+
+      const auto y0 = b * band_height;
+      const auto h = std::min(band_height, image.height() - y0);
+      auto band = QImage{reinterpret_cast<unsigned char*>(image.data()) +
+                             std::size_t(y0) * image.width() * 3,
+                         image.width(), h, image.width() * 3,
+                         QImage::Format_RGB888};
+
+      QPainter painter(&band);
+      painter.translate(0, -y0);
+      for (const auto i : bands[b])
+        paint(painter, _primitives[i]);
+    }
+  }
+
 } /* namespace Sara */
 } /* namespace DO */
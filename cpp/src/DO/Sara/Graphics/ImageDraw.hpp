@@ -13,6 +13,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 
 class QImage;
 
@@ -88,6 +91,109 @@ namespace DO { namespace Sara {
   void fill_circle(ImageView<Rgb8>& image,
                    int x, int y, int r, const Color3ub& c);
 
+
+  /*!
+    @brief Draw list of primitives to rasterize on an image in a single pass.
+
+    Each of the drawing functions above creates a painter for a single
+    primitive, which becomes the bottleneck when drawing thousands of
+    primitives. Instead, the draw list records the primitives and rasterizes
+    them all at once.
+
+    The image is split into horizontal bands, which are rasterized in
+    parallel with one painter per band. Each band only rasterizes the
+    primitives overlapping it, in the order they were recorded.
+
+    The draw list does not need any window and can be used headless.
+   */
+  class DO_SARA_EXPORT ImageDrawList
+  {
+  public:
+    //! @brief Recorded primitive.
+    struct Primitive
+    {
+      enum Type : std::uint8_t
+      {
+        Point,
+        Line,
+        Ellipse,
+        Rect,
+        FilledRect,
+        FilledEllipse
+      };
+
+      Type type;
+      //! @brief Point, start point of the line, center of the ellipse or
+      //! top-left corner of the rectangle.
+      Point2f a;
+      //! @brief End point of the line, radii of the ellipse or sizes of the
+      //! rectangle.
+      Point2f b;
+      //! @brief Orientation of the ellipse in degrees.
+      float degree;
+      Color3ub color;
+      int pen_width;
+      bool antialiasing;
+    };
+
+    //! @{
+    //! @brief Record a primitive.
+    void draw_point(int x, int y, const Color3ub& c);
+
+    void draw_line(const Point2f& p1, const Point2f& p2, const Color3ub& c,
+                   int pen_width = 1, bool antialiasing = true);
+
+    void draw_circle(const Point2f& center, float r, const Color3ub& c,
+                     int pen_width = 1, bool antialiasing = true);
+
+    void draw_ellipse(const Point2f& center, float r1, float r2, float degree,
+                      const Color3ub& c, int pen_width = 1,
+                      bool antialiasing = true);
+
+    void draw_rect(int x, int y, int w, int h, const Color3ub& c,
+                   int pen_width = 1);
+
+    void fill_rect(int x, int y, int w, int h, const Color3ub& c);
+
+    void fill_circle(const Point2f& center, float r, const Color3ub& c,
+                     bool antialiasing = true);
+    //! @}
+
+    //! @brief Rasterize the primitives on the image.
+    //!
+    //! @param[in] num_bands number of horizontal bands, by default one per
+    //! OpenMP thread.
+    void render(ImageView<Rgb8>& image, int num_bands = 0) const;
+
+    auto primitives() const -> const std::vector<Primitive>&
+    {
+      return _primitives;
+    }
+
+    auto size() const -> std::size_t
+    {
+      return _primitives.size();
+    }
+
+    auto empty() const -> bool
+    {
+      return _primitives.empty();
+    }
+
+    auto reserve(std::size_t n) -> void
+    {
+      _primitives.reserve(n);
+    }
+
+    auto clear() -> void
+    {
+      _primitives.clear();
+    }
+
+  private:
+    std::vector<Primitive> _primitives;
+  };
+
   //! @}
 
 } /* namespace Sara */
@@ -12,164 +12,212 @@
 #include <DO/Sara/Graphics.hpp>
 #include <DO/Sara/Graphics/GraphicsUtilities.hpp>
 
+#include <utility>
+#include <vector>
+
 
 namespace DO { namespace Sara {
 
-  bool draw_point(int x, int y, const Color3ub& c)
+  //! @brief Commands batched by a user thread.
+  struct CommandBuffer
+  {
+    //! Number of nested calls to begin_batch().
+    int depth = 0;
+    //! Consecutive commands issued to the same window are grouped together.
+    std::vector<std::pair<Window, WindowCommandBatch>> batches;
+  };
+
+  //! Each thread owns its buffer so that recording needs no lock.
+  static CommandBuffer& command_buffer()
+  {
+    thread_local CommandBuffer buffer;
+    return buffer;
+  }
+
+  static bool send(Window w, const WindowCommandBatch& batch)
   {
     return QMetaObject::invokeMethod(
-      active_window(), "drawPoint",
+      w, "runCommands",
       Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+      Q_ARG(const WindowCommandBatch&, batch));
+  }
+
+  void begin_batch()
+  {
+    ++command_buffer().depth;
+  }
+
+  bool flush_batch()
+  {
+    auto& batches = command_buffer().batches;
+    auto ok = true;
+    for (const auto& [w, batch] : batches)
+      ok = send(w, batch) && ok;
+    batches.clear();
+    return ok;
+  }
+
+  bool end_batch()
+  {
+    auto& buffer = command_buffer();
+    if (buffer.depth == 0)
+      return false;
+    --buffer.depth;
+    return buffer.depth == 0 ? flush_batch() : true;
+  }
+
+  bool is_batching()
+  {
+    return command_buffer().depth > 0;
+  }
+
+  bool run_command(Window w, WindowCommandBatch::Command command)
+  {
+    if (w == nullptr)
+      return false;
+
+    if (!is_batching())
+    {
+      auto batch = WindowCommandBatch{};
+      batch.commands->push_back(std::move(command));
+      return send(w, batch);
+    }
+
+    auto& batches = command_buffer().batches;
+    if (batches.empty() || batches.back().first != w)
+      batches.push_back({w, WindowCommandBatch{}});
+    batches.back().second.commands->push_back(std::move(command));
+    return true;
+  }
+
+  //! @brief Run the command on the window if it is a PaintingWindow.
+  template <typename PaintingCommand>
+  static bool paint(Window w, PaintingCommand command)
+  {
+    auto window = qobject_cast<PaintingWindow *>(w);
+    if (window == nullptr)
+      return false;
+    return run_command(window, [command](QWidget *widget) {
+      command(*static_cast<PaintingWindow *>(widget));
+    });
+  }
+
+  //! @brief Run the command on the active window if it is a PaintingWindow.
+  template <typename PaintingCommand>
+  static bool paint(PaintingCommand command)
+  {
+    return paint(active_window(), command);
+  }
+
+  bool draw_point(int x, int y, const Color3ub& c)
+  {
+    return paint([=](PaintingWindow& w) {
+      w.drawPoint(x, y, QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool draw_point(int x, int y, const Color4ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawPoint",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2], c[3])));
+    return paint([=](PaintingWindow& w) {
+      w.drawPoint(x, y, QColor(c[0], c[1], c[2], c[3]));
+    });
   }
 
   bool draw_point(const Point2f& p, const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawPoint",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(p.x(), p.y())),
-      Q_ARG(const QColor&,
-      QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& w) {
+      w.drawPoint(QPointF(p.x(), p.y()), QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool draw_circle(int xc, int yc, int r, const Color3ub& c, int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawCircle",
-      Qt::QueuedConnection,
-      Q_ARG(int, xc), Q_ARG(int, yc),
-      Q_ARG(int, r),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawCircle(xc, yc, r, QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_circle(const Point2f& center, float r, const Color3ub& c,
                    int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawCircle",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(center.x(), center.y())),
-      Q_ARG(qreal, r),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawCircle(QPointF(center.x(), center.y()), qreal(r),
+                   QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_circle(const Point2d& center, double r, const Color3ub& c,
                    int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawCircle",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(center.x(), center.y())),
-      Q_ARG(qreal, r),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawCircle(QPointF(center.x(), center.y()), qreal(r),
+                   QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_ellipse(int x, int y, int w, int h, const Color3ub&c, int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawEllipse",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(int, w), Q_ARG(int, h),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& win) {
+      win.drawEllipse(x, y, w, h, QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_ellipse(const Point2f& center, float r1, float r2, float degree,
                     const Color3ub& c, int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawEllipse",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(center.x(), center.y())),
-      Q_ARG(qreal, qreal(r1)), Q_ARG(qreal, qreal(r2)),
-      Q_ARG(qreal, qreal(degree)),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawEllipse(QPointF(center.x(), center.y()), qreal(r1), qreal(r2),
+                    qreal(degree), QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_ellipse(const Point2d& center, double r1, double r2, double degree,
                     const Color3ub& c, int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawEllipse",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(center.x(), center.y())),
-      Q_ARG(qreal, qreal(r1)), Q_ARG(qreal, qreal(r2)),
-      Q_ARG(qreal, qreal(degree)),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawEllipse(QPointF(center.x(), center.y()), qreal(r1), qreal(r2),
+                    qreal(degree), QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_line(int x1, int y1, int x2, int y2, const Color3ub& c,
                  int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawLine",
-      Qt::QueuedConnection,
-      Q_ARG(int, x1), Q_ARG(int, y1),
-      Q_ARG(int, x2), Q_ARG(int, y2),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawLine(x1, y1, x2, y2, QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_line(const Point2f& p1, const Point2f& p2, const Color3ub& c,
                  int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawLine",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(p1.x(), p1.y())),
-      Q_ARG(const QPointF&, QPointF(p2.x(), p2.y())),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawLine(QPointF(p1.x(), p1.y()), QPointF(p2.x(), p2.y()),
+                 QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_line(const Point2d& p1, const Point2d& p2, const Color3ub& c,
                  int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawLine",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(p1.x(), p1.y())),
-      Q_ARG(const QPointF&, QPointF(p2.x(), p2.y())),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& w) {
+      w.drawLine(QPointF(p1.x(), p1.y()), QPointF(p2.x(), p2.y()),
+                 QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   bool draw_rect(int x, int y, int w, int h, const Color3ub& c, int penWidth)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawRect",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(int, w), Q_ARG(int, h),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, penWidth));
+    return paint([=](PaintingWindow& win) {
+      win.drawRect(x, y, w, h, QColor(c[0], c[1], c[2]), penWidth);
+    });
   }
 
   static bool draw_poly(const QPolygonF& poly, const Color3ub& c, int width)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawPoly",
-      Qt::QueuedConnection,
-      Q_ARG(const QPolygonF&, poly),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, width));
+    return paint([=](PaintingWindow& w) {
+      w.drawPoly(poly, QColor(c[0], c[1], c[2]), width);
+    });
   }
 
   bool draw_poly(const int x[], const int y[], int n, const Color3ub& c,
@@ -193,92 +241,65 @@ namespace DO { namespace Sara {
                    int fontSize, double alpha, bool italic, bool bold,
                    bool underlined)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawText",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(const QString&, QString(s.c_str())),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])),
-      Q_ARG(int, fontSize),
-      Q_ARG(qreal, qreal(alpha)),
-      Q_ARG(bool, italic), Q_ARG(bool, bold),
-      Q_ARG(bool, underlined));
+    const auto text = QString(s.c_str());
+    return paint([=](PaintingWindow& w) {
+      w.drawText(x, y, text, QColor(c[0], c[1], c[2]), fontSize,
+                 qreal(alpha), italic, bold, underlined);
+    });
   }
 
   bool draw_arrow(int a, int b, int c, int d, const Color3ub& col,
                   int arrowWidth, int arrowHeight, int style, int width)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "drawArrow",
-      Qt::QueuedConnection,
-      Q_ARG(int, a), Q_ARG(int, b),
-      Q_ARG(int, c), Q_ARG(int, d),
-      Q_ARG(const QColor&, QColor(col[0], col[1], col[2])),
-      Q_ARG(int, arrowWidth),
-      Q_ARG(int, arrowHeight),
-      Q_ARG(int, style), Q_ARG(int, width));
+    return paint([=](PaintingWindow& w) {
+      w.drawArrow(a, b, c, d, QColor(col[0], col[1], col[2]), arrowWidth,
+                  arrowHeight, style, width);
+    });
   }
 
   bool fill_ellipse(int x, int y, int w, int h, const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "fillEllipse",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(int, w), Q_ARG(int, h),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& win) {
+      win.fillEllipse(x, y, w, h, QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool fill_ellipse(const Point2f& p, float rx, float ry, float degree,
                    const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "fillEllipse",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPointF(p.x(), p.y())),
-      Q_ARG(qreal, rx),
-      Q_ARG(qreal, ry),
-      Q_ARG(qreal, degree),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& w) {
+      w.fillEllipse(QPointF(p.x(), p.y()), qreal(rx), qreal(ry),
+                    qreal(degree), QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool fill_rect(int x, int y, int w, int h, const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "fillRect",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(int, w), Q_ARG(int, h),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& win) {
+      win.fillRect(x, y, w, h, QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool fill_circle(int x, int y, int r, const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "fillCircle",
-      Qt::QueuedConnection,
-      Q_ARG(int, x), Q_ARG(int, y),
-      Q_ARG(int, r),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& w) {
+      w.fillCircle(x, y, r, QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool fill_circle(const Point2f& p, float r, const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "fillCircle",
-      Qt::QueuedConnection,
-      Q_ARG(const QPointF&, QPoint(p.x(), p.y())),
-      Q_ARG(qreal, r),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& w) {
+      w.fillCircle(QPointF(QPoint(p.x(), p.y())), qreal(r),
+                   QColor(c[0], c[1], c[2]));
+    });
   }
 
   static bool fill_poly(const QPolygonF& polygon, const Color3ub& c)
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "fillPoly",
-      Qt::QueuedConnection,
-      Q_ARG(const QPolygonF&, polygon),
-      Q_ARG(const QColor&, QColor(c[0], c[1], c[2])));
+    return paint([=](PaintingWindow& w) {
+      w.fillPoly(polygon, QColor(c[0], c[1], c[2]));
+    });
   }
 
   bool fill_poly(const int x[], const int y[], int n, const Color3ub& c)
@@ -307,6 +328,20 @@ namespace DO { namespace Sara {
 
   static bool display(const QImage& image, int xoff, int yoff, double fact)
   {
+    // The image wraps the user data, which must stay valid until the image
+    // is displayed: in batch mode, the image is copied instead of waiting
+    // for the GUI thread.
+    if (is_batching())
+    {
+      // A new image starts a new frame: hand the commands of the previous
+      // frame over to the windows, so that each frame is repainted once.
+      const auto ok = flush_batch();
+      const auto image_copy = image.copy();
+      return paint([=](PaintingWindow& w) {
+        w.display(image_copy, xoff, yoff, fact);
+      }) && ok;
+    }
+
     return QMetaObject::invokeMethod(
       active_window(), "display",
       Qt::BlockingQueuedConnection,
@@ -336,31 +371,32 @@ namespace DO { namespace Sara {
 
   bool clear_window()
   {
-    return QMetaObject::invokeMethod(
-      active_window(), "clear",
-      Qt::QueuedConnection);
+    return paint([](PaintingWindow& w) { w.clear(); });
   }
 
+  // The render settings are commands too, so that they apply to the painting
+  // commands that follow them even in batch mode.
   bool set_antialiasing(Window w, bool on)
   {
-    return QMetaObject::invokeMethod(
-      w, "setAntialiasing",
-      Qt::QueuedConnection,
-      Q_ARG(bool, on));
+    return paint(w, [=](PaintingWindow& window) {
+      window.setAntialiasing(on);
+    });
   }
 
   bool set_transparency(Window w, bool on)
   {
-    return QMetaObject::invokeMethod(
-      w, "setTransparency",
-      Qt::QueuedConnection,
-      Q_ARG(bool, on));
+    return paint(w, [=](PaintingWindow& window) {
+      window.setTransparency(on);
+    });
   }
 
   bool save_screen(Window w, const std::string& fileName)
   {
     if (!active_window_is_visible())
       return false;
+    // Run the commands batched so far before saving the screen.
+    if (is_batching() && !flush_batch())
+      return false;
     return QMetaObject::invokeMethod(
       w, "saveScreen",
       Qt::BlockingQueuedConnection,
@@ -22,6 +22,70 @@ namespace DO { namespace Sara {
     @{
   */
 
+  // ======================================================================== //
+  // Command batching
+  /*!
+    @brief Start batching the painting commands issued by the calling thread.
+
+    Every painting command crosses from the user thread to the GUI thread,
+    which becomes slow when drawing thousands of primitives. Until the
+    matching end_batch(), the painting commands are instead appended to a
+    buffer owned by the calling thread, without any locking, and
+    flush_batch() sends the whole buffer at once: each window then runs its
+    commands and repaints once.
+
+    In batch mode:
+    - the painting commands return true as soon as they are recorded,
+    - display() starts a new frame: it flushes the commands batched so far,
+      then copies the image instead of blocking the calling thread until it
+      is displayed,
+    - save_screen(), the window management functions and the functions
+      waiting for user events first flush the commands batched so far.
+
+    Batches can be nested, only the outermost end_batch() flushes.
+   */
+  DO_SARA_EXPORT
+  void begin_batch();
+
+  /*!
+    @brief Send the commands batched by the calling thread to the GUI thread.
+    \return true if the commands are issued on the windows successfully.
+    \return false otherwise.
+   */
+  DO_SARA_EXPORT
+  bool flush_batch();
+
+  /*!
+    @brief Stop batching the painting commands and flush them.
+    \return true if the commands are issued on the windows successfully.
+    \return false otherwise.
+   */
+  DO_SARA_EXPORT
+  bool end_batch();
+
+  //! @brief Whether the calling thread batches its painting commands.
+  DO_SARA_EXPORT
+  bool is_batching();
+
+  //! @brief Batch the painting commands during the lifetime of the object.
+  class PaintingBatch
+  {
+  public:
+    PaintingBatch()
+    {
+      begin_batch();
+    }
+
+    ~PaintingBatch()
+    {
+      end_batch();
+    }
+
+    PaintingBatch(const PaintingBatch&) = delete;
+    PaintingBatch& operator=(const PaintingBatch&) = delete;
+  };
+
+
   // ======================================================================== //
   // Drawing commands
   /*!
@@ -53,6 +53,9 @@ namespace DO { namespace Sara {
 
   void close_window(Window w)
   {
+    // The window must not be deleted before running the commands batched for
+    // it.
+    flush_batch();
     QMetaObject::invokeMethod(gui_app(), "closeWindow",
                               Qt::BlockingQueuedConnection,
                               Q_ARG(QWidget *, w));
@@ -67,6 +70,8 @@ namespace DO { namespace Sara {
 
   void resize_window(int width, int height, Window w)
   {
+    // Keep the order of the commands batched before.
+    flush_batch();
     QMetaObject::invokeMethod(w, "resizeScreen",
                               Qt::BlockingQueuedConnection,
                               Q_ARG(int, width), Q_ARG(int, height));
@@ -84,6 +89,8 @@ namespace DO { namespace Sara {
 
   int get_mouse(int& x, int& y)
   {
+    // Show what was drawn so far before waiting for the user.
+    flush_batch();
     if (!active_window())
       return -1;
     return get_user_thread().getMouse(x, y);
@@ -101,6 +108,7 @@ namespace DO { namespace Sara {
 
   int get_key()
   {
+    flush_batch();
     if (!active_window())
       return -1;
     return get_user_thread().getKey();
@@ -119,6 +127,7 @@ namespace DO { namespace Sara {
 
   void get_event(int ms, Event& e)
   {
+    flush_batch();
     QMetaObject::invokeMethod(active_window(), "waitForEvent",
                               Qt::QueuedConnection,
                               Q_ARG(int, ms));
@@ -0,0 +1,289 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+// Copyright (C) 2017 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+
+#include <DO/Sara/ImageIO.hpp>
+#include <DO/Sara/ImageIO/Database/DataLoader.hpp>
+
+
+using namespace std;
+
+
+namespace DO { namespace Sara {
+
+  //! @brief Pool of batches filled by the worker threads.
+  //!
+  //! The batch b is prepared in the slot b % queue_depth once the consumer
+  //! has released the batch b - queue_depth.
+  struct ImageClassificationDataLoader::Impl
+  {
+    enum class SlotState
+    {
+      Free,
+      Filling,
+      Ready,
+      Borrowed
+    };
+
+    struct Slot
+    {
+      ImageClassificationBatch batch;
+      SlotState state{SlotState::Free};
+      //! @brief Index of the batch that the slot holds or waits for.
+      int batch_index{-1};
+      std::exception_ptr error;
+    };
+
+    Impl(const TransformedImageClassificationTrainingDataSet& data_set,
+         const DataLoaderOptions& options)
+      : data_set{data_set}
+      , options{options}
+    {
+    }
+
+    auto work() -> void;
+    auto fill(ImageClassificationBatch& batch, int b) const -> void;
+    auto stop_workers() -> void;
+
+    const TransformedImageClassificationTrainingDataSet& data_set;
+    DataLoaderOptions options;
+    //! @brief Output sizes (w, h) of the transformed samples.
+    Vector2i sizes{Vector2i::Zero()};
+
+    std::vector<int> order;
+    int num_batches{0};
+
+    std::vector<Slot> slots;
+    //! @brief Next batch to prepare by the workers.
+    int next_claim{0};
+    //! @brief Next batch to read by the consumer.
+    int next_read{0};
+    //! @brief Slot borrowed by 'next()'.
+    int current{-1};
+
+    bool stop{false};
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::vector<std::thread> workers;
+  };
+
+  auto ImageClassificationDataLoader::Impl::work() -> void
+  {
+    for (;;)
+    {
+      auto lock = std::unique_lock<std::mutex>{mutex};
+      if (stop || next_claim >= num_batches)
+        return;
+
+      const auto b = next_claim++;
+      auto& slot = slots[b % slots.size()];
+      cond.wait(lock, [&]() {
+        return stop || (slot.state == SlotState::Free && slot.batch_index == b);
+      });
+      if (stop)
+        return;
+      slot.state = SlotState::Filling;
+      lock.unlock();
+
+      auto error = std::exception_ptr{};
+      try
+      {
+        fill(slot.batch, b);
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+
+      lock.lock();
+      slot.error = error;
+      slot.state = SlotState::Ready;
+      cond.notify_all();
+    }
+  }
+
+  auto ImageClassificationDataLoader::Impl::fill(
+      ImageClassificationBatch& batch, int b) const -> void
+  {
+    const auto num_samples = static_cast<int>(order.size());
+    const auto begin = b * options.batch_size;
+    const auto end = std::min(begin + options.batch_size, num_samples);
+
+    batch.size = end - begin;
+    batch.indices.assign(order.begin() + begin, order.begin() + end);
+
+    for (auto i = 0; i < batch.size; ++i)
+    {
+      const auto s = batch.indices[i];
+
+      // Decode and augment directly into the batch.
+      const auto image = imread<Rgb8>(data_set.x[s]);
+      auto x = batch.x[i];
+      data_set.t[s].transform_into(image, x, 1 / 255.f);
+
+      batch.y(i) = data_set.y[s];
+    }
+  }
+
+  auto ImageClassificationDataLoader::Impl::stop_workers() -> void
+  {
+    {
+      std::lock_guard<std::mutex> lock{mutex};
+      stop = true;
+    }
+    cond.notify_all();
+
+    for (auto& worker : workers)
+      worker.join();
+    workers.clear();
+  }
+
+
+  ImageClassificationDataLoader::ImageClassificationDataLoader(
+      const TransformedImageClassificationTrainingDataSet& data_set,
+      const DataLoaderOptions& options)
+    : _impl{new Impl{data_set, options}}
+  {
+    if (options.batch_size < 1 || options.num_workers < 1 ||
+        options.queue_depth < 1)
+      throw std::domain_error{
+          "The batch size, the number of workers and the queue depth must be "
+          "positive!"};
+
+    if (data_set.x.size() != data_set.y.size() ||
+        data_set.x.size() != data_set.t.size())
+      throw std::runtime_error{"The data set is inconsistent!"};
+
+    if (!data_set.t.empty())
+      _impl->sizes = data_set.t.front().out_sizes;
+    for (const auto& t : data_set.t)
+      if (t.out_sizes != _impl->sizes)
+        throw std::runtime_error{
+            "All the data transforms must have the same output sizes!"};
+
+    // Preallocate the batches.
+    const auto w = _impl->sizes.x();
+    const auto h = _impl->sizes.y();
+    _impl->slots.resize(options.queue_depth);
+    for (auto& slot : _impl->slots)
+    {
+      slot.batch.x = Tensor_<float, 4>{{options.batch_size, 3, h, w}};
+      slot.batch.y = Tensor_<int, 1>{options.batch_size};
+      slot.batch.indices.reserve(options.batch_size);
+    }
+  }
+
+  ImageClassificationDataLoader::~ImageClassificationDataLoader()
+  {
+    stop();
+  }
+
+  auto ImageClassificationDataLoader::start_epoch(int epoch) -> void
+  {
+    stop();
+
+    auto& impl = *_impl;
+    const auto num_samples = static_cast<int>(impl.data_set.x.size());
+
+    // Fisher-Yates shuffle on the raw engine output, so that the order does
+    // not depend on the implementation of the standard library.
+    impl.order.resize(num_samples);
+    std::iota(impl.order.begin(), impl.order.end(), 0);
+    if (impl.options.shuffle)
+    {
+      auto gen = std::mt19937{impl.options.seed +
+                              static_cast<std::uint32_t>(epoch)};
+      for (auto i = num_samples - 1; i > 0; --i)
+        std::swap(impl.order[i], impl.order[gen() % (i + 1)]);
+    }
+
+    const auto batch_size = impl.options.batch_size;
+    impl.num_batches = impl.options.drop_last
+                           ? num_samples / batch_size
+                           : (num_samples + batch_size - 1) / batch_size;
+
+    for (auto s = 0u; s < impl.slots.size(); ++s)
+    {
+      impl.slots[s].state = Impl::SlotState::Free;
+      impl.slots[s].batch_index = static_cast<int>(s);
+      impl.slots[s].error = nullptr;
+    }
+    impl.next_claim = 0;
+    impl.next_read = 0;
+    impl.current = -1;
+    impl.stop = false;
+
+    const auto num_workers = std::min(impl.options.num_workers, impl.num_batches);
+    for (auto i = 0; i < num_workers; ++i)
+      impl.workers.emplace_back([&impl]() { impl.work(); });
+  }
+
+  auto ImageClassificationDataLoader::next() -> const ImageClassificationBatch*
+  {
+    auto& impl = *_impl;
+    auto lock = std::unique_lock<std::mutex>{impl.mutex};
+
+    // Release the previous batch.
+    if (impl.current != -1)
+    {
+      auto& slot = impl.slots[impl.current];
+      slot.state = Impl::SlotState::Free;
+      slot.batch_index += static_cast<int>(impl.slots.size());
+      impl.current = -1;
+      impl.cond.notify_all();
+    }
+
+    if (impl.next_read >= impl.num_batches || impl.workers.empty())
+      return nullptr;
+
+    const auto b = impl.next_read++;
+    const auto s = static_cast<int>(b % impl.slots.size());
+    auto& slot = impl.slots[s];
+    impl.cond.wait(lock, [&]() {
+      return slot.state == Impl::SlotState::Ready && slot.batch_index == b;
+    });
+    slot.state = Impl::SlotState::Borrowed;
+    impl.current = s;
+
+    if (slot.error)
+    {
+      auto error = slot.error;
+      slot.error = nullptr;
+      std::rethrow_exception(error);
+    }
+
+    return &slot.batch;
+  }
+
+  auto ImageClassificationDataLoader::stop() -> void
+  {
+    _impl->stop_workers();
+  }
+
+  auto ImageClassificationDataLoader::num_batches() const -> int
+  {
+    return _impl->num_batches;
+  }
+
+  auto ImageClassificationDataLoader::order() const -> const std::vector<int>&
+  {
+    return _impl->order;
+  }
+
+} /* namespace Sara */
+} /* namespace DO */
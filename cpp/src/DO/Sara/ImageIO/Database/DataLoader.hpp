@@ -0,0 +1,120 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+// Copyright (C) 2017 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <DO/Sara/Defines.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+#include <DO/Sara/ImageIO/Database/TransformedTrainingDataSet.hpp>
+
+
+namespace DO { namespace Sara {
+
+  //! @addtogroup ImageIO
+  //! @{
+
+  //! @brief Data loader options.
+  struct DataLoaderOptions
+  {
+    int batch_size{32};
+    //! @brief Number of threads decoding and augmenting the samples.
+    int num_workers{4};
+    //! @brief Number of preallocated batches, i.e., the number of batches
+    //! that can be prepared ahead of the consumer.
+    int queue_depth{4};
+    //! @brief Shuffle the samples at each epoch.
+    //!
+    //! The order of the samples only depends on the seed and on the epoch.
+    bool shuffle{true};
+    std::uint32_t seed{0};
+    //! @brief Discard the last incomplete batch.
+    bool drop_last{false};
+  };
+
+  //! @brief Batch of transformed samples.
+  struct ImageClassificationBatch
+  {
+    //! @brief (N, 3, H, W) tensor of RGB values in [0, 1].
+    Tensor_<float, 4> x;
+    //! @brief (N) tensor of labels.
+    Tensor_<int, 1> y;
+    //! @brief Sample indices in the data set.
+    std::vector<int> indices;
+    //! @brief Number of valid samples, which is less than N for the last
+    //! batch of an epoch.
+    int size{0};
+  };
+
+  /*!
+    @brief Decode and augment the samples of a data set in parallel.
+
+    The worker threads prepare the batches ahead of the consumer into a pool
+    of 'queue_depth' preallocated tensors. The batches are delivered in order
+    whatever the number of workers.
+
+    Usage:
+    @code
+    auto loader = ImageClassificationDataLoader{data_set, options};
+    for (auto epoch = 0; epoch < num_epochs; ++epoch)
+    {
+      loader.start_epoch(epoch);
+      while (const auto batch = loader.next())
+        train(batch->x, batch->y, batch->size);
+    }
+    @endcode
+   */
+  class DO_SARA_EXPORT ImageClassificationDataLoader
+  {
+  public:
+    //! @brief The data set must outlive the loader. All the transforms must
+    //! have the same output sizes.
+    ImageClassificationDataLoader(
+        const TransformedImageClassificationTrainingDataSet& data_set,
+        const DataLoaderOptions& options = {});
+
+    ~ImageClassificationDataLoader();
+
+    ImageClassificationDataLoader(const ImageClassificationDataLoader&) =
+        delete;
+    auto operator=(const ImageClassificationDataLoader&)
+        -> ImageClassificationDataLoader& = delete;
+
+    //! @brief Shuffle the samples and launch the workers.
+    auto start_epoch(int epoch = 0) -> void;
+
+    //! @brief Return the next batch of the epoch or nullptr at the end.
+    //!
+    //! The batch is valid until the next call. The exceptions thrown while
+    //! preparing the batch are rethrown here.
+    auto next() -> const ImageClassificationBatch*;
+
+    //! @brief Stop the workers.
+    auto stop() -> void;
+
+    auto num_batches() const -> int;
+
+    //! @brief Sample order of the current epoch.
+    auto order() const -> const std::vector<int>&;
+
+  private:
+    struct Impl;
+    std::unique_ptr<Impl> _impl;
+  };
+
+  //! @}
+
+} /* namespace Sara */
+} /* namespace DO */
@@ -45,6 +45,8 @@ namespace DO { namespace Sara {
     {
       const auto flip_type = csv_cells[10] == "H"
                                  ? ImageDataTransform::Horizontal
+                             : csv_cells[10] == "V"
+                                 ? ImageDataTransform::Vertical
                                  : ImageDataTransform::None;
       t.set_flip(flip_type);
     }
@@ -14,10 +14,12 @@
 #pragma once
 
 #include <array>
+#include <cmath>
 #include <vector>
 
 #include <DO/Sara/Defines.hpp>
 #include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
 #include <DO/Sara/ImageProcessing/ColorFancyPCA.hpp>
 #include <DO/Sara/ImageProcessing/ColorJitter.hpp>
 #include <DO/Sara/ImageProcessing/Flip.hpp>
@@ -114,13 +116,13 @@ namespace DO { namespace Sara {
           out = enlarge(in, z);
       }
 
-      out = crop(out, t, t + out_sizes);
+      out = safe_crop(out, t, t + out_sizes);
 
       if (apply_transform[Flip])
       {
         if (flip_type == Horizontal)
           flip_horizontally(out);
-        else
+        else if (flip_type == Vertical)
           flip_vertically(out);
       }
 
@@ -131,6 +133,160 @@ namespace DO { namespace Sara {
     Image<Rgb32f> operator()(const Image<Rgb32f>& in) const;
     //! @}
 
+
+    // ===================================================================== //
+    //! @{
+    //! @brief Fused data transform.
+    //!
+    //! The zoom, the shift and the flip are composed into one axis-aligned
+    //! affine map from the output patch to the input image:
+    //!   p_in = A * p_out + b.
+    //!
+    //! The color transforms are composed into one affine color map:
+    //!   c_out = M * c_in + m.
+    auto sampling_map(const Vector2i& in_sizes) const
+        -> std::pair<Matrix2f, Vector2f>
+    {
+      // Same conventions as 'reduce', 'enlarge' and 'crop'.
+      auto ratio = Vector2d::Ones().eval();
+      auto shift = Vector2d::Zero().eval();
+      if (use_original)
+        ratio = in_sizes.cast<double>().cwiseQuotient(
+            out_sizes.cast<double>());
+      else
+      {
+        if (apply_transform[Zoom])
+        {
+          const Vector2i zoomed_sizes =
+              z < 1 ? (in_sizes.cast<double>() / (1 / double(z)))
+                          .cast<int>()
+                          .eval()
+                    : (in_sizes.cast<double>() * double(z)).cast<int>().eval();
+          ratio = in_sizes.cast<double>().cwiseQuotient(
+              zoomed_sizes.cast<double>());
+        }
+        shift = t.cast<double>();
+      }
+
+      Matrix2d A = ratio.asDiagonal();
+      Vector2d b = shift.cwiseProduct(ratio);
+      if (!use_original && apply_transform[Flip] && flip_type != None)
+      {
+        const auto i = flip_type == Horizontal ? 0 : 1;
+        b(i) += (out_sizes(i) - 1) * A(i, i);
+        A(i, i) = -A(i, i);
+      }
+
+      return {A.cast<float>(), b.cast<float>()};
+    }
+
+    //! @brief The input colors are first multiplied by 'scale', e.g. 1/255
+    //! for 8-bit images.
+    auto color_map(float scale = 1.f) const -> std::pair<Matrix3f, Vector3f>
+    {
+      const Matrix3f M = scale * Matrix3f::Identity();
+      const Vector3f m = !use_original && apply_transform[FancyPCA]
+                             ? (U * S.asDiagonal() * alpha).eval()
+                             : Vector3f::Zero().eval();
+      return {M, m};
+    }
+
+    /*!
+      @brief Apply the transform in a single pass over the output patch.
+
+      The result is written in planar layout into 'out', which has sizes
+      (3, h, w). No intermediate image is allocated.
+
+      Pixels are sampled bilinearly. When the input is reduced, each output
+      pixel averages ceil(ratio) x ceil(ratio) bilinear samples over its
+      footprint instead of blurring the whole input image as 'extract_patch'
+      does. As in 'extract_patch', an output pixel outside the (zoomed) input
+      image is zero before the color map.
+     */
+    template <typename T>
+    void transform_into(const ImageView<T>& in, TensorView_<float, 3>& out,
+                        float scale = 1.f) const
+    {
+      static_assert(PixelTraits<T>::num_channels == 3,
+                    "The pixels must have 3 channels!");
+
+      const auto w = out_sizes.x();
+      const auto h = out_sizes.y();
+      if (out.size(0) != 3 || out.size(1) != h || out.size(2) != w)
+        throw std::domain_error{"The output tensor must have sizes (3, h, w)!"};
+
+      const auto [A, b] = sampling_map(in.sizes());
+      const auto [M, m] = color_map(scale);
+
+      // Footprint of an output pixel in the input image.
+      const Vector2f footprint = A.diagonal().cwiseAbs();
+      const Vector2i k =
+          footprint.array().ceil().cast<int>().max(1).matrix();
+      const Vector2f step = footprint.cwiseQuotient(k.cast<float>());
+      const Vector2f first_offset =
+          -0.5f * (k.cast<float>() - Vector2f::Ones()).cwiseProduct(step);
+      const auto weight = 1.f / (k.x() * k.y());
+
+      // An output pixel is inside the zoomed image if its center is closer to
+      // the input image than to the first pixel padded by 'safe_crop'.
+      const Vector2f center_min = -0.5f * footprint;
+      const Vector2f center_max = in.sizes().template cast<float>() -
+                                  0.5f * footprint;
+
+      const auto x_max = in.width() - 1;
+      const auto y_max = in.height() - 1;
+      const auto sample = [&](float x, float y) -> Vector3f {
+        x = std::min(std::max(x, 0.f), float(x_max));
+        y = std::min(std::max(y, 0.f), float(y_max));
+        const auto x0 = static_cast<int>(x);
+        const auto y0 = static_cast<int>(y);
+        const auto x1 = std::min(x0 + 1, x_max);
+        const auto y1 = std::min(y0 + 1, y_max);
+        const auto fx = x - x0;
+        const auto fy = y - y0;
+
+        const auto& p00 = in(x0, y0);
+        const auto& p10 = in(x1, y0);
+        const auto& p01 = in(x0, y1);
+        const auto& p11 = in(x1, y1);
+
+        auto c = Vector3f{};
+        for (auto i = 0; i < 3; ++i)
+          c(i) = (1 - fy) * ((1 - fx) * float(p00[i]) + fx * float(p10[i])) +
+                 fy * ((1 - fx) * float(p01[i]) + fx * float(p11[i]));
+        return c;
+      };
+
+      float* planes[3] = {out[0].data(), out[1].data(), out[2].data()};
+      for (auto y = 0; y < h; ++y)
+      {
+        for (auto x = 0; x < w; ++x)
+        {
+          const Vector2f center = A * Vector2f(float(x), float(y)) + b;
+          const auto inside = (center.array() >= center_min.array()).all() &&
+                              (center.array() <= center_max.array()).all();
+
+          auto c = Vector3f::Zero().eval();
+          if (inside)
+          {
+            const Vector2f p = center + first_offset;
+            for (auto j = 0; j < k.y(); ++j)
+              for (auto i = 0; i < k.x(); ++i)
+                c += sample(p.x() + i * step.x(), p.y() + j * step.y());
+            if (k.x() * k.y() > 1)
+              c *= weight;
+          }
+
+          c = M * c + m;
+
+          const auto offset = y * w + x;
+          for (auto i = 0; i < 3; ++i)
+            planes[i][offset] = c(i);
+        }
+      }
+    }
+    //! @}
+
     inline bool operator==(const ImageDataTransform& other) const
     {
       return out_sizes == other.out_sizes &&
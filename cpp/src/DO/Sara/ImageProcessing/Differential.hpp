@@ -15,6 +15,9 @@
 
 #include <DO/Sara/Core/Image.hpp>
 
+#include <algorithm>
+#include <type_traits>
+
 
 namespace DO { namespace Sara {
 
@@ -24,6 +27,234 @@ namespace DO { namespace Sara {
     @{
    */
 
+  namespace detail {
+
+    //! @{
+    //! @brief Dimension-specialized finite difference kernels.
+    //!
+    //! Pixels are stored with the x-coordinate varying fastest, so we process
+    //! the image row by row. Rows are processed in parallel. Each pixel kernel
+    //! is parametrized by the indices of its neighbors so that the interior
+    //! columns are processed in a branch-free loop, while the first and last
+    //! columns are processed separately with clamped indices. Clamping the
+    //! indices replicates the border exactly as the generic functors do.
+    template <typename T>
+    auto gradient_2d(const ImageView<T, 2>& in,
+                     ImageView<Matrix<T, 2, 1>, 2>& out) -> void
+    {
+      const auto w = in.width();
+      const auto h = in.height();
+
+#pragma omp parallel for
+      for (int y = 0; y < h; ++y)
+      {
+        const auto f = in.data() + y * w;
+        const auto f_yp = in.data() + std::max(y - 1, 0) * w;
+        const auto f_yn = in.data() + std::min(y + 1, h - 1) * w;
+        auto g = out.data() + y * w;
+
+        const auto kernel = [&](int x, int xp, int xn) {
+          g[x][0] = (f[xn] - f[xp]) / 2;
+          g[x][1] = (f_yn[x] - f_yp[x]) / 2;
+        };
+
+        for (int x = 1; x < w - 1; ++x)
+          kernel(x, x - 1, x + 1);
+        kernel(0, 0, std::min(1, w - 1));
+        if (w > 1)
+          kernel(w - 1, w - 2, w - 1);
+      }
+    }
+
+    template <typename T>
+    auto gradient_3d(const ImageView<T, 3>& in,
+                     ImageView<Matrix<T, 3, 1>, 3>& out) -> void
+    {
+      const auto w = in.size(0);
+      const auto h = in.size(1);
+      const auto d = in.size(2);
+      const auto row = [&](int y, int z) { return in.data() + (z * h + y) * w; };
+
+#pragma omp parallel for
+      for (int r = 0; r < h * d; ++r)
+      {
+        const auto y = r % h;
+        const auto z = r / h;
+        const auto yp = std::max(y - 1, 0);
+        const auto yn = std::min(y + 1, h - 1);
+        const auto zp = std::max(z - 1, 0);
+        const auto zn = std::min(z + 1, d - 1);
+
+        const auto f = row(y, z);
+        const auto f_yp = row(yp, z);
+        const auto f_yn = row(yn, z);
+        const auto f_zp = row(y, zp);
+        const auto f_zn = row(y, zn);
+        auto g = out.data() + r * w;
+
+        const auto kernel = [&](int x, int xp, int xn) {
+          g[x][0] = (f[xn] - f[xp]) / 2;
+          g[x][1] = (f_yn[x] - f_yp[x]) / 2;
+          g[x][2] = (f_zn[x] - f_zp[x]) / 2;
+        };
+
+        for (int x = 1; x < w - 1; ++x)
+          kernel(x, x - 1, x + 1);
+        kernel(0, 0, std::min(1, w - 1));
+        if (w > 1)
+          kernel(w - 1, w - 2, w - 1);
+      }
+    }
+
+    template <typename T>
+    auto laplacian_2d(const ImageView<T, 2>& in, ImageView<T, 2>& out) -> void
+    {
+      const auto w = in.width();
+      const auto h = in.height();
+
+#pragma omp parallel for
+      for (int y = 0; y < h; ++y)
+      {
+        const auto f = in.data() + y * w;
+        const auto f_yp = in.data() + std::max(y - 1, 0) * w;
+        const auto f_yn = in.data() + std::min(y + 1, h - 1) * w;
+        auto lap_f = out.data() + y * w;
+
+        const auto kernel = [&](int x, int xp, int xn) {
+          const auto value = (f[xn] + f[xp]) + (f_yn[x] + f_yp[x]);
+          lap_f[x] = value - 2 * 2 * f[x];
+        };
+
+        for (int x = 1; x < w - 1; ++x)
+          kernel(x, x - 1, x + 1);
+        kernel(0, 0, std::min(1, w - 1));
+        if (w > 1)
+          kernel(w - 1, w - 2, w - 1);
+      }
+    }
+
+    template <typename T>
+    auto laplacian_3d(const ImageView<T, 3>& in, ImageView<T, 3>& out) -> void
+    {
+      const auto w = in.size(0);
+      const auto h = in.size(1);
+      const auto d = in.size(2);
+      const auto row = [&](int y, int z) { return in.data() + (z * h + y) * w; };
+
+#pragma omp parallel for
+      for (int r = 0; r < h * d; ++r)
+      {
+        const auto y = r % h;
+        const auto z = r / h;
+
+        const auto f = row(y, z);
+        const auto f_yp = row(std::max(y - 1, 0), z);
+        const auto f_yn = row(std::min(y + 1, h - 1), z);
+        const auto f_zp = row(y, std::max(z - 1, 0));
+        const auto f_zn = row(y, std::min(z + 1, d - 1));
+        auto lap_f = out.data() + r * w;
+
+        const auto kernel = [&](int x, int xp, int xn) {
+          const auto value =
+              (f[xn] + f[xp]) + (f_yn[x] + f_yp[x]) + (f_zn[x] + f_zp[x]);
+          lap_f[x] = value - 2 * 3 * f[x];
+        };
+
+        for (int x = 1; x < w - 1; ++x)
+          kernel(x, x - 1, x + 1);
+        kernel(0, 0, std::min(1, w - 1));
+        if (w > 1)
+          kernel(w - 1, w - 2, w - 1);
+      }
+    }
+
+    template <typename T>
+    auto hessian_2d(const ImageView<T, 2>& in,
+                    ImageView<Matrix<T, 2, 2>, 2>& out) -> void
+    {
+      const auto w = in.width();
+      const auto h = in.height();
+
+#pragma omp parallel for
+      for (int y = 0; y < h; ++y)
+      {
+        const auto f = in.data() + y * w;
+        const auto f_yp = in.data() + std::max(y - 1, 0) * w;
+        const auto f_yn = in.data() + std::min(y + 1, h - 1) * w;
+        auto H = out.data() + y * w;
+
+        const auto kernel = [&](int x, int xp, int xn) {
+          H[x](0, 0) = f[xn] - T(2) * f[x] + f[xp];
+          H[x](1, 1) = f_yn[x] - T(2) * f[x] + f_yp[x];
+          H[x](0, 1) = (f_yn[xn] - f_yn[xp] - f_yp[xn] + f_yp[xp]) /
+                       static_cast<T>(4);
+          H[x](1, 0) = H[x](0, 1);
+        };
+
+        for (int x = 1; x < w - 1; ++x)
+          kernel(x, x - 1, x + 1);
+        kernel(0, 0, std::min(1, w - 1));
+        if (w > 1)
+          kernel(w - 1, w - 2, w - 1);
+      }
+    }
+
+    template <typename T>
+    auto hessian_3d(const ImageView<T, 3>& in,
+                    ImageView<Matrix<T, 3, 3>, 3>& out) -> void
+    {
+      const auto w = in.size(0);
+      const auto h = in.size(1);
+      const auto d = in.size(2);
+      const auto row = [&](int y, int z) { return in.data() + (z * h + y) * w; };
+
+#pragma omp parallel for
+      for (int r = 0; r < h * d; ++r)
+      {
+        const auto y = r % h;
+        const auto z = r / h;
+        const auto yp = std::max(y - 1, 0);
+        const auto yn = std::min(y + 1, h - 1);
+        const auto zp = std::max(z - 1, 0);
+        const auto zn = std::min(z + 1, d - 1);
+
+        const auto f = row(y, z);
+        const auto f_yp = row(yp, z);
+        const auto f_yn = row(yn, z);
+        const auto f_zp = row(y, zp);
+        const auto f_zn = row(y, zn);
+        const auto f_yp_zp = row(yp, zp);
+        const auto f_yn_zp = row(yn, zp);
+        const auto f_yp_zn = row(yp, zn);
+        const auto f_yn_zn = row(yn, zn);
+        auto H = out.data() + r * w;
+
+        const auto kernel = [&](int x, int xp, int xn) {
+          H[x](0, 0) = f[xn] - T(2) * f[x] + f[xp];
+          H[x](1, 1) = f_yn[x] - T(2) * f[x] + f_yp[x];
+          H[x](2, 2) = f_zn[x] - T(2) * f[x] + f_zp[x];
+          H[x](0, 1) = (f_yn[xn] - f_yn[xp] - f_yp[xn] + f_yp[xp]) /
+                       static_cast<T>(4);
+          H[x](0, 2) = (f_zn[xn] - f_zn[xp] - f_zp[xn] + f_zp[xp]) /
+                       static_cast<T>(4);
+          H[x](1, 2) = (f_yn_zn[x] - f_yp_zn[x] - f_yn_zp[x] + f_yp_zp[x]) /
+                       static_cast<T>(4);
+          H[x](1, 0) = H[x](0, 1);
+          H[x](2, 0) = H[x](0, 2);
+          H[x](2, 1) = H[x](1, 2);
+        };
+
+        for (int x = 1; x < w - 1; ++x)
+          kernel(x, x - 1, x + 1);
+        kernel(0, 0, std::min(1, w - 1));
+        if (w > 1)
+          kernel(w - 1, w - 2, w - 1);
+      }
+    }
+    //! @}
+
+  }  // namespace detail
+
 
   //! @brief Gradient functor class
   struct Gradient
@@ -74,31 +305,52 @@ namespace DO { namespace Sara {
     }
 
 
+    //! @brief Compute the gradient field into a preallocated buffer.
     template <typename Field>
-    auto operator()(const Field& in, GradientFieldView<Field>& out)
+    auto operator()(const Field& in, GradientFieldView<Field>& out) const
+        -> void
     {
-      if (out.sizes() != out.sizes())
+      if (in.sizes() != out.sizes())
         throw std::domain_error{
             "Error: input and output must have the same sizes!"};
 
-      auto in_i = in.begin_array();
-      auto out_i = out.begin();
-      for (; !in_i.end(); ++in_i, ++out_i)
-        operator()<Field>(in_i, *out_i);
+      apply(in, out, std::integral_constant<int, Field::Dimension>{});
     }
 
     template <typename Field>
     auto operator()(const Field& in) const -> GradientField<Field>
     {
       auto out = GradientField<Field>{in.sizes()};
+      operator()(in, out);
+      return out;
+    }
 
+    //! @{
+    //! @brief Dispatch to the fastest implementation for the field dimension.
+    template <typename Field, int N>
+    auto apply(const Field& in, GradientFieldView<Field>& out,
+               std::integral_constant<int, N>) const -> void
+    {
       auto in_i = in.begin_array();
       auto out_i = out.begin();
       for (; !in_i.end(); ++in_i, ++out_i)
         operator()<Field>(in_i, *out_i);
+    }
 
-      return out;
+    template <typename Field>
+    auto apply(const Field& in, GradientFieldView<Field>& out,
+               std::integral_constant<int, 2>) const -> void
+    {
+      detail::gradient_2d(in, out);
+    }
+
+    template <typename Field>
+    auto apply(const Field& in, GradientFieldView<Field>& out,
+               std::integral_constant<int, 3>) const -> void
+    {
+      detail::gradient_3d(in, out);
     }
+    //! @}
   };
 
 
@@ -148,6 +400,7 @@ namespace DO { namespace Sara {
       return out;
     }
 
+    //! @brief Compute the Laplacian field into a preallocated buffer.
     template <typename Field>
     auto operator()(const Field& in, ScalarFieldView<Field>& out) const
         -> void
@@ -157,10 +410,7 @@ namespace DO { namespace Sara {
           "Source and destination image sizes are not equal!"
         };
 
-      auto in_i = in.begin_array();
-      auto out_i = out.begin();
-      for ( ; !in_i.end(); ++in_i, ++out_i)
-        operator()<Field>(in_i, *out_i);
+      apply(in, out, std::integral_constant<int, Field::Dimension>{});
     }
 
     template <typename Field>
@@ -170,6 +420,33 @@ namespace DO { namespace Sara {
       operator()(in, out);
       return out;
     }
+
+    //! @{
+    //! @brief Dispatch to the fastest implementation for the field dimension.
+    template <typename Field, int N>
+    auto apply(const Field& in, ScalarFieldView<Field>& out,
+               std::integral_constant<int, N>) const -> void
+    {
+      auto in_i = in.begin_array();
+      auto out_i = out.begin();
+      for ( ; !in_i.end(); ++in_i, ++out_i)
+        operator()<Field>(in_i, *out_i);
+    }
+
+    template <typename Field>
+    auto apply(const Field& in, ScalarFieldView<Field>& out,
+               std::integral_constant<int, 2>) const -> void
+    {
+      detail::laplacian_2d(in, out);
+    }
+
+    template <typename Field>
+    auto apply(const Field& in, ScalarFieldView<Field>& out,
+               std::integral_constant<int, 3>) const -> void
+    {
+      detail::laplacian_3d(in, out);
+    }
+    //! @}
   };
 
 
@@ -189,6 +466,9 @@ namespace DO { namespace Sara {
     template <typename Field>
     using HessianField = Image<HessianMatrix<Field>, Field::Dimension>;
 
+    template <typename Field>
+    using HessianFieldView = ImageView<HessianMatrix<Field>, Field::Dimension>;
+
     template <typename Field>
     auto operator()(typename Field::const_array_iterator& in,
                     HessianMatrix<Field>& out) const -> void
@@ -241,18 +521,52 @@ namespace DO { namespace Sara {
       return out;
     }
 
+    //! @brief Compute the Hessian matrix field into a preallocated buffer.
+    template <typename Field>
+    auto operator()(const Field& in, HessianFieldView<Field>& out) const
+        -> void
+    {
+      if (in.sizes() != out.sizes())
+        throw std::domain_error{
+            "Source and destination image sizes are not equal!"};
+
+      apply(in, out, std::integral_constant<int, Field::Dimension>{});
+    }
+
     template <typename Field>
     auto operator()(const Field& in) const -> HessianField<Field>
     {
       auto out = HessianField<Field>{ in.sizes() };
+      operator()(in, out);
+      return out;
+    }
 
+    //! @{
+    //! @brief Dispatch to the fastest implementation for the field dimension.
+    template <typename Field, int N>
+    auto apply(const Field& in, HessianFieldView<Field>& out,
+               std::integral_constant<int, N>) const -> void
+    {
       auto in_i = in.begin_array();
       auto out_i = out.begin();
       for (; !in_i.end(); ++in_i, ++out_i)
         operator()<Field>(in_i, *out_i);
+    }
 
-      return out;
-    };
+    template <typename Field>
+    auto apply(const Field& in, HessianFieldView<Field>& out,
+               std::integral_constant<int, 2>) const -> void
+    {
+      detail::hessian_2d(in, out);
+    }
+
+    template <typename Field>
+    auto apply(const Field& in, HessianFieldView<Field>& out,
+               std::integral_constant<int, 3>) const -> void
+    {
+      detail::hessian_3d(in, out);
+    }
+    //! @}
   };
 
 
@@ -279,6 +593,18 @@ namespace DO { namespace Sara {
     return Gradient{}(in);
   }
 
+  /*!
+    @brief Gradient computation
+    @param[in] in scalar field
+    @param[out] out preallocated gradient vector field
+   */
+  template <typename T, int N>
+  inline void gradient(const ImageView<T, N>& in,
+                       ImageView<Matrix<T, N, 1>, N>& out)
+  {
+    Gradient{}(in, out);
+  }
+
   /*!
     @brief Laplacian computation
     @param[in] f input scalar field.
@@ -304,6 +630,17 @@ namespace DO { namespace Sara {
     return Laplacian{}.operator()<ImageView<T, N>>(in);
   }
 
+  /*!
+    @brief Laplacian computation
+    @param[in] in scalar field.
+    @param[out] out preallocated laplacian field.
+   */
+  template <typename T, int N>
+  inline void laplacian(const ImageView<T, N>& in, ImageView<T, N>& out)
+  {
+    Laplacian{}.operator()<ImageView<T, N>>(in, out);
+  }
+
   /*!
     @brief Compute the Hessian matrix at a specified position.
     @param[in] f scalar field.
@@ -323,11 +660,23 @@ namespace DO { namespace Sara {
     @return Hessian matrix field
    */
   template <typename T, int N>
-  inline Image<Matrix<T, N, N>> hessian(const ImageView<T, N>& in)
+  inline Image<Matrix<T, N, N>, N> hessian(const ImageView<T, N>& in)
   {
     return Hessian{}(in);
   }
 
+  /*!
+    @brief Compute the Hessian matrix field.
+    @param[in] in scalar field.
+    @param[out] out preallocated Hessian matrix field
+   */
+  template <typename T, int N>
+  inline void hessian(const ImageView<T, N>& in,
+                      ImageView<Matrix<T, N, N>, N>& out)
+  {
+    Hessian{}(in, out);
+  }
+
   //! @}
 
 } /* namespace Sara */
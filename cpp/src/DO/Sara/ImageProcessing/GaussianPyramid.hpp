@@ -28,30 +28,32 @@ namespace DO { namespace Sara {
     @{
    */
 
-  //! Computes a pyramid of Gaussians.
-  template <typename T>
-  ImagePyramid<T>
-  gaussian_pyramid(const ImageView<T>& image,
-                   const ImagePyramidParams& params = ImagePyramidParams())
+  /*!
+    @brief Computes a pyramid of Gaussians in place.
+
+    The image buffers of the pyramid are reused whenever their sizes are
+    unchanged, so that calling this function for every frame of a video does
+    not allocate any memory once the pyramid has been built for the first
+    frame. Combined with a pooled allocator, e.g.,
+    'ImagePyramid<float, 2, PooledAllocator>', the buffers are also recycled
+    when the frame size changes.
+   */
+  template <typename T, template <typename> class Allocator>
+  void gaussian_pyramid(const ImageView<T>& image,
+                        ImagePyramid<T, 2, Allocator>& G,
+                        const ImagePyramidParams& params = ImagePyramidParams())
   {
     using Scalar = typename ImagePyramid<T>::scalar_type;
 
     // Resize the image with the appropriate factor.
     const auto resize_factor = pow(2.f, -params.first_octave_index());
-    auto I = enlarge(image, resize_factor);
+    const Vector2i enlarged_sizes =
+        (image.sizes().template cast<double>() * double(resize_factor))
+            .template cast<int>();
 
     // Deduce the new camera sigma with respect to the dilated image.
     const auto camera_sigma = Scalar(params.scale_camera()) * resize_factor;
 
-    // Blur the image so that its new sigma is equal to the initial sigma.
-    const auto init_sigma = Scalar(params.scale_initial());
-    if (camera_sigma < init_sigma)
-    {
-      const auto sigma =
-          sqrt(init_sigma * init_sigma - camera_sigma * camera_sigma);
-      I = gaussian(I, sigma);
-    }
-
     // Deduce the maximum number of octaves.
     const auto l =
         std::min(image.width(), image.height());  // l = min image image sizes.
@@ -69,13 +71,13 @@ namespace DO { namespace Sara {
     const auto num_octaves = static_cast<int>(log(l / (2.f * b)) / log(2.f));
 
     // Shorten names.
+    const auto init_sigma = Scalar(params.scale_initial());
     const auto k = static_cast<Scalar>(params.scale_geometric_factor());
     const auto num_scales = params.num_scales_per_octave();
     const auto downscale_index =
         static_cast<int>(floor(log(Scalar(2)) / log(k)));
 
     // Create the image pyramid
-    auto G = ImagePyramid<T>{};
     G.reset(num_octaves, num_scales, init_sigma, k);
 
     for (auto o = 0; o < num_octaves; ++o)
@@ -86,25 +88,56 @@ namespace DO { namespace Sara {
 
       // Compute the gaussians in octave @f$o@f$
       auto sigma_s_1 = init_sigma;
-      G(0, o) = o == 0 ? I : downscale(G(downscale_index, o - 1), 2);
+      if (o == 0)
+      {
+        G(0, o).resize(enlarged_sizes);
+        enlarge(image, G(0, o));
+
+        // Blur the image so that its new sigma is equal to the initial sigma.
+        if (camera_sigma < init_sigma)
+        {
+          const auto sigma =
+              sqrt(init_sigma * init_sigma - camera_sigma * camera_sigma);
+          apply_gaussian_filter(G(0, o), G(0, o), sigma);
+        }
+      }
+      else
+      {
+        const auto& G_prev = G(downscale_index, o - 1);
+        G(0, o).resize(G_prev.sizes() / 2);
+        downscale(G_prev, G(0, o), 2);
+      }
 
       for (auto s = 1; s < num_scales; ++s)
       {
         const auto sigma =
             sqrt(k * k * sigma_s_1 * sigma_s_1 - sigma_s_1 * sigma_s_1);
-        G(s, o) = gaussian(G(s - 1, o), sigma);
+        G(s, o).resize(G(s - 1, o).sizes());
+        apply_gaussian_filter(G(s - 1, o), G(s, o), sigma);
         sigma_s_1 *= k;
       }
     }
+  }
 
+  //! Computes a pyramid of Gaussians.
+  template <typename T>
+  ImagePyramid<T>
+  gaussian_pyramid(const ImageView<T>& image,
+                   const ImagePyramidParams& params = ImagePyramidParams())
+  {
+    auto G = ImagePyramid<T>{};
+    gaussian_pyramid(image, G, params);
     return G;
   }
 
-  //! Computes a pyramid of difference of Gaussians from the Gaussian pyramid.
-  template <typename T>
-  ImagePyramid<T> difference_of_gaussians_pyramid(const ImagePyramid<T>& gaussians)
+  //! Computes a pyramid of difference of Gaussians from the Gaussian pyramid
+  //! in place.
+  template <typename T, template <typename> class SrcAllocator,
+            template <typename> class DstAllocator>
+  void difference_of_gaussians_pyramid(
+      const ImagePyramid<T, 2, SrcAllocator>& gaussians,
+      ImagePyramid<T, 2, DstAllocator>& D)
   {
-    auto D = ImagePyramid<T>{};
     D.reset(gaussians.num_octaves(),
             gaussians.num_scales_per_octave() - 1,
             gaussians.scale_initial(),
@@ -121,6 +154,15 @@ namespace DO { namespace Sara {
             tensor_view(gaussians(s, o)).flat_array();
       }
     }
+  }
+
+  //! Computes a pyramid of difference of Gaussians from the Gaussian pyramid.
+  template <typename T, template <typename> class Allocator>
+  ImagePyramid<T>
+  difference_of_gaussians_pyramid(const ImagePyramid<T, 2, Allocator>& gaussians)
+  {
+    auto D = ImagePyramid<T>{};
+    difference_of_gaussians_pyramid(gaussians, D);
     return D;
   }
 
@@ -14,6 +14,7 @@
 #pragma once
 
 #include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/MemoryPool.hpp>
 
 
 namespace DO { namespace Sara {
@@ -184,31 +185,38 @@ namespace DO { namespace Sara {
     The image pyramid is regular, i.e., it has:
     - the same number of scales in each octave
     - the same geometric progression factor in the scale in each octave
+
+    The image buffers can be drawn from a memory pool by specifying the
+    allocator, e.g., 'ImagePyramid<float, 2, PooledAllocator>'.
    */
-  template <typename Pixel, int N=2>
+  template <typename Pixel, int N = 2,
+            template <typename> class Allocator = std::allocator>
   class ImagePyramid
   {
   public: /* member functions */
     //! Convenient typedefs.
     //! @{
     using pixel_type = Pixel;
-    using image_type = Image<Pixel>;
-    using octave_type = std::vector<Image<Pixel, N>>;
+    using image_type = Image<Pixel, N, Allocator>;
+    using octave_type = std::vector<image_type>;
     using scalar_type = typename PixelTraits<Pixel>::channel_type;
     //! @}
 
     //! @brief Default constructor.
     inline ImagePyramid() = default;
 
-    //! @brief Reset image pyramid with the following parameters.
+    /*!
+      @brief Reset image pyramid with the following parameters.
+
+      The image buffers already allocated are kept, so that a pyramid can be
+      rebuilt in place for a new frame of the same size without allocating
+      memory.
+     */
     void reset(int num_octaves,
                int num_scales_per_octave,
                double scale_initial,
                double scale_geometric_factor)
     {
-      _octaves.clear();
-      _oct_scaling_factors.clear();
-
       _octaves.resize(num_octaves);
       _oct_scaling_factors.resize(num_octaves);
       for (int o = 0; o < num_octaves; ++o)
@@ -86,22 +86,27 @@ namespace DO { namespace Sara {
     const auto h = src.height();
     const auto half_size = kernel_size / 2;
 
-#pragma omp parallel for
-    for (int y = 0; y < h; ++y)
+#pragma omp parallel
     {
+      // Allocate the work array once per thread.
       auto buffer = std::vector<T>(w + half_size * 2);
-      // Copy to work array and add padding.
-      for (int x = 0; x < half_size; ++x)
-        buffer[x] = src(0, y);
-      for (int x = 0; x < w; ++x)
-        buffer[half_size + x] = src(x, y);
-      for (int x = 0; x < half_size; ++x)
-        buffer[w + half_size + x] = src(w - 1, y);
-
-      convolve_array(&buffer[0], kernel, w, kernel_size);
 
-      for (int x = 0; x < w; ++x)
-        dst(x, y) = buffer[x];
+#pragma omp for
+      for (int y = 0; y < h; ++y)
+      {
+        // Copy to work array and add padding.
+        for (int x = 0; x < half_size; ++x)
+          buffer[x] = src(0, y);
+        for (int x = 0; x < w; ++x)
+          buffer[half_size + x] = src(x, y);
+        for (int x = 0; x < half_size; ++x)
+          buffer[w + half_size + x] = src(w - 1, y);
+
+        convolve_array(&buffer[0], kernel, w, kernel_size);
+
+        for (int x = 0; x < w; ++x)
+          dst(x, y) = buffer[x];
+      }
     }
   }
 
@@ -128,22 +133,26 @@ namespace DO { namespace Sara {
     const auto h = src.height();
     const auto half_size = kernel_size / 2;
 
-#pragma omp parallel for
-    for (int x = 0; x < w; ++x)
+#pragma omp parallel
     {
+      // Allocate the work array once per thread.
       auto buffer = std::vector<T>(h + half_size * 2);
 
-      for (int y = 0; y < half_size; ++y)
-        buffer[y] = src(x, 0);
-      for (int y = 0; y < h; ++y)
-        buffer[half_size + y] = src(x, y);
-      for (int y = 0; y < half_size; ++y)
-        buffer[h + half_size + y] = src(x, h - 1);
+#pragma omp for
+      for (int x = 0; x < w; ++x)
+      {
+        for (int y = 0; y < half_size; ++y)
+          buffer[y] = src(x, 0);
+        for (int y = 0; y < h; ++y)
+          buffer[half_size + y] = src(x, y);
+        for (int y = 0; y < half_size; ++y)
+          buffer[h + half_size + y] = src(x, h - 1);
 
-      convolve_array(&buffer[0], kernel, h, kernel_size);
+        convolve_array(&buffer[0], kernel, h, kernel_size);
 
-      for (int y = 0; y < h; ++y)
-        dst(x, y) = buffer[y];
+        for (int y = 0; y < h; ++y)
+          dst(x, y) = buffer[y];
+      }
     }
   }
 
@@ -37,15 +37,28 @@ namespace DO { namespace Sara {
     return dst;
   }
 
+  //! @{
   //! @brief Downscale image.
   template <typename T, int N>
-  Image<T, N> downscale(const ImageView<T, N>& src, int fact)
+  void downscale(const ImageView<T, N>& src, ImageView<T, N>& dst, int fact)
   {
-    auto dst = Image<T, N>(src.sizes() / fact);
+    if (dst.sizes() != src.sizes() / fact)
+      throw std::domain_error{
+          "The destination image sizes must be the downscaled source image "
+          "sizes!"};
+
     for (auto it = dst.begin_array(); !it.end(); ++it)
       *it = src(it.position() * fact);
+  }
+
+  template <typename T, int N>
+  Image<T, N> downscale(const ImageView<T, N>& src, int fact)
+  {
+    auto dst = Image<T, N>(src.sizes() / fact);
+    downscale(src, dst, fact);
     return dst;
   }
+  //! @}
 
   //! @brief Find min and max coefficient of a vector.
   template <typename T, int N>
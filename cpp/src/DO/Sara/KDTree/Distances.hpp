@@ -0,0 +1,215 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+//! @file
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+
+
+namespace DO { namespace Sara {
+
+  //! @addtogroup KDTree
+  //! @{
+
+  //! @name Distance functors
+  //!
+  //! The functors model the distance concept of FLANN. Contrary to FLANN's
+  //! distances, they process the coordinates by fixed-size blocks so that the
+  //! compiler vectorizes the inner loop, and they only check for early
+  //! termination between two blocks.
+  //! @{
+
+  namespace detail {
+
+    //! @brief Distances are accumulated in single precision unless the
+    //! coordinates are in double precision.
+    template <typename T>
+    using distance_result_t =
+        std::conditional_t<std::is_same_v<T, double>, double, float>;
+
+    //! @brief Byte coordinates are accumulated exactly with integers within
+    //! a block.
+    template <typename Iterator1, typename Iterator2, typename ResultType>
+    using block_accumulator_t = std::conditional_t<
+        std::is_integral_v<
+            typename std::iterator_traits<Iterator1>::value_type> &&
+            std::is_integral_v<
+                typename std::iterator_traits<Iterator2>::value_type> &&
+            sizeof(typename std::iterator_traits<Iterator1>::value_type) ==
+                1 &&
+            sizeof(typename std::iterator_traits<Iterator2>::value_type) == 1,
+        std::int32_t, ResultType>;
+
+  }  // namespace detail
+
+
+  //! @brief Squared Euclidean distance.
+  template <typename T>
+  struct SquaredL2Distance
+  {
+    using is_kdtree_distance = bool;
+
+    using ElementType = T;
+    using ResultType = detail::distance_result_t<T>;
+
+    static constexpr std::size_t block_size = 16;
+
+    template <typename Iterator1, typename Iterator2>
+    inline auto operator()(Iterator1 a, Iterator2 b, std::size_t size,
+                           ResultType worst_dist = -1) const -> ResultType
+    {
+      using Accumulator =
+          detail::block_accumulator_t<Iterator1, Iterator2, ResultType>;
+
+      auto result = ResultType{};
+      auto i = std::size_t{};
+      for (; i + block_size <= size; i += block_size)
+      {
+        auto block_result = Accumulator{};
+#pragma omp simd reduction(+ : block_result)
+        for (auto j = std::size_t{}; j < block_size; ++j)
+        {
+          const auto d = static_cast<Accumulator>(a[i + j]) -
+                         static_cast<Accumulator>(b[i + j]);
+          block_result += d * d;
+        }
+        result += static_cast<ResultType>(block_result);
+
+        if (worst_dist > 0 && result > worst_dist)
+          return result;
+      }
+
+      for (; i < size; ++i)
+        result += accum_dist(a[i], b[i], 0);
+
+      return result;
+    }
+
+    //! @brief Partial distance along one dimension.
+    template <typename U, typename V>
+    inline auto accum_dist(const U& a, const V& b, int) const -> ResultType
+    {
+      const auto d = static_cast<ResultType>(a) - static_cast<ResultType>(b);
+      return d * d;
+    }
+  };
+
+
+  //! @brief Manhattan distance.
+  template <typename T>
+  struct L1Distance
+  {
+    using is_kdtree_distance = bool;
+
+    using ElementType = T;
+    using ResultType = detail::distance_result_t<T>;
+
+    static constexpr std::size_t block_size = 16;
+
+    template <typename Iterator1, typename Iterator2>
+    inline auto operator()(Iterator1 a, Iterator2 b, std::size_t size,
+                           ResultType worst_dist = -1) const -> ResultType
+    {
+      using Accumulator =
+          detail::block_accumulator_t<Iterator1, Iterator2, ResultType>;
+
+      auto result = ResultType{};
+      auto i = std::size_t{};
+      for (; i + block_size <= size; i += block_size)
+      {
+        auto block_result = Accumulator{};
+#pragma omp simd reduction(+ : block_result)
+        for (auto j = std::size_t{}; j < block_size; ++j)
+        {
+          const auto d = static_cast<Accumulator>(a[i + j]) -
+                         static_cast<Accumulator>(b[i + j]);
+          block_result += d < 0 ? -d : d;
+        }
+        result += static_cast<ResultType>(block_result);
+
+        if (worst_dist > 0 && result > worst_dist)
+          return result;
+      }
+
+      for (; i < size; ++i)
+        result += accum_dist(a[i], b[i], 0);
+
+      return result;
+    }
+
+    //! @brief Partial distance along one dimension.
+    template <typename U, typename V>
+    inline auto accum_dist(const U& a, const V& b, int) const -> ResultType
+    {
+      return std::abs(static_cast<ResultType>(a) - static_cast<ResultType>(b));
+    }
+  };
+
+
+  /*!
+    @brief Hamming distance between binary descriptors packed in bytes.
+
+    This is not a vector space distance: it must be used with a hierarchical
+    clustering index or a linear index, not with a kd-tree index.
+   */
+  struct HammingDistance
+  {
+    using ElementType = std::uint8_t;
+    using ResultType = std::int32_t;
+
+    template <typename Iterator1, typename Iterator2>
+    inline auto operator()(Iterator1 a, Iterator2 b, std::size_t size,
+                           ResultType = -1) const -> ResultType
+    {
+      auto result = ResultType{};
+      auto i = std::size_t{};
+      for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t))
+      {
+        auto wa = std::uint64_t{};
+        auto wb = std::uint64_t{};
+        std::memcpy(&wa, &a[i], sizeof(std::uint64_t));
+        std::memcpy(&wb, &b[i], sizeof(std::uint64_t));
+        result += popcount(wa ^ wb);
+      }
+
+      for (; i < size; ++i)
+        result += popcount(static_cast<std::uint64_t>(
+            static_cast<std::uint8_t>(a[i] ^ b[i])));
+
+      return result;
+    }
+
+  private:
+    static inline auto popcount(std::uint64_t x) -> ResultType
+    {
+#if defined(__GNUC__) || defined(__clang__)
+      return __builtin_popcountll(x);
+#else
+      x -= (x >> 1) & 0x5555555555555555ULL;
+      x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+      x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+      return static_cast<ResultType>((x * 0x0101010101010101ULL) >> 56);
+#endif
+    }
+  };
+
+  //! @}
+
+  //! @}
+
+}}  // namespace DO::Sara
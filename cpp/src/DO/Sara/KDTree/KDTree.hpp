@@ -16,6 +16,16 @@
 #include <DO/Sara/Defines.hpp>
 
 #include <DO/Sara/Core/EigenExtension.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+
+#include <DO/Sara/KDTree/Distances.hpp>
+
+#ifdef _OPENMP
+#  include <omp.h>
+#endif
+
+#include <stdexcept>
+#include <tuple>
 
 
 namespace DO { namespace Sara {
@@ -130,6 +140,144 @@ namespace DO { namespace Sara {
     flann::SearchParams _search_params;
   };
 
+
+  //! @brief Default index parameters for a distance: a randomized kd-tree
+  //! for vector space distances and a hierarchical clustering tree otherwise.
+  //!
+  //! With the default search parameters, the kd-tree search is exact while
+  //! the hierarchical clustering search is approximate.
+  template <typename Distance>
+  inline auto default_index_params() -> flann::IndexParams
+  {
+    if constexpr (flann::is_kdtree_distance<Distance>::value)
+      return flann::KDTreeIndexParams(1);
+    else
+      return flann::HierarchicalClusteringIndexParams();
+  }
+
+
+  /*!
+    @brief Nearest neighbor index on the rows of a row-major tensor.
+
+    Contrary to 'KDTree', the data points are not converted to double, which
+    is convenient for float descriptors or for uint8-quantized descriptors,
+    e.g.:
+    @code
+    const auto& descriptors = std::get<1>(keys);  // Tensor_<float, 2>
+    auto tree = KDTree_<float>{descriptors};
+
+    auto nn_indices = Tensor_<int, 2>{num_queries, k};
+    auto nn_distances = Tensor_<float, 2>{num_queries, k};
+    tree.knn_search(queries, k, nn_indices, nn_distances);
+    @endcode
+
+    The index does not copy the data points, which must outlive it.
+   */
+  template <typename T, typename Distance = SquaredL2Distance<T>>
+  class KDTree_
+  {
+  public:
+    using scalar_type = T;
+    using distance_type = typename Distance::ResultType;
+
+    //! @brief Build the index on the rows of the data matrix.
+    KDTree_(const TensorView_<T, 2>& data,
+            const flann::IndexParams& index_params =
+                default_index_params<Distance>(),
+            const flann::SearchParams& search_params = flann::SearchParams(-1))
+      : _data{const_cast<T*>(data.data()), static_cast<size_t>(data.rows()),
+              static_cast<size_t>(data.cols())}
+      , _index{_data, index_params}
+      , _search_params{search_params}
+    {
+      _index.buildIndex();
+    }
+
+    //! @brief Number of data points.
+    auto size() const -> int
+    {
+      return static_cast<int>(_data.rows);
+    }
+
+    //! @brief Dimension of the data points.
+    auto dimension() const -> int
+    {
+      return static_cast<int>(_data.cols);
+    }
+
+    /*!
+      @brief Batch k-NN search for the rows of the query matrix.
+
+      The i-th rows of 'nn_indices' and 'nn_distances' are filled with the
+      nearest neighbors of the i-th query by increasing distance. The output
+      tensors must have at least 'num_nearest_neighbors' columns and as many
+      rows as the query matrix. They are not resized so that they can be
+      reused from one batch to the next.
+
+      The queries are dispatched to 'num_threads' threads, where 0 means as
+      many threads as OpenMP would use.
+     */
+    auto knn_search(const TensorView_<T, 2>& queries,
+                    int num_nearest_neighbors, TensorView_<int, 2>& nn_indices,
+                    TensorView_<distance_type, 2>& nn_distances,
+                    int num_threads = 0) const -> void
+    {
+      if (queries.cols() != dimension())
+        throw std::runtime_error{"Dimension of query vectors do not match "
+                                 "dimension of input feature space!"};
+      if (num_nearest_neighbors < 1 || num_nearest_neighbors > size())
+        throw std::domain_error{"Invalid number of nearest neighbors!"};
+      if (nn_indices.rows() != queries.rows() ||
+          nn_distances.rows() != queries.rows() ||
+          nn_indices.cols() < num_nearest_neighbors ||
+          nn_distances.cols() < num_nearest_neighbors)
+        throw std::domain_error{"Invalid sizes for the output tensors!"};
+
+      if (queries.rows() == 0)
+        return;
+
+      auto query_matrix = flann::Matrix<T>{
+          const_cast<T*>(queries.data()), static_cast<size_t>(queries.rows()),
+          static_cast<size_t>(queries.cols())};
+      auto nn_index_matrix = flann::Matrix<int>{
+          nn_indices.data(), static_cast<size_t>(nn_indices.rows()),
+          static_cast<size_t>(nn_indices.cols())};
+      auto nn_distance_matrix = flann::Matrix<distance_type>{
+          nn_distances.data(), static_cast<size_t>(nn_distances.rows()),
+          static_cast<size_t>(nn_distances.cols())};
+
+      auto search_params = _search_params;
+#ifdef _OPENMP
+      search_params.cores =
+          num_threads > 0 ? num_threads : omp_get_max_threads();
+#else
+      (void) num_threads;
+      search_params.cores = 1;
+#endif
+
+      _index.knnSearch(query_matrix, nn_index_matrix, nn_distance_matrix,
+                       num_nearest_neighbors, search_params);
+    }
+
+    //! @brief Batch k-NN search allocating the output tensors.
+    auto knn_search(const TensorView_<T, 2>& queries,
+                    int num_nearest_neighbors, int num_threads = 0) const
+        -> std::tuple<Tensor_<int, 2>, Tensor_<distance_type, 2>>
+    {
+      auto nn_indices = Tensor_<int, 2>{queries.rows(), num_nearest_neighbors};
+      auto nn_distances =
+          Tensor_<distance_type, 2>{queries.rows(), num_nearest_neighbors};
+      knn_search(queries, num_nearest_neighbors, nn_indices, nn_distances,
+                 num_threads);
+      return std::make_tuple(std::move(nn_indices), std::move(nn_distances));
+    }
+
+  private:
+    flann::Matrix<T> _data;
+    flann::Index<Distance> _index;
+    flann::SearchParams _search_params;
+  };
+
   //! @}
 
 } /* namespace Sara */
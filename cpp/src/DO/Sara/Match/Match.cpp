@@ -133,6 +133,8 @@ namespace DO { namespace Sara {
 
   void draw_matches(const vector<Match>& matches, const Point2f& off2, float z)
   {
+    // Send all the drawing commands at once to the GUI thread.
+    const auto batch = PaintingBatch{};
     for (auto m = matches.begin(); m != matches.end(); ++m)
       draw_match(*m, Color3ub(rand()%256, rand()%256, rand()%256), off2, z);
   }
@@ -0,0 +1,821 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/Core/StringFormat.hpp>
+#include <DO/Sara/MultiViewGeometry/BundleAdjuster.hpp>
+#include <DO/Sara/MultiViewGeometry/Utilities.hpp>
+
+#include <Eigen/SparseCholesky>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+
+namespace DO::Sara {
+
+namespace {
+
+  constexpr auto camera_dof = 12;
+
+  using Vector12d = Eigen::Matrix<double, camera_dof, 1>;
+  using Matrix12d = Eigen::Matrix<double, camera_dof, camera_dof>;
+  using Matrix12x3d = Eigen::Matrix<double, camera_dof, 3>;
+  using Matrix2x12d = Eigen::Matrix<double, 2, camera_dof>;
+  using Matrix2x3d = Eigen::Matrix<double, 2, 3>;
+
+
+  //! Compressed lists of observation indices grouped by camera or by point.
+  struct ObservationLists
+  {
+    std::vector<int> offsets;
+    std::vector<int> observations;
+
+    ObservationLists(const std::vector<int>& keys, int num_keys)
+      : offsets(num_keys + 1, 0)
+      , observations(keys.size())
+    {
+      for (const auto& k : keys)
+        ++offsets[k + 1];
+      std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+      auto next = std::vector<int>(offsets.begin(), offsets.end() - 1);
+      for (auto o = 0; o < static_cast<int>(keys.size()); ++o)
+        observations[next[keys[o]]++] = o;
+    }
+
+    auto begin(int k) const
+    {
+      return observations.begin() + offsets[k];
+    }
+
+    auto end(int k) const
+    {
+      return observations.begin() + offsets[k + 1];
+    }
+  };
+
+
+  inline auto rotation(const double* angle_axis) -> Matrix3d
+  {
+    const auto w = Eigen::Map<const Vector3d>{angle_axis};
+    const auto angle = w.norm();
+    if (angle < std::numeric_limits<double>::epsilon())
+      return Matrix3d::Identity() + skew_symmetric_matrix(Vector3d{w});
+    return Eigen::AngleAxisd{angle, w / angle}.toRotationMatrix();
+  }
+
+  //! Calculate the reprojection residual and optionally its Jacobians
+  //! w.r.t. the camera parameters and the 3D point.
+  inline auto project(const double* camera_params, const double* point,
+                      const double* observation, Vector2d& residual,
+                      Matrix2x12d* Jc = nullptr, Matrix2x3d* Jp = nullptr)
+      -> void
+  {
+    const auto camera = CameraModelView<double>{camera_params};
+    const auto& fx = camera.fx();
+    const auto& fy = camera.fy();
+    const auto& l1 = camera.l1();
+    const auto& l2 = camera.l2();
+
+    const Matrix3d R = rotation(camera.angle_axis());
+    const Vector3d RX = R * Eigen::Map<const Vector3d>{point};
+    const Vector3d p = RX + Eigen::Map<const Vector3d>{camera.t()};
+
+    // Normalized camera coordinates.
+    const auto inv_z = 1 / p.z();
+    const auto xp = p.x() * inv_z;
+    const auto yp = p.y() * inv_z;
+
+    // Radial distortion.
+    const auto r2 = xp * xp + yp * yp;
+    const auto distortion = 1 + r2 * (l1 + l2 * r2);
+
+    residual << fx * distortion * xp + camera.x0() - observation[0],
+        fy * distortion * yp + camera.y0() - observation[1];
+
+    if (Jc == nullptr || Jp == nullptr)
+      return;
+
+    // Differentiate the distorted coordinates w.r.t. the normalized ones.
+    const auto ddistortion_dr2 = l1 + 2 * l2 * r2;
+    auto dq_dn = Matrix2d{};
+    dq_dn(0, 0) = distortion + 2 * xp * xp * ddistortion_dr2;
+    dq_dn(0, 1) = 2 * xp * yp * ddistortion_dr2;
+    dq_dn(1, 0) = dq_dn(0, 1);
+    dq_dn(1, 1) = distortion + 2 * yp * yp * ddistortion_dr2;
+    dq_dn.row(0) *= fx;
+    dq_dn.row(1) *= fy;
+
+    // Differentiate the normalized coordinates w.r.t. the camera coordinates.
+    auto dn_dp = Matrix2x3d{};
+    dn_dp << inv_z, 0, -xp * inv_z,  //
+        0, inv_z, -yp * inv_z;
+
+    const Matrix2x3d du_dp = dq_dn * dn_dp;
+
+    // The rotation is perturbed as R <- exp([w]x) R.
+    Jc->block<2, 3>(0, 0) = -du_dp * skew_symmetric_matrix(RX);
+    Jc->block<2, 3>(0, 3) = du_dp;
+    // Internal parameters.
+    Jc->rightCols<6>() <<                                                   //
+        distortion * xp, 0, 1, 0, fx * xp * r2, fx * xp * r2 * r2,          //
+        0, distortion * yp, 0, 1, fy * yp * r2, fy * yp * r2 * r2;
+
+    *Jp = du_dp * R;
+  }
+
+  //! Return the loss and its derivative at the squared error s.
+  inline auto robust_loss(RobustLoss loss, double a, double s)
+      -> std::pair<double, double>
+  {
+    switch (loss)
+    {
+    case RobustLoss::Huber:
+    {
+      const auto a2 = a * a;
+      if (s <= a2)
+        return {s, 1.};
+      const auto r = std::sqrt(s);
+      return {2 * a * r - a2, a / r};
+    }
+    case RobustLoss::Cauchy:
+    {
+      const auto a2 = a * a;
+      return {a2 * std::log1p(s / a2), 1 / (1 + s / a2)};
+    }
+    case RobustLoss::Squared:
+    default:
+      return {s, 1.};
+    }
+  }
+
+
+  //! Levenberg-Marquardt solver with Schur complement.
+  class SchurLevenbergMarquardt
+  {
+  public:
+    SchurLevenbergMarquardt(BundleAdjustmentProblem& problem,
+                            const BundleAdjustmentOptions& options)
+      : _problem{problem}
+      , _options{options}
+      , _num_observations{problem.observations.size(0)}
+      , _num_cameras{problem.num_cameras}
+      , _num_points{problem.num_points}
+      , _camera_obs{problem.camera_indices, problem.num_cameras}
+      , _point_obs{problem.point_indices, problem.num_points}
+    {
+      _camera_is_constant.resize(_num_cameras, false);
+      for (const auto& c : _options.constant_cameras)
+        _camera_is_constant.at(c) = true;
+
+      _r.resize(_num_observations);
+      _Jc.resize(_num_observations);
+      _Jp.resize(_num_observations);
+
+      _U.resize(_num_cameras);
+      _gc.resize(_num_cameras);
+      _V.resize(_num_points);
+      _gp.resize(_num_points);
+      _V_inv.resize(_num_points);
+
+      _dc = VectorXd::Zero(camera_dof * _num_cameras);
+      _dp = VectorXd::Zero(3 * _num_points);
+    }
+
+    auto solve() -> BundleAdjustmentSummary
+    {
+      auto summary = BundleAdjustmentSummary{};
+
+      auto lambda = _options.initial_damping;
+      auto nu = 2.;
+
+      auto cost = linearize();
+      summary.initial_cost = cost;
+
+      if (_options.linear_solver == SchurSolver::SparseCholesky)
+        initialize_reduced_camera_matrix();
+
+      for (summary.num_iterations = 0;
+           summary.num_iterations < _options.max_iterations;
+           ++summary.num_iterations)
+      {
+        if (gradient_max_norm() < _options.gradient_tolerance)
+        {
+          summary.converged = true;
+          break;
+        }
+
+        if (!solve_damped_system(lambda))
+        {
+          lambda *= nu;
+          nu *= 2;
+          continue;
+        }
+
+        const auto parameter_norm = Eigen::Map<const VectorXd>{
+            _problem.parameters.data(),
+            static_cast<Eigen::Index>(_problem.parameters.size())}
+                                        .norm();
+        const auto step_norm =
+            std::sqrt(_dc.squaredNorm() + _dp.squaredNorm());
+        if (step_norm <= _options.parameter_tolerance *
+                             (parameter_norm + _options.parameter_tolerance))
+        {
+          summary.converged = true;
+          break;
+        }
+
+        const auto model_decrease = model_cost_decrease();
+
+        auto new_parameters = _problem.parameters;
+        update(new_parameters);
+        const auto new_cost = evaluate_cost(new_parameters);
+
+        const auto rho = (cost - new_cost) / model_decrease;
+        if (_options.verbose)
+          SARA_DEBUG << format("iter = %3d  cost = %12.6e  new_cost = %12.6e  "
+                               "lambda = %8.2e  rho = %6.3f",
+                               summary.num_iterations, cost, new_cost, lambda,
+                               rho)
+                     << std::endl;
+
+        if (!std::isfinite(new_cost) || !(model_decrease > 0) || !(rho > 0))
+        {
+          lambda *= nu;
+          nu *= 2;
+          continue;
+        }
+
+        // Accept the step. The parameters are copied so that the views of the
+        // problem remain valid.
+        std::copy(new_parameters.begin(), new_parameters.end(),
+                  _problem.parameters.begin());
+        ++summary.num_successful_steps;
+        lambda *= std::max(1. / 3., 1 - std::pow(2 * rho - 1, 3));
+        nu = 2;
+
+        const auto relative_decrease = (cost - new_cost) / cost;
+        cost = linearize();
+        if (relative_decrease < _options.function_tolerance)
+        {
+          summary.converged = true;
+          break;
+        }
+      }
+
+      summary.final_cost = cost;
+      return summary;
+    }
+
+  private:
+    auto camera_params(const std::vector<double>& parameters, int c) const
+        -> const double*
+    {
+      return parameters.data() + camera_dof * c;
+    }
+
+    auto point_coords(const std::vector<double>& parameters, int p) const
+        -> const double*
+    {
+      return parameters.data() + camera_dof * _num_cameras + 3 * p;
+    }
+
+    auto evaluate_cost(const std::vector<double>& parameters) const -> double
+    {
+      const auto& obs = _problem.observations;
+      auto cost = 0.;
+#pragma omp parallel for reduction(+ : cost)
+      for (int o = 0; o < _num_observations; ++o)
+      {
+        auto r = Vector2d{};
+        project(camera_params(parameters, _problem.camera_indices[o]),
+                point_coords(parameters, _problem.point_indices[o]),
+                obs.data() + 2 * o, r);
+        cost += robust_loss(_options.loss, _options.loss_scale,
+                            r.squaredNorm())
+                    .first;
+      }
+      return 0.5 * cost;
+    }
+
+    //! Evaluate the weighted residuals, the Jacobians and the undamped normal
+    //! equations at the current parameters and return the cost.
+    auto linearize() -> double
+    {
+      const auto& parameters = _problem.parameters;
+      const auto& obs = _problem.observations;
+
+      auto cost = 0.;
+#pragma omp parallel for reduction(+ : cost)
+      for (int o = 0; o < _num_observations; ++o)
+      {
+        const auto c = _problem.camera_indices[o];
+        auto& r = _r[o];
+        auto& Jc = _Jc[o];
+        auto& Jp = _Jp[o];
+        project(camera_params(parameters, c),
+                point_coords(parameters, _problem.point_indices[o]),
+                obs.data() + 2 * o, r, &Jc, &Jp);
+
+        const auto [rho, drho] =
+            robust_loss(_options.loss, _options.loss_scale, r.squaredNorm());
+        cost += rho;
+
+        // Reweight the residual and the Jacobians, so that the normal
+        // equations are those of the robustified cost.
+        const auto w = std::sqrt(drho);
+        r *= w;
+        Jc *= w;
+        Jp *= w;
+
+        if (_camera_is_constant[c])
+          Jc.setZero();
+        else if (!_options.refine_intrinsics)
+          Jc.rightCols<6>().setZero();
+      }
+
+#pragma omp parallel for
+      for (int c = 0; c < _num_cameras; ++c)
+      {
+        _U[c].setZero();
+        _gc[c].setZero();
+        for (auto o = _camera_obs.begin(c); o != _camera_obs.end(c); ++o)
+        {
+          _U[c].noalias() += _Jc[*o].transpose() * _Jc[*o];
+          _gc[c].noalias() += _Jc[*o].transpose() * _r[*o];
+        }
+      }
+
+#pragma omp parallel for
+      for (int p = 0; p < _num_points; ++p)
+      {
+        _V[p].setZero();
+        _gp[p].setZero();
+        for (auto o = _point_obs.begin(p); o != _point_obs.end(p); ++o)
+        {
+          _V[p].noalias() += _Jp[*o].transpose() * _Jp[*o];
+          _gp[p].noalias() += _Jp[*o].transpose() * _r[*o];
+        }
+      }
+
+      return 0.5 * cost;
+    }
+
+    auto gradient_max_norm() const -> double
+    {
+      auto g = 0.;
+      for (const auto& gc : _gc)
+        g = std::max(g, gc.cwiseAbs().maxCoeff());
+      for (const auto& gp : _gp)
+        g = std::max(g, gp.cwiseAbs().maxCoeff());
+      return g;
+    }
+
+    //! Marquardt damping of a diagonal block. Parameters that are kept
+    //! constant have a zero diagonal entry, which is replaced by 1.
+    template <typename Matrix>
+    static auto damp(Matrix& A, double lambda) -> void
+    {
+      for (auto i = 0; i < A.rows(); ++i)
+      {
+        if (A(i, i) == 0)
+          A(i, i) = 1;
+        else
+          A(i, i) += lambda * std::clamp(A(i, i), 1e-6, 1e32);
+      }
+    }
+
+    //! @{
+    //! Off-diagonal block W = Jc^T Jp of an observation. The products with
+    //! vectors are cheaper without forming W.
+    auto W(int o) const -> Matrix12x3d
+    {
+      return _Jc[o].transpose() * _Jp[o];
+    }
+
+    auto W_times(int o, const Vector3d& x) const -> Vector12d
+    {
+      return _Jc[o].transpose() * (_Jp[o] * x);
+    }
+
+    template <typename Vector>
+    auto Wt_times(int o, const Vector& x) const -> Vector3d
+    {
+      return _Jp[o].transpose() * (_Jc[o] * x);
+    }
+    //! @}
+
+    auto damped_U(int c, double lambda) const -> Matrix12d
+    {
+      Matrix12d U = _U[c];
+      damp(U, lambda);
+      return U;
+    }
+
+    auto solve_damped_system(double lambda) -> bool
+    {
+#pragma omp parallel for
+      for (int p = 0; p < _num_points; ++p)
+      {
+        Matrix3d V = _V[p];
+        damp(V, lambda);
+        _V_inv[p] = V.inverse();
+      }
+
+      // Right-hand side of the reduced camera system:
+      //   b = -gc + W V^{-1} gp.
+      auto b = VectorXd{camera_dof * _num_cameras};
+#pragma omp parallel for
+      for (int c = 0; c < _num_cameras; ++c)
+      {
+        Vector12d bc = -_gc[c];
+        for (auto o = _camera_obs.begin(c); o != _camera_obs.end(c); ++o)
+        {
+          const auto p = _problem.point_indices[*o];
+          bc.noalias() += W_times(*o, _V_inv[p] * _gp[p]);
+        }
+        b.segment<camera_dof>(camera_dof * c) = bc;
+      }
+
+      const auto solved = _options.linear_solver == SchurSolver::SparseCholesky
+                              ? solve_sparse_cholesky(lambda, b)
+                              : solve_conjugate_gradient(lambda, b);
+      if (!solved || !_dc.allFinite())
+        return false;
+
+      // Back-substitute the point updates:
+      //   dp = V^{-1} (-gp - W^T dc).
+#pragma omp parallel for
+      for (int p = 0; p < _num_points; ++p)
+      {
+        Vector3d rhs = -_gp[p];
+        for (auto o = _point_obs.begin(p); o != _point_obs.end(p); ++o)
+        {
+          const auto c = _problem.camera_indices[*o];
+          rhs.noalias() -=
+              Wt_times(*o, _dc.segment<camera_dof>(camera_dof * c));
+        }
+        _dp.segment<3>(3 * p) = _V_inv[p] * rhs;
+      }
+
+      return _dp.allFinite();
+    }
+
+    //! Build the sparsity pattern of the upper triangular part of the reduced
+    //! camera matrix S. The block (c1, c2) is nonzero if the cameras c1 and
+    //! c2 observe a common point.
+    auto initialize_reduced_camera_matrix() -> void
+    {
+      _camera_neighbors.assign(_num_cameras, {});
+#pragma omp parallel for
+      for (int c1 = 0; c1 < _num_cameras; ++c1)
+      {
+        auto& neighbors = _camera_neighbors[c1];
+        neighbors.push_back(c1);
+        for (auto o1 = _camera_obs.begin(c1); o1 != _camera_obs.end(c1); ++o1)
+        {
+          const auto p = _problem.point_indices[*o1];
+          for (auto o2 = _point_obs.begin(p); o2 != _point_obs.end(p); ++o2)
+          {
+            const auto c2 = _problem.camera_indices[*o2];
+            if (c2 > c1)
+              neighbors.push_back(c2);
+          }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()),
+                        neighbors.end());
+      }
+
+      _block_offsets.resize(_num_cameras + 1);
+      _block_offsets[0] = 0;
+      for (auto c = 0; c < _num_cameras; ++c)
+        _block_offsets[c + 1] =
+            _block_offsets[c] + static_cast<int>(_camera_neighbors[c].size());
+      _S_blocks.resize(_block_offsets.back());
+
+      // The nonzero coefficients are enumerated column by column, each
+      // column being sorted by row index, which is Eigen's storage order.
+      auto column_blocks = std::vector<std::vector<int>>(_num_cameras);
+      for (auto c1 = 0; c1 < _num_cameras; ++c1)
+        for (auto k = 0u; k < _camera_neighbors[c1].size(); ++k)
+          column_blocks[_camera_neighbors[c1][k]].push_back(
+              _block_offsets[c1] + k);
+
+      _S_value_indices.clear();
+      auto triplets = std::vector<Eigen::Triplet<double>>{};
+      for (auto c2 = 0; c2 < _num_cameras; ++c2)
+      {
+        for (auto b = 0; b < camera_dof; ++b)
+        {
+          const auto col = camera_dof * c2 + b;
+          for (const auto& block : column_blocks[c2])
+          {
+            const auto c1 = block_row(block);
+            const auto num_rows = c1 == c2 ? b + 1 : camera_dof;
+            for (auto a = 0; a < num_rows; ++a)
+            {
+              triplets.emplace_back(camera_dof * c1 + a, col, 0.);
+              _S_value_indices.push_back(camera_dof * camera_dof * block +
+                                         camera_dof * b + a);
+            }
+          }
+        }
+      }
+
+      const auto n = camera_dof * _num_cameras;
+      _S.resize(n, n);
+      _S.setFromTriplets(triplets.begin(), triplets.end());
+      _S.makeCompressed();
+      if (_S.nonZeros() != static_cast<Eigen::Index>(_S_value_indices.size()))
+        throw std::runtime_error{
+            "Error: inconsistent reduced camera matrix structure!"};
+
+      _S_solver.analyzePattern(_S);
+    }
+
+    auto block_row(int block) const -> int
+    {
+      const auto it = std::upper_bound(_block_offsets.begin(),
+                                       _block_offsets.end(), block);
+      return static_cast<int>(it - _block_offsets.begin()) - 1;
+    }
+
+    auto block_index(int c1, int c2) const -> int
+    {
+      const auto& neighbors = _camera_neighbors[c1];
+      const auto it = std::lower_bound(neighbors.begin(), neighbors.end(), c2);
+      return _block_offsets[c1] + static_cast<int>(it - neighbors.begin());
+    }
+
+    //! Form S = U - W V^{-1} W^T block row by block row and factorize it.
+    auto solve_sparse_cholesky(double lambda, const VectorXd& b) -> bool
+    {
+#pragma omp parallel for
+      for (int c1 = 0; c1 < _num_cameras; ++c1)
+      {
+        for (auto k = _block_offsets[c1]; k < _block_offsets[c1 + 1]; ++k)
+          _S_blocks[k].setZero();
+        _S_blocks[_block_offsets[c1]] = damped_U(c1, lambda);
+
+        for (auto o1 = _camera_obs.begin(c1); o1 != _camera_obs.end(c1); ++o1)
+        {
+          const auto p = _problem.point_indices[*o1];
+          const Matrix12x3d Y = W(*o1) * _V_inv[p];
+          for (auto o2 = _point_obs.begin(p); o2 != _point_obs.end(p); ++o2)
+          {
+            const auto c2 = _problem.camera_indices[*o2];
+            if (c2 < c1)
+              continue;
+            _S_blocks[block_index(c1, c2)].noalias() -= Y * W(*o2).transpose();
+          }
+        }
+      }
+
+      auto values = _S.valuePtr();
+      const auto num_values = static_cast<int>(_S_value_indices.size());
+#pragma omp parallel for
+      for (int i = 0; i < num_values; ++i)
+      {
+        const auto block = _S_value_indices[i] / (camera_dof * camera_dof);
+        const auto coeff = _S_value_indices[i] % (camera_dof * camera_dof);
+        values[i] = _S_blocks[block].data()[coeff];
+      }
+
+      _S_solver.factorize(_S);
+      if (_S_solver.info() != Eigen::Success)
+        return false;
+
+      _dc = _S_solver.solve(b);
+      return _S_solver.info() == Eigen::Success;
+    }
+
+    //! Calculate y = S x without forming S.
+    auto reduced_camera_product(const std::vector<Matrix12d>& U,
+                                const VectorXd& x, VectorXd& y,
+                                std::vector<Vector3d>& z) const -> void
+    {
+#pragma omp parallel for
+      for (int p = 0; p < _num_points; ++p)
+      {
+        Vector3d zp = Vector3d::Zero();
+        for (auto o = _point_obs.begin(p); o != _point_obs.end(p); ++o)
+        {
+          const auto c = _problem.camera_indices[*o];
+          zp.noalias() += Wt_times(*o, x.segment<camera_dof>(camera_dof * c));
+        }
+        z[p] = _V_inv[p] * zp;
+      }
+
+#pragma omp parallel for
+      for (int c = 0; c < _num_cameras; ++c)
+      {
+        Vector12d yc = U[c] * x.segment<camera_dof>(camera_dof * c);
+        for (auto o = _camera_obs.begin(c); o != _camera_obs.end(c); ++o)
+          yc.noalias() -= W_times(*o, z[_problem.point_indices[*o]]);
+        y.segment<camera_dof>(camera_dof * c) = yc;
+      }
+    }
+
+    auto solve_conjugate_gradient(double lambda, const VectorXd& b) -> bool
+    {
+      auto U = std::vector<Matrix12d>(_num_cameras);
+      auto preconditioner =
+          std::vector<Eigen::LDLT<Matrix12d>>(_num_cameras);
+#pragma omp parallel for
+      for (int c = 0; c < _num_cameras; ++c)
+      {
+        U[c] = damped_U(c, lambda);
+
+        // Diagonal block of the reduced camera matrix.
+        Matrix12d S_cc = U[c];
+        for (auto o1 = _camera_obs.begin(c); o1 != _camera_obs.end(c); ++o1)
+        {
+          const auto p = _problem.point_indices[*o1];
+          const Matrix12x3d Y = W(*o1) * _V_inv[p];
+          for (auto o2 = _point_obs.begin(p); o2 != _point_obs.end(p); ++o2)
+            if (_problem.camera_indices[*o2] == c)
+              S_cc.noalias() -= Y * W(*o2).transpose();
+        }
+        preconditioner[c].compute(S_cc);
+      }
+
+      const auto apply_preconditioner = [&](const VectorXd& r, VectorXd& z) {
+#pragma omp parallel for
+        for (int c = 0; c < _num_cameras; ++c)
+          z.segment<camera_dof>(camera_dof * c) =
+              preconditioner[c].solve(r.segment<camera_dof>(camera_dof * c));
+      };
+
+      const auto n = camera_dof * _num_cameras;
+      auto& x = _dc;
+      x.setZero();
+      auto r = VectorXd{b};
+      auto z = VectorXd{n};
+      auto q = VectorXd{n};
+      auto work = std::vector<Vector3d>(_num_points);
+
+      apply_preconditioner(r, z);
+      auto d = VectorXd{z};
+      auto rz = r.dot(z);
+
+      const auto b_norm = b.norm();
+      if (b_norm == 0)
+        return true;
+
+      auto i = 0;
+      for (; i < _options.max_linear_iterations; ++i)
+      {
+        reduced_camera_product(U, d, q, work);
+        const auto dq = d.dot(q);
+        if (!(dq > 0))
+          return i > 0;
+
+        const auto alpha = rz / dq;
+        x.noalias() += alpha * d;
+        r.noalias() -= alpha * q;
+        if (r.norm() <= _options.linear_tolerance * b_norm)
+          break;
+
+        apply_preconditioner(r, z);
+        const auto rz_new = r.dot(z);
+        d = z + (rz_new / rz) * d;
+        rz = rz_new;
+      }
+
+      if (_options.verbose)
+        SARA_DEBUG << format("CG iterations = %d  relative residual = %8.2e",
+                             i, r.norm() / b_norm)
+                   << std::endl;
+
+      return true;
+    }
+
+    //! Decrease of the quadratic model of the cost, where the Jacobians are
+    //! undamped.
+    auto model_cost_decrease() const -> double
+    {
+      auto decrease = 0.;
+#pragma omp parallel for reduction(+ : decrease)
+      for (int o = 0; o < _num_observations; ++o)
+      {
+        const auto c = _problem.camera_indices[o];
+        const auto p = _problem.point_indices[o];
+        const Vector2d Jd =
+            _Jc[o] * _dc.segment<camera_dof>(camera_dof * c) +
+            _Jp[o] * _dp.segment<3>(3 * p);
+        decrease -= _r[o].dot(Jd) + 0.5 * Jd.squaredNorm();
+      }
+      return decrease;
+    }
+
+    auto update(std::vector<double>& parameters) const -> void
+    {
+#pragma omp parallel for
+      for (int c = 0; c < _num_cameras; ++c)
+      {
+        auto camera = Eigen::Map<Vector12d>{parameters.data() + camera_dof * c};
+        const auto dc = _dc.segment<camera_dof>(camera_dof * c);
+
+        const Vector3d w = dc.head<3>();
+        const auto angle = w.norm();
+        if (angle > 0)
+        {
+          const Matrix3d R =
+              Eigen::AngleAxisd{angle, w / angle}.toRotationMatrix() *
+              rotation(camera.data());
+          const auto angle_axis = Eigen::AngleAxisd{R};
+          camera.head<3>() = angle_axis.angle() * angle_axis.axis();
+        }
+        camera.tail<9>() += dc.tail<9>();
+      }
+
+      auto points = Eigen::Map<VectorXd>{
+          parameters.data() + camera_dof * _num_cameras, 3 * _num_points};
+      points += _dp;
+    }
+
+  private:
+    BundleAdjustmentProblem& _problem;
+    const BundleAdjustmentOptions& _options;
+
+    int _num_observations;
+    int _num_cameras;
+    int _num_points;
+    ObservationLists _camera_obs;
+    ObservationLists _point_obs;
+    std::vector<bool> _camera_is_constant;
+
+    //! Weighted residuals and Jacobians.
+    std::vector<Vector2d> _r;
+    std::vector<Matrix2x12d> _Jc;
+    std::vector<Matrix2x3d> _Jp;
+
+    //! Blocks of the undamped normal equations.
+    std::vector<Matrix12d> _U;
+    std::vector<Vector12d> _gc;
+    std::vector<Matrix3d> _V;
+    std::vector<Vector3d> _gp;
+    std::vector<Matrix3d> _V_inv;
+
+    //! Reduced camera matrix.
+    std::vector<std::vector<int>> _camera_neighbors;
+    std::vector<int> _block_offsets;
+    std::vector<Matrix12d> _S_blocks;
+    std::vector<int> _S_value_indices;
+    Eigen::SparseMatrix<double> _S;
+    Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Upper> _S_solver;
+
+    //! Camera and point updates.
+    VectorXd _dc;
+    VectorXd _dp;
+  };
+
+}  // namespace
+
+
+auto bundle_adjust(BundleAdjustmentProblem& problem,
+                   const BundleAdjustmentOptions& options)
+    -> BundleAdjustmentSummary
+{
+  if (problem.camera_dof != CameraModelView<double>::dof())
+    throw std::runtime_error{"Error: unsupported camera model!"};
+  if (problem.observations.size(0) !=
+          static_cast<int>(problem.camera_indices.size()) ||
+      problem.observations.size(0) !=
+          static_cast<int>(problem.point_indices.size()))
+    throw std::runtime_error{"Error: inconsistent number of observations!"};
+
+  auto solver = SchurLevenbergMarquardt{problem, options};
+  return solver.solve();
+}
+
+auto reprojection_residuals(const BundleAdjustmentProblem& problem)
+    -> Tensor_<double, 2>
+{
+  const auto num_observations = problem.observations.size(0);
+  auto residuals = Tensor_<double, 2>{num_observations, 2};
+
+#pragma omp parallel for
+  for (int o = 0; o < num_observations; ++o)
+  {
+    auto r = Vector2d{};
+    project(problem.camera_parameters[problem.camera_indices[o]].data(),
+            problem.points_abs_coords_3d[problem.point_indices[o]].data(),
+            problem.observations[o].data(), r);
+    residuals[o].row_vector() = r.transpose();
+  }
+
+  return residuals;
+}
+
+} /* namespace DO::Sara */
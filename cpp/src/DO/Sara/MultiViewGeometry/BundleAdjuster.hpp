@@ -0,0 +1,126 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <DO/Sara/MultiViewGeometry/BundleAdjustmentProblem.hpp>
+
+#include <cstdint>
+#include <vector>
+
+
+namespace DO::Sara {
+
+  /*!
+   *  @addtogroup MultiviewBA
+   *  @{
+   */
+
+  //! @brief Robust loss applied to the squared reprojection errors.
+  enum class RobustLoss : std::uint8_t
+  {
+    Squared,
+    Huber,
+    Cauchy
+  };
+
+  //! @brief Linear solver of the reduced camera system.
+  enum class SchurSolver : std::uint8_t
+  {
+    //! @brief Sparse Cholesky factorization of the reduced camera matrix.
+    SparseCholesky,
+    //! @brief Conjugate gradient with a block-Jacobi preconditioner, where the
+    //! reduced camera matrix is never formed.
+    //!
+    //! This is the option for very large problems.
+    ConjugateGradient
+  };
+
+  //! @brief Bundle adjustment options.
+  struct BundleAdjustmentOptions
+  {
+    //! @{
+    //! @brief Stopping criteria.
+    int max_iterations = 50;
+    double function_tolerance = 1e-8;
+    double gradient_tolerance = 1e-10;
+    double parameter_tolerance = 1e-10;
+    //! @}
+
+    //! @brief Initial Levenberg-Marquardt damping.
+    double initial_damping = 1e-4;
+
+    //! @{
+    //! @brief Robust loss and its scale in pixels.
+    RobustLoss loss = RobustLoss::Squared;
+    double loss_scale = 1.;
+    //! @}
+
+    //! @{
+    //! @brief Linear solver settings.
+    //!
+    //! The conjugate gradient stops when the residual norm is reduced by
+    //! 'linear_tolerance'. Inexact steps are fine for Levenberg-Marquardt.
+    SchurSolver linear_solver = SchurSolver::SparseCholesky;
+    int max_linear_iterations = 500;
+    double linear_tolerance = 1e-1;
+    //! @}
+
+    //! @brief Refine the internal parameters (fx, fy, x0, y0, l1, l2).
+    bool refine_intrinsics = true;
+
+    //! @brief Cameras whose parameters are not refined, typically to fix the
+    //! gauge freedom.
+    std::vector<int> constant_cameras;
+
+    bool verbose = false;
+  };
+
+  //! @brief Bundle adjustment summary.
+  struct BundleAdjustmentSummary
+  {
+    //! @brief Costs, i.e., half the sum of the robustified squared
+    //! reprojection errors.
+    double initial_cost = 0;
+    double final_cost = 0;
+    int num_iterations = 0;
+    int num_successful_steps = 0;
+    bool converged = false;
+  };
+
+  /*!
+    @brief Refine the cameras and the 3D points with the Levenberg-Marquardt
+    algorithm.
+
+    The camera model is the 12-DoF model of 'CameraModelView'. The rotation is
+    updated multiplicatively, i.e., R <- exp([w]x) R, and stored back as an
+    angle-axis vector.
+
+    The Jacobians are analytic. At each iteration, the 3D points are
+    eliminated from the normal equations by Schur complement and the reduced
+    camera system is solved with the chosen 'SchurSolver'. The Jacobians and
+    the normal equations are assembled in parallel.
+   */
+  DO_SARA_EXPORT
+  auto bundle_adjust(BundleAdjustmentProblem& problem,
+                     const BundleAdjustmentOptions& options = {})
+      -> BundleAdjustmentSummary;
+
+  //! @brief Calculate the (N, 2) reprojection residuals of the observations.
+  DO_SARA_EXPORT
+  auto reprojection_residuals(const BundleAdjustmentProblem& problem)
+      -> Tensor_<double, 2>;
+
+  //! @}
+
+} /* namespace DO::Sara */
@@ -51,15 +51,7 @@ auto ViewAttributes::read_images() -> void
 
 auto ViewAttributes::read_keypoints(H5File& h5_file) -> void
 {
-  if (!keypoints.empty())
-    keypoints.clear();
-
-  keypoints.reserve(image_paths.size());
-  std::transform(std::begin(group_names), std::end(group_names),
-                 std::back_inserter(keypoints),
-                 [&](const std::string& group_name) {
-                   return DO::Sara::read_keypoints(h5_file, group_name);
-                 });
+  keypoints = DO::Sara::read_keypoints(h5_file, group_names);
 }
 
 
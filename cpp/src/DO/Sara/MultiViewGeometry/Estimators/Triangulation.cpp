@@ -15,35 +15,114 @@
 
 namespace DO::Sara {
 
-auto triangulate_single_point_linear_eigen(const Matrix34d& P1,
-                                           const Matrix34d& P2,
-                                           const Vector3d& u1,
-                                           const Vector3d& u2) -> Vector4d
+//! Accumulate the normal equations of the two linear constraints
+//!   (u x P) X = 0
+//! for a single view.
+static inline auto accumulate_normal_equations(const Matrix34d& P,
+                                               const double* u, Matrix4d& AtA)
+    -> void
+{
+  const RowVector4d a0 = u[0] * P.row(2) - u[2] * P.row(0);
+  const RowVector4d a1 = u[1] * P.row(2) - u[2] * P.row(1);
+  AtA.noalias() += a0.transpose() * a0;
+  AtA.noalias() += a1.transpose() * a1;
+}
+
+static inline auto triangulate_point(const Matrix34d& P1, const Matrix34d& P2,
+                                     const double* u1, const double* u2)
+    -> Vector4d
 {
-  Matrix<double, 6, 6> M = Matrix<double, 6, 6>::Zero(6, 6);
+  Matrix4d AtA = Matrix4d::Zero();
+  accumulate_normal_equations(P1, u1, AtA);
+  accumulate_normal_equations(P2, u2, AtA);
 
-  for (int i = 0; i < u1.cols(); ++i)
+  // Finite points: fix the last coordinate to 1 and solve the 3x3 system in
+  // closed form.
+  const Matrix3d A = AtA.topLeftCorner<3, 3>();
+  const auto scale = A.cwiseAbs().maxCoeff();
+  if (std::abs(A.determinant()) > 1e-12 * scale * scale * scale)
   {
-    M.block<3, 4>(0, 0) = P1;
-    M.block<3, 4>(3, 0) = P2;
-    M.block<3, 1>(0, 4) = -u1;
-    M.block<3, 1>(3, 5) = -u2;
+    auto X = Vector4d{};
+    X.head<3>() = -A.inverse() * AtA.topRightCorner<3, 1>();
+    X(3) = 1;
+    return X;
   }
 
-  JacobiSVD<MatrixXd> svd(M, Eigen::ComputeFullV);
-  const MatrixXd& V = svd.matrixV();
-  return V.col(5).head(4) / V(3, 5);
+  // Points close to infinity: the solution is the eigenvector of the
+  // smallest eigenvalue.
+  const auto eig = Eigen::SelfAdjointEigenSolver<Matrix4d>{AtA};
+  const Vector4d X = eig.eigenvectors().col(0);
+  return X / X(3);
+}
+
+auto triangulate_single_point_linear_eigen(const Matrix34d& P1,
+                                           const Matrix34d& P2,
+                                           const Vector3d& u1,
+                                           const Vector3d& u2) -> Vector4d
+{
+  return triangulate_point(P1, P2, u1.data(), u2.data());
 }
 
 auto triangulate_linear_eigen(const Matrix34d& P1, const Matrix34d& P2,
                               const MatrixXd& u1, const MatrixXd& u2)
     -> MatrixXd
 {
-  auto X = MatrixXd{4, u1.cols()};
-  for (int i = 0; i < u1.cols(); ++i)
-    X.col(i) = triangulate_single_point_linear_eigen(
-        P1, P2, Vector3d{u1.col(i)}, Vector3d{u2.col(i)});
+  const auto num_points = static_cast<int>(u1.cols());
+  auto X = MatrixXd{4, num_points};
+
+#pragma omp parallel for
+  for (int i = 0; i < num_points; ++i)
+    X.col(i) = triangulate_point(P1, P2, u1.col(i).data(), u2.col(i).data());
+
   return X;
 }
 
+auto triangulate(const Matrix34d& P1, const Matrix34d& P2,
+                 const TensorView_<double, 2>& u1,
+                 const TensorView_<double, 2>& u2, TensorView_<double, 2>& X,
+                 TensorView_<bool, 1>& cheirality,
+                 TensorView_<double, 1>& reprojection_errors) -> void
+{
+  const auto num_points = u1.size(0);
+  if (u1.size(1) != 3 || u2.sizes() != u1.sizes())
+    throw std::runtime_error{"Error: the image points must be (N, 3) tensors!"};
+  if (X.sizes() != Eigen::Vector2i(num_points, 4) ||
+      cheirality.size(0) != num_points ||
+      reprojection_errors.size(0) != num_points)
+    throw std::runtime_error{"Error: invalid sizes of the output tensors!"};
+
+  const auto reprojection_error = [](const Vector3d& PX, const double* u) {
+    return (PX.hnormalized() - Vector2d{u[0] / u[2], u[1] / u[2]}).norm();
+  };
+
+#pragma omp parallel for
+  for (int i = 0; i < num_points; ++i)
+  {
+    const auto u1i = u1.data() + 3 * i;
+    const auto u2i = u2.data() + 3 * i;
+
+    const Vector4d Xi = triangulate_point(P1, P2, u1i, u2i);
+    const Vector3d P1X = P1 * Xi;
+    const Vector3d P2X = P2 * Xi;
+
+    Eigen::Map<Vector4d>{X.data() + 4 * i} = Xi;
+    cheirality(i) = P1X.z() > 0 && P2X.z() > 0;
+    reprojection_errors(i) = std::max(reprojection_error(P1X, u1i),
+                                      reprojection_error(P2X, u2i));
+  }
+}
+
+auto triangulate(const Matrix34d& P1, const Matrix34d& P2,
+                 const TensorView_<double, 2>& u1,
+                 const TensorView_<double, 2>& u2)
+    -> std::tuple<Tensor_<double, 2>, Tensor_<bool, 1>, Tensor_<double, 1>>
+{
+  const auto num_points = u1.size(0);
+  auto X = Tensor_<double, 2>{num_points, 4};
+  auto cheirality = Tensor_<bool, 1>{num_points};
+  auto reprojection_errors = Tensor_<double, 1>{num_points};
+  triangulate(P1, P2, u1, u2, X, cheirality, reprojection_errors);
+  return {std::move(X), std::move(cheirality), std::move(reprojection_errors)};
+}
+
 } /* namespace DO::Sara */
@@ -14,6 +14,9 @@
 #include <DO/Sara/Defines.hpp>
 
 #include <DO/Sara/Core/EigenExtension.hpp>
+#include <DO/Sara/Core/Tensor.hpp>
+
+#include <tuple>
 
 
 namespace DO::Sara {
@@ -23,6 +26,10 @@ namespace DO::Sara {
 
   //! @{
   //! @brief Invariant up to affine-transformations.
+  //!
+  //! The point is the solution of the 4x4 normal equations of the linear
+  //! system. These are solved in closed form with fixed-size matrices, so
+  //! that no memory is allocated on the heap.
   DO_SARA_EXPORT
   auto triangulate_single_point_linear_eigen(const Matrix34d& P1,
                                              const Matrix34d& P2,
@@ -35,6 +42,38 @@ namespace DO::Sara {
       -> MatrixXd;
   //! @}
 
+  /*!
+    @brief Triangulate a batch of point correspondences in parallel.
+
+    The homogeneous coordinates 'u1' and 'u2' are stored row-wise in (N, 3)
+    tensors. In the same pass, the function calculates for each point:
+    - its homogeneous coordinates 'X' with a unit last coordinate in a (N, 4)
+      tensor,
+    - its cheirality, i.e., whether it has a positive depth w.r.t. both
+      cameras,
+    - its reprojection error, i.e., the larger of the distances between the
+      projected point and the image point in each view.
+
+    The outputs must already have the right sizes.
+
+    N.B.: a (N, 3) row-major tensor has the same memory layout as a 3xN
+    column-major Eigen matrix.
+   */
+  DO_SARA_EXPORT
+  auto triangulate(const Matrix34d& P1, const Matrix34d& P2,
+                   const TensorView_<double, 2>& u1,
+                   const TensorView_<double, 2>& u2,
+                   TensorView_<double, 2>& X,
+                   TensorView_<bool, 1>& cheirality,
+                   TensorView_<double, 1>& reprojection_errors) -> void;
+
+  //! @brief Allocating overload.
+  DO_SARA_EXPORT
+  auto triangulate(const Matrix34d& P1, const Matrix34d& P2,
+                   const TensorView_<double, 2>& u1,
+                   const TensorView_<double, 2>& u2)
+      -> std::tuple<Tensor_<double, 2>, Tensor_<bool, 1>, Tensor_<double, 1>>;
+
   //! @}
 
 } /* namespace DO::Sara */
@@ -26,6 +26,8 @@ namespace DO::Sara {
     PinholeCamera C2;
     Eigen::MatrixXd X;
     Eigen::Array<bool, 1, Eigen::Dynamic> cheirality;
+    //! @brief Reprojection errors of the points, if they were calculated.
+    Eigen::Array<double, 1, Eigen::Dynamic> reprojection_errors;
   };
 
   inline auto two_view_geometry(const Motion& m, const MatrixXd& u1,
@@ -37,7 +39,7 @@ namespace DO::Sara {
     const Matrix34d P2 = C2;
     const auto X = triangulate_linear_eigen(P1, P2, u1, u2);
     const auto cheirality = relative_motion_cheirality_predicate(X, P2);
-    return {C1, C2, X, cheirality};
+    return {C1, C2, X, cheirality, {}};
   }
 
   //! @}
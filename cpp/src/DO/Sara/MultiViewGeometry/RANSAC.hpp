@@ -13,6 +13,7 @@
 
 #include <DO/Sara/Core/DebugUtilities.hpp>
 #include <DO/Sara/Core/Numpy.hpp>
+#include <DO/Sara/Core/Profiler.hpp>
 #include <DO/Sara/Core/Random.hpp>
 #include <DO/Sara/Core/Tensor.hpp>
 #include <DO/Sara/MultiViewGeometry/DataTransformations.hpp>
@@ -39,6 +40,8 @@ namespace DO::Sara {
   {
     using Model = typename Estimator::model_type;
 
+    SARA_PROFILE_SCOPE("RANSAC");
+
     // Normalization transformation.
     auto normalizer = Normalizer<Model>{p1, p2};
 
@@ -118,13 +121,19 @@ namespace DO::Sara {
           inliers_best.flat_array() = inliers;
           subset_best = S[n];
 
+#ifdef DEBUG
           SARA_CHECK(model_best);
           SARA_CHECK(num_inliers);
           SARA_CHECK(subset_best.row_vector());
+#endif
         }
       }
     }
 
+    SARA_PROFILE_COUNTER("ransac.iterations", N);
+    SARA_PROFILE_HISTOGRAM("ransac.inlier_ratio",
+                           double(num_inliers_best) / card_M);
+
     return std::make_tuple(model_best, inliers_best, subset_best);
   }
 
@@ -16,3 +16,4 @@
 #include <DO/Sara/SfM/BuildingBlocks/FundamentalMatrixEstimation.hpp>
 #include <DO/Sara/SfM/BuildingBlocks/EssentialMatrixEstimation.hpp>
 #include <DO/Sara/SfM/BuildingBlocks/Triangulation.hpp>
+#include <DO/Sara/SfM/BuildingBlocks/IncrementalReconstruction.hpp>
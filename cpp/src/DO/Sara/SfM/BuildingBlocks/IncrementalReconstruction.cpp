@@ -0,0 +1,715 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#include <DO/Sara/Core/DebugUtilities.hpp>
+#include <DO/Sara/Core/Profiler.hpp>
+#include <DO/Sara/MultiViewGeometry/Estimators/Triangulation.hpp>
+#include <DO/Sara/SfM/BuildingBlocks/IncrementalReconstruction.hpp>
+
+#include <boost/graph/kruskal_min_spanning_tree.hpp>
+#include <boost/property_map/transform_value_property_map.hpp>
+
+#include <algorithm>
+#include <queue>
+#include <random>
+
+
+using namespace std;
+
+
+namespace DO::Sara {
+
+  static auto project_to_so3(const Matrix3d& M) -> Matrix3d
+  {
+    const auto svd = Eigen::JacobiSVD<Matrix3d>{
+        M, Eigen::ComputeFullU | Eigen::ComputeFullV};
+    const Matrix3d& U = svd.matrixU();
+    const Matrix3d& V = svd.matrixV();
+    const auto s = (U * V.transpose()).determinant() > 0 ? 1. : -1.;
+    return U * Vector3d{1, 1, s}.asDiagonal() * V.transpose();
+  }
+
+
+  auto maximum_spanning_tree(const PoseGraph& pose_graph)
+      -> std::vector<PoseGraph::edge_descriptor>
+  {
+    // Kruskal's algorithm on the negated weights.
+    const auto weights = boost::make_transform_value_property_map(
+        [](const EpipolarEdgeID& e) { return -e.weight; },
+        boost::get(boost::edge_bundle, pose_graph));
+
+    auto mst = std::vector<PoseGraph::edge_descriptor>{};
+    mst.reserve(boost::num_vertices(pose_graph));
+    boost::kruskal_minimum_spanning_tree(pose_graph, std::back_inserter(mst),
+                                         boost::weight_map(weights));
+    return mst;
+  }
+
+  auto average_rotations(const PoseGraph& pose_graph,
+                         const EpipolarEdgeAttributes& epipolar_edges,
+                         int root, int num_sweeps)
+      -> std::vector<Eigen::Matrix3d>
+  {
+    const auto num_vertices = static_cast<int>(boost::num_vertices(pose_graph));
+    if (root < 0 || root >= num_vertices)
+      throw std::runtime_error{"Invalid root vertex!"};
+
+    // Estimate of R[v] from R[u] and the edge (u, v).
+    const auto relative_rotation = [&](const PoseGraph::edge_descriptor& e,
+                                       int u) -> Matrix3d {
+      const auto ij = pose_graph[e].id;
+      const Matrix3d& Rij = epipolar_edges.two_view_geometries[ij].C2.R;
+      return epipolar_edges.edges[ij].first == u ? Rij : Rij.transpose();
+    };
+
+    auto mst_adjacency =
+        std::vector<std::vector<PoseGraph::edge_descriptor>>(num_vertices);
+    for (const auto& e : maximum_spanning_tree(pose_graph))
+    {
+      mst_adjacency[boost::source(e, pose_graph)].push_back(e);
+      mst_adjacency[boost::target(e, pose_graph)].push_back(e);
+    }
+
+    // Propagate the relative rotations along the spanning tree.
+    auto R = std::vector<Matrix3d>(num_vertices, Matrix3d::Identity());
+    auto reached = std::vector<bool>(num_vertices, false);
+    auto order = std::vector<int>{};
+    order.reserve(num_vertices);
+
+    auto queue = std::queue<int>{};
+    queue.push(root);
+    reached[root] = true;
+    while (!queue.empty())
+    {
+      const auto u = queue.front();
+      queue.pop();
+      order.push_back(u);
+
+      for (const auto& e : mst_adjacency[u])
+      {
+        const auto v = static_cast<int>(boost::source(e, pose_graph)) == u
+                           ? static_cast<int>(boost::target(e, pose_graph))
+                           : static_cast<int>(boost::source(e, pose_graph));
+        if (reached[v])
+          continue;
+        R[v] = relative_rotation(e, u) * R[u];
+        reached[v] = true;
+        queue.push(v);
+      }
+    }
+
+    // Robust chordal averaging by Gauss-Seidel sweeps. The root is fixed.
+    //
+    // The residuals are chordal distances, i.e., about sqrt(2) times the
+    // rotation angle in radians for small angles. The Cauchy scale thus
+    // corresponds to ~4 degrees.
+    //
+    // The first sweeps are not robust: a corrupted edge of the spanning tree
+    // would otherwise be trusted by its own initialization.
+    constexpr auto sigma = 0.1;
+    const auto num_least_squares_sweeps = num_sweeps / 4;
+    for (auto sweep = 0; sweep < num_sweeps; ++sweep)
+    {
+      const auto robust = sweep >= num_least_squares_sweeps;
+      for (auto k = 1u; k < order.size(); ++k)
+      {
+        const auto v = order[k];
+
+        auto M = Matrix3d::Zero().eval();
+        for (const auto& e : boost::make_iterator_range(
+                 boost::out_edges(v, pose_graph)))
+        {
+          const auto u = static_cast<int>(boost::target(e, pose_graph));
+          if (!reached[u])
+            continue;
+          const Matrix3d Rv = relative_rotation(e, u) * R[u];
+          const auto r = robust ? (Rv - R[v]).norm() / sigma : 0.;
+          M += pose_graph[e].weight / (1 + r * r) * Rv;
+        }
+
+        if (M.squaredNorm() > 0)
+          R[v] = project_to_so3(M);
+      }
+    }
+
+    return R;
+  }
+
+
+  IncrementalReconstruction::IncrementalReconstruction(
+      const ViewAttributes& views, const EpipolarEdgeAttributes& epipolar_edges,
+      const PoseGraph& pose_graph, const std::set<std::set<FeatureGID>>& tracks,
+      const IncrementalReconstructionOptions& options)
+    : _views{views}
+    , _epipolar_edges{epipolar_edges}
+    , _pose_graph{pose_graph}
+    , _options{options}
+  {
+    const auto num_views = static_cast<int>(boost::num_vertices(pose_graph));
+    if (static_cast<int>(views.keypoints.size()) != num_views ||
+        static_cast<int>(views.cameras.size()) != num_views)
+      throw std::runtime_error{
+          "Each view must have its keypoints and its calibration matrix!"};
+
+    _tracks.reserve(tracks.size());
+    _view_tracks.resize(num_views);
+    for (const auto& track : tracks)
+    {
+      const auto t = static_cast<int>(_tracks.size());
+      _tracks.emplace_back(track.begin(), track.end());
+      for (const auto& f : track)
+        _view_tracks[f.image_id].emplace_back(t, f.local_id);
+    }
+    _track_points.assign(_tracks.size(), -1);
+
+    _cameras = views.cameras;
+    _registered.assign(num_views, false);
+    _num_visible_points.assign(num_views, 0);
+    _num_visible_points_at_failure.assign(num_views, -1);
+
+    // The root is the view with the largest weight.
+    for (auto v = 0; v < num_views; ++v)
+      if (_root == -1 || pose_graph[v].weight > pose_graph[_root].weight)
+        _root = v;
+  }
+
+  auto IncrementalReconstruction::run() -> void
+  {
+    if (_root == -1)
+      return;
+
+    SARA_PROFILE_SCOPE("SfM/Incremental reconstruction");
+
+    {
+      SARA_PROFILE_SCOPE("SfM/Rotation averaging");
+      _rotations = average_rotations(_pose_graph, _epipolar_edges, _root,
+                                     _options.num_rotation_averaging_sweeps);
+    }
+
+    if (!initialize())
+    {
+      SARA_DEBUG << "Failed to initialize the reconstruction!" << std::endl;
+      return;
+    }
+
+    auto num_views_at_last_global_ba = _num_registered_views;
+    for (auto v = next_view(); v != -1; v = next_view())
+    {
+      if (!resect(v))
+      {
+        _num_visible_points_at_failure[v] = _num_visible_points[v];
+        continue;
+      }
+      register_view(v);
+
+      if (_num_registered_views >=
+          _options.global_growth_ratio * num_views_at_last_global_ba)
+      {
+        refine(_registration_order, _options.global_ba_options);
+        num_views_at_last_global_ba = _num_registered_views;
+      }
+
+      if (_options.verbose)
+        SARA_DEBUG << "Registered view " << v << ": "
+                   << _num_registered_views << " views, "
+                   << "RMS reprojection error = " << rms_reprojection_error()
+                   << " px" << std::endl;
+    }
+
+    if (num_views_at_last_global_ba != _num_registered_views)
+      refine(_registration_order, _options.global_ba_options);
+  }
+
+  auto IncrementalReconstruction::point_cloud() const -> Tensor_<double, 2>
+  {
+    const auto num_points = std::count_if(
+        _points.begin(), _points.end(), [](const auto& p) { return p.valid; });
+
+    auto X = Tensor_<double, 2>{static_cast<int>(num_points), 3};
+    auto i = 0;
+    for (const auto& p : _points)
+      if (p.valid)
+        X[i++].row_vector() = p.coords.transpose();
+    return X;
+  }
+
+  auto IncrementalReconstruction::rms_reprojection_error() const -> double
+  {
+    auto sum = 0.;
+    auto count = 0;
+    for (const auto& p : _points)
+    {
+      if (!p.valid)
+        continue;
+      for (const auto& o : p.observations)
+      {
+        const auto e = reprojection_error(o.view, p.coords,
+                                          pixel_coords(o.view, o.local_id));
+        sum += e * e;
+        ++count;
+      }
+    }
+    return count == 0 ? 0. : std::sqrt(sum / count);
+  }
+
+  auto IncrementalReconstruction::pixel_coords(int view, int local_id) const
+      -> Vector2d
+  {
+    return features(_views.keypoints[view])[local_id].center().cast<double>();
+  }
+
+  auto IncrementalReconstruction::reprojection_error(int view,
+                                                     const Vector3d& X,
+                                                     const Vector2d& x) const
+      -> double
+  {
+    const auto& C = _cameras[view];
+    const Vector3d p = C.R * X + C.t;
+    if (p.z() <= 0)
+      return std::numeric_limits<double>::infinity();
+    return ((C.K * p).hnormalized() - x).norm();
+  }
+
+  auto IncrementalReconstruction::initialize() -> bool
+  {
+    // Try the neighbors of the root in the spanning tree, heaviest first.
+    auto candidates = std::vector<PoseGraph::edge_descriptor>{};
+    for (const auto& e : maximum_spanning_tree(_pose_graph))
+      if (static_cast<int>(boost::source(e, _pose_graph)) == _root ||
+          static_cast<int>(boost::target(e, _pose_graph)) == _root)
+        candidates.push_back(e);
+    std::sort(candidates.begin(), candidates.end(),
+              [this](const auto& e1, const auto& e2) {
+                return _pose_graph[e1].weight > _pose_graph[e2].weight;
+              });
+
+    for (const auto& e : candidates)
+    {
+      const auto ij = _pose_graph[e].id;
+      const auto [i, j] = _epipolar_edges.edges[ij];
+      const auto& C2 = _epipolar_edges.two_view_geometries[ij].C2;
+      const auto other = i == _root ? j : i;
+
+      // The baseline of the initial pair sets the unit of the reconstruction.
+      _cameras[_root].R = _rotations[_root];
+      _cameras[_root].t.setZero();
+      _cameras[other].R = _rotations[other];
+      _cameras[other].t =
+          i == _root ? C2.t.eval() : (-C2.R.transpose() * C2.t).eval();
+
+      _registered[_root] = true;
+      _registration_order = {_root};
+      _num_registered_views = 1;
+      register_view(other);
+
+      const auto num_points = std::count_if(
+          _points.begin(), _points.end(), [](const auto& p) { return p.valid; });
+      if (num_points >= _options.min_num_correspondences)
+        return true;
+
+      // Start over.
+      _registered.assign(_registered.size(), false);
+      _registration_order.clear();
+      _num_registered_views = 0;
+      _points.clear();
+      _track_points.assign(_tracks.size(), -1);
+      _num_visible_points.assign(_num_visible_points.size(), 0);
+    }
+
+    return false;
+  }
+
+  auto IncrementalReconstruction::next_view() const -> int
+  {
+    auto best_view = -1;
+    auto best_count = _options.min_num_correspondences - 1;
+    for (auto v = 0; v < static_cast<int>(_registered.size()); ++v)
+    {
+      if (_registered[v] ||
+          _num_visible_points[v] <= _num_visible_points_at_failure[v])
+        continue;
+      if (_num_visible_points[v] > best_count)
+      {
+        best_view = v;
+        best_count = _num_visible_points[v];
+      }
+    }
+    return best_view;
+  }
+
+  auto IncrementalReconstruction::resect(int view) -> bool
+  {
+    SARA_PROFILE_SCOPE("SfM/Resection");
+
+    // Since the rotation R is known, each 2D-3D correspondence (u, X) in
+    // normalized coordinates gives two linear equations on the translation:
+    //   (R X + t).xy - u.xy * (R X + t).z = 0.
+    const Matrix3d& R = _rotations[view];
+    const Matrix3d& K = _cameras[view].K;
+    const Matrix3d K_inv = K.inverse();
+
+    auto RX = std::vector<Vector3d>{};
+    auto x = std::vector<Vector2d>{};
+    auto u = std::vector<Vector2d>{};
+    for (const auto& [track, local_id] : _view_tracks[view])
+    {
+      const auto p = _track_points[track];
+      if (p == -1)
+        continue;
+      RX.push_back(R * _points[p].coords);
+      x.push_back(pixel_coords(view, local_id));
+      u.push_back((K_inv * x.back().homogeneous()).hnormalized());
+    }
+
+    const auto num_correspondences = static_cast<int>(RX.size());
+    if (num_correspondences < _options.min_num_correspondences)
+      return false;
+
+    // The equations are weighted by the inverse depths when a previous
+    // estimate is available, so that the algebraic errors approximate the
+    // reprojection errors.
+    const auto solve = [&](const std::vector<int>& indices,
+                           const Vector3d* t_previous) -> Vector3d {
+      auto AtA = Matrix3d::Zero().eval();
+      auto Atb = Vector3d::Zero().eval();
+      for (const auto i : indices)
+      {
+        auto w = 1.;
+        if (t_previous != nullptr)
+        {
+          const auto depth = RX[i].z() + t_previous->z();
+          if (depth > 0)
+            w = 1 / (depth * depth);
+        }
+        for (auto k = 0; k < 2; ++k)
+        {
+          const Vector3d a = Vector3d::Unit(k) - u[i](k) * Vector3d::UnitZ();
+          const auto b = u[i](k) * RX[i].z() - RX[i](k);
+          AtA += w * a * a.transpose();
+          Atb += w * b * a;
+        }
+      }
+      return AtA.ldlt().solve(Atb);
+    };
+
+    const auto inliers = [&](const Vector3d& t) {
+      auto indices = std::vector<int>{};
+      for (auto i = 0; i < num_correspondences; ++i)
+      {
+        const Vector3d p = RX[i] + t;
+        if (p.z() > 0 && ((K * p).hnormalized() - x[i]).norm() <=
+                             _options.max_reprojection_error)
+          indices.push_back(i);
+      }
+      return indices;
+    };
+
+    // RANSAC with minimal samples of two correspondences.
+    auto gen = std::mt19937{static_cast<std::mt19937::result_type>(view)};
+    auto dist = std::uniform_int_distribution<int>{0, num_correspondences - 1};
+    auto best_inliers = std::vector<int>{};
+    for (auto s = 0; s < _options.num_resection_samples; ++s)
+    {
+      const auto i = dist(gen);
+      const auto j = dist(gen);
+      if (i == j)
+        continue;
+      auto sample_inliers = inliers(solve({i, j}, nullptr));
+      if (sample_inliers.size() > best_inliers.size())
+        best_inliers.swap(sample_inliers);
+    }
+    SARA_PROFILE_COUNTER("ransac.iterations", _options.num_resection_samples);
+
+    // Refine the translation on the inliers.
+    auto t = Vector3d{};
+    for (auto iter = 0; iter < 2; ++iter)
+    {
+      if (static_cast<int>(best_inliers.size()) <
+          _options.min_num_correspondences)
+        return false;
+      const auto t_previous = iter == 0 ? Vector3d::Zero().eval() : t;
+      t = solve(best_inliers, iter == 0 ? nullptr : &t_previous);
+      best_inliers = inliers(t);
+    }
+
+    if (static_cast<int>(best_inliers.size()) <
+        _options.min_num_correspondences)
+      return false;
+
+    _cameras[view].R = R;
+    _cameras[view].t = t;
+    return true;
+  }
+
+  auto IncrementalReconstruction::register_view(int view) -> void
+  {
+    _registered[view] = true;
+    _registration_order.push_back(view);
+    ++_num_registered_views;
+
+    // Extend the existing points and triangulate the new ones.
+    for (const auto& [track, local_id] : _view_tracks[view])
+    {
+      const auto p = _track_points[track];
+      if (p == -1)
+      {
+        triangulate_track(track, view);
+        continue;
+      }
+
+      auto& point = _points[p];
+      if (reprojection_error(view, point.coords,
+                             pixel_coords(view, local_id)) <=
+          _options.max_reprojection_error)
+        point.observations.push_back({view, local_id});
+    }
+
+    const auto window_size = std::min(_options.local_window_size,
+                                      _num_registered_views);
+    const auto local_views = std::vector<int>(
+        _registration_order.end() - window_size, _registration_order.end());
+    refine(local_views, _options.local_ba_options);
+  }
+
+  auto IncrementalReconstruction::triangulate_track(int track, int view)
+      -> void
+  {
+    const auto& features = _tracks[track];
+
+    // Backprojected ray in normalized camera coordinates.
+    const auto ray = [this](const FeatureGID& f) -> Vector3d {
+      const auto& C = _cameras[f.image_id];
+      return C.K.inverse() * pixel_coords(f.image_id, f.local_id).homogeneous();
+    };
+
+    const auto f_new = std::find_if(
+        features.begin(), features.end(),
+        [view](const auto& f) { return f.image_id == view; });
+    const Vector3d u_new = ray(*f_new);
+    const Vector3d d_new = (_cameras[view].R.transpose() * u_new).normalized();
+
+    // Pair the new view with the registered view of widest angle.
+    auto best_angle = -1.;
+    auto f_best = features.end();
+    for (auto f = features.begin(); f != features.end(); ++f)
+    {
+      if (f->image_id == view || !_registered[f->image_id])
+        continue;
+      const Vector3d d =
+          (_cameras[f->image_id].R.transpose() * ray(*f)).normalized();
+      const auto angle = std::acos(std::clamp(d.dot(d_new), -1., 1.));
+      if (angle > best_angle)
+      {
+        best_angle = angle;
+        f_best = f;
+      }
+    }
+    if (f_best == features.end() ||
+        best_angle < _options.min_triangulation_angle * M_PI / 180)
+      return;
+
+    const auto normalized_matrix = [](const PinholeCamera& C) -> Matrix34d {
+      return normalized_camera(C.R, C.t);
+    };
+    const Vector4d X = triangulate_single_point_linear_eigen(
+        normalized_matrix(_cameras[view]),
+        normalized_matrix(_cameras[f_best->image_id]), u_new, ray(*f_best));
+    if (std::abs(X(3)) < std::numeric_limits<double>::epsilon())
+      return;
+
+    auto point = Point{};
+    point.coords = X.hnormalized();
+    point.track = track;
+    for (const auto& f : features)
+      if (_registered[f.image_id] &&
+          reprojection_error(f.image_id, point.coords,
+                             pixel_coords(f.image_id, f.local_id)) <=
+              _options.max_reprojection_error)
+        point.observations.push_back({f.image_id, f.local_id});
+    if (point.observations.size() < 2)
+      return;
+
+    _track_points[track] = static_cast<int>(_points.size());
+    _points.push_back(std::move(point));
+    for (const auto& f : features)
+      ++_num_visible_points[f.image_id];
+  }
+
+  auto IncrementalReconstruction::invalidate_point(int p) -> void
+  {
+    auto& point = _points[p];
+    point.valid = false;
+    point.observations.clear();
+    _track_points[point.track] = -1;
+    for (const auto& f : _tracks[point.track])
+      --_num_visible_points[f.image_id];
+  }
+
+  auto IncrementalReconstruction::refine(const std::vector<int>& views,
+                                         const BundleAdjustmentOptions& options)
+      -> void
+  {
+    SARA_PROFILE_SCOPE("SfM/Bundle adjustment");
+
+    // Collect the points observed by the views.
+    auto points = std::vector<int>{};
+    auto is_selected = std::vector<bool>(_points.size(), false);
+    for (const auto v : views)
+    {
+      for (const auto& [track, local_id] : _view_tracks[v])
+      {
+        const auto p = _track_points[track];
+        if (p == -1 || is_selected[p])
+          continue;
+        is_selected[p] = true;
+        points.push_back(p);
+      }
+    }
+    if (points.empty())
+      return;
+
+    // Collect the cameras observing these points.
+    auto camera_index = std::vector<int>(_cameras.size(), -1);
+    auto cameras = std::vector<int>{};
+    auto num_observations = 0;
+    for (const auto p : points)
+    {
+      for (const auto& o : _points[p].observations)
+      {
+        if (camera_index[o.view] == -1)
+        {
+          camera_index[o.view] = static_cast<int>(cameras.size());
+          cameras.push_back(o.view);
+        }
+        ++num_observations;
+      }
+    }
+
+    auto problem = BundleAdjustmentProblem{};
+    problem.resize(num_observations, static_cast<int>(points.size()),
+                   static_cast<int>(cameras.size()), 12);
+
+    auto o = 0;
+    for (auto i = 0u; i < points.size(); ++i)
+    {
+      const auto& point = _points[points[i]];
+      problem.points_abs_coords_3d[i].row_vector() = point.coords.transpose();
+      for (const auto& obs : point.observations)
+      {
+        problem.observations[o].row_vector() =
+            pixel_coords(obs.view, obs.local_id).transpose();
+        problem.point_indices[o] = static_cast<int>(i);
+        problem.camera_indices[o] = camera_index[obs.view];
+        ++o;
+      }
+    }
+
+    auto ba_options = options;
+    ba_options.constant_cameras.clear();
+    for (auto c = 0u; c < cameras.size(); ++c)
+    {
+      const auto v = cameras[c];
+      const auto& C = _cameras[v];
+      const auto angle_axis = Eigen::AngleAxisd{C.R};
+      auto camera = problem.camera_parameters[c].row_vector();
+      camera.head(3) = (angle_axis.angle() * angle_axis.axis()).transpose();
+      camera.segment(3, 3) = C.t.transpose();
+      camera.tail(6) << C.K(0, 0), C.K(1, 1), C.K(0, 2), C.K(1, 2), 0., 0.;
+
+      // The root fixes the rotation and the translation of the gauge, the
+      // views outside the window provide the context.
+      if (v == _root || std::find(views.begin(), views.end(), v) == views.end())
+        ba_options.constant_cameras.push_back(static_cast<int>(c));
+    }
+
+    // If the root is the only constant camera, the scale of the
+    // reconstruction is free. The baseline of the initial pair then fixes it,
+    // as in 'initialize'.
+    const auto scale_is_free = std::all_of(
+        ba_options.constant_cameras.begin(), ba_options.constant_cameras.end(),
+        [&](int c) { return cameras[c] == _root; });
+    const auto baseline_view =
+        _registration_order.size() > 1 ? _registration_order[1] : -1;
+    const auto fix_scale = scale_is_free && camera_index[_root] != -1 &&
+                           baseline_view != -1 &&
+                           camera_index[baseline_view] != -1;
+    const auto baseline = fix_scale ? _cameras[baseline_view].t.norm() : 0.;
+
+    DO::Sara::bundle_adjust(problem, ba_options);
+
+    // The root is at the origin, so rescaling the translations and the points
+    // does not change the reprojection errors.
+    if (fix_scale)
+    {
+      const auto new_baseline =
+          problem.camera_parameters[camera_index[baseline_view]]
+              .row_vector()
+              .segment(3, 3)
+              .norm();
+      if (new_baseline > std::numeric_limits<double>::epsilon())
+      {
+        const auto scale = baseline / new_baseline;
+        for (auto c = 0u; c < cameras.size(); ++c)
+          problem.camera_parameters[c].row_vector().segment(3, 3) *= scale;
+        problem.points_abs_coords_3d.flat_array() *= scale;
+      }
+    }
+
+    // N.B.: the radial distortion cannot be represented by 'PinholeCamera'
+    // and is dropped.
+    for (auto c = 0u; c < cameras.size(); ++c)
+    {
+      auto& C = _cameras[cameras[c]];
+      const auto camera = problem.camera_parameters[c].row_vector();
+      const Vector3d w = camera.head(3).transpose();
+      const auto angle = w.norm();
+      C.R = angle < std::numeric_limits<double>::epsilon()
+                ? Matrix3d::Identity().eval()
+                : Eigen::AngleAxisd{angle, w / angle}.toRotationMatrix();
+      C.t = camera.segment(3, 3).transpose();
+      if (options.refine_intrinsics)
+      {
+        C.K(0, 0) = camera(6);
+        C.K(1, 1) = camera(7);
+        C.K(0, 2) = camera(8);
+        C.K(1, 2) = camera(9);
+      }
+    }
+
+    for (auto i = 0u; i < points.size(); ++i)
+      _points[points[i]].coords =
+          problem.points_abs_coords_3d[i].row_vector().transpose();
+
+    filter_observations(points);
+  }
+
+  auto IncrementalReconstruction::filter_observations(
+      const std::vector<int>& points) -> void
+  {
+    for (const auto p : points)
+    {
+      auto& point = _points[p];
+      auto& observations = point.observations;
+      observations.erase(
+          std::remove_if(observations.begin(), observations.end(),
+                         [&](const Observation& o) {
+                           return reprojection_error(
+                                      o.view, point.coords,
+                                      pixel_coords(o.view, o.local_id)) >
+                                  _options.max_reprojection_error;
+                         }),
+          observations.end());
+      if (observations.size() < 2)
+        invalidate_point(p);
+    }
+  }
+
+} /* namespace DO::Sara */
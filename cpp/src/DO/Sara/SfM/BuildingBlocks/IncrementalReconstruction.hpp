@@ -0,0 +1,219 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#pragma once
+
+#include <DO/Sara/Defines.hpp>
+
+#include <DO/Sara/MultiViewGeometry/BundleAdjuster.hpp>
+#include <DO/Sara/MultiViewGeometry/EpipolarGraph.hpp>
+#include <DO/Sara/MultiViewGeometry/FeatureGraph.hpp>
+#include <DO/Sara/MultiViewGeometry/PoseGraph.hpp>
+
+#include <set>
+#include <vector>
+
+
+namespace DO::Sara {
+
+  //! @addtogroup SfM
+  //! @{
+
+  //! @brief Return the edges of the maximum spanning tree of the pose graph,
+  //! where the edge weights are the numbers of cheiral inliers.
+  DO_SARA_EXPORT
+  auto maximum_spanning_tree(const PoseGraph& pose_graph)
+      -> std::vector<PoseGraph::edge_descriptor>;
+
+  /*!
+    @brief Estimate the absolute rotations from the relative rotations of the
+    epipolar edges.
+
+    The relative rotation of the edge (i, j) is the rotation of the second
+    camera of its two-view geometry, i.e., R[j] = R[i, j] * R[i].
+
+    The rotations are initialized by propagation along the maximum spanning
+    tree from the root vertex. They are then refined by robust chordal
+    averaging over all the edges, where each sweep costs O(|E|).
+
+    Vertices that are not connected to the root keep an identity rotation.
+   */
+  DO_SARA_EXPORT
+  auto average_rotations(const PoseGraph& pose_graph,
+                         const EpipolarEdgeAttributes& epipolar_edges,
+                         int root, int num_sweeps = 20)
+      -> std::vector<Eigen::Matrix3d>;
+
+
+  //! @brief Incremental reconstruction options.
+  struct IncrementalReconstructionOptions
+  {
+    //! @brief Maximum reprojection error in pixels of an observation.
+    double max_reprojection_error = 4.;
+    //! @brief Minimum triangulation angle in degrees of a new 3D point.
+    double min_triangulation_angle = 1.;
+    //! @brief Minimum number of 2D-3D correspondences to register a view.
+    int min_num_correspondences = 8;
+    //! @brief Number of RANSAC iterations of the camera resection.
+    int num_resection_samples = 64;
+
+    //! @brief Number of rotation averaging sweeps.
+    int num_rotation_averaging_sweeps = 20;
+
+    //! @{
+    //! @brief Bundle adjustment schedule.
+    //!
+    //! A local bundle adjustment refines the last 'local_window_size'
+    //! registered views and their 3D points after each registration.
+    //!
+    //! A global bundle adjustment is performed whenever the number of
+    //! registered views has grown by 'global_growth_ratio' since the last
+    //! one. The total cost of the global adjustments is thus linear in the
+    //! cost of the final one.
+    int local_window_size = 8;
+    double global_growth_ratio = 1.5;
+    BundleAdjustmentOptions local_ba_options = default_ba_options(10);
+    BundleAdjustmentOptions global_ba_options = default_ba_options(50);
+    //! @}
+
+    bool verbose = false;
+
+    //! @brief The internal camera parameters are fixed and the observations
+    //! are robustified with a Huber loss.
+    static auto default_ba_options(int max_iterations)
+        -> BundleAdjustmentOptions
+    {
+      auto options = BundleAdjustmentOptions{};
+      options.max_iterations = max_iterations;
+      options.refine_intrinsics = false;
+      options.loss = RobustLoss::Huber;
+      options.loss_scale = 2.;
+      return options;
+    }
+  };
+
+
+  /*!
+    @brief Incremental structure-from-motion driven by the pose graph.
+
+    1. The absolute rotations are estimated globally by rotation averaging.
+    2. The reconstruction is initialized with the root view, i.e., the view
+       with the largest weight, and its heaviest neighbor in the maximum
+       spanning tree.
+    3. The views are registered one by one, preferring the view that sees
+       the most 3D points. Since the rotation is known, the translation of
+       a new view is estimated linearly from its 2D-3D correspondences.
+    4. The feature tracks are triangulated as soon as they are seen by two
+       registered views with a sufficient triangulation angle.
+    5. Local and global bundle adjustments are interleaved with the
+       registrations.
+   */
+  class DO_SARA_EXPORT IncrementalReconstruction
+  {
+  public:
+    IncrementalReconstruction(const ViewAttributes& views,
+                              const EpipolarEdgeAttributes& epipolar_edges,
+                              const PoseGraph& pose_graph,
+                              const std::set<std::set<FeatureGID>>& tracks,
+                              const IncrementalReconstructionOptions& options =
+                                  {});
+
+    //! @brief Register as many views as possible.
+    auto run() -> void;
+
+    //! @{
+    //! @brief Reconstruction state.
+    auto cameras() const -> const std::vector<PinholeCamera>&
+    {
+      return _cameras;
+    }
+
+    auto is_registered(int view) const -> bool
+    {
+      return _registered[view];
+    }
+
+    auto num_registered_views() const -> int
+    {
+      return _num_registered_views;
+    }
+
+    //! @brief Return the triangulated points as a (N, 3) tensor.
+    auto point_cloud() const -> Tensor_<double, 2>;
+
+    //! @brief Root mean square reprojection error of all the observations.
+    auto rms_reprojection_error() const -> double;
+    //! @}
+
+  private:
+    struct Observation
+    {
+      int view;
+      int local_id;
+    };
+
+    struct Point
+    {
+      Eigen::Vector3d coords;
+      int track;
+      std::vector<Observation> observations;
+      bool valid = true;
+    };
+
+    auto pixel_coords(int view, int local_id) const -> Eigen::Vector2d;
+    auto reprojection_error(int view, const Eigen::Vector3d& X,
+                            const Eigen::Vector2d& x) const -> double;
+
+    auto initialize() -> bool;
+    auto next_view() const -> int;
+    auto resect(int view) -> bool;
+    auto register_view(int view) -> void;
+    auto triangulate_track(int track, int view) -> void;
+    auto invalidate_point(int point) -> void;
+
+    //! @brief Refine the given views and their points. The other registered
+    //! views observing these points are kept constant.
+    auto refine(const std::vector<int>& views,
+                const BundleAdjustmentOptions& options) -> void;
+    auto filter_observations(const std::vector<int>& points) -> void;
+
+  private:
+    const ViewAttributes& _views;
+    const EpipolarEdgeAttributes& _epipolar_edges;
+    const PoseGraph& _pose_graph;
+    IncrementalReconstructionOptions _options;
+
+    //! @brief Feature tracks.
+    std::vector<std::vector<FeatureGID>> _tracks;
+    //! @brief (track, local feature ID) pairs of each view.
+    std::vector<std::vector<std::pair<int, int>>> _view_tracks;
+
+    //! @brief Absolute rotations.
+    std::vector<Eigen::Matrix3d> _rotations;
+    std::vector<PinholeCamera> _cameras;
+    std::vector<bool> _registered;
+    std::vector<int> _registration_order;
+    int _num_registered_views = 0;
+    int _root = -1;
+
+    //! @brief 3D points and the point index of each track (-1 if none).
+    std::vector<Point> _points;
+    std::vector<int> _track_points;
+    //! @brief Number of 3D points visible in each view.
+    std::vector<int> _num_visible_points;
+    //! @brief Number of visible 3D points when the registration of a view
+    //! last failed.
+    std::vector<int> _num_visible_points_at_failure;
+  };
+
+  //! @}
+
+} /* namespace DO::Sara */
@@ -10,9 +10,11 @@
 // ========================================================================== //
 
 #include <DO/Sara/Core/HDF5.hpp>
+#include <DO/Sara/Core/Numpy.hpp>
 #include <DO/Sara/Core/StdVectorHelpers.hpp>
 #include <DO/Sara/Core/StringFormat.hpp>
 #include <DO/Sara/Features/Draw.hpp>
+#include <DO/Sara/Features/KeypointStore.hpp>
 #include <DO/Sara/FileSystem.hpp>
 #include <DO/Sara/Graphics.hpp>
 #include <DO/Sara/ImageIO.hpp>
@@ -27,6 +29,9 @@ auto detect_keypoints(const std::string& dirpath,
                       bool overwrite) -> void
 {
   auto h5_file = H5File{h5_filepath, H5F_ACC_TRUNC};
+  // The next pipeline stages map the keypoints from this file instead of
+  // decoding them from the HDF5 file.
+  auto keypoint_store = KeypointStoreWriter{keypoint_store_path(h5_filepath)};
 
   auto image_paths = std::vector<std::string>{};
   append(image_paths, ls(dirpath, ".png"));
@@ -45,7 +50,10 @@ auto detect_keypoints(const std::string& dirpath,
 
         SARA_DEBUG << "Saving SIFT keypoints of " << path << "..." << std::endl;
         write_keypoints(h5_file, group_name, keys, overwrite);
+        keypoint_store.write(group_name, keys);
       });
+
+  keypoint_store.close();
 }
 
 
@@ -57,17 +65,26 @@ auto read_keypoints(const std::string& dirpath, const std::string& h5_filepath)
   append(image_paths, ls(dirpath, ".png"));
   append(image_paths, ls(dirpath, ".jpg"));
 
+  auto group_names = std::vector<std::string>{};
+  group_names.reserve(image_paths.size());
+  std::transform(std::begin(image_paths), std::end(image_paths),
+                 std::back_inserter(group_names),
+                 [&](const std::string& image_path) {
+                   return basename(image_path);
+                 });
+
+  SARA_DEBUG << "Read keypoints..." << std::endl;
+  const auto keypoints = read_keypoints(h5_file, group_names);
+
+  auto image_ids = range(static_cast<int>(image_paths.size()));
   std::for_each(
-      std::begin(image_paths), std::end(image_paths), [&](const auto& path) {
+      std::begin(image_ids), std::end(image_ids), [&](const auto i) {
+        const auto& path = image_paths[i];
         SARA_DEBUG << "Reading image " << path << "..." << std::endl;
         const auto image = imread<float>(path);
 
-        const auto group_name = basename(path);
-
-        SARA_DEBUG << "Read keypoints for " << group_name << "..." << std::endl;
-        const auto keys = read_keypoints(h5_file, group_name);
-
-        const auto& features = std::get<0>(keys);
+        const auto& group_name = group_names[i];
+        const auto& features = std::get<0>(keypoints[i]);
 
         // Visual inspection.
         if (!active_window())
@@ -10,6 +10,7 @@
 // ========================================================================== //
 
 #include <DO/Sara/FeatureMatching.hpp>
+#include <DO/Sara/Features/KeypointStore.hpp>
 #include <DO/Sara/FileSystem.hpp>
 #include <DO/Sara/Match.hpp>
 #include <DO/Sara/SfM/BuildingBlocks/KeypointMatching.hpp>
@@ -33,7 +34,8 @@ auto match(const KeypointList<OERegion, float>& keys1,
 
 
 auto match_keypoints(const std::string& dirpath, const std::string& h5_filepath,
-                     bool overwrite) -> void
+                     bool overwrite, const H5DatasetOptions& options)
+    -> void
 {
   // Create a backup.
   if (!fs::exists(h5_filepath + ".bak"))
@@ -54,13 +56,7 @@ auto match_keypoints(const std::string& dirpath, const std::string& h5_filepath,
                    return basename(image_path);
                  });
 
-  auto keypoints = std::vector<KeypointList<OERegion, float>>{};
-  keypoints.reserve(image_paths.size());
-  std::transform(std::begin(group_names), std::end(group_names),
-                 std::back_inserter(keypoints),
-                 [&](const std::string& group_name) {
-                   return read_keypoints(h5_file, group_name);
-                 });
+  const auto keypoints = read_keypoints(h5_file, group_names);
 
   const auto N = int(image_paths.size());
   auto edges = std::vector<std::pair<int, int>>{};
@@ -102,7 +98,8 @@ auto match_keypoints(const std::string& dirpath, const std::string& h5_filepath,
 
         const auto match_dataset =
             group_name + "/" + std::to_string(i) + "_" + std::to_string(j);
-        h5_file.write_dataset(match_dataset, tensor_view(Mij), overwrite);
+        h5_file.write_dataset(match_dataset, tensor_view(Mij), overwrite,
+                              options);
       });
 }
 
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <DO/Sara/Core/HDF5.hpp>
 #include <DO/Sara/Defines.hpp>
 #include <DO/Sara/Match.hpp>
 
@@ -29,7 +30,8 @@ namespace DO::Sara {
 
   DO_SARA_EXPORT
   auto match_keypoints(const std::string& dirpath,
-                       const std::string& h5_filepath, bool overwrite) -> void;
+                       const std::string& h5_filepath, bool overwrite,
+                       const H5DatasetOptions& options = {}) -> void;
   //! @}
 
   //! @}
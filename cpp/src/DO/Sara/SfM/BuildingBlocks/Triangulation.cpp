@@ -136,13 +136,26 @@ auto estimate_two_view_geometry(const TensorView_<int, 2>& M,
              << un2_matched_mat.leftCols(10) << std::endl;
 #endif
 
-  SARA_DEBUG << "Triangulating all matches..." << std::endl;
-  best_geom->X = triangulate_linear_eigen(P1, P2, un1_matched_mat, un2_matched_mat);
+  SARA_DEBUG << "Triangulating all matches and calculating cheirality..."
+             << std::endl;
+  {
+    const auto num_matches = static_cast<int>(card_M_filtered);
+    best_geom->X.resize(4, num_matches);
+    best_geom->cheirality.resize(num_matches);
+    best_geom->reprojection_errors.resize(num_matches);
+
+    // The (N, 4) row-major view has the same layout as the 4xN column-major
+    // matrix.
+    auto X = TensorView_<double, 2>{best_geom->X.data(), {num_matches, 4}};
+    auto cheirality =
+        TensorView_<bool, 1>{best_geom->cheirality.data(), num_matches};
+    auto reprojection_errors = TensorView_<double, 1>{
+        best_geom->reprojection_errors.data(), num_matches};
+    triangulate(P1, P2, coords_matched[0], coords_matched[1], X, cheirality,
+                reprojection_errors);
+  }
   SARA_CHECK(best_geom->X.cols());
   SARA_CHECK(inliers.flat_array().count());
-
-  SARA_DEBUG << "Calculating cheirality..." << std::endl;
-  best_geom->cheirality = relative_motion_cheirality_predicate(best_geom->X, P2);
   SARA_CHECK(best_geom->cheirality.count());
 
   SARA_DEBUG << "Cheiral inliers count = "
@@ -156,12 +169,15 @@ auto keep_cheiral_inliers_only(TwoViewGeometry& complete_geom,
                                const TensorView_<bool, 1>& inliers) -> void
 {
   auto& X = complete_geom.X;
+  auto& errors = complete_geom.reprojection_errors;
   const auto& cheirality = complete_geom.cheirality;
   SARA_DEBUG << "Keep cheiral inliers..." << std::endl;
+  const auto cheiral_indices =
+      range(static_cast<int>(X.cols()))  //
+      | filtered([&](int i) { return cheirality(i) && inliers(i); });
   const auto X_cheiral =
-      range(static_cast<int>(X.cols()))                               //
-      | filtered([&](int i) { return cheirality(i) && inliers(i); })  //
-      | transformed([&](int i) -> Vector4d { return X.col(i); });
+      cheiral_indices |
+      transformed([&](int i) -> Vector4d { return X.col(i); });
   SARA_CHECK(X_cheiral.size());
 
   const auto P2 = complete_geom.C2.matrix();
@@ -170,6 +186,14 @@ auto keep_cheiral_inliers_only(TwoViewGeometry& complete_geom,
   for (int i = 0; i < X_cheiral.size(0); ++i)
     complete_geom.X.col(i) = X_cheiral(i);
 
+  // The reprojection errors are in place since the indices are increasing.
+  if (errors.size() > 0)
+  {
+    for (int i = 0; i < cheiral_indices.size(0); ++i)
+      errors(i) = errors(cheiral_indices(i));
+    errors.conservativeResize(cheiral_indices.size(0));
+  }
+
   complete_geom.cheirality =
       relative_motion_cheirality_predicate(complete_geom.X, P2);
 
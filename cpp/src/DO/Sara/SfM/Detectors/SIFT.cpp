@@ -10,61 +10,183 @@
 // ========================================================================== //
 
 #include <DO/Sara/Core/DebugUtilities.hpp>
+#include <DO/Sara/Core/Profiler.hpp>
 #include <DO/Sara/SfM/Detectors/SIFT.hpp>
 
+#ifdef DO_SARA_USE_HALIDE
+#  include <HalideBuffer.h>
+#  include <HalideRuntime.h>
+
+#  include "shakti_sift_descriptor_v4_cpu.h"
+#endif
+
 #include <omp.h>
 
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
 
 namespace DO::Sara {
 
+#ifdef DO_SARA_USE_HALIDE
+  //! @brief Describe the keypoints with the Halide CPU implementation.
+  static auto compute_sift_descriptors_halide_cpu(
+      const std::vector<OERegion>& features,
+      const std::vector<Point2i>& scale_octave_pairs,
+      const ImagePyramid<Vector2f>& gradient_polar_coords, bool parallel)
+      -> Tensor_<float, 2>
+  {
+    // The Halide thread pool is separate from the OpenMP one.
+    struct HalideThreadScope
+    {
+      explicit HalideThreadScope(int num_threads)
+        : previous_num_threads{halide_set_num_threads(num_threads)}
+      {
+      }
+
+      ~HalideThreadScope()
+      {
+        halide_set_num_threads(previous_num_threads);
+      }
+
+      int previous_num_threads;
+    } halide_threads{parallel ? omp_get_max_threads() : 1};
+
+    constexpr auto N = 4;
+    constexpr auto O = 8;
+    constexpr auto Dim = N * N * O;
+
+    auto descriptors =
+        Tensor_<float, 2>{static_cast<int>(features.size()), Dim};
+    descriptors.flat_array().fill(0);
+
+    // Group the keypoints by scale so that each Halide call processes a
+    // batch of keypoints on the same gradient image.
+    auto batches = std::map<std::pair<int, int>, std::vector<int>>{};
+    for (auto i = 0u; i < features.size(); ++i)
+      batches[{scale_octave_pairs[i](0), scale_octave_pairs[i](1)}].push_back(
+          static_cast<int>(i));
+
+    for (const auto& [so, indices] : batches)
+    {
+      const auto& [s, o] = so;
+      const auto& grads = gradient_polar_coords(s, o);
+
+      // Split the gradients into magnitude and orientation planes.
+      auto mag = Image<float>{grads.sizes()};
+      auto ori = Image<float>{grads.sizes()};
+      std::transform(grads.begin(), grads.end(), mag.begin(),
+                     [](const auto& g) { return g(0); });
+      std::transform(grads.begin(), grads.end(), ori.begin(),
+                     [](const auto& g) { return g(1); });
+
+      const auto num_keypoints = static_cast<int>(indices.size());
+      auto x = std::vector<float>(num_keypoints);
+      auto y = std::vector<float>(num_keypoints);
+      auto scale = std::vector<float>(num_keypoints);
+      auto theta = std::vector<float>(num_keypoints);
+      for (auto k = 0; k < num_keypoints; ++k)
+      {
+        const auto& f = features[indices[k]];
+        x[k] = f.x();
+        y[k] = f.y();
+        scale[k] = f.scale();
+        theta[k] = f.orientation;
+      }
+
+      auto batch_descriptors = Tensor_<float, 3>{num_keypoints, N * N, O};
+
+      auto mag_buffer = Halide::Runtime::Buffer<float>(mag.data(), mag.width(),
+                                                       mag.height());
+      auto ori_buffer = Halide::Runtime::Buffer<float>(ori.data(), ori.width(),
+                                                       ori.height());
+      auto x_buffer = Halide::Runtime::Buffer<float>(x.data(), num_keypoints);
+      auto y_buffer = Halide::Runtime::Buffer<float>(y.data(), num_keypoints);
+      auto scale_buffer =
+          Halide::Runtime::Buffer<float>(scale.data(), num_keypoints);
+      auto theta_buffer =
+          Halide::Runtime::Buffer<float>(theta.data(), num_keypoints);
+      auto descriptor_buffer = Halide::Runtime::Buffer<float>(
+          batch_descriptors.data(), O, N * N, num_keypoints);
+
+      const auto status = shakti_sift_descriptor_v4_cpu(
+          mag_buffer, ori_buffer, x_buffer, y_buffer, scale_buffer,
+          theta_buffer, descriptor_buffer);
+      if (status != 0)
+        throw std::runtime_error{"The Halide SIFT pipeline failed!"};
+
+      // The Halide descriptors have unit norm: rescale them as in
+      // 'ComputeSIFTDescriptor'.
+      for (auto k = 0; k < num_keypoints; ++k)
+        descriptors.matrix().row(indices[k]) =
+            (batch_descriptors[k].flat_array() * 512.f)
+                .min(255.f)
+                .matrix()
+                .transpose();
+    }
+
+    return descriptors;
+  }
+#endif
+
+  auto sift_backend_available(SIFTBackend backend) -> bool
+  {
+    switch (backend)
+    {
+    case SIFTBackend::Reference:
+      return true;
+    case SIFTBackend::HalideCPU:
+#ifdef DO_SARA_USE_HALIDE
+      return true;
+#else
+      return false;
+#endif
+    default:
+      return false;
+    }
+  }
+
   auto compute_sift_keypoints(const ImageView<float>& image,
                               const ImagePyramidParams& pyramid_params,
-                              bool parallel) -> KeypointList<OERegion, float>
+                              bool parallel, SIFTBackend backend)
+      -> KeypointList<OERegion, float>
   {
     using namespace std;
 
-    // Time everything.
-    auto timer = Timer{};
-    auto elapsed = 0.;
+    if (!sift_backend_available(backend))
+      throw std::runtime_error{
+          "The requested SIFT backend is not compiled in the library!"};
+
+    SARA_PROFILE_SCOPE("SIFT");
 
     // We describe the work flow of the feature detection and description.
     auto DoGs = vector<OERegion>{};
     auto SIFTDescriptors = Tensor_<float, 2>{};
 
     // 1. Feature extraction.
-    SARA_DEBUG << "Computing DoG extrema" << endl;
-    timer.restart();
     ComputeDoGExtrema compute_DoGs{pyramid_params, 0.01f};
     auto scale_octave_pairs = vector<Point2i>{};
-    DoGs = compute_DoGs(image, &scale_octave_pairs);
-    auto dog_detection_time = timer.elapsed_ms();
-    elapsed += dog_detection_time;
-    SARA_DEBUG << "DoG detection time = " << dog_detection_time << " ms"
-               << endl;
+    {
+      SARA_PROFILE_SCOPE("SIFT/DoG extrema");
+      DoGs = compute_DoGs(image, &scale_octave_pairs);
+    }
     SARA_DEBUG << "DoGs.size() = " << DoGs.size() << endl;
 
     // 2. Feature orientation.
     // Prepare the computation of gradients on gaussians.
-    SARA_DEBUG << "Computing gradients of Gaussians" << endl;
-    timer.restart();
-    auto nabla_G = gradient_polar_coordinates(compute_DoGs.gaussians());
-    auto grad_gaussian_time = timer.elapsed_ms();
-    elapsed += grad_gaussian_time;
-    SARA_DEBUG << "gradient of Gaussian computation time = "
-               << grad_gaussian_time << " ms" << endl;
-    SARA_DEBUG << "DoGs.size() = " << DoGs.size() << endl;
+    auto nabla_G = ImagePyramid<Vector2f>{};
+    {
+      SARA_PROFILE_SCOPE("SIFT/Gradients");
+      nabla_G = gradient_polar_coordinates(compute_DoGs.gaussians());
+    }
 
     // Find dominant gradient orientations.
-    SARA_DEBUG
-        << "Assigning (possibly multiple) dominant orientations to DoG extrema"
-        << endl;
-    timer.restart();
-    ComputeDominantOrientations assign_dominant_orientations;
-    assign_dominant_orientations(nabla_G, DoGs, scale_octave_pairs);
-    auto ori_assign_time = timer.elapsed_ms();
-    elapsed += ori_assign_time;
-    SARA_DEBUG << "orientation assignment time = " << ori_assign_time << " ms"
-               << endl;
+    {
+      SARA_PROFILE_SCOPE("SIFT/Orientations");
+      ComputeDominantOrientations assign_dominant_orientations;
+      assign_dominant_orientations(nabla_G, DoGs, scale_octave_pairs);
+    }
     SARA_DEBUG << "DoGs.size() = " << DoGs.size() << endl;
 
     if (parallel)
@@ -75,20 +197,23 @@ namespace DO::Sara {
     }
 
     // 3. Feature description.
-    SARA_DEBUG << "Describe DoG extrema with SIFT descriptors" << endl;
-    timer.restart();
-    ComputeSIFTDescriptor<> compute_sift;
-    SIFTDescriptors = compute_sift(DoGs, scale_octave_pairs, nabla_G, parallel);
-    auto sift_description_time = timer.elapsed_ms();
-    elapsed += sift_description_time;
-    SARA_DEBUG << "description time = " << sift_description_time << " ms"
-               << endl;
-    SARA_DEBUG << "sifts.size() = " << SIFTDescriptors.sizes().transpose()
-               << endl;
-
-    // Summary in terms of computation time.
-    SARA_DEBUG << "Total Detection/Description time" << endl;
-    SARA_DEBUG << "SIFT computation time = " << elapsed << " ms" << endl;
+    {
+      SARA_PROFILE_SCOPE("SIFT/Descriptors");
+      if (backend == SIFTBackend::Reference)
+      {
+        ComputeSIFTDescriptor<> compute_sift;
+        SIFTDescriptors =
+            compute_sift(DoGs, scale_octave_pairs, nabla_G, parallel);
+      }
+#ifdef DO_SARA_USE_HALIDE
+      else if (backend == SIFTBackend::HalideCPU)
+        SIFTDescriptors = compute_sift_descriptors_halide_cpu(
+            DoGs, scale_octave_pairs, nabla_G, parallel);
+#endif
+    }
+
+    SARA_PROFILE_COUNTER("sift.keypoints", DoGs.size());
+    SARA_PROFILE_HISTOGRAM("sift.keypoints_per_image", DoGs.size());
 
     // 4. Rescale  the feature position and scale $(x, y, \sigma)$ with the
     //    octave scale.
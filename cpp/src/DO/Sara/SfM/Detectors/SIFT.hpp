@@ -22,11 +22,39 @@ namespace DO::Sara {
   //! @addtogroup SfM Structure-from-Motion Building Blocks
   //! @{
 
+  //! @brief Implementations of the SIFT descriptor computation.
+  enum class SIFTBackend
+  {
+    //! @brief Reference implementation.
+    Reference,
+    //! @brief Vectorized and multi-threaded Halide implementation compiled
+    //! ahead-of-time for x86-64 CPUs, i.e., AVX-512, AVX2 and SSE4.1, with
+    //! runtime dispatch.
+    HalideCPU
+  };
+
+  //! @brief Check whether a backend is compiled in the library.
+  DO_SARA_EXPORT
+  auto sift_backend_available(SIFTBackend backend) -> bool;
+
+  /*!
+    @brief Detect DoG extrema and describe them with SIFT.
+
+    The DoG extrema and their dominant orientations are the same whichever
+    the backend. Requesting a backend that is not available throws a
+    'std::runtime_error'.
+
+    'parallel' enables the multi-threaded description with either backend:
+    OpenMP threads for the reference implementation, and the Halide thread
+    pool, limited to the OpenMP thread count, for the Halide implementation.
+    Otherwise the description runs on a single thread.
+   */
   DO_SARA_EXPORT
   auto compute_sift_keypoints(
       const ImageView<float>& image,
       const ImagePyramidParams& pyramid_params = ImagePyramidParams(),
-      bool parallel = false)
+      bool parallel = false,
+      SIFTBackend backend = SIFTBackend::Reference)
       -> KeypointList<OERegion, float>;
 
   //! @}
@@ -15,4 +15,9 @@ if (NOT DO_Sara_Core_ADDED)
     target_include_directories(DO_Sara_Core PUBLIC ${HDF5_INCLUDE_DIRS})
     target_link_libraries(DO_Sara_Core PUBLIC ${HDF5_CXX_LIBRARIES})
   endif()
+
+  # POSIX shared memory used by the shared-memory frame ring.
+  if (UNIX AND NOT APPLE)
+    target_link_libraries(DO_Sara_Core PUBLIC rt)
+  endif ()
 endif ()
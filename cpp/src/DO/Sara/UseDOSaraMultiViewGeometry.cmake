@@ -10,5 +10,7 @@ if (SARA_USE_FROM_SOURCE)
     target_include_directories(DO_Sara_MultiViewGeometry
       PUBLIC
       ${Boost_INCLUDE_DIRS})
+    target_link_libraries(DO_Sara_MultiViewGeometry
+      PUBLIC $<$<BOOL:OpenMP_CXX_FOUND>:OpenMP::OpenMP_CXX>)
   endif ()
 endif ()
@@ -19,5 +19,14 @@ if (SARA_USE_FROM_SOURCE)
     target_link_libraries(DO_Sara_SfM
       PRIVATE tinyply Boost::filesystem
       PUBLIC $<$<BOOL:OpenMP_CXX_FOUND>:OpenMP::OpenMP_CXX>)
+
+    # Halide CPU backend of the SIFT descriptor. The ahead-of-time compiled
+    # pipeline is generated in `cpp/drafts/Halide/Generators`.
+    if (SARA_USE_HALIDE)
+      find_package(Halide REQUIRED)
+      target_compile_definitions(DO_Sara_SfM PRIVATE DO_SARA_USE_HALIDE)
+      target_link_libraries(DO_Sara_SfM
+        PRIVATE Halide::Runtime shakti_sift_descriptor_v4_cpu)
+    endif ()
   endif ()
 endif ()
@@ -13,15 +13,219 @@ extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
 #include <DO/Sara/Core/DebugUtilities.hpp>
+#include <DO/Sara/Core/Image/BulkColorConversion.hpp>
 #include <DO/Sara/VideoIO/VideoStream.hpp>
 
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
 
 namespace DO::Sara {
 
+  //! @brief Ring buffer of decoded frames filled by a producer thread.
+  struct VideoStream::Prefetcher
+  {
+    enum class SlotState
+    {
+      Free,
+      Ready,
+      Borrowed
+    };
+
+    std::vector<frame_buffer_type> frames;
+    std::vector<SlotState> states;
+
+    //! @brief Next slot to fill by the producer.
+    int write_index = 0;
+    //! @brief Next slot to borrow by the consumer.
+    int read_index = 0;
+    //! @brief Slot borrowed by 'read()'.
+    int current_index = -1;
+
+    bool end_of_stream = false;
+    bool stop = false;
+    std::exception_ptr error;
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::thread producer;
+
+    auto slot_index(const std::uint8_t* data) const -> int
+    {
+      for (auto i = 0u; i < frames.size(); ++i)
+        if (frames[i].data() == data)
+          return static_cast<int>(i);
+      return -1;
+    }
+  };
+
+
+  static auto sws_flags(VideoScaler scaler) -> int
+  {
+    switch (scaler)
+    {
+    case VideoScaler::FastBilinear:
+      return SWS_FAST_BILINEAR;
+    case VideoScaler::Bilinear:
+      return SWS_BILINEAR;
+    case VideoScaler::Bicubic:
+      return SWS_BICUBIC;
+    case VideoScaler::Area:
+      return SWS_AREA;
+    case VideoScaler::Lanczos:
+      return SWS_LANCZOS;
+    case VideoScaler::Point:
+    default:
+      return SWS_POINT;
+    }
+  }
+
+
+  // ======================================================================== //
+  // Frame index.
+  static constexpr char frame_index_magic[8] = {'S', 'A', 'R', 'A',
+                                                'F', 'I', 'D', 'X'};
+  static constexpr std::uint32_t frame_index_version = 2;
+
+  //! The timestamp of a video packet is its pts, otherwise its dts, otherwise
+  //! its number among the video packets. The frame index and the decoder must
+  //! agree on it.
+  static auto packet_timestamp(const AVPacket& pkt,
+                               std::int64_t packet_number) -> std::int64_t
+  {
+    if (pkt.pts != AV_NOPTS_VALUE)
+      return pkt.pts;
+    if (pkt.dts != AV_NOPTS_VALUE)
+      return pkt.dts;
+    return packet_number;
+  }
+
+  static auto file_signature(const std::string& filepath,
+                             std::int64_t& file_size,
+                             std::int64_t& modification_time) -> bool
+  {
+    struct stat file_stat;
+    if (stat(filepath.c_str(), &file_stat) != 0)
+      return false;
+    file_size = static_cast<std::int64_t>(file_stat.st_size);
+    modification_time = static_cast<std::int64_t>(file_stat.st_mtime);
+    return true;
+  }
+
+  auto VideoFrameIndex::position(std::int64_t timestamp) const -> int
+  {
+    return static_cast<int>(
+        std::lower_bound(timestamps.begin(), timestamps.end(), timestamp) -
+        timestamps.begin());
+  }
+
+  auto VideoFrameIndex::keyframe_before(int frame_position) const -> int
+  {
+    const auto k =
+        std::upper_bound(keyframes.begin(), keyframes.end(), frame_position);
+    if (k == keyframes.begin())
+      return keyframes.empty() ? 0 : keyframes.front();
+    return *(k - 1);
+  }
+
+  template <typename T>
+  static auto write_array(std::ofstream& file, const std::vector<T>& v)
+      -> void
+  {
+    const auto size = static_cast<std::uint64_t>(v.size());
+    file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char*>(v.data()), size * sizeof(T));
+  }
+
+  template <typename T>
+  static auto read_array(std::ifstream& file, std::vector<T>& v) -> bool
+  {
+    auto size = std::uint64_t{};
+    if (!file.read(reinterpret_cast<char*>(&size), sizeof(size)))
+      return false;
+    // Guard against corrupted sizes before allocating.
+    const auto pos = file.tellg();
+    file.seekg(0, std::ios::end);
+    const auto remaining = static_cast<std::uint64_t>(file.tellg() - pos);
+    file.seekg(pos);
+    if (size > remaining / sizeof(T))
+      return false;
+    v.resize(size);
+    return static_cast<bool>(
+        file.read(reinterpret_cast<char*>(v.data()), size * sizeof(T)));
+  }
+
+  auto VideoFrameIndex::save(const std::string& filepath) const -> void
+  {
+    auto file = std::ofstream{filepath, std::ios::binary | std::ios::trunc};
+    if (!file.is_open())
+      throw std::runtime_error{"Could not create the frame index file \"" +
+                               filepath + "\"!"};
+
+    file.write(frame_index_magic, sizeof(frame_index_magic));
+    file.write(reinterpret_cast<const char*>(&frame_index_version),
+               sizeof(frame_index_version));
+    file.write(reinterpret_cast<const char*>(&file_size), sizeof(file_size));
+    file.write(reinterpret_cast<const char*>(&file_modification_time),
+               sizeof(file_modification_time));
+    write_array(file, timestamps);
+    write_array(file, keyframes);
+    write_array(file, keyframe_byte_offsets);
+    write_array(file, keyframe_packet_numbers);
+
+    if (!file)
+      throw std::runtime_error{"Could not write the frame index file \"" +
+                               filepath + "\"!"};
+  }
+
+  auto VideoFrameIndex::load(const std::string& filepath) -> bool
+  {
+    auto file = std::ifstream{filepath, std::ios::binary};
+    if (!file.is_open())
+      return false;
+
+    char magic[sizeof(frame_index_magic)];
+    auto version = std::uint32_t{};
+    auto index = VideoFrameIndex{};
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&index.file_size),
+              sizeof(index.file_size));
+    file.read(reinterpret_cast<char*>(&index.file_modification_time),
+              sizeof(index.file_modification_time));
+    if (!file ||
+        std::memcmp(magic, frame_index_magic, sizeof(magic)) != 0 ||
+        version != frame_index_version ||
+        !read_array(file, index.timestamps) ||
+        !read_array(file, index.keyframes) ||
+        !read_array(file, index.keyframe_byte_offsets) ||
+        !read_array(file, index.keyframe_packet_numbers) ||
+        index.keyframe_packet_numbers.size() != index.keyframes.size())
+      return false;
+
+    *this = std::move(index);
+    return true;
+  }
+
+
+  // ======================================================================== //
+  // Video stream.
   bool VideoStream::_registered_all_codecs = false;
 
   VideoStream::VideoStream()
@@ -79,6 +283,11 @@ namespace DO::Sara {
                                       _video_codec_params))
       throw std::runtime_error{"Could not copy video decoder context!"};
 
+    // Let FFmpeg decode with frame and slice threading, with as many threads
+    // as there are cores.
+    _video_codec_context->thread_count = 0;
+    _video_codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+
     // Open it.
     if (avcodec_open2(_video_codec_context, _video_codec, nullptr) < 0)
       throw std::runtime_error{"Could not open video decoder!"};
@@ -96,6 +305,9 @@ namespace DO::Sara {
       throw std::runtime_error("Could not allocate video packet!");
     av_init_packet(_pkt);
 
+    _file_path = file_path;
+    _frame_position = -1;
+
     SARA_DEBUG << "#[VideoStream] sizes = " << sizes().transpose() << std::endl;
     SARA_DEBUG
         << "#[VideoStream] time base = " << _video_stream_index << ": "  //
@@ -104,35 +316,21 @@ namespace DO::Sara {
         << _video_format_context->streams[_video_stream_index]->time_base.den
         << std::endl;
 
-    // Get video format converter to RGB24.
-    _sws_context = sws_getContext(
-        width(), height(), _video_codec_context->pix_fmt, width(), height(),
-        AV_PIX_FMT_RGB24, SWS_POINT, nullptr, nullptr, nullptr);
-    if (_sws_context == nullptr)
-      throw std::runtime_error{"Could not allocate SWS context!"};
-
-    // The converted the video frame.
-    if (_picture_rgb == nullptr)
-      _picture_rgb = av_frame_alloc();
-    if (_picture_rgb == nullptr)
-      throw std::runtime_error{"Could not allocate video frame!"};
-
-    // @TODO: make it 32 to optimize for SSE/AVX2.
-    constexpr auto alignment_size = 1;
-    const auto byte_size =
-        av_image_alloc(_picture_rgb->data, _picture_rgb->linesize, width(),
-                       height(), AV_PIX_FMT_RGB24, alignment_size);
-    if (byte_size != width() * height() * 3)
-      throw std::runtime_error{
-          "Allocated memory size for the converted video frame is wrong!"};
+    // Get the video format converter and the converted video frame.
+    update_sws_context();
+    _frame_buffer.resize(output_byte_size());
+    _frame_data = nullptr;
 
     _end_of_stream = false;
+    _num_video_packets = 0;
   }
 
   auto VideoStream::close() -> void
   {
+    stop_prefetching();
+
     // Flush the decoder (draining mode.)
-    if (_video_format_context != nullptr)
+    if (_video_format_context != nullptr && !_draining)
       this->decode(_video_codec_context, _picture, nullptr);
 
     // Free the data structures.
@@ -150,18 +348,504 @@ namespace DO::Sara {
     _video_codec = nullptr;
 
     sws_freeContext(_sws_context);
-    if (_picture_rgb != nullptr)
-      av_freep(_picture_rgb->data);
-    av_frame_free(&_picture_rgb);
+    _sws_context = nullptr;
+    _frame_buffer.clear();
+    _gray8_buffer.clear();
+    _frame_data = nullptr;
 
     _end_of_stream = true;
+    _draining = false;
+    _packet_pending = false;
+
+    _file_path.clear();
+    _frame_index = {};
+    _frame_position = -1;
   }
 
   auto VideoStream::read() -> bool
+  {
+    if (_prefetcher != nullptr)
+    {
+      if (_prefetcher->current_index != -1)
+      {
+        release_frame_data(_prefetcher->frames[_prefetcher->current_index]
+                               .data());
+        _prefetcher->current_index = -1;
+      }
+
+      const auto next_frame = acquire_frame_data();
+      if (next_frame == nullptr)
+        return false;
+
+      _prefetcher->current_index = _prefetcher->slot_index(next_frame);
+      return true;
+    }
+
+    _frame_data = nullptr;
+    if (!decode_next_frame())
+      return false;
+
+    present_decoded_frame();
+    return true;
+  }
+
+  auto VideoStream::present_decoded_frame() -> void
+  {
+    if (!_frame_index.empty())
+      _frame_position = _frame_index.position(_picture->best_effort_timestamp);
+
+    // Point to the luma plane when it is not padded.
+    if (_output_pixel_format == VideoPixelFormat::Gray8 &&
+        luma_plane_available() && _picture->linesize[0] == width())
+    {
+      _frame_data = _picture->data[0];
+      return;
+    }
+
+    convert_frame(_frame_buffer.data());
+    _frame_data = _frame_buffer.data();
+  }
+
+  auto VideoStream::frame_data() const -> std::uint8_t*
+  {
+    if (_prefetcher != nullptr)
+      return _prefetcher->current_index == -1
+                 ? nullptr
+                 : _prefetcher->frames[_prefetcher->current_index].data();
+
+    return _frame_data;
+  }
+
+  auto VideoStream::set_output_format(VideoPixelFormat pixel_format,
+                                      const Vector2i& sizes,
+                                      VideoScaler scaler) -> void
+  {
+    if ((sizes.array() < 0).any() || (sizes.x() == 0) != (sizes.y() == 0))
+      throw std::domain_error{"Invalid output frame sizes!"};
+
+    // The buffered frames are in the previous format and are dropped.
+    const auto num_buffered_frames =
+        _prefetcher != nullptr ? static_cast<int>(_prefetcher->frames.size())
+                               : 0;
+    stop_prefetching();
+
+    _output_pixel_format = pixel_format;
+    _output_width = sizes.x();
+    _output_height = sizes.y();
+    _scaler = scaler;
+
+    if (_video_codec_context != nullptr)
+    {
+      update_sws_context();
+      _frame_buffer.resize(output_byte_size());
+      _frame_data = nullptr;
+    }
+
+    if (num_buffered_frames > 0)
+      start_prefetching(num_buffered_frames);
+  }
+
+  auto VideoStream::output_sizes() const -> Vector2i
+  {
+    if (_output_width == 0)
+      return sizes();
+    return {_output_width, _output_height};
+  }
+
+  auto VideoStream::output_byte_size() const -> std::size_t
+  {
+    const auto num_pixels =
+        static_cast<std::size_t>(output_sizes().cast<std::size_t>().prod());
+    switch (_output_pixel_format)
+    {
+    case VideoPixelFormat::Rgb8:
+      return 3 * num_pixels;
+    case VideoPixelFormat::Gray32f:
+      return sizeof(float) * num_pixels;
+    case VideoPixelFormat::Gray8:
+    default:
+      return num_pixels;
+    }
+  }
+
+  auto VideoStream::luma_plane_available() const -> bool
+  {
+    if (_output_pixel_format == VideoPixelFormat::Rgb8 ||
+        output_sizes() != sizes())
+      return false;
+
+    // The first plane must store the 8-bit luma values contiguously.
+    const auto desc = av_pix_fmt_desc_get(_video_codec_context->pix_fmt);
+    return desc != nullptr &&
+           !(desc->flags & (AV_PIX_FMT_FLAG_RGB | AV_PIX_FMT_FLAG_PAL |
+                            AV_PIX_FMT_FLAG_BE | AV_PIX_FMT_FLAG_HWACCEL)) &&
+           desc->comp[0].plane == 0 && desc->comp[0].step == 1 &&
+           desc->comp[0].offset == 0 && desc->comp[0].shift == 0 &&
+           desc->comp[0].depth == 8;
+  }
+
+  auto VideoStream::update_sws_context() -> void
+  {
+    const auto dst_format = _output_pixel_format == VideoPixelFormat::Rgb8
+                                ? AV_PIX_FMT_RGB24
+                                : AV_PIX_FMT_GRAY8;
+    const auto dst_sizes = output_sizes();
+    _sws_context = sws_getCachedContext(
+        _sws_context, width(), height(), _video_codec_context->pix_fmt,
+        dst_sizes.x(), dst_sizes.y(), dst_format, sws_flags(_scaler), nullptr,
+        nullptr, nullptr);
+    if (_sws_context == nullptr)
+      throw std::runtime_error{"Could not allocate SWS context!"};
+  }
+
+  auto VideoStream::seek(std::size_t frame_pos) -> void
+  {
+    // The producer thread owns the decoder while it runs.
+    const auto num_buffered_frames =
+        _prefetcher != nullptr ? static_cast<int>(_prefetcher->frames.size())
+                               : 0;
+    stop_prefetching();
+
+    av_seek_frame(_video_format_context, _video_stream_index, frame_pos,
+                  AVSEEK_FLAG_BACKWARD);
+    // Streams without timestamps are seeked by packet number.
+    _num_video_packets = static_cast<std::int64_t>(frame_pos);
+
+    // Reset the decoder: with frame threading, it still holds the frames
+    // decoded before the seek.
+    avcodec_flush_buffers(_video_codec_context);
+    av_packet_unref(_pkt);
+    _packet_pending = false;
+    _end_of_stream = false;
+    _draining = false;
+    _frame_data = nullptr;
+    _frame_position = -1;
+
+    if (num_buffered_frames > 0)
+      start_prefetching(num_buffered_frames);
+  }
+
+  auto VideoStream::build_frame_index(const std::string& cache_filepath)
+      -> void
+  {
+    if (_video_format_context == nullptr)
+      throw std::runtime_error{"No video stream is open!"};
+
+    stop_prefetching();
+
+    const auto index_filepath = cache_filepath.empty()
+                                    ? _file_path + ".frame_index"
+                                    : cache_filepath;
+
+    auto file_size = std::int64_t{};
+    auto modification_time = std::int64_t{};
+    const auto signed_file =
+        file_signature(_file_path, file_size, modification_time);
+
+    // Reuse the cached index if it describes the same file.
+    auto index = VideoFrameIndex{};
+    if (!(signed_file && index.load(index_filepath) &&
+          index.file_size == file_size &&
+          index.file_modification_time == modification_time &&
+          !index.empty()))
+    {
+      // Rewind the demuxer and scan all the packets without decoding them.
+      index = VideoFrameIndex{};
+      index.file_size = file_size;
+      index.file_modification_time = modification_time;
+
+      constexpr auto min_ts = std::numeric_limits<std::int64_t>::min();
+      constexpr auto max_ts = std::numeric_limits<std::int64_t>::max();
+      avformat_seek_file(_video_format_context, _video_stream_index, min_ts,
+                         min_ts, max_ts, 0);
+
+      auto keyframe_timestamps = std::vector<std::int64_t>{};
+      auto keyframe_byte_offsets = std::vector<std::int64_t>{};
+      auto keyframe_packet_numbers = std::vector<std::int64_t>{};
+      auto num_packets = std::int64_t{};
+      auto pkt = av_packet_alloc();
+      while (av_read_frame(_video_format_context, pkt) >= 0)
+      {
+        if (pkt->stream_index == _video_stream_index)
+        {
+          const auto timestamp = packet_timestamp(*pkt, num_packets);
+          index.timestamps.push_back(timestamp);
+          if (pkt->flags & AV_PKT_FLAG_KEY)
+          {
+            keyframe_timestamps.push_back(timestamp);
+            keyframe_byte_offsets.push_back(pkt->pos);
+            keyframe_packet_numbers.push_back(num_packets);
+          }
+          ++num_packets;
+        }
+        av_packet_unref(pkt);
+      }
+      av_packet_free(&pkt);
+
+      // Sort the frames in presentation order.
+      std::sort(index.timestamps.begin(), index.timestamps.end());
+      index.timestamps.erase(
+          std::unique(index.timestamps.begin(), index.timestamps.end()),
+          index.timestamps.end());
+
+      // Sort the keyframes in presentation order as well.
+      auto order = std::vector<std::size_t>(keyframe_timestamps.size());
+      std::iota(order.begin(), order.end(), 0);
+      std::sort(order.begin(), order.end(), [&](auto a, auto b) {
+        return keyframe_timestamps[a] < keyframe_timestamps[b];
+      });
+      for (const auto k : order)
+      {
+        index.keyframes.push_back(index.position(keyframe_timestamps[k]));
+        index.keyframe_byte_offsets.push_back(keyframe_byte_offsets[k]);
+        index.keyframe_packet_numbers.push_back(keyframe_packet_numbers[k]);
+      }
+
+      // The cache is only an optimization.
+      if (signed_file)
+      {
+        try
+        {
+          index.save(index_filepath);
+        }
+        catch (const std::exception& e)
+        {
+          SARA_DEBUG << e.what() << std::endl;
+        }
+      }
+    }
+
+    _frame_index = std::move(index);
+
+    // Rewind to the first frame.
+    if (!_frame_index.empty())
+      seek_keyframe(_frame_index.keyframe_before(0));
+  }
+
+  auto VideoStream::seek_keyframe(int keyframe_position) -> void
+  {
+    const auto timestamp = _frame_index.timestamps[keyframe_position];
+    if (av_seek_frame(_video_format_context, _video_stream_index, timestamp,
+                      AVSEEK_FLAG_BACKWARD) < 0)
+      throw std::runtime_error{"Could not seek the keyframe!"};
+
+    // Resynchronize the packet counter with the keyframe packet.
+    const auto& keyframes = _frame_index.keyframes;
+    const auto k = std::lower_bound(keyframes.begin(), keyframes.end(),
+                                    keyframe_position);
+    _num_video_packets =
+        k != keyframes.end() && *k == keyframe_position
+            ? _frame_index.keyframe_packet_numbers[k - keyframes.begin()]
+            : 0;
+
+    // Reset the decoder.
+    avcodec_flush_buffers(_video_codec_context);
+    av_packet_unref(_pkt);
+    _packet_pending = false;
+    _end_of_stream = false;
+    _draining = false;
+    _frame_data = nullptr;
+    _frame_position = -1;
+  }
+
+  auto VideoStream::read_frame(int frame_position) -> bool
+  {
+    if (_frame_index.empty())
+      throw std::runtime_error{"The frame index is not built!"};
+    if (frame_position < 0 || frame_position >= num_frames())
+      throw std::out_of_range{"The frame position is out of range!"};
+
+    // The producer thread owns the decoder while it runs.
+    stop_prefetching();
+
+    // Keep decoding forward if no keyframe lies between the current frame and
+    // the requested one.
+    const auto keyframe = _frame_index.keyframe_before(frame_position);
+    if (_frame_position == -1 || _frame_position >= frame_position ||
+        keyframe > _frame_position)
+      seek_keyframe(keyframe);
+
+    auto found = false;
+    while (decode_next_frame())
+    {
+      const auto position =
+          _frame_index.position(_picture->best_effort_timestamp);
+      if (position < frame_position)
+      {
+        _frame_position = position;
+        continue;
+      }
+
+      present_decoded_frame();
+      found = position == frame_position;
+      break;
+    }
+
+    return found;
+  }
+
+  auto VideoStream::extract_frames(
+      const std::vector<int>& frame_positions,
+      const std::function<void(std::size_t)>& visitor) -> void
+  {
+    // Visit the frames in increasing order of position.
+    auto order = std::vector<std::size_t>(frame_positions.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](auto a, auto b) {
+      return frame_positions[a] < frame_positions[b];
+    });
+
+    for (const auto i : order)
+    {
+      // Duplicate positions share the same decoded frame.
+      if (_frame_position != frame_positions[i] &&
+          !read_frame(frame_positions[i]))
+        throw std::runtime_error{"Could not decode frame " +
+                                 std::to_string(frame_positions[i]) + "!"};
+      visitor(i);
+    }
+  }
+
+  auto VideoStream::start_prefetching(int num_buffered_frames) -> void
+  {
+    if (num_buffered_frames < 1)
+      throw std::domain_error{
+          "The number of buffered frames must be positive!"};
+    if (_video_format_context == nullptr)
+      throw std::runtime_error{"No video stream is open!"};
+
+    stop_prefetching();
+
+    _prefetcher.reset(new Prefetcher{});
+    _prefetcher->frames.reserve(num_buffered_frames);
+    for (auto i = 0; i < num_buffered_frames; ++i)
+      _prefetcher->frames.emplace_back(output_byte_size());
+    _prefetcher->states.resize(num_buffered_frames,
+                               Prefetcher::SlotState::Free);
+    _prefetcher->end_of_stream = _end_of_stream;
+    // The position of the frames decoded ahead is not tracked.
+    _frame_position = -1;
+
+    _prefetcher->producer = std::thread{[this]() { produce_frames(); }};
+  }
+
+  auto VideoStream::stop_prefetching() -> void
+  {
+    if (_prefetcher == nullptr)
+      return;
+
+    {
+      std::lock_guard<std::mutex> lock{_prefetcher->mutex};
+      _prefetcher->stop = true;
+    }
+    _prefetcher->cond.notify_all();
+
+    if (_prefetcher->producer.joinable())
+      _prefetcher->producer.join();
+
+    // Any frame decoded ahead and not consumed is dropped.
+    _prefetcher.reset();
+  }
+
+  auto VideoStream::acquire_frame_data() -> std::uint8_t*
+  {
+    if (_prefetcher == nullptr)
+      throw std::runtime_error{"Frame prefetching is not started!"};
+
+    auto& p = *_prefetcher;
+    auto lock = std::unique_lock<std::mutex>{p.mutex};
+    p.cond.wait(lock, [&p]() {
+      return p.states[p.read_index] == Prefetcher::SlotState::Ready ||
+             p.end_of_stream;
+    });
+
+    if (p.states[p.read_index] != Prefetcher::SlotState::Ready)
+    {
+      if (p.error)
+        std::rethrow_exception(p.error);
+      return nullptr;
+    }
+
+    auto frame = p.frames[p.read_index].data();
+    p.states[p.read_index] = Prefetcher::SlotState::Borrowed;
+    p.read_index = (p.read_index + 1) % static_cast<int>(p.frames.size());
+
+    return frame;
+  }
+
+  auto VideoStream::release_frame_data(const std::uint8_t* data) -> void
+  {
+    if (_prefetcher == nullptr)
+      return;
+
+    auto& p = *_prefetcher;
+    {
+      std::lock_guard<std::mutex> lock{p.mutex};
+      const auto i = p.slot_index(data);
+      if (i == -1 || p.states[i] != Prefetcher::SlotState::Borrowed)
+        throw std::runtime_error{"This frame was not borrowed from the video "
+                                 "stream!"};
+      p.states[i] = Prefetcher::SlotState::Free;
+    }
+    p.cond.notify_all();
+  }
+
+  auto VideoStream::produce_frames() -> void
+  {
+    auto& p = *_prefetcher;
+    const auto num_frames = static_cast<int>(p.frames.size());
+
+    while (true)
+    {
+      // Wait for the next slot in the ring to be given back.
+      auto slot = int{};
+      {
+        auto lock = std::unique_lock<std::mutex>{p.mutex};
+        p.cond.wait(lock, [&p]() {
+          return p.stop || p.end_of_stream ||
+                 p.states[p.write_index] == Prefetcher::SlotState::Free;
+        });
+        if (p.stop || p.end_of_stream)
+          return;
+        slot = p.write_index;
+      }
+
+      // Decode and convert outside the critical section.
+      auto got_frame = false;
+      try
+      {
+        got_frame = decode_next_frame();
+        if (got_frame)
+          convert_frame(p.frames[slot].data());
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock{p.mutex};
+        p.error = std::current_exception();
+        got_frame = false;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock{p.mutex};
+        if (got_frame)
+        {
+          p.states[slot] = Prefetcher::SlotState::Ready;
+          p.write_index = (slot + 1) % num_frames;
+        }
+        else
+          p.end_of_stream = true;
+      }
+      p.cond.notify_all();
+    }
+  }
+
+  auto VideoStream::decode_next_frame() -> bool
   {
     do
     {
-      if (!_end_of_stream)
+      // A packet refused by the decoder is sent again before reading the
+      // next one.
+      if (!_end_of_stream && !_packet_pending)
         if (av_read_frame(_video_format_context, _pkt) < 0)
           _end_of_stream = true;
 
@@ -169,46 +853,97 @@ namespace DO::Sara {
       {
         _pkt->data = nullptr;
         _pkt->size = 0;
-        return false;
+
+        // With frame threading, the decoder holds several frames in flight:
+        // drain them before reporting the end of the stream.
+        if (!_draining)
+        {
+          _draining = true;
+          if (avcodec_send_packet(_video_codec_context, nullptr) < 0)
+            return false;
+        }
+        return avcodec_receive_frame(_video_codec_context, _picture) == 0;
       }
 
       if (_pkt->stream_index == _video_stream_index || _end_of_stream)
       {
         _got_frame = 0;
 
+        // Same timestamps as in the frame index.
         if (_pkt->pts == AV_NOPTS_VALUE)
-          _pkt->pts = _pkt->dts = _i;
+        {
+          _pkt->pts = packet_timestamp(*_pkt, _num_video_packets);
+          if (_pkt->dts == AV_NOPTS_VALUE)
+            _pkt->dts = _pkt->pts;
+        }
 
         // Decompress the video frame.
         _got_frame = decode(_video_codec_context, _picture, _pkt);
 
-        if (_got_frame)
+        if (!_packet_pending)
         {
           av_packet_unref(_pkt);
-          av_init_packet(_pkt);
-
-          // Convert to RGB24 pixel format.
-          sws_scale(_sws_context, _picture->data, _picture->linesize, 0,
-                    height(), _picture_rgb->data, _picture_rgb->linesize);
+          ++_num_video_packets;
+        }
 
+        if (_got_frame)
           return true;
-        }
       }
-      ++_i;
+      else
+        av_packet_unref(_pkt);
     } while (!_end_of_stream || _got_frame);
 
     return false;
   }
 
-  auto VideoStream::frame() const -> ImageView<Rgb8>
+  auto VideoStream::convert_frame(std::uint8_t* dst) -> void
   {
-    return {reinterpret_cast<Rgb8*>(_picture_rgb->data[0]), sizes()};
-  }
+    const auto w = output_sizes().x();
+    const auto h = output_sizes().y();
 
-  auto VideoStream::seek(std::size_t frame_pos) -> void
-  {
-    av_seek_frame(_video_format_context, _video_stream_index, frame_pos,
-                  AVSEEK_FLAG_BACKWARD);
+    // Grayscale frames: read the luma plane directly.
+    if (luma_plane_available())
+    {
+      const auto src = _picture->data[0];
+      const auto src_linesize = _picture->linesize[0];
+      if (_output_pixel_format == VideoPixelFormat::Gray8)
+      {
+        for (auto y = 0; y < h; ++y)
+          std::memcpy(dst + y * w, src + y * src_linesize, w);
+      }
+      else
+      {
+        const auto& lut = detail::normalized_uint8_lut<float>();
+        auto dst_float = reinterpret_cast<float*>(dst);
+        for (auto y = 0; y < h; ++y)
+          for (auto x = 0; x < w; ++x)
+            dst_float[y * w + x] = lut[src[y * src_linesize + x]];
+      }
+      return;
+    }
+
+    // Otherwise convert to packed RGB24 or GRAY8 with swscale.
+    auto sws_dst = dst;
+    if (_output_pixel_format == VideoPixelFormat::Gray32f)
+    {
+      _gray8_buffer.resize(w * h);
+      sws_dst = _gray8_buffer.data();
+    }
+
+    const auto num_channels =
+        _output_pixel_format == VideoPixelFormat::Rgb8 ? 3 : 1;
+    std::uint8_t* dst_data[4] = {sws_dst, nullptr, nullptr, nullptr};
+    int dst_linesize[4] = {num_channels * w, 0, 0, 0};
+    sws_scale(_sws_context, _picture->data, _picture->linesize, 0, height(),
+              dst_data, dst_linesize);
+
+    if (_output_pixel_format == VideoPixelFormat::Gray32f)
+    {
+      const auto& lut = detail::normalized_uint8_lut<float>();
+      auto dst_float = reinterpret_cast<float*>(dst);
+      std::transform(_gray8_buffer.begin(), _gray8_buffer.end(), dst_float,
+                     [&lut](auto v) { return lut[v]; });
+    }
   }
 
   auto VideoStream::decode(AVCodecContext* dec_ctx, AVFrame* frame,
@@ -217,15 +952,25 @@ namespace DO::Sara {
     auto ret = int{};
 
     // Transfer raw compressed video data to the packet.
+    //
+    // A decoder with frames in flight refuses the packet until its output is
+    // drained: receive a decoded frame first and send the packet again at the
+    // next call.
     ret = avcodec_send_packet(dec_ctx, pkt);
-    if (ret < 0)
+    _packet_pending = ret == AVERROR(EAGAIN);
+    if (ret < 0 && !_packet_pending && ret != AVERROR_EOF)
       throw std::runtime_error{"Error sending a packet for decoding!"};
 
     // Decode the compressed video data into an uncompressed video frame.
     ret = avcodec_receive_frame(dec_ctx, frame);
 
     if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF)
+    {
+      // The decoder can neither accept input nor produce output.
+      if (_packet_pending)
+        throw std::runtime_error{"The decoder is stalled!"};
       return false;
+    }
 
     if (ret < 0)
       throw std::runtime_error{"Error during decoding!"};
@@ -14,9 +14,15 @@
 #include <DO/Sara/Defines.hpp>
 
 #include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/MemoryPool.hpp>
 
+#include <cstdint>
 #include <cstdio>
+#include <functional>
 #include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 
 struct AVCodec;
@@ -33,6 +39,122 @@ namespace DO { namespace Sara {
   //! @defgroup VideoIO Video I/O
   //! @{
 
+  //! @brief Pixel format of the decoded video frames.
+  enum class VideoPixelFormat
+  {
+    Rgb8,
+    Gray8,
+    Gray32f
+  };
+
+  //! @brief Rescaling algorithm used when the output sizes differ from the
+  //! video sizes.
+  enum class VideoScaler
+  {
+    Point,
+    FastBilinear,
+    Bilinear,
+    Bicubic,
+    Area,
+    Lanczos
+  };
+
+  //! @{
+  //! @brief Pixel format associated to the pixel type.
+  template <typename T>
+  struct VideoPixelFormatOf;
+
+  template <>
+  struct VideoPixelFormatOf<Rgb8>
+  {
+    static constexpr auto value = VideoPixelFormat::Rgb8;
+  };
+
+  template <>
+  struct VideoPixelFormatOf<std::uint8_t>
+  {
+    static constexpr auto value = VideoPixelFormat::Gray8;
+  };
+
+  template <>
+  struct VideoPixelFormatOf<float>
+  {
+    static constexpr auto value = VideoPixelFormat::Gray32f;
+  };
+  //! @}
+
+  /*!
+    @brief Index of the frames of a video stream.
+
+    The index is built by demuxing the whole video once, without decoding
+    it. It maps the frame positions in presentation order to their
+    timestamps and records the keyframes, which are the entry points for
+    decoding.
+   */
+  struct DO_SARA_EXPORT VideoFrameIndex
+  {
+    //! @brief Sorted presentation timestamps of the frames, in the stream time
+    //! base.
+    std::vector<std::int64_t> timestamps;
+    //! @brief Positions of the keyframes.
+    std::vector<int> keyframes;
+    //! @brief Byte offsets of the keyframe packets in the video file.
+    std::vector<std::int64_t> keyframe_byte_offsets;
+    //! @brief Numbers of the keyframe packets among the video packets.
+    std::vector<std::int64_t> keyframe_packet_numbers;
+
+    //! @{
+    //! @brief Identification of the indexed video file.
+    std::int64_t file_size = 0;
+    std::int64_t file_modification_time = 0;
+    //! @}
+
+    auto num_frames() const -> int
+    {
+      return static_cast<int>(timestamps.size());
+    }
+
+    auto empty() const -> bool
+    {
+      return timestamps.empty();
+    }
+
+    //! @brief Position of the first frame with a timestamp not less than the
+    //! given one.
+    auto position(std::int64_t timestamp) const -> int;
+
+    //! @brief Position of the last keyframe at or before the frame.
+    auto keyframe_before(int frame_position) const -> int;
+
+    //! @brief Save the index to a binary file.
+    auto save(const std::string& filepath) const -> void;
+
+    //! @brief Load the index from a binary file, and return false if the file
+    //! does not exist or is invalid.
+    auto load(const std::string& filepath) -> bool;
+  };
+
+  /*!
+    @brief Video decoder.
+
+    Frames are converted to RGB by default. Alternatively,
+    'set_output_format()' lets the caller request grayscale frames, possibly
+    resized. For YUV videos, grayscale frames are obtained from the luma plane
+    directly, without any colorspace conversion. Output frames are aligned on
+    cache lines.
+
+    By default, frames are decoded synchronously when calling 'read()'.
+
+    Alternatively, 'start_prefetching()' launches a producer thread which
+    decodes frames ahead into a bounded ring of preallocated frames. The
+    consumer then borrows frames with 'acquire_frame()' and gives them back
+    with 'release_frame()' once it is done, so that decoding and processing
+    overlap. 'read()' and 'frame()' keep working in this mode: the frame
+    borrowed by 'read()' is released at the next call to 'read()'.
+
+    Frame-accurate random access requires the frame index, which is built or
+    loaded from its cache file by 'build_frame_index()'.
+   */
   class DO_SARA_EXPORT VideoStream
   {
   public:
@@ -50,10 +172,135 @@ namespace DO { namespace Sara {
 
     auto read() -> bool;
 
-    auto frame() const -> ImageView<Rgb8>;
+    //! @brief Current RGB frame.
+    auto frame() const -> ImageView<Rgb8>
+    {
+      return frame_as<Rgb8>();
+    }
+
+    //! @brief Current frame in the output pixel format.
+    template <typename T>
+    auto frame_as() const -> ImageView<T>
+    {
+      check_output_pixel_type<T>();
+      const auto data = frame_data();
+      if (data == nullptr)
+        return {};
+      return {reinterpret_cast<T*>(data), output_sizes()};
+    }
+
+    //! @brief Choose the format of the decoded frames.
+    //!
+    //! Null sizes mean the video sizes.
+    auto set_output_format(VideoPixelFormat pixel_format,
+                           const Vector2i& sizes = Vector2i::Zero(),
+                           VideoScaler scaler = VideoScaler::Point) -> void;
+
+    auto output_pixel_format() const -> VideoPixelFormat
+    {
+      return _output_pixel_format;
+    }
+
+    auto output_sizes() const -> Vector2i;
 
     auto seek(std::size_t frame_pos) -> void;
 
+    //! @{
+    //! @brief Frame-accurate random access.
+    //!
+    //! Build the frame index or load it from the cache file if it is valid,
+    //! and rewind the stream to its first frame. By default, the cache file
+    //! is the video file path suffixed with ".frame_index".
+    auto build_frame_index(const std::string& cache_filepath = {}) -> void;
+
+    auto frame_index() const -> const VideoFrameIndex&
+    {
+      return _frame_index;
+    }
+
+    auto num_frames() const -> int
+    {
+      return _frame_index.num_frames();
+    }
+
+    //! @brief Position of the current frame, or -1 if it is unknown.
+    auto frame_position() const -> int
+    {
+      return _frame_position;
+    }
+
+    //! @brief Decode the frame at the given position, which becomes the
+    //! current frame.
+    //!
+    //! Decoding resumes from the current frame if the requested frame is in
+    //! the same group of pictures. Otherwise, it starts from the closest
+    //! keyframe. Subsequent calls to 'read()' return the next frames.
+    //! Prefetching is stopped if it was running.
+    auto read_frame(int frame_position) -> bool;
+
+    //! @brief Decode the frames at the given positions.
+    //!
+    //! Frames are decoded in increasing order of position so that each group
+    //! of pictures is decoded at most once. The visitor is called with the
+    //! index of the requested position in the list while the frame is the
+    //! current frame.
+    auto extract_frames(const std::vector<int>& frame_positions,
+                        const std::function<void(std::size_t)>& visitor)
+        -> void;
+
+    //! @brief Decode the frames at the given positions and copy them, in the
+    //! order of the list.
+    template <typename T = Rgb8>
+    auto extract_frames(const std::vector<int>& frame_positions)
+        -> std::vector<Image<T>>
+    {
+      check_output_pixel_type<T>();
+      auto frames = std::vector<Image<T>>(frame_positions.size());
+      extract_frames(frame_positions, [&](std::size_t i) {
+        frames[i] = Image<T>(frame_as<T>());
+      });
+      return frames;
+    }
+    //! @}
+
+    //! @{
+    //! @brief Asynchronous decoding.
+    auto start_prefetching(int num_buffered_frames = 4) -> void;
+
+    auto stop_prefetching() -> void;
+
+    auto prefetching() const -> bool
+    {
+      return _prefetcher != nullptr;
+    }
+
+    //! @brief Borrow the next decoded frame.
+    //!
+    //! Blocks until the frame is decoded and returns an empty view at the end
+    //! of the stream.
+    auto acquire_frame() -> ImageView<Rgb8>
+    {
+      return acquire_frame_as<Rgb8>();
+    }
+
+    template <typename T>
+    auto acquire_frame_as() -> ImageView<T>
+    {
+      check_output_pixel_type<T>();
+      const auto data = acquire_frame_data();
+      if (data == nullptr)
+        return {};
+      return {reinterpret_cast<T*>(data), output_sizes()};
+    }
+
+    //! @brief Give back a borrowed frame to the ring buffer.
+    template <typename T>
+    auto release_frame(const ImageView<T>& frame) -> void
+    {
+      release_frame_data(reinterpret_cast<const std::uint8_t*>(frame.data()));
+    }
+    //! @}
+
     auto frame_rate() const -> float;
 
     auto width() const -> int;
@@ -78,6 +325,36 @@ namespace DO { namespace Sara {
   private:
     auto decode(AVCodecContext* dec_ctx, AVFrame* frame, AVPacket* pkt) -> bool;
 
+    auto decode_next_frame() -> bool;
+
+    auto convert_frame(std::uint8_t* dst) -> void;
+
+    auto produce_frames() -> void;
+
+    template <typename T>
+    auto check_output_pixel_type() const -> void
+    {
+      if (VideoPixelFormatOf<T>::value != _output_pixel_format)
+        throw std::runtime_error{
+            "The pixel type differs from the output pixel format!"};
+    }
+
+    auto frame_data() const -> std::uint8_t*;
+
+    auto acquire_frame_data() -> std::uint8_t*;
+
+    auto release_frame_data(const std::uint8_t* data) -> void;
+
+    auto output_byte_size() const -> std::size_t;
+
+    auto luma_plane_available() const -> bool;
+
+    auto update_sws_context() -> void;
+
+    auto present_decoded_frame() -> void;
+
+    auto seek_keyframe(int keyframe_position) -> void;
+
   private:
     static bool _registered_all_codecs;
 
@@ -91,11 +368,39 @@ namespace DO { namespace Sara {
     AVPacket* _pkt = nullptr;
 
     SwsContext *_sws_context = nullptr;
-    AVFrame* _picture_rgb = nullptr;
+
+    // Output format.
+    VideoPixelFormat _output_pixel_format = VideoPixelFormat::Rgb8;
+    int _output_width = 0;
+    int _output_height = 0;
+    VideoScaler _scaler = VideoScaler::Point;
+
+    // Output buffers, aligned on cache lines.
+    using frame_buffer_type =
+        std::vector<std::uint8_t, PooledAllocator<std::uint8_t>>;
+    frame_buffer_type _frame_buffer;
+    frame_buffer_type _gray8_buffer;
+    // Current frame, which points to the luma plane of the decoded picture
+    // when no copy is needed.
+    std::uint8_t* _frame_data = nullptr;
 
     bool _end_of_stream{true};
+    bool _draining{false};
+    // Whether '_pkt' was refused by the decoder and must be sent again.
+    bool _packet_pending{false};
     int _got_frame{};
-    int _i{};
+    // Number of video packets read so far, which is the timestamp of the
+    // packets without pts and dts.
+    std::int64_t _num_video_packets{};
+
+    // Frame index.
+    std::string _file_path;
+    VideoFrameIndex _frame_index;
+    int _frame_position = -1;
+
+    // Asynchronous decoding.
+    struct Prefetcher;
+    std::unique_ptr<Prefetcher> _prefetcher;
   };
 
   //! @}
@@ -154,6 +154,83 @@ BOOST_AUTO_TEST_CASE(test_hdf5_read_write_array)
   fs::remove(filepath);
 }
 
+BOOST_AUTO_TEST_CASE(test_hdf5_chunked_compressed_and_extendible_datasets)
+{
+  const auto filepath =
+      (fs::temp_directory_path() / "test_chunked.h5").string();
+
+  auto array = Tensor_<float, 2>{100, 8};
+  for (auto i = 0; i < array.size(); ++i)
+    array.data()[i] = float(i);
+
+  {
+    auto h5file = H5File{filepath, H5F_ACC_TRUNC};
+
+    auto options = H5DatasetOptions{};
+    options.chunk_sizes = {16, 8};
+    options.deflate_level = 6;
+    options.shuffle = true;
+    h5file.write_dataset("compressed", array, false, options);
+
+    // Chunk sizes must be specified for each dimension.
+    options.chunk_sizes = {16};
+    BOOST_CHECK_THROW(h5file.write_dataset("bad", array, false, options),
+                      std::runtime_error);
+
+    // Append the rows in three batches.
+    auto append_options = H5DatasetOptions{};
+    append_options.deflate_level = 1;
+    h5file.append_dataset("appended",
+                          TensorView_<float, 2>{array.data(), {30, 8}},
+                          append_options);
+    h5file.append_dataset(
+        "appended", TensorView_<float, 2>{array.data() + 30 * 8, {50, 8}});
+    h5file.append_dataset(
+        "appended", TensorView_<float, 2>{array.data() + 80 * 8, {20, 8}});
+
+    // The row sizes must match.
+    BOOST_CHECK_THROW(
+        h5file.append_dataset("appended",
+                              TensorView_<float, 2>{array.data(), {2, 4}}),
+        std::runtime_error);
+
+    // A contiguous dataset cannot be extended.
+    h5file.write_dataset("contiguous", array);
+    BOOST_CHECK_THROW(h5file.append_dataset("contiguous", array),
+                      std::runtime_error);
+  }
+
+  {
+    auto h5file = H5File{filepath, H5F_ACC_RDONLY};
+
+    auto full = Tensor_<float, 2>{};
+    h5file.read_dataset("compressed", full);
+    BOOST_CHECK_EQUAL(full.matrix(), array.matrix());
+
+    const auto appended = h5file.find_dataset("appended");
+    BOOST_REQUIRE(appended != nullptr);
+    BOOST_CHECK(h5file.read_dataset_sizes(*appended).cast<int>() ==
+                Vector2i(100, 8));
+
+    h5file.read_dataset("appended", full);
+    BOOST_CHECK_EQUAL(full.matrix(), array.matrix());
+
+    // Read a range of rows straddling several chunks.
+    auto rows = Tensor_<float, 2>{25, 8};
+    h5file.read_dataset_rows("compressed", 40, rows);
+    BOOST_CHECK_EQUAL(rows.matrix(), array.matrix().middleRows(40, 25));
+
+    h5file.read_dataset_rows("appended", 75, rows);
+    BOOST_CHECK_EQUAL(rows.matrix(), array.matrix().middleRows(75, 25));
+
+    // Out of range.
+    BOOST_CHECK_THROW(h5file.read_dataset_rows("compressed", 80, rows),
+                      std::out_of_range);
+  }
+
+  fs::remove(filepath);
+}
+
 
 //BOOST_AUTO_TEST_CASE(test_hdf5_read_write_std_string)
 //{
@@ -0,0 +1,120 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2014-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "Core/Image/Bulk Color Conversions"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/Pixel/Typedefs.hpp>
+
+#include <random>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+template <typename T>
+auto random_image(int w, int h) -> Image<T>
+{
+  using channel_type = typename PixelTraits<T>::channel_type;
+  constexpr auto num_channels = PixelTraits<T>::num_channels;
+
+  auto rng = std::mt19937{0};
+  auto dist = std::uniform_int_distribution<int>{0, 255};
+
+  auto image = Image<T>{w, h};
+  auto channels = reinterpret_cast<channel_type*>(image.data());
+  for (auto i = 0u; i < image.size() * num_channels; ++i)
+  {
+    if (std::is_floating_point<channel_type>::value)
+      channels[i] = static_cast<channel_type>(dist(rng) / 255.);
+    else
+      channels[i] = static_cast<channel_type>(dist(rng));
+  }
+
+  return image;
+}
+
+// Compare the bulk conversion with the reference per-pixel conversion.
+template <typename Src, typename Dst>
+auto check_bit_exact_conversion(const Image<Src>& src) -> void
+{
+  const auto dst = src.template convert<Dst>();
+
+  for (auto i = 0u; i < src.size(); ++i)
+  {
+    auto expected = Dst{};
+    smart_convert_color(src.data()[i], expected);
+    BOOST_REQUIRE(expected == dst.data()[i]);
+  }
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestBulkColorConversion)
+
+BOOST_AUTO_TEST_CASE(test_gray8_conversions)
+{
+  // Enumerate all the 8-bit grayscale values.
+  auto src = Image<unsigned char>{16, 16};
+  for (auto i = 0; i < 256; ++i)
+    src.data()[i] = static_cast<unsigned char>(i);
+
+  check_bit_exact_conversion<unsigned char, float>(src);
+  check_bit_exact_conversion<unsigned char, double>(src);
+  check_bit_exact_conversion<unsigned char, Rgb8>(src);
+  check_bit_exact_conversion<unsigned char, Rgb32f>(src);
+}
+
+BOOST_AUTO_TEST_CASE(test_rgb8_conversions)
+{
+  const auto rgb8 = random_image<Rgb8>(37, 23);
+  check_bit_exact_conversion<Rgb8, unsigned char>(rgb8);
+  check_bit_exact_conversion<Rgb8, float>(rgb8);
+  check_bit_exact_conversion<Rgb8, double>(rgb8);
+  check_bit_exact_conversion<Rgb8, Rgb32f>(rgb8);
+  check_bit_exact_conversion<Rgb8, Rgb64f>(rgb8);
+  check_bit_exact_conversion<Rgb8, Yuv32f>(rgb8);
+  check_bit_exact_conversion<Rgb8, Rgba32f>(rgb8);
+
+  const auto rgba8 = random_image<Rgba8>(37, 23);
+  check_bit_exact_conversion<Rgba8, unsigned char>(rgba8);
+  check_bit_exact_conversion<Rgba8, float>(rgba8);
+  check_bit_exact_conversion<Rgba8, Rgb32f>(rgba8);
+}
+
+BOOST_AUTO_TEST_CASE(test_floating_point_conversions)
+{
+  const auto gray32f = random_image<float>(37, 23);
+  check_bit_exact_conversion<float, unsigned char>(gray32f);
+  check_bit_exact_conversion<float, double>(gray32f);
+  check_bit_exact_conversion<float, Rgb8>(gray32f);
+
+  const auto rgb32f = random_image<Rgb32f>(37, 23);
+  check_bit_exact_conversion<Rgb32f, Rgb8>(rgb32f);
+  check_bit_exact_conversion<Rgb32f, Rgb64f>(rgb32f);
+  check_bit_exact_conversion<Rgb32f, Yuv32f>(rgb32f);
+  check_bit_exact_conversion<Rgb32f, float>(rgb32f);
+
+  const auto yuv32f = random_image<Yuv32f>(37, 23);
+  check_bit_exact_conversion<Yuv32f, Rgb32f>(yuv32f);
+  check_bit_exact_conversion<Yuv32f, Rgb8>(yuv32f);
+}
+
+BOOST_AUTO_TEST_CASE(test_generic_fallback)
+{
+  const auto rgb8 = random_image<Rgb8>(37, 23);
+  check_bit_exact_conversion<Rgb8, Yuv8>(rgb8);
+  check_bit_exact_conversion<Rgb8, Rgba8>(rgb8);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
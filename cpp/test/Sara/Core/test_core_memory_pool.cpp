@@ -0,0 +1,105 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "Core/Memory Pool"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/MemoryPool.hpp>
+
+#include <cstdint>
+#include <thread>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+BOOST_AUTO_TEST_SUITE(TestMemoryPool)
+
+BOOST_AUTO_TEST_CASE(test_size_classes)
+{
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(0), 0);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(1), 0);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(64), 0);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(65), 1);
+  BOOST_CHECK_EQUAL(MemoryPool::size_class(4096), 6);
+
+  BOOST_CHECK_EQUAL(MemoryPool::block_size(6), 4096u);
+  BOOST_CHECK_EQUAL(MemoryPool::block_alignment(0), 64u);
+  BOOST_CHECK_EQUAL(MemoryPool::block_alignment(6), 4096u);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocate_and_reuse)
+{
+  MemoryPool pool;
+
+  auto small_block = pool.allocate(100);
+  auto large_block = pool.allocate(640 * 480 * sizeof(float));
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(small_block) % 64, 0u);
+  BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(large_block) % 4096, 0u);
+  BOOST_CHECK_EQUAL(pool.num_system_allocations(), 2u);
+
+  pool.deallocate(large_block, 640 * 480 * sizeof(float));
+  BOOST_CHECK_EQUAL(pool.cached_bytes(),
+                    MemoryPool::block_size(MemoryPool::size_class(
+                        640 * 480 * sizeof(float))));
+
+  // A block of the same size class is served from the free list.
+  auto reused_block = pool.allocate(600 * 480 * sizeof(float));
+  BOOST_CHECK_EQUAL(reused_block, large_block);
+  BOOST_CHECK_EQUAL(pool.num_reused_blocks(), 1u);
+  BOOST_CHECK_EQUAL(pool.cached_bytes(), 0u);
+
+  pool.deallocate(small_block, 100);
+  pool.deallocate(reused_block, 600 * 480 * sizeof(float));
+  pool.release();
+  BOOST_CHECK_EQUAL(pool.cached_bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_concurrent_allocations)
+{
+  MemoryPool pool;
+
+  auto threads = std::vector<std::thread>{};
+  for (auto t = 0; t < 4; ++t)
+    threads.emplace_back([&pool, t]() {
+      for (auto i = 0; i < 1000; ++i)
+      {
+        const auto num_bytes = std::size_t(64) << ((i + t) % 8);
+        auto ptr = static_cast<unsigned char*>(pool.allocate(num_bytes));
+        ptr[0] = ptr[num_bytes - 1] = static_cast<unsigned char>(t);
+        pool.deallocate(ptr, num_bytes);
+      }
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  BOOST_CHECK_EQUAL(pool.num_reused_blocks() + pool.num_system_allocations(),
+                    4000u);
+}
+
+BOOST_AUTO_TEST_CASE(test_pooled_image)
+{
+  auto& pool = MemoryPool::global();
+
+  auto image = Image<float, 2, PooledAllocator>{320, 240};
+  const auto data = image.data();
+  image.clear();
+
+  const auto num_reused_blocks = pool.num_reused_blocks();
+  image.resize(320, 240);
+  BOOST_CHECK_EQUAL(image.data(), data);
+  BOOST_CHECK_EQUAL(pool.num_reused_blocks(), num_reused_blocks + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,257 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "Core/Profiler"
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/Core/Profiler.hpp>
+
+#include <atomic>
+#include <sstream>
+#include <thread>
+
+
+using namespace DO::Sara;
+using namespace std;
+
+
+auto parse_json(const std::string& s) -> boost::property_tree::ptree
+{
+  auto is = std::istringstream{s};
+  auto tree = boost::property_tree::ptree{};
+  boost::property_tree::read_json(is, tree);
+  return tree;
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestProfiler)
+
+BOOST_AUTO_TEST_CASE(test_zones_and_counters)
+{
+  auto& profiler = Profiler::instance();
+  profiler.reset();
+
+  for (auto i = 0; i < 3; ++i)
+  {
+    ProfileScope outer{"outer"};
+    {
+      ProfileScope inner{"inner"};
+      this_thread::sleep_for(chrono::milliseconds{2});
+    }
+    profiler.add_counter("iterations", 10);
+  }
+
+  const auto summary = profiler.summary();
+  BOOST_CHECK_EQUAL(summary.num_threads, 1);
+  BOOST_REQUIRE_EQUAL(summary.zones.size(), 2u);
+  BOOST_CHECK_EQUAL(summary.zones.at("outer").count, 3);
+  BOOST_CHECK_EQUAL(summary.zones.at("inner").count, 3);
+  BOOST_CHECK_GE(summary.zones.at("inner").min_ms, 2.);
+  BOOST_CHECK_GE(summary.zones.at("outer").total_ms,
+                 summary.zones.at("inner").total_ms);
+  BOOST_CHECK_GE(summary.wall_time_ms, summary.zones.at("outer").total_ms);
+  BOOST_CHECK_EQUAL(summary.counters.at("iterations"), 30);
+
+  profiler.reset();
+  const auto empty = profiler.summary();
+  BOOST_CHECK_EQUAL(empty.num_threads, 0);
+  BOOST_CHECK(empty.zones.empty());
+  BOOST_CHECK(empty.counters.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_threads)
+{
+  auto& profiler = Profiler::instance();
+  profiler.reset();
+
+  // Keep the threads alive until they have all recorded their metrics, so
+  // that none of them reuses the buffer of another one.
+  auto num_done = std::atomic<int>{0};
+  auto threads = std::vector<std::thread>{};
+  for (auto t = 0; t < 4; ++t)
+    threads.emplace_back([&profiler, &num_done]() {
+      for (auto i = 0; i < 1000; ++i)
+      {
+        ProfileScope scope{"task"};
+        profiler.add_counter("tasks", 1);
+        profiler.add_sample("values", i);
+      }
+      ++num_done;
+      while (num_done < 4)
+        this_thread::yield();
+    });
+  for (auto& thread : threads)
+    thread.join();
+
+  const auto summary = profiler.summary();
+  BOOST_CHECK_EQUAL(summary.num_threads, 4);
+  BOOST_CHECK_EQUAL(summary.zones.at("task").count, 4000);
+  BOOST_CHECK_EQUAL(summary.counters.at("tasks"), 4000);
+  BOOST_CHECK_EQUAL(summary.histograms.at("values").count, 4000);
+  BOOST_CHECK_EQUAL(summary.histograms.at("values").max, 999.);
+}
+
+BOOST_AUTO_TEST_CASE(test_recycled_thread_buffers)
+{
+  auto& profiler = Profiler::instance();
+  profiler.reset();
+
+  // Short-lived threads, like the workers of a data loader at each epoch.
+  for (auto epoch = 0; epoch < 10; ++epoch)
+  {
+    auto worker = std::thread{[&profiler]() {
+      ProfileScope scope{"worker"};
+      profiler.add_counter("batches", 1);
+    }};
+    worker.join();
+  }
+
+  const auto summary = profiler.summary();
+  BOOST_CHECK_EQUAL(summary.num_threads, 1);
+  BOOST_CHECK_EQUAL(summary.zones.at("worker").count, 10);
+  BOOST_CHECK_EQUAL(summary.counters.at("batches"), 10);
+
+  auto trace = std::ostringstream{};
+  profiler.write_chrome_trace(trace);
+  const auto events = parse_json(trace.str()).get_child("traceEvents");
+  auto num_zones = 0;
+  for (const auto& [key, event] : events)
+    num_zones += event.get<std::string>("ph") == "X";
+  BOOST_CHECK_EQUAL(num_zones, 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_max_zones_per_thread)
+{
+  auto& profiler = Profiler::instance();
+  profiler.reset();
+  profiler.set_max_zones_per_thread(5);
+
+  for (auto i = 0; i < 12; ++i)
+    ProfileScope scope{"zone"};
+
+  // The statistics account for all the zones but the trace is bounded.
+  const auto summary = profiler.summary();
+  BOOST_CHECK_EQUAL(summary.zones.at("zone").count, 12);
+  BOOST_CHECK_EQUAL(summary.num_dropped_zones, 7);
+
+  auto trace = std::ostringstream{};
+  profiler.write_chrome_trace(trace);
+  const auto events = parse_json(trace.str()).get_child("traceEvents");
+  auto num_zones = 0;
+  for (const auto& [key, event] : events)
+    num_zones += event.get<std::string>("ph") == "X";
+  BOOST_CHECK_EQUAL(num_zones, 5);
+
+  auto json = std::ostringstream{};
+  profiler.write_summary(json);
+  BOOST_CHECK_EQUAL(parse_json(json.str()).get<int>("num_dropped_zones"), 7);
+
+  profiler.set_max_zones_per_thread(Profiler::default_max_zones_per_thread);
+  profiler.reset();
+}
+
+BOOST_AUTO_TEST_CASE(test_histogram)
+{
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(-1.), 0);
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(0.), 0);
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(1.), 32);
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(1.5), 32);
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(2.), 33);
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(0.25), 30);
+  BOOST_CHECK_EQUAL(ProfileHistogram::bin(1e30), ProfileHistogram::num_bins - 1);
+  BOOST_CHECK_EQUAL(ProfileHistogram::lower_bound(33), 2.);
+
+  auto h = ProfileHistogram{};
+  for (const auto x : {0.5, 1., 3., 3.5})
+    h.add(x);
+  BOOST_CHECK_EQUAL(h.count, 4);
+  BOOST_CHECK_EQUAL(h.sum, 8.);
+  BOOST_CHECK_EQUAL(h.min, 0.5);
+  BOOST_CHECK_EQUAL(h.max, 3.5);
+  BOOST_CHECK_EQUAL(h.bins[31], 1);
+  BOOST_CHECK_EQUAL(h.bins[32], 1);
+  BOOST_CHECK_EQUAL(h.bins[33], 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_export)
+{
+  auto& profiler = Profiler::instance();
+  profiler.reset();
+
+  {
+    ProfileScope scope{"stage \"1\""};
+    profiler.add_counter("keypoints", 42);
+    profiler.add_sample("matches", 100);
+  }
+
+  auto trace = std::ostringstream{};
+  profiler.write_chrome_trace(trace);
+  const auto trace_tree = parse_json(trace.str());
+  auto num_zones = 0;
+  auto num_counters = 0;
+  for (const auto& [key, event] : trace_tree.get_child("traceEvents"))
+  {
+    const auto phase = event.get<std::string>("ph");
+    if (phase == "X")
+    {
+      ++num_zones;
+      BOOST_CHECK_EQUAL(event.get<std::string>("name"), "stage \"1\"");
+      BOOST_CHECK_GE(event.get<double>("dur"), 0.);
+    }
+    else if (phase == "C")
+    {
+      ++num_counters;
+      BOOST_CHECK_EQUAL(event.get<std::string>("name"), "keypoints");
+      BOOST_CHECK_EQUAL(event.get<int>("args.value"), 42);
+    }
+  }
+  BOOST_CHECK_EQUAL(num_zones, 1);
+  BOOST_CHECK_EQUAL(num_counters, 1);
+
+  auto summary = std::ostringstream{};
+  profiler.write_summary(summary);
+  const auto summary_tree = parse_json(summary.str());
+  BOOST_CHECK_EQUAL(summary_tree.get<int>("num_threads"), 1);
+  BOOST_CHECK_EQUAL(summary_tree.get<int>("counters.keypoints"), 42);
+  BOOST_CHECK_EQUAL(summary_tree.get<int>("histograms.matches.count"), 1);
+  BOOST_CHECK_EQUAL(
+      summary_tree.get_child("zones").begin()->second.get<int>("count"), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_macros)
+{
+  auto& profiler = Profiler::instance();
+  profiler.reset();
+
+  auto num_evaluations = 0;
+  {
+    SARA_PROFILE_SCOPE("scope");
+    SARA_PROFILE_COUNTER("counter", ++num_evaluations);
+    SARA_PROFILE_HISTOGRAM("histogram", ++num_evaluations);
+  }
+
+  const auto summary = profiler.summary();
+#ifdef DO_SARA_USE_PROFILING
+  BOOST_CHECK_EQUAL(num_evaluations, 2);
+  BOOST_CHECK_EQUAL(summary.zones.at("scope").count, 1);
+  BOOST_CHECK_EQUAL(summary.counters.at("counter"), 1);
+  BOOST_CHECK_EQUAL(summary.histograms.at("histogram").count, 1);
+#else
+  BOOST_CHECK_EQUAL(num_evaluations, 0);
+  BOOST_CHECK(summary.zones.empty());
+  BOOST_CHECK(summary.counters.empty());
+  BOOST_CHECK(summary.histograms.empty());
+#endif
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,285 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "Core/Shared Frame Ring"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/Core/Image.hpp>
+#include <DO/Sara/Core/SharedFrameRing.hpp>
+
+#include <algorithm>
+#include <string>
+
+#ifndef _WIN32
+# include <sys/wait.h>
+# include <unistd.h>
+#endif
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+static auto ring_name(const std::string& test_name) -> std::string
+{
+#ifdef _WIN32
+  return "sara_test_" + test_name;
+#else
+  return "sara_test_" + test_name + "_" + std::to_string(getpid());
+#endif
+}
+
+//! Every pixel of frame n has the value n % 256.
+static auto fill_frame(ImageView<Rgb8>& frame, std::uint64_t n) -> void
+{
+  const auto value = static_cast<std::uint8_t>(n % 256);
+  frame.flat_array().fill(Rgb8(value, value, value));
+}
+
+static auto check_frame(const ImageView<Rgb8>& frame, std::uint64_t n) -> bool
+{
+  const auto value = static_cast<std::uint8_t>(n % 256);
+  return std::all_of(frame.begin(), frame.end(), [&](const Rgb8& p) {
+    return p == Rgb8(value, value, value);
+  });
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestSharedFrameRing)
+
+BOOST_AUTO_TEST_CASE(test_frame_layout)
+{
+  const auto rgb = FrameLayout::of_image<Rgb8>(Vector2i(640, 480));
+  BOOST_CHECK(rgb.element_type == FrameElementType::UInt8);
+  BOOST_CHECK_EQUAL(rgb.num_dims, 3);
+  BOOST_CHECK_EQUAL(rgb.shape[0], 480);
+  BOOST_CHECK_EQUAL(rgb.shape[1], 640);
+  BOOST_CHECK_EQUAL(rgb.shape[2], 3);
+  BOOST_CHECK_EQUAL(rgb.num_bytes(), 640u * 480u * 3u);
+
+  const auto gray = FrameLayout::of_image<float>(Vector2i(640, 480));
+  BOOST_CHECK(gray.element_type == FrameElementType::Float32);
+  BOOST_CHECK_EQUAL(gray.num_dims, 2);
+  BOOST_CHECK_EQUAL(gray.num_bytes(), 640u * 480u * 4u);
+
+  const auto tensor = FrameLayout::of_tensor<double, 4>(Vector4i(2, 3, 4, 5));
+  BOOST_CHECK(tensor.element_type == FrameElementType::Float64);
+  BOOST_CHECK_EQUAL(tensor.size(), 120);
+}
+
+BOOST_AUTO_TEST_CASE(test_publish_and_read)
+{
+  const auto name = ring_name("publish_and_read");
+  auto producer = SharedFrameProducer{name, 4, 64 * 48 * 3};
+  auto consumer = SharedFrameConsumer{name};
+  BOOST_CHECK_EQUAL(consumer.num_slots(), 4);
+  BOOST_CHECK_EQUAL(consumer.slot_capacity(), 64u * 48u * 3u);
+
+  // Nothing is published yet.
+  BOOST_CHECK(!consumer.next(std::chrono::microseconds{0}));
+
+  // Copy an image into the ring.
+  auto image = Image<Rgb8>{64, 48};
+  fill_frame(image, 7);
+  BOOST_CHECK_EQUAL(producer.publish(image), 0u);
+
+  // Write a frame in place.
+  auto frame = producer.begin_frame<Rgb8>(Vector2i(32, 16));
+  fill_frame(frame, 8);
+  BOOST_CHECK_EQUAL(producer.end_frame(), 1u);
+  BOOST_CHECK_EQUAL(producer.num_published(), 2u);
+
+  auto f0 = consumer.next();
+  BOOST_REQUIRE(f0);
+  BOOST_CHECK_EQUAL(f0->sequence, 0u);
+  const auto v0 = f0->image_view<Rgb8>();
+  BOOST_CHECK_EQUAL(v0.sizes(), Vector2i(64, 48));
+  BOOST_CHECK(check_frame(v0, 7));
+  BOOST_CHECK(consumer.is_valid(*f0));
+
+  auto f1 = consumer.next();
+  BOOST_REQUIRE(f1);
+  BOOST_CHECK_EQUAL(f1->sequence, 1u);
+  BOOST_CHECK_EQUAL(f1->image_view<Rgb8>().sizes(), Vector2i(32, 16));
+  BOOST_CHECK(check_frame(f1->image_view<Rgb8>(), 8));
+
+  // The layout is checked against the requested view type.
+  BOOST_CHECK_THROW(f1->image_view<float>(), std::runtime_error);
+  BOOST_CHECK_THROW((f1->tensor_view<std::uint8_t, 2>()), std::runtime_error);
+  BOOST_CHECK_EQUAL((f1->tensor_view<std::uint8_t, 3>().sizes()),
+                    Vector3i(16, 32, 3));
+
+  BOOST_CHECK(!consumer.next(std::chrono::microseconds{0}));
+  BOOST_CHECK_EQUAL(consumer.num_dropped(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(test_publish_tensor)
+{
+  const auto name = ring_name("publish_tensor");
+  auto producer = SharedFrameProducer{name, 2, 1024};
+  auto consumer = SharedFrameConsumer{name};
+
+  auto tensor = Tensor_<float, 2>{10, 3};
+  for (auto i = 0; i < 30; ++i)
+    tensor.data()[i] = float(i);
+  producer.publish(tensor);
+
+  const auto frame = consumer.next();
+  BOOST_REQUIRE(frame);
+  const auto view = frame->tensor_view<float, 2>();
+  BOOST_CHECK_EQUAL(view.sizes(), Vector2i(10, 3));
+  BOOST_CHECK_EQUAL(view(4, 2), 14.f);
+
+  // Frames that do not fit in a slot are rejected.
+  auto too_large = Tensor_<float, 2>{100, 3};
+  BOOST_CHECK_THROW(producer.publish(too_large), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_multiple_consumers)
+{
+  const auto name = ring_name("multiple_consumers");
+  auto producer = SharedFrameProducer{name, 4, 8 * 8 * 3};
+  auto early_consumer = SharedFrameConsumer{name};
+
+  auto image = Image<Rgb8>{8, 8};
+  fill_frame(image, 0);
+  producer.publish(image);
+
+  // A consumer only reads the frames published after it is attached.
+  auto late_consumer = SharedFrameConsumer{name};
+
+  fill_frame(image, 1);
+  producer.publish(image);
+
+  const auto a0 = early_consumer.next();
+  const auto a1 = early_consumer.next();
+  const auto b1 = late_consumer.next();
+  BOOST_REQUIRE(a0 && a1 && b1);
+  BOOST_CHECK_EQUAL(a0->sequence, 0u);
+  BOOST_CHECK_EQUAL(a1->sequence, 1u);
+  BOOST_CHECK_EQUAL(b1->sequence, 1u);
+  BOOST_CHECK(check_frame(a1->image_view<Rgb8>(), 1));
+  BOOST_CHECK(check_frame(b1->image_view<Rgb8>(), 1));
+}
+
+BOOST_AUTO_TEST_CASE(test_lagging_consumer)
+{
+  const auto name = ring_name("lagging_consumer");
+  auto producer = SharedFrameProducer{name, 4, 8 * 8 * 3};
+  auto consumer = SharedFrameConsumer{name};
+
+  auto image = Image<Rgb8>{8, 8};
+  fill_frame(image, 0);
+  producer.publish(image);
+
+  const auto f0 = consumer.next();
+  BOOST_REQUIRE(f0);
+
+  // The producer laps the consumer.
+  for (auto n = 1; n <= 10; ++n)
+  {
+    fill_frame(image, n);
+    producer.publish(image);
+  }
+
+  // The slot of frame 0 has been overwritten.
+  BOOST_CHECK(!consumer.is_valid(*f0));
+
+  // The consumer skips to the oldest frame that is guaranteed to be intact,
+  // i.e., the last 3 frames.
+  const auto f8 = consumer.next();
+  BOOST_REQUIRE(f8);
+  BOOST_CHECK_EQUAL(f8->sequence, 8u);
+  BOOST_CHECK_EQUAL(consumer.num_dropped(), 7u);
+  BOOST_CHECK(check_frame(f8->image_view<Rgb8>(), 8));
+  BOOST_CHECK(consumer.is_valid(*f8));
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_ring)
+{
+  BOOST_CHECK_THROW(SharedFrameConsumer{ring_name("missing")},
+                    std::runtime_error);
+  BOOST_CHECK_THROW((SharedFrameProducer{ring_name("one_slot"), 1, 64}),
+                    std::runtime_error);
+
+  auto producer = SharedFrameProducer{ring_name("end_frame"), 2, 64};
+  BOOST_CHECK_THROW(producer.end_frame(), std::runtime_error);
+}
+
+#ifndef _WIN32
+BOOST_AUTO_TEST_CASE(test_two_processes)
+{
+  constexpr auto num_frames = 200;
+  const auto name = ring_name("two_processes");
+  auto producer = SharedFrameProducer{name, 8, 320 * 240 * 3};
+
+  int ready[2];
+  BOOST_REQUIRE_EQUAL(pipe(ready), 0);
+
+  const auto pid = fork();
+  BOOST_REQUIRE_NE(pid, -1);
+
+  if (pid == 0)
+  {
+    // Consumer process: every frame is either received intact, or
+    // overwritten and then reported as such, or dropped.
+    auto status = 0;
+    try
+    {
+      auto consumer = SharedFrameConsumer{name};
+      const auto c = char{1};
+      if (write(ready[1], &c, 1) != 1)
+        _exit(2);
+
+      auto num_received = std::uint64_t{};
+      while (num_received + consumer.num_dropped() < num_frames)
+      {
+        const auto frame = consumer.next(std::chrono::seconds{5});
+        if (!frame)
+          _exit(3);
+        const auto intact = check_frame(frame->image_view<Rgb8>(),
+                                        frame->sequence);
+        if (!intact && consumer.is_valid(*frame))
+          _exit(4);
+        ++num_received;
+      }
+      if (num_received == 0)
+        status = 5;
+    }
+    catch (...)
+    {
+      status = 6;
+    }
+    _exit(status);
+  }
+
+  // Producer process.
+  auto c = char{};
+  BOOST_REQUIRE_EQUAL(read(ready[0], &c, 1), 1);
+  for (auto n = 0; n < num_frames; ++n)
+  {
+    auto frame = producer.begin_frame<Rgb8>(Vector2i(320, 240));
+    fill_frame(frame, n);
+    producer.end_frame();
+  }
+
+  auto status = 0;
+  BOOST_REQUIRE_EQUAL(waitpid(pid, &status, 0), pid);
+  BOOST_REQUIRE(WIFEXITED(status));
+  BOOST_CHECK_EQUAL(WEXITSTATUS(status), 0);
+
+  close(ready[0]);
+  close(ready[1]);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
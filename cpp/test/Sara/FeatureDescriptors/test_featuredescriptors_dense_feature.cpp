@@ -15,6 +15,8 @@
 
 #include <DO/Sara/FeatureDescriptors/DenseFeature.hpp>
 
+#include <cstdlib>
+
 
 using namespace std;
 using namespace DO::Sara;
@@ -31,4 +33,52 @@ BOOST_AUTO_TEST_CASE(test_function)
   BOOST_CHECK_EQUAL(Vector128f::Zero(), dense_sifts(0, 0));
 }
 
+BOOST_AUTO_TEST_CASE(test_fast_dense_sift_sizes)
+{
+  auto image = Image<float>{21, 10};
+  image.flat_array().fill(0.f);
+
+  const auto dense_sifts = compute_fast_dense_sift(image, 8, 4);
+  BOOST_CHECK_EQUAL(Vector2i(6, 3), dense_sifts.sizes());
+
+  // A flat image has no gradient.
+  for (const auto& d : dense_sifts)
+    BOOST_CHECK_EQUAL(Vector128f::Zero(), d);
+}
+
+BOOST_AUTO_TEST_CASE(test_fast_dense_sift_matches_sift)
+{
+  // Smooth random image.
+  auto image = Image<float>{96, 96};
+  std::srand(0);
+  for (auto& v : image)
+    v = float(std::rand()) / float(RAND_MAX);
+  image = image.compute<DericheBlur>(2.f);
+
+  const auto patch_size = 8;
+  const auto sigma = float(patch_size / 2);
+
+  const auto gradients = gradient_polar_coordinates(image);
+  const auto dense_sifts = DenseSIFTComputer<>{}(gradients, sigma);
+  BOOST_CHECK_EQUAL(image.sizes(), dense_sifts.sizes());
+
+  const auto compute_sift = ComputeSIFTDescriptor<>{};
+  const auto r = int(3 * sigma * 2.5f);
+  for (auto y = r; y < image.height() - r; y += 3)
+  {
+    for (auto x = r; x < image.width() - r; x += 3)
+    {
+      const auto expected =
+          compute_sift(float(x), float(y), sigma, gradients);
+      const auto& actual = dense_sifts(x, y);
+
+      // The Gaussian window is only evaluated at the cell centers so the
+      // descriptors are close but not equal.
+      const auto cosine =
+          expected.dot(actual) / (expected.norm() * actual.norm());
+      BOOST_CHECK_GT(cosine, 0.99f);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,269 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "FeatureMatching/Brute-Force Matching"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/FeatureMatching.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+auto make_keys(int num_keys, int dimension, std::mt19937& gen)
+    -> KeypointList<OERegion, float>
+{
+  auto dist = std::uniform_real_distribution<float>{0.f, 1.f};
+
+  auto keys = KeypointList<OERegion, float>{};
+  resize(keys, num_keys, dimension);
+  auto& [f, d] = keys;
+  for (auto i = 0; i < num_keys; ++i)
+  {
+    f[i].coords = Point2f{100.f * dist(gen), 100.f * dist(gen)};
+    f[i].shape_matrix = Eigen::Matrix2f::Identity();
+  }
+  std::generate(d.begin(), d.end(), [&]() { return dist(gen); });
+  return keys;
+}
+
+//! Perturb the descriptors of the first keypoints and permute them.
+auto make_noisy_copy(const KeypointList<OERegion, float>& keys,
+                     const std::vector<int>& permutation, std::mt19937& gen)
+    -> KeypointList<OERegion, float>
+{
+  auto noise = std::normal_distribution<float>{0.f, 0.01f};
+
+  const auto n = static_cast<int>(permutation.size());
+  const auto& [f, d] = keys;
+
+  auto copy = KeypointList<OERegion, float>{};
+  resize(copy, n, d.cols());
+  auto& [f2, d2] = copy;
+  for (auto i = 0; i < n; ++i)
+  {
+    f2[permutation[i]] = f[i];
+    for (auto k = 0; k < d.cols(); ++k)
+      d2(permutation[i], k) = d(i, k) + noise(gen);
+  }
+  return copy;
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestBruteForceMatching)
+
+BOOST_AUTO_TEST_CASE(test_nearest_neighbor)
+{
+  auto keys1 = KeypointList<OERegion, float>{};
+  auto keys2 = KeypointList<OERegion, float>{};
+
+  resize(keys1, 1, 2);
+  auto& [f1, v1] = keys1;
+  f1[0].coords = Point2f::Zero();
+  v1[0].row_vector() = RowVector2f::Zero();
+
+  resize(keys2, 10, 2);
+  auto& [f2, v2] = keys2;
+  for (auto i = 0; i < size(keys2); ++i)
+  {
+    f2[i].coords = Point2f::Ones() * float(i);
+    v2[i].row_vector() = RowVector2f::Ones() * float(i);
+  }
+
+  constexpr auto nearest_neighbor_ratio = 0.6f;
+  auto matcher = BruteForceMatcher{keys1, keys2, nearest_neighbor_ratio};
+  const auto matches = matcher.compute_matches();
+
+  BOOST_REQUIRE_EQUAL(1u, matches.size());
+  const auto& m = matches.front();
+  BOOST_CHECK_EQUAL(f1[0], m.x());
+  BOOST_CHECK_EQUAL(f2[0], m.y());
+  BOOST_CHECK_EQUAL(0.f, m.score());
+  BOOST_CHECK_EQUAL(1, m.rank());
+}
+
+BOOST_AUTO_TEST_CASE(test_same_matches_as_ann_matcher)
+{
+  auto gen = std::mt19937{0};
+
+  // FLANN only finds approximate nearest neighbors, so the second image is a
+  // noisy copy of the first one: the nearest neighbors are then unambiguous
+  // and the kd-trees find them.
+  const auto n = 300;
+  const auto keys1 = make_keys(n, 8, gen);
+
+  auto permutation = std::vector<int>(n);
+  std::iota(permutation.begin(), permutation.end(), 0);
+  std::shuffle(permutation.begin(), permutation.end(), gen);
+  const auto keys2 = make_noisy_copy(keys1, permutation, gen);
+
+  auto ann_matcher = AnnMatcher{keys1, keys2, 0.8f};
+  auto bf_matcher = BruteForceMatcher{keys1, keys2, 0.8f};
+  const auto ann_matches = ann_matcher.compute_matches();
+  const auto bf_matches = bf_matcher.compute_matches();
+
+  const auto index_pairs = [](const std::vector<Match>& matches) {
+    auto pairs = std::vector<std::pair<int, int>>{};
+    for (const auto& m : matches)
+      pairs.emplace_back(m.x_index(), m.y_index());
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+  BOOST_REQUIRE(!bf_matches.empty());
+  BOOST_CHECK(index_pairs(ann_matches) == index_pairs(bf_matches));
+}
+
+BOOST_AUTO_TEST_CASE(test_exact_matches_across_tiles)
+{
+  auto gen = std::mt19937{0};
+
+  // Use more keypoints than the tile sizes, so that there are several row
+  // tiles and several column tiles.
+  const auto n = BruteForceMatcher::tile_cols + 100;
+  const auto keys1 = make_keys(n, 32, gen);
+
+  auto permutation = std::vector<int>(n);
+  std::iota(permutation.begin(), permutation.end(), 0);
+  std::shuffle(permutation.begin(), permutation.end(), gen);
+  const auto keys2 = make_noisy_copy(keys1, permutation, gen);
+
+  using Mode = BruteForceMatcher::DescriptorMode;
+  for (const auto mode : {Mode::Float32, Mode::Int8})
+  {
+    auto matcher = BruteForceMatcher{keys1, keys2, 0.8f, mode, true};
+    const auto matches = matcher.compute_matches();
+
+    BOOST_CHECK_EQUAL(matches.size(), static_cast<size_t>(n));
+    for (const auto& m : matches)
+    {
+      BOOST_CHECK_EQUAL(m.y_index(), permutation[m.x_index()]);
+      BOOST_CHECK_LT(m.score(), 0.8f * 0.8f);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_int8_mode_on_integer_descriptors)
+{
+  auto gen = std::mt19937{0};
+  auto value = std::uniform_int_distribution<int>{-127, 127};
+
+  // The descriptors are already 8-bit integers and the common scale is 1, so
+  // both modes compute the same exact distances. The sizes are not multiples
+  // of the SIMD widths nor of the row blocks.
+  auto keys1 = make_keys(103, 37, gen);
+  auto keys2 = make_keys(61, 37, gen);
+  for (auto* keys : {&keys1, &keys2})
+  {
+    auto& d = descriptors(*keys);
+    std::generate(d.begin(), d.end(), [&]() { return float(value(gen)); });
+  }
+  descriptors(keys1)(0, 0) = 127.f;
+
+  using Mode = BruteForceMatcher::DescriptorMode;
+  const auto matches_f32 =
+      BruteForceMatcher{keys1, keys2, 1.2f, Mode::Float32}.compute_matches();
+  const auto matches_i8 =
+      BruteForceMatcher{keys1, keys2, 1.2f, Mode::Int8}.compute_matches();
+
+  BOOST_REQUIRE(!matches_f32.empty());
+  BOOST_REQUIRE_EQUAL(matches_f32.size(), matches_i8.size());
+  for (auto i = 0u; i < matches_f32.size(); ++i)
+  {
+    BOOST_CHECK_EQUAL(matches_f32[i].x_index(), matches_i8[i].x_index());
+    BOOST_CHECK_EQUAL(matches_f32[i].y_index(), matches_i8[i].y_index());
+    BOOST_CHECK_EQUAL(matches_f32[i].score(), matches_i8[i].score());
+    BOOST_CHECK_EQUAL(matches_f32[i].rank(), matches_i8[i].rank());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_ratio_test_and_mutual_check)
+{
+  auto keys1 = KeypointList<OERegion, float>{};
+  auto keys2 = KeypointList<OERegion, float>{};
+  resize(keys1, 2, 1);
+  resize(keys2, 2, 1);
+
+  // Both keypoints of the first image are closest to the first keypoint of
+  // the second image.
+  auto& [f1, d1] = keys1;
+  auto& [f2, d2] = keys2;
+  d1(0, 0) = 0.f;
+  d1(1, 0) = 0.3f;
+  d2(0, 0) = 0.1f;
+  d2(1, 0) = 1.f;
+  for (auto i = 0; i < 2; ++i)
+  {
+    f1[i].coords = Point2f{float(i), 0.f};
+    f2[i].coords = Point2f{float(i), 1.f};
+  }
+
+  // The best matches are:
+  // - (0, 0) and (1, 0) from the first image,
+  // - (0, 0) and (1, 1) from the second image, but (1, 1) fails the ratio
+  //   test.
+  auto matcher = BruteForceMatcher{keys1, keys2, 0.6f};
+  const auto matches = matcher.compute_matches();
+  BOOST_REQUIRE_EQUAL(matches.size(), 2u);
+  BOOST_CHECK_EQUAL(matches[0].index_pair(), Vector2i(0, 0));
+  BOOST_CHECK_EQUAL(matches[1].index_pair(), Vector2i(1, 0));
+
+  // Only (0, 0) is the best match in both directions.
+  auto mutual_matcher = BruteForceMatcher{
+      keys1, keys2, 0.6f, BruteForceMatcher::DescriptorMode::Float32, true};
+  const auto mutual_matches = mutual_matcher.compute_matches();
+  BOOST_REQUIRE_EQUAL(mutual_matches.size(), 1u);
+  BOOST_CHECK_EQUAL(mutual_matches[0].index_pair(), Vector2i(0, 0));
+  BOOST_CHECK_CLOSE(mutual_matches[0].score(), 0.01f, 1e-3f);
+}
+
+BOOST_AUTO_TEST_CASE(test_self_matching)
+{
+  auto keys = KeypointList<OERegion, float>{};
+  resize(keys, 3, 2);
+  auto& [f, d] = keys;
+
+  // The first two keypoints have similar descriptors but are far apart. The
+  // third one is a redundant copy of the first one.
+  f[0].coords = Point2f{0.f, 0.f};
+  f[1].coords = Point2f{50.f, 50.f};
+  f[2].coords = Point2f{1.f, 0.f};
+  for (auto i = 0; i < 3; ++i)
+    f[i].shape_matrix = Eigen::Matrix2f::Identity();
+  d[0].row_vector() << 0.f, 0.f;
+  d[1].row_vector() << 0.1f, 0.f;
+  d[2].row_vector() << 0.f, 0.01f;
+
+  // The large ratio threshold keeps the second nearest neighbors.
+  auto matcher = BruteForceMatcher{keys, 20.f};
+  const auto matches = matcher.compute_self_matches();
+
+  for (const auto& m : matches)
+  {
+    BOOST_CHECK_NE(m.x_index(), m.y_index());
+    // The redundant pair must be discarded.
+    BOOST_CHECK(m.index_pair() != Vector2i(0, 2));
+    BOOST_CHECK(m.index_pair() != Vector2i(2, 0));
+  }
+
+  const auto has_match_01 =
+      std::any_of(matches.begin(), matches.end(), [](const Match& m) {
+        return m.index_pair() == Vector2i(0, 1);
+      });
+  BOOST_CHECK(has_match_01);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
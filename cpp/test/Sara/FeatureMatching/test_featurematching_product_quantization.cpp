@@ -0,0 +1,259 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "FeatureMatching/Product Quantization"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/FeatureMatching/ProductQuantization.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <random>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+namespace fs = boost::filesystem;
+
+
+//! Descriptors sampled around random cluster centers.
+auto make_clustered_data(int num_points, int dimension, int num_clusters,
+                         std::mt19937& gen) -> Tensor_<float, 2>
+{
+  auto uniform = std::uniform_real_distribution<float>{0.f, 1.f};
+  auto noise = std::normal_distribution<float>{0.f, 0.05f};
+  auto cluster = std::uniform_int_distribution<int>{0, num_clusters - 1};
+
+  auto centers = Tensor_<float, 2>{num_clusters, dimension};
+  std::generate(centers.begin(), centers.end(), [&]() { return uniform(gen); });
+
+  auto data = Tensor_<float, 2>{num_points, dimension};
+  for (auto i = 0; i < num_points; ++i)
+  {
+    const auto c = cluster(gen);
+    for (auto j = 0; j < dimension; ++j)
+      data(i, j) = centers(c, j) + noise(gen);
+  }
+  return data;
+}
+
+//! Split the rows into the queries and the database.
+auto split_rows(const Tensor_<float, 2>& data, int num_queries)
+    -> std::pair<Tensor_<float, 2>, Tensor_<float, 2>>
+{
+  auto queries = Tensor_<float, 2>{num_queries, data.cols()};
+  auto database = Tensor_<float, 2>{data.rows() - num_queries, data.cols()};
+  queries.matrix() = data.matrix().topRows(num_queries);
+  database.matrix() = data.matrix().bottomRows(data.rows() - num_queries);
+  return {std::move(queries), std::move(database)};
+}
+
+//! Exact nearest neighbor of each query.
+auto exact_nearest_neighbors(const Tensor_<float, 2>& data,
+                             const Tensor_<float, 2>& queries)
+    -> std::vector<int>
+{
+  auto nn = std::vector<int>(queries.rows());
+  for (auto q = 0; q < queries.rows(); ++q)
+  {
+    auto best_distance = std::numeric_limits<float>::max();
+    for (auto i = 0; i < data.rows(); ++i)
+    {
+      const auto d =
+          (data[i].row_vector() - queries[q].row_vector()).squaredNorm();
+      if (d < best_distance)
+      {
+        best_distance = d;
+        nn[q] = i;
+      }
+    }
+  }
+  return nn;
+}
+
+//! Fraction of queries whose exact nearest neighbor is among the k returned
+//! neighbors.
+auto recall_at_k(const std::vector<int>& exact_nn,
+                 const Tensor_<int, 2>& nn_indices) -> float
+{
+  auto num_found = 0;
+  for (auto q = 0; q < nn_indices.rows(); ++q)
+  {
+    const auto row = nn_indices[q];
+    if (std::find(row.begin(), row.end(), exact_nn[q]) != row.end())
+      ++num_found;
+  }
+  return static_cast<float>(num_found) / nn_indices.rows();
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestProductQuantization)
+
+BOOST_AUTO_TEST_CASE(test_invalid_parameters)
+{
+  BOOST_CHECK_THROW(ProductQuantizer(30, 8), std::domain_error);
+  BOOST_CHECK_THROW(ProductQuantizer(32, 8, 9), std::domain_error);
+  BOOST_CHECK_THROW(ProductQuantizer(32, 8).encode(Tensor_<float, 2>{1, 32}),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_encode_decode)
+{
+  auto gen = std::mt19937{0};
+  const auto data = make_clustered_data(2000, 32, 20, gen);
+
+  auto pq = ProductQuantizer{32, 8};
+  pq.train(data);
+  BOOST_CHECK(pq.trained());
+  BOOST_CHECK_EQUAL(pq.code_size(), 8);
+  BOOST_CHECK_EQUAL(pq.codebooks().sizes(), Eigen::Vector3i(8, 256, 4));
+
+  const auto codes = pq.encode(data);
+  BOOST_CHECK_EQUAL(codes.sizes(), Eigen::Vector2i(2000, 8));
+
+  // 128 bytes per descriptor are compressed into 8 bytes.
+  BOOST_CHECK_EQUAL(data.cols() * sizeof(float) / (codes.cols()), 16u);
+
+  // The reconstruction error is much smaller than the variance of the data.
+  const auto decoded = pq.decode(codes);
+  const auto mean = data.matrix().colwise().mean();
+  const auto variance =
+      (data.matrix().rowwise() - mean).squaredNorm() / data.rows();
+  const auto error =
+      (decoded.matrix() - data.matrix()).squaredNorm() / data.rows();
+  BOOST_CHECK_LT(error, 0.1f * variance);
+}
+
+BOOST_AUTO_TEST_CASE(test_adc_search)
+{
+  auto gen = std::mt19937{1};
+  const auto [queries, data] =
+      split_rows(make_clustered_data(3100, 32, 20, gen), 100);
+
+  auto pq = ProductQuantizer{32, 8};
+  pq.train(data);
+  const auto codes = pq.encode(data);
+
+  constexpr auto k = 10;
+  auto nn_indices = Tensor_<int, 2>{queries.rows(), k};
+  auto nn_distances = Tensor_<float, 2>{queries.rows(), k};
+  pq.knn_search(queries, codes, k, nn_indices, nn_distances);
+
+  for (auto q = 0; q < queries.rows(); ++q)
+    for (auto r = 1; r < k; ++r)
+      BOOST_CHECK_LE(nn_distances(q, r - 1), nn_distances(q, r));
+
+  const auto exact_nn = exact_nearest_neighbors(data, queries);
+  BOOST_CHECK_GE(recall_at_k(exact_nn, nn_indices), 0.8f);
+}
+
+BOOST_AUTO_TEST_CASE(test_ivf_search_and_serialization)
+{
+  auto gen = std::mt19937{2};
+  const auto [queries, data] =
+      split_rows(make_clustered_data(3100, 32, 20, gen), 100);
+
+  auto index = IVFPQIndex{32, 16, 8};
+  index.train(data);
+
+  // Add the data in two batches.
+  auto ptr = const_cast<float*>(data.data());
+  index.add(TensorView_<float, 2>{ptr, {1000, 32}});
+  index.add(TensorView_<float, 2>{ptr + 1000 * 32, {2000, 32}});
+  BOOST_CHECK_EQUAL(index.size(), 3000);
+
+  auto total_size = 0;
+  for (auto l = 0; l < index.num_lists(); ++l)
+    total_size += index.list_size(l);
+  BOOST_CHECK_EQUAL(total_size, 3000);
+
+  constexpr auto k = 10;
+  auto nn_indices = Tensor_<int, 2>{queries.rows(), k};
+  auto nn_distances = Tensor_<float, 2>{queries.rows(), k};
+  index.knn_search(queries, k, nn_indices, nn_distances, 4);
+
+  const auto exact_nn = exact_nearest_neighbors(data, queries);
+  BOOST_CHECK_GE(recall_at_k(exact_nn, nn_indices), 0.8f);
+
+  // Save and reload the index.
+  const auto filepath =
+      (fs::temp_directory_path() / "sara_ivfpq_index.h5").string();
+  {
+    auto file = H5File{filepath, H5F_ACC_TRUNC};
+    index.write(file, "index");
+  }
+
+  auto index2 = IVFPQIndex{};
+  {
+    auto file = H5File{filepath, H5F_ACC_RDONLY};
+    index2.read(file, "index");
+  }
+  fs::remove(filepath);
+
+  BOOST_CHECK_EQUAL(index2.size(), index.size());
+  BOOST_CHECK_EQUAL(index2.num_lists(), index.num_lists());
+
+  auto nn_indices2 = Tensor_<int, 2>{queries.rows(), k};
+  auto nn_distances2 = Tensor_<float, 2>{queries.rows(), k};
+  index2.knn_search(queries, k, nn_indices2, nn_distances2, 4);
+  BOOST_CHECK(nn_indices2.matrix() == nn_indices.matrix());
+  BOOST_CHECK(nn_distances2.matrix() == nn_distances.matrix());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_read_corrupted_index)
+{
+  auto gen = std::mt19937{3};
+  const auto data = make_clustered_data(500, 32, 10, gen);
+
+  auto index = IVFPQIndex{32, 8, 8};
+  index.train(data);
+  index.add(data);
+
+  const auto filepath =
+      (fs::temp_directory_path() / "sara_corrupted_ivfpq_index.h5").string();
+
+  const auto read_with = [&](const std::string& dataset, const auto& value) {
+    {
+      auto file = H5File{filepath, H5F_ACC_TRUNC};
+      index.write(file, "index");
+      file.write_dataset("index/" + dataset, value, true);
+    }
+    auto file = H5File{filepath, H5F_ACC_RDONLY};
+    auto index2 = IVFPQIndex{};
+    index2.read(file, "index");
+  };
+
+  // The inverted lists overlap.
+  auto list_offsets = Tensor_<int, 1>{9};
+  for (auto l = 0; l < 9; ++l)
+    list_offsets(l) = l * 500 / 8;
+  list_offsets(4) = list_offsets(5) + 1;
+  BOOST_CHECK_THROW(read_with("list_offsets", list_offsets),
+                    std::runtime_error);
+
+  // The inverted lists start before the codes.
+  list_offsets(4) = list_offsets(3);
+  list_offsets(0) = -1;
+  BOOST_CHECK_THROW(read_with("list_offsets", list_offsets),
+                    std::runtime_error);
+
+  // The codes do not have the code size of the product quantizer.
+  auto codes = Tensor_<std::uint8_t, 2>{500, 4};
+  codes.flat_array().fill(0);
+  BOOST_CHECK_THROW(read_with("codes", codes), std::runtime_error);
+
+  fs::remove(filepath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
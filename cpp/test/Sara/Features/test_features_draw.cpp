@@ -42,6 +42,25 @@ BOOST_AUTO_TEST_CASE(test_draw_oe_regions)
   close_window();
 }
 
+BOOST_AUTO_TEST_CASE(test_draw_oe_regions_on_image)
+{
+  auto features = vector<OERegion>{OERegion{Point2f{150.f, 150.f}, 10.f},
+                                   OERegion{Point2f{200.f, 150.f}, 0.5f}};
+
+  auto draw_list = ImageDrawList{};
+  draw_oe_regions(draw_list, features.data(),
+                  features.data() + features.size(), Red8);
+  // The large region is an ellipse with its orientation line, the small one
+  // a cross, both drawn with a black contour.
+  BOOST_CHECK_EQUAL(draw_list.size(), 8u);
+
+  auto image = Image<Rgb8>{300, 300};
+  image.flat_array().fill(White8);
+  draw_oe_regions(image, features, Red8);
+  BOOST_CHECK(std::any_of(image.begin(), image.end(),
+                          [](const auto& p) { return p == Red8; }));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 int worker_thread(int argc, char **argv)
@@ -0,0 +1,203 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "Features/Keypoint Store"
+
+#include <DO/Sara/Features/IO.hpp>
+#include <DO/Sara/Features/KeypointStore.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <fstream>
+
+
+namespace fs = boost::filesystem;
+using namespace DO::Sara;
+
+
+auto make_keypoints(int num_keypoints, int dim, float shift)
+    -> KeypointList<OERegion, float>
+{
+  auto keys = KeypointList<OERegion, float>{};
+  resize(keys, num_keypoints, dim);
+
+  auto& [f, d] = keys;
+  for (auto i = 0; i < num_keypoints; ++i)
+  {
+    f[i].coords << shift + i, shift - i;
+    f[i].shape_matrix << 1.f + i, 0.5f, 0.5f, 2.f + i;
+    f[i].orientation = 0.1f * i;
+    f[i].extremum_value = shift * i;
+    f[i].type = OERegion::Type::DoG;
+    f[i].extremum_type = i % 2 == 0 ? OERegion::ExtremumType::Max
+                                    : OERegion::ExtremumType::Min;
+  }
+  for (auto i = 0; i < d.size(); ++i)
+    d.data()[i] = float(i % 101) / 100.f;
+
+  return keys;
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestKeypointStore)
+
+BOOST_AUTO_TEST_CASE(test_write_and_map_float_descriptors)
+{
+  const auto filepath =
+      (fs::temp_directory_path() / "test_keypoint_store.bin").string();
+
+  const auto keys0 = make_keypoints(10, 128, 1.f);
+  const auto keys1 = make_keypoints(0, 128, 2.f);
+  const auto keys2 = make_keypoints(37, 64, 3.f);
+
+  {
+    auto writer = KeypointStoreWriter{filepath};
+    writer.write("image0", keys0);
+    writer.write("image1", keys1);
+    writer.write("image2", keys2);
+    BOOST_CHECK_THROW(writer.write("image0", keys0), std::runtime_error);
+  }
+
+  const auto store = KeypointStore{filepath};
+  BOOST_REQUIRE_EQUAL(store.size(), 3);
+  BOOST_CHECK(store.names() ==
+              std::vector<std::string>({"image0", "image1", "image2"}));
+  BOOST_CHECK(store.contains("image2"));
+  BOOST_CHECK(!store.contains("image3"));
+  BOOST_CHECK_THROW(store["image3"], std::out_of_range);
+
+  for (const auto& [name, keys] :
+       {std::make_pair("image0", &keys0), std::make_pair("image1", &keys1),
+        std::make_pair("image2", &keys2)})
+  {
+    const auto view = store[name];
+    BOOST_REQUIRE_EQUAL(view.size(), features(*keys).size());
+    BOOST_CHECK(!view.quantized());
+
+    // Every section is aligned on cache lines.
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(view.coords.data()) % 64,
+                      0u);
+    BOOST_CHECK_EQUAL(
+        reinterpret_cast<std::uintptr_t>(view.descriptors.data()) % 64, 0u);
+
+    BOOST_CHECK(view.features() == features(*keys));
+    for (auto i = 0; i < view.size(); ++i)
+      BOOST_CHECK_EQUAL(view.extremum_types(i),
+                        std::int8_t(features(*keys)[i].extremum_type));
+
+    if (view.size() > 0)
+      BOOST_CHECK(view.float_descriptors().matrix() ==
+                  descriptors(*keys).matrix());
+  }
+
+  fs::remove(filepath);
+}
+
+BOOST_AUTO_TEST_CASE(test_quantized_descriptors)
+{
+  const auto filepath =
+      (fs::temp_directory_path() / "test_keypoint_store_uint8.bin").string();
+
+  const auto keys = make_keypoints(20, 128, 1.f);
+  {
+    auto writer = KeypointStoreWriter{filepath, true};
+    writer.write("image", keys);
+  }
+
+  auto store = KeypointStore{filepath};
+  const auto view = store["image"];
+  BOOST_REQUIRE(view.quantized());
+  BOOST_CHECK(view.descriptors.empty());
+  BOOST_CHECK_EQUAL(view.descriptor_dimension(), 128);
+
+  const auto d = view.float_descriptors();
+  const auto max_error =
+      (d.matrix() - descriptors(keys).matrix()).cwiseAbs().maxCoeff();
+  BOOST_CHECK_LE(max_error, 0.5f * view.descriptor_scale + 1e-6f);
+
+  // Moving the store keeps the mapping alive.
+  const auto moved_store = std::move(store);
+  BOOST_CHECK_EQUAL(store.size(), 0);
+  BOOST_CHECK(moved_store["image"].features() == features(keys));
+
+  fs::remove(filepath);
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_file)
+{
+  const auto filepath =
+      (fs::temp_directory_path() / "test_keypoint_store_invalid.bin").string();
+  {
+    auto file = std::ofstream{filepath, std::ios::binary};
+    file << "This is not a keypoint store";
+  }
+
+  BOOST_CHECK_THROW(KeypointStore{filepath}, std::runtime_error);
+  BOOST_CHECK_THROW(KeypointStore{filepath + ".missing"}, std::runtime_error);
+
+  fs::remove(filepath);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_read_keypoints_next_to_hdf5_file)
+{
+  const auto h5_filepath =
+      (fs::temp_directory_path() / "test_keypoint_store.h5").string();
+  const auto store_path = keypoint_store_path(h5_filepath);
+
+  const auto keys0 = make_keypoints(10, 128, 1.f);
+  const auto keys1 = make_keypoints(5, 128, 2.f);
+  const auto group_names = std::vector<std::string>{"image0", "image1"};
+
+  auto h5_file = H5File{h5_filepath, H5F_ACC_TRUNC};
+  for (const auto& [name, keys] : {std::make_pair("image0", &keys0),
+                                   std::make_pair("image1", &keys1)})
+  {
+    h5_file.get_group(name);
+    write_keypoints(h5_file, name, *keys);
+  }
+
+  // Without keypoint store, the keypoints are read from the HDF5 file.
+  fs::remove(store_path);
+  auto keypoints = read_keypoints(h5_file, group_names);
+  BOOST_REQUIRE_EQUAL(keypoints.size(), 2u);
+  BOOST_CHECK(features(keypoints[1]) == features(keys1));
+
+  // The keypoint store is read instead if it has all the images. Store
+  // different keypoints to tell where they are read from.
+  const auto other_keys1 = make_keypoints(7, 128, 4.f);
+  {
+    auto writer = KeypointStoreWriter{store_path};
+    writer.write("image0", keys0);
+    writer.write("image1", other_keys1);
+  }
+  keypoints = read_keypoints(h5_file, group_names);
+  BOOST_REQUIRE_EQUAL(keypoints.size(), 2u);
+  BOOST_CHECK(features(keypoints[0]) == features(keys0));
+  BOOST_CHECK(features(keypoints[1]) == features(other_keys1));
+  BOOST_CHECK(descriptors(keypoints[1]).matrix() ==
+              descriptors(other_keys1).matrix());
+
+  // Otherwise the keypoints are read from the HDF5 file.
+  {
+    auto writer = KeypointStoreWriter{store_path};
+    writer.write("image0", keys0);
+  }
+  keypoints = read_keypoints(h5_file, group_names);
+  BOOST_REQUIRE_EQUAL(keypoints.size(), 2u);
+  BOOST_CHECK(features(keypoints[1]) == features(keys1));
+
+  fs::remove(store_path);
+  fs::remove(h5_filepath);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
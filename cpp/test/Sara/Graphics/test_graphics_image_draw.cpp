@@ -0,0 +1,96 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "Graphics/Image Drawing"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/Core.hpp>
+#include <DO/Sara/Graphics/ImageDraw.hpp>
+
+
+using namespace DO::Sara;
+
+
+BOOST_AUTO_TEST_SUITE(TestImageDrawList)
+
+BOOST_AUTO_TEST_CASE(test_record)
+{
+  auto draw_list = ImageDrawList{};
+  BOOST_CHECK(draw_list.empty());
+
+  draw_list.draw_point(1, 2, Red8);
+  draw_list.draw_line(Point2f(0, 0), Point2f(10, 10), Green8, 3);
+  draw_list.draw_circle(Point2f(5, 5), 2.f, Blue8);
+  draw_list.fill_rect(0, 0, 2, 2, White8);
+  BOOST_CHECK_EQUAL(draw_list.size(), 4u);
+
+  const auto& p = draw_list.primitives();
+  BOOST_CHECK(p[0].type == ImageDrawList::Primitive::Point);
+  BOOST_CHECK(p[1].type == ImageDrawList::Primitive::Line);
+  BOOST_CHECK_EQUAL(p[1].pen_width, 3);
+  BOOST_CHECK(p[2].type == ImageDrawList::Primitive::Ellipse);
+  BOOST_CHECK(p[2].b == Point2f(2, 2));
+  BOOST_CHECK(p[3].color == White8);
+
+  draw_list.clear();
+  BOOST_CHECK(draw_list.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_render)
+{
+  auto draw_list = ImageDrawList{};
+  draw_list.fill_rect(2, 3, 4, 5, Red8);
+  draw_list.draw_point(9, 9, Blue8);
+  // Primitives outside the image are ignored.
+  draw_list.fill_rect(0, 100, 4, 4, Green8);
+
+  auto image = Image<Rgb8>{10, 10};
+  image.flat_array().fill(Black8);
+  draw_list.render(image, 1);
+
+  for (auto y = 0; y < 10; ++y)
+    for (auto x = 0; x < 10; ++x)
+    {
+      if (2 <= x && x < 6 && 3 <= y && y < 8)
+        BOOST_REQUIRE(image(x, y) == Red8);
+      else if (x == 9 && y == 9)
+        BOOST_REQUIRE(image(x, y) == Blue8);
+      else
+        BOOST_REQUIRE(image(x, y) == Black8);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_render_in_bands)
+{
+  auto draw_list = ImageDrawList{};
+  for (auto i = 0; i < 20; ++i)
+  {
+    draw_list.fill_rect(i, 2 * i, 7, 9, i % 2 == 0 ? Red8 : Green8);
+    draw_list.draw_circle(Point2f(3 * i, 2 * i), 5.f, Blue8, 2);
+    draw_list.draw_line(Point2f(0, i), Point2f(39, 39 - i), Yellow8);
+  }
+
+  auto image_1 = Image<Rgb8>{40, 40};
+  image_1.flat_array().fill(Black8);
+  auto image_n = image_1;
+
+  // The bands only split the rasterization: the result must be the same.
+  draw_list.render(image_1, 1);
+  for (const auto num_bands : {2, 3, 7, 40, 100})
+  {
+    image_n.flat_array().fill(Black8);
+    draw_list.render(image_n, num_bands);
+    BOOST_REQUIRE(image_1 == image_n);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -14,6 +14,8 @@
 
 #include <vector>
 
+#include <QImage>
+
 #include <boost/mpl/list.hpp>
 #include <boost/test/unit_test.hpp>
 
@@ -185,6 +187,96 @@ BOOST_AUTO_TEST_CASE(test_save_screen)
   BOOST_CHECK(save_screen(active_window(), "test.png"));
 }
 
+BOOST_AUTO_TEST_CASE(test_batch)
+{
+  BOOST_CHECK(!is_batching());
+
+  begin_batch();
+  BOOST_CHECK(is_batching());
+  BOOST_CHECK(clear_window());
+  for (int i = 0; i < 1000; ++i)
+    BOOST_CHECK(draw_point(i % 300, i / 300, Red8));
+  BOOST_CHECK(flush_batch());
+  BOOST_CHECK(is_batching());
+
+  // The image is copied, so it can be released before the batch is flushed.
+  {
+    auto image = Image<Rgb8>{20, 20};
+    image.flat_array().fill(Blue8);
+    BOOST_CHECK(display(image, 0, 0, 1.4));
+  }
+  BOOST_CHECK(fill_circle(10, 10, 5, Green8));
+  BOOST_CHECK(end_batch());
+  BOOST_CHECK(!is_batching());
+
+  // There is no batch to end.
+  BOOST_CHECK(!end_batch());
+}
+
+BOOST_AUTO_TEST_CASE(test_nested_batches)
+{
+  {
+    const auto batch = PaintingBatch{};
+    BOOST_CHECK(draw_line(10, 10, 50, 100, Black8, 2));
+    {
+      const auto nested_batch = PaintingBatch{};
+      BOOST_CHECK(draw_rect(10, 10, 50, 100, Black8, 2));
+    }
+    BOOST_CHECK(is_batching());
+  }
+  BOOST_CHECK(!is_batching());
+  BOOST_CHECK(draw_line(10, 10, 50, 100, Black8, 2));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_save_screen_after_batch)
+{
+  {
+    const auto batch = PaintingBatch{};
+    BOOST_CHECK(set_transparency(active_window(), false));
+    BOOST_CHECK(fill_rect(0, 0, 300, 300, Red8));
+    BOOST_CHECK(fill_rect(100, 100, 50, 50, Blue8));
+    // The commands batched so far are run before the screen is saved.
+    BOOST_CHECK(save_screen(active_window(), "test_batch_0.png"));
+    BOOST_CHECK(fill_rect(0, 0, 50, 50, Green8));
+  }
+  BOOST_CHECK(save_screen(active_window(), "test_batch_1.png"));
+
+  const auto during_batch = QImage{"test_batch_0.png"};
+  BOOST_REQUIRE(!during_batch.isNull());
+  BOOST_CHECK(during_batch.pixel(200, 200) == qRgb(255, 0, 0));
+  BOOST_CHECK(during_batch.pixel(120, 120) == qRgb(0, 0, 255));
+  BOOST_CHECK(during_batch.pixel(20, 20) == qRgb(255, 0, 0));
+
+  const auto after_batch = QImage{"test_batch_1.png"};
+  BOOST_REQUIRE(!after_batch.isNull());
+  BOOST_CHECK(after_batch.pixel(200, 200) == qRgb(255, 0, 0));
+  BOOST_CHECK(after_batch.pixel(120, 120) == qRgb(0, 0, 255));
+  BOOST_CHECK(after_batch.pixel(20, 20) == qRgb(0, 255, 0));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_close_window_in_batch)
+{
+  const auto other_window = create_window(100, 100);
+  set_active_window(other_window);
+  {
+    const auto batch = PaintingBatch{};
+    BOOST_CHECK(fill_rect(0, 0, 50, 50, Red8));
+    // The commands batched for the window are run before it is closed.
+    close_window(other_window);
+
+    set_active_window(_test_window);
+    BOOST_CHECK(fill_rect(0, 0, 50, 50, Blue8));
+  }
+  BOOST_CHECK(!is_batching());
+
+  BOOST_CHECK(save_screen(_test_window, "test_batch_2.png"));
+  const auto screen = QImage{"test_batch_2.png"};
+  BOOST_REQUIRE(!screen.isNull());
+  BOOST_CHECK(screen.pixel(20, 20) == qRgb(0, 0, 255));
+}
+
 
 using ColorTypes = boost::mpl::list<unsigned char, unsigned short, unsigned int,
                                     char, short, int, float, double>;
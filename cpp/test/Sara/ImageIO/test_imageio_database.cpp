@@ -13,6 +13,7 @@
 
 #include <DO/Sara/Core.hpp>
 #include <DO/Sara/ImageIO.hpp>
+#include <DO/Sara/ImageIO/Database/DataLoader.hpp>
 #include <DO/Sara/ImageIO/Database/ImageDataSet.hpp>
 #include <DO/Sara/ImageIO/Database/TrainingDataSet.hpp>
 #include <DO/Sara/ImageIO/Database/TransformedTrainingDataSet.hpp>
@@ -267,7 +268,7 @@ BOOST_AUTO_TEST_CASE(
     data_transforms[1].set_flip(ImageDataTransform::Horizontal);
 
     data_transforms[2].set_zoom(2.f);
-    data_transforms[2].set_flip(ImageDataTransform::Horizontal);
+    data_transforms[2].set_flip(ImageDataTransform::Vertical);
   }
   training_data_set.t = data_transforms;
 
@@ -287,3 +288,158 @@ BOOST_AUTO_TEST_CASE(
 }
 
 BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_AUTO_TEST_SUITE(TestDataLoader)
+
+auto make_transformed_data_set() -> TransformedImageClassificationTrainingDataSet
+{
+  const auto db_dir = string{src_path("../../../../data/")};
+
+  auto data_set = TransformedImageClassificationTrainingDataSet{};
+  const auto filenames = vector<string>{"All.tif", "ksmall.jpg", "stinkbug.png"};
+  for (auto i = 0; i < 11; ++i)
+  {
+    auto t = ImageDataTransform{};
+    t.out_sizes = Vector2i{64, 48};
+    if (i % 2 == 1)
+    {
+      t.set_zoom(i % 4 == 1 ? 0.5f : 1.2f);
+      t.set_shift(Vector2i{i, 2 * i});
+    }
+    if (i % 3 == 0)
+      t.set_flip(ImageDataTransform::Horizontal);
+    if (i % 5 == 0)
+      t.set_fancy_pca(Vector3f{0.1f, -0.2f, 0.05f});
+
+    data_set.x.push_back(db_dir + "/" + filenames[i % 3]);
+    data_set.y.push_back(i);
+    data_set.t.push_back(t);
+  }
+  return data_set;
+}
+
+BOOST_AUTO_TEST_CASE(test_batches)
+{
+  const auto data_set = make_transformed_data_set();
+
+  auto options = DataLoaderOptions{};
+  options.batch_size = 4;
+  options.num_workers = 3;
+  options.queue_depth = 2;
+  auto loader = ImageClassificationDataLoader{data_set, options};
+  loader.start_epoch(0);
+  BOOST_CHECK_EQUAL(loader.num_batches(), 3);
+
+  auto num_samples = 0;
+  auto seen = vector<int>{};
+  while (const auto batch = loader.next())
+  {
+    BOOST_CHECK_EQUAL(batch->x.sizes(), Vector4i(4, 3, 48, 64));
+    for (auto i = 0; i < batch->size; ++i)
+    {
+      const auto s = batch->indices[i];
+      BOOST_CHECK_EQUAL(s, loader.order()[num_samples + i]);
+      BOOST_CHECK_EQUAL(batch->y(i), data_set.y[s]);
+
+      // Compare with the sequential data augmentation.
+      const auto& t = data_set.t[s];
+      const auto patch = t.extract_patch(imread<Rgb32f>(data_set.x[s]));
+      const Vector3f offset = t.apply_transform[ImageDataTransform::FancyPCA]
+                                  ? (t.U * t.S.asDiagonal() * t.alpha).eval()
+                                  : Vector3f::Zero().eval();
+      auto max_error = 0.f;
+      auto mean_error = 0.f;
+      for (auto c = 0; c < 3; ++c)
+        for (auto v = 0; v < 48; ++v)
+          for (auto u = 0; u < 64; ++u)
+          {
+            const auto error = std::abs(batch->x(Vector4i{i, c, v, u}) -
+                                        patch(u, v)[c] - offset[c]);
+            max_error = std::max(max_error, error);
+            mean_error += error / (3 * 48 * 64);
+          }
+
+      // The fused kernel reduces the images with a box filter instead of a
+      // Gaussian blur. Otherwise it only differs by rounding errors.
+      const auto reduced =
+          t.use_original ||
+          (t.apply_transform[ImageDataTransform::Zoom] && t.z < 1);
+      if (reduced)
+        BOOST_CHECK_SMALL(mean_error, 2e-2f);
+      else
+        BOOST_CHECK_SMALL(max_error, 1e-5f);
+
+      seen.push_back(s);
+    }
+    num_samples += batch->size;
+  }
+  BOOST_CHECK_EQUAL(num_samples, 11);
+
+  std::sort(seen.begin(), seen.end());
+  for (auto i = 0; i < 11; ++i)
+    BOOST_CHECK_EQUAL(seen[i], i);
+
+  // The last incomplete batch can be dropped.
+  options.drop_last = true;
+  auto loader2 = ImageClassificationDataLoader{data_set, options};
+  loader2.start_epoch(0);
+  BOOST_CHECK_EQUAL(loader2.num_batches(), 2);
+  auto num_batches = 0;
+  while (loader2.next())
+    ++num_batches;
+  BOOST_CHECK_EQUAL(num_batches, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_deterministic_order)
+{
+  const auto data_set = make_transformed_data_set();
+
+  const auto collect = [&](int num_workers, std::uint32_t seed, int epoch) {
+    auto options = DataLoaderOptions{};
+    options.batch_size = 3;
+    options.num_workers = num_workers;
+    options.seed = seed;
+    auto loader = ImageClassificationDataLoader{data_set, options};
+    loader.start_epoch(epoch);
+
+    auto labels = vector<int>{};
+    while (const auto batch = loader.next())
+      for (auto i = 0; i < batch->size; ++i)
+        labels.push_back(batch->y(i));
+    return labels;
+  };
+
+  const auto labels = collect(1, 7, 0);
+  BOOST_CHECK(collect(4, 7, 0) == labels);
+  BOOST_CHECK(collect(4, 7, 1) != labels);
+  BOOST_CHECK(collect(4, 8, 0) != labels);
+}
+
+BOOST_AUTO_TEST_CASE(test_errors)
+{
+  auto data_set = make_transformed_data_set();
+
+  auto options = DataLoaderOptions{};
+  options.queue_depth = 0;
+  BOOST_CHECK_THROW(ImageClassificationDataLoader(data_set, options),
+                    std::domain_error);
+
+  data_set.t[3].out_sizes = Vector2i{32, 32};
+  BOOST_CHECK_THROW(ImageClassificationDataLoader{data_set},
+                    std::runtime_error);
+
+  // A sample that cannot be read makes the loader throw when the batch is
+  // requested.
+  data_set = make_transformed_data_set();
+  data_set.x[0] = "missing.png";
+  options = DataLoaderOptions{};
+  options.shuffle = false;
+  options.batch_size = 4;
+  auto loader = ImageClassificationDataLoader{data_set, options};
+  loader.start_epoch();
+  BOOST_CHECK_THROW(loader.next(), std::exception);
+  BOOST_CHECK(loader.next() != nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -98,6 +98,110 @@ BOOST_AUTO_TEST_CASE(test_fancy_pca)
   BOOST_CHECK_EQUAL(true_out_r.matrix(), out_tensor[0].matrix());
 }
 
+auto make_smooth_rgb_image(int w, int h) -> Image<Rgb32f>
+{
+  auto in = Image<Rgb32f>{w, h};
+  for (auto y = 0; y < h; ++y)
+    for (auto x = 0; x < w; ++x)
+      in(x, y) = Vector3f{0.5f + 0.4f * std::sin(0.3f * x),
+                          0.5f + 0.4f * std::cos(0.2f * y),
+                          float(x + y) / (w + h)};
+  return in;
+}
+
+BOOST_AUTO_TEST_CASE(test_fused_transform)
+{
+  const auto in = make_smooth_rgb_image(40, 30);
+
+  auto transforms = vector<ImageDataTransform>(4);
+  for (auto& t : transforms)
+    t.out_sizes = Vector2i{16, 12};
+  transforms[0].set_shift(Vector2i{3, 5});
+  transforms[0].set_flip(ImageDataTransform::Horizontal);
+  transforms[1].set_zoom(1.5f);
+  transforms[1].set_shift(Vector2i{7, 2});
+  transforms[1].set_flip(ImageDataTransform::Vertical);
+  transforms[1].set_fancy_pca(Vector3f{0.1f, -0.2f, 0.3f});
+  transforms[2].set_zoom(1.2f);
+  transforms[2].set_shift(Vector2i{1, 1});
+  // No flip at all.
+  transforms[3].set_shift(Vector2i{2, 4});
+  transforms[3].set_flip(ImageDataTransform::None);
+
+  // Without reduction, the fused transform is exactly the sequential one.
+  for (const auto& t : transforms)
+  {
+    const auto true_out = to_cwh_tensor(t(in));
+
+    auto out = Tensor_<float, 3>{3, 12, 16};
+    t.transform_into(in, out);
+    BOOST_CHECK_SMALL((out.flat_array() - true_out.flat_array())
+                          .abs()
+                          .maxCoeff(),
+                      1e-5f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_fused_transform_past_the_border)
+{
+  const auto in = make_smooth_rgb_image(40, 30);
+
+  auto transforms = vector<ImageDataTransform>(4);
+  for (auto& t : transforms)
+    t.out_sizes = Vector2i{16, 12};
+  transforms[0].set_shift(Vector2i{30, 25});
+  transforms[1].set_shift(Vector2i{-3, -2});
+  transforms[1].set_flip(ImageDataTransform::Horizontal);
+  transforms[2].set_zoom(1.2f);
+  transforms[2].set_shift(Vector2i{38, 30});
+  transforms[2].set_fancy_pca(Vector3f{0.1f, -0.2f, 0.3f});
+  transforms[3].set_zoom(3.f);
+  transforms[3].set_shift(Vector2i{110, 80});
+  transforms[3].set_flip(ImageDataTransform::Vertical);
+
+  // The crop pads the patch with zeros.
+  for (const auto& t : transforms)
+  {
+    const auto true_out = to_cwh_tensor(t(in));
+
+    auto out = Tensor_<float, 3>{3, 12, 16};
+    t.transform_into(in, out);
+    BOOST_CHECK_SMALL((out.flat_array() - true_out.flat_array())
+                          .abs()
+                          .maxCoeff(),
+                      1e-5f);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_fused_transform_with_reduction)
+{
+  const auto in = make_smooth_rgb_image(40, 30);
+
+  auto t = ImageDataTransform{};
+  t.out_sizes = Vector2i{20, 15};
+
+  const auto true_out = to_cwh_tensor(t(in));
+  auto out = Tensor_<float, 3>{3, 15, 20};
+  t.transform_into(in, out);
+
+  // The anti-aliasing filters differ but both are close on a smooth image.
+  const auto mean_error =
+      (out.flat_array() - true_out.flat_array()).abs().mean();
+  BOOST_CHECK_LT(mean_error, 0.02f);
+
+  // 8-bit images are rescaled by the color map.
+  auto in8 = Image<Rgb8>{40, 30};
+  in8.flat_array().fill(Rgb8{51, 102, 255});
+  t.set_zoom(0.5f);
+  t.transform_into(in8, out, 1 / 255.f);
+  BOOST_CHECK_SMALL((out[0].flat_array() - 0.2f).abs().maxCoeff(), 1e-6f);
+  BOOST_CHECK_SMALL((out[1].flat_array() - 0.4f).abs().maxCoeff(), 1e-6f);
+  BOOST_CHECK_SMALL((out[2].flat_array() - 1.0f).abs().maxCoeff(), 1e-6f);
+
+  auto wrong_out = Tensor_<float, 3>{3, 15, 21};
+  BOOST_CHECK_THROW(t.transform_into(in8, wrong_out), std::domain_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -181,4 +181,57 @@ BOOST_AUTO_TEST_CASE(test_hessian_2)
     }
 }
 
+BOOST_AUTO_TEST_CASE(test_specialized_kernels_2d)
+{
+  // The 2D kernels must agree with the generic pointwise implementation,
+  // including on the borders.
+  for (const auto& sizes : {Vector2i{2, 2}, Vector2i{2, 5}, Vector2i{7, 5}})
+  {
+    auto f = Image<float>{sizes};
+    f.flat_array() = ArrayXf::Random(f.size());
+
+    auto nabla_f = Image<Vector2f>{sizes};
+    auto delta_f = Image<float>{sizes};
+    auto H_f = Image<Matrix2f>{sizes};
+    gradient(f, nabla_f);
+    laplacian(f, delta_f);
+    hessian(f, H_f);
+
+    for (int y = 0; y < f.height(); ++y)
+    {
+      for (int x = 0; x < f.width(); ++x)
+      {
+        const auto p = Vector2i{x, y};
+        BOOST_CHECK_EQUAL(gradient(f, p), nabla_f(p));
+        BOOST_CHECK_EQUAL(laplacian(f, p), delta_f(p));
+        BOOST_CHECK_EQUAL(hessian(f, p), H_f(p));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_specialized_kernels_3d)
+{
+  auto f = Image<float, 3>{6, 4, 3};
+  f.flat_array() = ArrayXf::Random(f.size());
+
+  const auto nabla_f = gradient(f);
+  const auto delta_f = laplacian(f);
+  const auto H_f = hessian(f);
+
+  for (int z = 0; z < f.depth(); ++z)
+  {
+    for (int y = 0; y < f.height(); ++y)
+    {
+      for (int x = 0; x < f.width(); ++x)
+      {
+        const auto p = Vector3i{x, y, z};
+        BOOST_CHECK_EQUAL(gradient(f, p), nabla_f(p));
+        BOOST_CHECK_EQUAL(laplacian(f, p), delta_f(p));
+        BOOST_CHECK_EQUAL(hessian(f, p), H_f(p));
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -39,4 +39,47 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(test_gaussian_pyramid, T, ChannelTypes)
   ImagePyramid<T> L(laplacian_pyramid(G));
 }
 
+BOOST_AUTO_TEST_CASE(test_rebuild_pyramid_in_place)
+{
+  auto frame = Image<float>{40, 30};
+  auto G = ImagePyramid<float, 2, PooledAllocator>{};
+  auto D = ImagePyramid<float, 2, PooledAllocator>{};
+
+  // Build the pyramids for a first frame.
+  frame.flat_array() = ArrayXf::Random(frame.size());
+  gaussian_pyramid(frame, G);
+  difference_of_gaussians_pyramid(G, D);
+
+  auto buffers = std::vector<const float*>{};
+  for (auto o = 0; o < G.num_octaves(); ++o)
+    for (auto s = 0; s < G.num_scales_per_octave(); ++s)
+      buffers.push_back(G(s, o).data());
+
+  // Rebuild the pyramids for a new frame of the same size.
+  frame.flat_array() = ArrayXf::Random(frame.size());
+  gaussian_pyramid(frame, G);
+  difference_of_gaussians_pyramid(G, D);
+
+  // The image buffers must have been reused.
+  auto i = 0;
+  for (auto o = 0; o < G.num_octaves(); ++o)
+    for (auto s = 0; s < G.num_scales_per_octave(); ++s)
+      BOOST_CHECK_EQUAL(G(s, o).data(), buffers[i++]);
+
+  // And the pyramids must be identical to the ones built from scratch.
+  const auto G_expected = gaussian_pyramid(frame);
+  const auto D_expected = difference_of_gaussians_pyramid(G_expected);
+  BOOST_REQUIRE_EQUAL(G.num_octaves(), G_expected.num_octaves());
+  BOOST_REQUIRE_EQUAL(D.num_octaves(), D_expected.num_octaves());
+  for (auto o = 0; o < G.num_octaves(); ++o)
+  {
+    BOOST_CHECK_EQUAL(G.octave_scaling_factor(o),
+                      G_expected.octave_scaling_factor(o));
+    for (auto s = 0; s < G.num_scales_per_octave(); ++s)
+      BOOST_CHECK(G(s, o).matrix() == G_expected(s, o).matrix());
+    for (auto s = 0; s < D.num_scales_per_octave(); ++s)
+      BOOST_CHECK(D(s, o).matrix() == D_expected(s, o).matrix());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
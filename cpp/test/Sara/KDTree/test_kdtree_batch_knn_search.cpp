@@ -0,0 +1,195 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2013-2016 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "KDTree/Batch K-Nearest Neighbor Search"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/KDTree.hpp>
+
+#include <algorithm>
+#include <bitset>
+#include <random>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+template <typename T>
+auto random_tensor(int rows, int cols, std::mt19937& gen) -> Tensor_<T, 2>
+{
+  auto t = Tensor_<T, 2>{rows, cols};
+  if constexpr (std::is_floating_point_v<T>)
+  {
+    auto dist = std::uniform_real_distribution<T>{0, 1};
+    std::generate(t.begin(), t.end(), [&]() { return dist(gen); });
+  }
+  else
+  {
+    auto dist = std::uniform_int_distribution<int>{0, 255};
+    std::generate(t.begin(), t.end(),
+                  [&]() { return static_cast<T>(dist(gen)); });
+  }
+  return t;
+}
+
+//! Brute-force k-NN search as the reference.
+template <typename T, typename Distance>
+auto brute_force_knn(const Tensor_<T, 2>& data, const Tensor_<T, 2>& queries,
+                     int k, const Distance& distance)
+    -> Tensor_<typename Distance::ResultType, 2>
+{
+  auto nn_distances = Tensor_<typename Distance::ResultType, 2>{
+      queries.rows(), k};
+  auto d = std::vector<typename Distance::ResultType>(data.rows());
+  for (auto q = 0; q < queries.rows(); ++q)
+  {
+    for (auto i = 0; i < data.rows(); ++i)
+      d[i] = distance(queries[q].data(), data[i].data(), data.cols());
+    std::partial_sort(d.begin(), d.begin() + k, d.end());
+    std::copy(d.begin(), d.begin() + k, nn_distances[q].data());
+  }
+  return nn_distances;
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestDistances)
+
+BOOST_AUTO_TEST_CASE(test_squared_l2_distance)
+{
+  auto gen = std::mt19937{0};
+  // The dimension is not a multiple of the block size.
+  const auto x = random_tensor<float>(2, 37, gen);
+
+  auto expected = 0.f;
+  for (auto j = 0; j < 37; ++j)
+    expected += (x(0, j) - x(1, j)) * (x(0, j) - x(1, j));
+
+  const auto distance = SquaredL2Distance<float>{};
+  BOOST_CHECK_CLOSE(distance(x[0].data(), x[1].data(), 37), expected, 1e-3f);
+}
+
+BOOST_AUTO_TEST_CASE(test_l1_distance_on_bytes)
+{
+  auto gen = std::mt19937{0};
+  const auto x = random_tensor<std::uint8_t>(2, 37, gen);
+
+  auto expected = 0;
+  for (auto j = 0; j < 37; ++j)
+    expected += std::abs(int(x(0, j)) - int(x(1, j)));
+
+  const auto distance = L1Distance<std::uint8_t>{};
+  BOOST_CHECK_EQUAL(distance(x[0].data(), x[1].data(), 37), float(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_hamming_distance)
+{
+  auto gen = std::mt19937{0};
+  const auto x = random_tensor<std::uint8_t>(2, 13, gen);
+
+  auto expected = 0;
+  for (auto j = 0; j < 13; ++j)
+    expected += static_cast<int>(std::bitset<8>(x(0, j) ^ x(1, j)).count());
+
+  const auto distance = HammingDistance{};
+  BOOST_CHECK_EQUAL(distance(x[0].data(), x[1].data(), 13), expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+
+BOOST_AUTO_TEST_SUITE(TestBatchKnnSearch)
+
+BOOST_AUTO_TEST_CASE(test_float_kdtree)
+{
+  auto gen = std::mt19937{0};
+  const auto data = random_tensor<float>(500, 16, gen);
+  const auto queries = random_tensor<float>(50, 16, gen);
+  constexpr auto k = 5;
+
+  const auto tree = KDTree_<float>{data};
+  BOOST_CHECK_EQUAL(tree.size(), 500);
+  BOOST_CHECK_EQUAL(tree.dimension(), 16);
+
+  auto nn_indices = Tensor_<int, 2>{queries.rows(), k};
+  auto nn_distances = Tensor_<float, 2>{queries.rows(), k};
+  tree.knn_search(queries, k, nn_indices, nn_distances);
+
+  const auto distance = SquaredL2Distance<float>{};
+  const auto expected = brute_force_knn(data, queries, k, distance);
+  for (auto q = 0; q < queries.rows(); ++q)
+    for (auto r = 0; r < k; ++r)
+    {
+      BOOST_CHECK_CLOSE(nn_distances(q, r), expected(q, r), 1e-3f);
+      BOOST_CHECK_CLOSE(distance(queries[q].data(),
+                                 data[nn_indices(q, r)].data(), 16),
+                        nn_distances(q, r), 1e-3f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_uint8_kdtree_with_l1_distance)
+{
+  auto gen = std::mt19937{1};
+  const auto data = random_tensor<std::uint8_t>(300, 32, gen);
+  const auto queries = random_tensor<std::uint8_t>(20, 32, gen);
+  constexpr auto k = 3;
+
+  const auto tree = KDTree_<std::uint8_t, L1Distance<std::uint8_t>>{data};
+  const auto [nn_indices, nn_distances] = tree.knn_search(queries, k, 1);
+  BOOST_CHECK_EQUAL(nn_indices.sizes(), Eigen::Vector2i(20, k));
+
+  const auto expected =
+      brute_force_knn(data, queries, k, L1Distance<std::uint8_t>{});
+  for (auto q = 0; q < queries.rows(); ++q)
+    for (auto r = 0; r < k; ++r)
+      BOOST_CHECK_EQUAL(nn_distances(q, r), expected(q, r));
+}
+
+BOOST_AUTO_TEST_CASE(test_binary_descriptors_with_hamming_distance)
+{
+  auto gen = std::mt19937{2};
+  const auto data = random_tensor<std::uint8_t>(300, 32, gen);
+  auto queries = Tensor_<std::uint8_t, 2>{4, 32};
+  for (auto q = 0; q < 4; ++q)
+    std::copy(data[10 * q].begin(), data[10 * q].end(), queries[q].begin());
+
+  const auto tree = KDTree_<std::uint8_t, HammingDistance>{data};
+  const auto [nn_indices, nn_distances] = tree.knn_search(queries, 2);
+
+  // The hierarchical clustering search is approximate: only the exact
+  // matches are guaranteed to be found.
+  const auto distance = HammingDistance{};
+  const auto expected = brute_force_knn(data, queries, 2, distance);
+  for (auto q = 0; q < 4; ++q)
+  {
+    BOOST_CHECK_EQUAL(nn_indices(q, 0), 10 * q);
+    BOOST_CHECK_EQUAL(nn_distances(q, 0), 0);
+    BOOST_CHECK_GE(nn_distances(q, 1), expected(q, 1));
+    BOOST_CHECK_EQUAL(
+        distance(queries[q].data(), data[nn_indices(q, 1)].data(), 32),
+        nn_distances(q, 1));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_output_sizes)
+{
+  auto gen = std::mt19937{0};
+  const auto data = random_tensor<float>(10, 4, gen);
+  const auto tree = KDTree_<float>{data};
+
+  auto nn_indices = Tensor_<int, 2>{3, 1};
+  auto nn_distances = Tensor_<float, 2>{3, 1};
+  BOOST_CHECK_THROW(tree.knn_search(data, 2, nn_indices, nn_distances),
+                    std::domain_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "MultiViewGeometry/Bundle Adjuster"
+
+#include <DO/Sara/MultiViewGeometry/BundleAdjuster.hpp>
+#include <DO/Sara/MultiViewGeometry/Utilities.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <random>
+
+
+using namespace DO::Sara;
+
+
+//! Cameras on an arc looking at points in the unit cube. Each camera
+//! observes about 80% of the points and each point is observed at least
+//! twice.
+auto make_synthetic_problem(int num_cameras, int num_points, double noise,
+                            double outlier_ratio, std::mt19937& gen)
+    -> std::pair<BundleAdjustmentProblem, std::vector<bool>>
+{
+  auto uniform = std::uniform_real_distribution<double>{0., 1.};
+  auto gaussian = std::normal_distribution<double>{0., noise};
+
+  auto points = MatrixXd{3, num_points};
+  for (auto p = 0; p < num_points; ++p)
+    points.col(p) << 2 * uniform(gen) - 1, 2 * uniform(gen) - 1,
+        2 * uniform(gen) - 1;
+
+  auto cameras = MatrixXd{12, num_cameras};
+  for (auto c = 0; c < num_cameras; ++c)
+  {
+    const auto R = Eigen::AngleAxisd{rotation_y(0.15 * c) * rotation_x(0.05)};
+    cameras.col(c) << R.angle() * R.axis(), 0.1, -0.05, 6.,  //
+        500., 500., 320., 240., 0., 0.;
+  }
+
+  auto visibility = std::vector<std::pair<int, int>>{};
+  for (auto p = 0; p < num_points; ++p)
+    for (auto c = 0; c < num_cameras; ++c)
+      if (c == p % num_cameras || c == (p + 1) % num_cameras ||
+          uniform(gen) < 0.8)
+        visibility.emplace_back(c, p);
+
+  const auto num_observations = static_cast<int>(visibility.size());
+  auto problem = BundleAdjustmentProblem{};
+  problem.resize(num_observations, num_points, num_cameras, 12);
+  problem.camera_parameters.colmajor_view().matrix() = cameras;
+  problem.points_abs_coords_3d.colmajor_view().matrix() = points;
+
+  auto is_inlier = std::vector<bool>(num_observations, true);
+  for (auto o = 0; o < num_observations; ++o)
+  {
+    const auto [c, p] = visibility[o];
+    problem.camera_indices[o] = c;
+    problem.point_indices[o] = p;
+    problem.observations(o, 0) = 0;
+    problem.observations(o, 1) = 0;
+  }
+
+  // The residuals at zero observations are the projections.
+  const auto projections = reprojection_residuals(problem);
+  for (auto o = 0; o < num_observations; ++o)
+  {
+    problem.observations(o, 0) = projections(o, 0) + gaussian(gen);
+    problem.observations(o, 1) = projections(o, 1) + gaussian(gen);
+    if (uniform(gen) < outlier_ratio)
+    {
+      problem.observations(o, 0) += 50.;
+      problem.observations(o, 1) -= 50.;
+      is_inlier[o] = false;
+    }
+  }
+
+  return {std::move(problem), std::move(is_inlier)};
+}
+
+auto perturb(BundleAdjustmentProblem& problem, int num_constant_cameras,
+             std::mt19937& gen) -> void
+{
+  auto gaussian = std::normal_distribution<double>{0., 1.};
+
+  auto cameras = problem.camera_parameters.colmajor_view().matrix();
+  for (auto c = num_constant_cameras; c < problem.num_cameras; ++c)
+  {
+    for (auto i = 0; i < 3; ++i)
+      cameras(i, c) += 0.01 * gaussian(gen);
+    for (auto i = 3; i < 6; ++i)
+      cameras(i, c) += 0.05 * gaussian(gen);
+    cameras(6, c) += 5 * gaussian(gen);
+    cameras(7, c) += 5 * gaussian(gen);
+  }
+
+  auto points = problem.points_abs_coords_3d.colmajor_view().matrix();
+  for (auto p = 0; p < problem.num_points; ++p)
+    for (auto i = 0; i < 3; ++i)
+      points(i, p) += 0.05 * gaussian(gen);
+}
+
+auto rms(const Tensor_<double, 2>& residuals) -> double
+{
+  return std::sqrt(residuals.matrix().squaredNorm() / residuals.rows());
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestBundleAdjuster)
+
+BOOST_AUTO_TEST_CASE(test_exact_data)
+{
+  for (const auto solver :
+       {SchurSolver::SparseCholesky, SchurSolver::ConjugateGradient})
+  {
+    auto gen = std::mt19937{0};
+    auto [problem, is_inlier] = make_synthetic_problem(8, 300, 0., 0., gen);
+    const auto true_parameters = problem.parameters;
+
+    // Fix the gauge with the first two cameras.
+    perturb(problem, 2, gen);
+    BOOST_CHECK_GT(rms(reprojection_residuals(problem)), 1.);
+
+    auto options = BundleAdjustmentOptions{};
+    options.linear_solver = solver;
+    options.constant_cameras = {0, 1};
+    const auto summary = bundle_adjust(problem, options);
+
+    BOOST_CHECK(summary.converged);
+    BOOST_CHECK_LT(summary.final_cost, 1e-12 * summary.initial_cost);
+    BOOST_CHECK_SMALL(rms(reprojection_residuals(problem)), 1e-6);
+
+    auto error = 0.;
+    for (auto i = 0u; i < true_parameters.size(); ++i)
+      error = std::max(error, std::abs(problem.parameters[i] -
+                                       true_parameters[i]));
+    BOOST_CHECK_SMALL(error, 1e-6);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_robust_loss)
+{
+  // N.B.: the problem cannot be copied as it contains views on its own
+  // parameters.
+  const auto make_problem = []() {
+    auto gen = std::mt19937{1};
+    auto data = make_synthetic_problem(8, 300, 0.5, 0.05, gen);
+    perturb(data.first, 2, gen);
+    return data;
+  };
+  auto [problem, is_inlier] = make_problem();
+  auto problem_l2 = std::move(make_problem().first);
+
+  auto options = BundleAdjustmentOptions{};
+  options.constant_cameras = {0, 1};
+  options.refine_intrinsics = false;
+
+  const auto inlier_rms = [&](const BundleAdjustmentProblem& problem) {
+    const auto residuals = reprojection_residuals(problem);
+    auto sum = 0.;
+    auto count = 0;
+    for (auto o = 0; o < residuals.rows(); ++o)
+    {
+      if (!is_inlier[o])
+        continue;
+      sum += residuals[o].row_vector().squaredNorm();
+      ++count;
+    }
+    return std::sqrt(sum / count);
+  };
+
+  BOOST_CHECK(bundle_adjust(problem_l2, options).converged);
+
+  options.loss = RobustLoss::Cauchy;
+  options.loss_scale = 2.;
+  BOOST_CHECK(bundle_adjust(problem, options).converged);
+
+  // The outliers bias the least-squares solution, but not the robust one.
+  const auto rms_l2 = inlier_rms(problem_l2);
+  const auto rms_cauchy = inlier_rms(problem);
+  BOOST_CHECK_LT(rms_cauchy, 1.);
+  BOOST_CHECK_LT(rms_cauchy, rms_l2);
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_problem)
+{
+  auto problem = BundleAdjustmentProblem{};
+  problem.resize(1, 1, 1, 9);
+  BOOST_CHECK_THROW(bundle_adjust(problem), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -221,3 +221,91 @@ BOOST_AUTO_TEST_CASE(test_calculate_two_view_geometries)
   BOOST_CHECK_EQUAL(g.C2.matrix(),
                     normalized_camera(R, t.normalized()).matrix());
 }
+
+
+BOOST_AUTO_TEST_CASE(test_batched_triangulation)
+{
+  const auto [X, R, t, E, C1, C2, x1, x2] = generate_test_data();
+  (void) E;
+
+  // Put a point behind the cameras and perturb the image of another point.
+  MatrixXd X_true = X;
+  X_true.col(4).head<3>() *= -1;
+  MatrixXd u1 = C1 * X_true;
+  MatrixXd u2 = C2 * X_true;
+  u1.col(3) = u1.col(3).hnormalized().homogeneous().eval();
+  u1(0, 3) += 1e-2;
+
+  // The 3xN column-major matrices are viewed as (N, 3) row-major tensors.
+  const auto num_points = static_cast<int>(X.cols());
+  const auto u1_view = TensorView_<double, 2>{u1.data(), {num_points, 3}};
+  const auto u2_view = TensorView_<double, 2>{u2.data(), {num_points, 3}};
+
+  const auto [X_est, cheirality, reprojection_errors] =
+      triangulate(C1, C2, u1_view, u2_view);
+  BOOST_REQUIRE_EQUAL(X_est.sizes(), Eigen::Vector2i(num_points, 4));
+
+  // The batched triangulation is consistent with the single point version.
+  for (auto i = 0; i < num_points; ++i)
+  {
+    const Vector4d Xi = triangulate_single_point_linear_eigen(
+        C1, C2, u1.col(i), u2.col(i));
+    BOOST_CHECK_SMALL((X_est[i].row_vector().transpose() - Xi).norm(), 1e-12);
+  }
+
+  // Check the exact points.
+  for (auto i : {0, 1, 2, 4})
+  {
+    BOOST_CHECK_SMALL(
+        (X_est[i].row_vector().transpose() - X_true.col(i)).norm(), 1e-6);
+    BOOST_CHECK_SMALL(reprojection_errors(i), 1e-9);
+  }
+
+  // The perturbed point has a nonzero reprojection error which is at most the
+  // perturbation.
+  BOOST_CHECK_GT(reprojection_errors(3), 1e-4);
+  BOOST_CHECK_LE(reprojection_errors(3), 1e-2);
+
+  // Only the last point is not cheiral.
+  for (auto i = 0; i < 4; ++i)
+    BOOST_CHECK(cheirality(i));
+  BOOST_CHECK(!cheirality(4));
+
+  // The output sizes are checked.
+  auto X_wrong = Tensor_<double, 2>{num_points, 3};
+  auto cheirality_wrong = Tensor_<bool, 1>{num_points};
+  auto errors_wrong = Tensor_<double, 1>{num_points};
+  BOOST_CHECK_THROW(triangulate(C1, C2, u1_view, u2_view, X_wrong,
+                                cheirality_wrong, errors_wrong),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_batched_triangulation_many_points)
+{
+  const auto num_points = 100'000;
+
+  const Matrix3d R = rotation_z(0.1) * rotation_y(0.2);
+  const Vector3d t{1., 0.1, 0.};
+  const Matrix34d P1 = normalized_camera();
+  const Matrix34d P2 = normalized_camera(R, t);
+
+  MatrixXd X = MatrixXd::Random(4, num_points);
+  X.row(2).array() += 5;
+  X.row(3).fill(1);
+  MatrixXd u1 = P1 * X;
+  MatrixXd u2 = P2 * X;
+
+  auto X_est = MatrixXd{4, num_points};
+  auto cheirality = Eigen::Array<bool, 1, Eigen::Dynamic>{num_points};
+  auto reprojection_errors = Tensor_<double, 1>{num_points};
+
+  auto X_view = TensorView_<double, 2>{X_est.data(), {num_points, 4}};
+  auto cheirality_view = TensorView_<bool, 1>{cheirality.data(), num_points};
+  triangulate(P1, P2, TensorView_<double, 2>{u1.data(), {num_points, 3}},
+              TensorView_<double, 2>{u2.data(), {num_points, 3}}, X_view,
+              cheirality_view, reprojection_errors);
+
+  BOOST_CHECK_SMALL((X_est - X).norm() / X.norm(), 1e-9);
+  BOOST_CHECK(cheirality.all());
+  BOOST_CHECK_SMALL(reprojection_errors.flat_array().maxCoeff(), 1e-9);
+}
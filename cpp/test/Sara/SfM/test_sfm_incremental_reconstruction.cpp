@@ -0,0 +1,240 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "SfM/Incremental Reconstruction"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/MultiViewGeometry/Utilities.hpp>
+#include <DO/Sara/SfM/BuildingBlocks/IncrementalReconstruction.hpp>
+
+#include <limits>
+#include <random>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+struct SyntheticScene
+{
+  std::vector<PinholeCamera> cameras;
+  ViewAttributes views;
+  EpipolarEdgeAttributes epipolar_edges;
+  PoseGraph pose_graph;
+  std::set<std::set<FeatureGID>> tracks;
+};
+
+//! Cameras on an arc looking at points in the unit cube. The views are
+//! connected in the pose graph when they are at most 3 views apart.
+auto make_synthetic_scene(int num_views, int num_points, double pixel_noise,
+                          double rotation_noise, std::mt19937& gen)
+    -> SyntheticScene
+{
+  auto uniform = std::uniform_real_distribution<double>{0., 1.};
+  auto gaussian = std::normal_distribution<double>{0., 1.};
+
+  auto scene = SyntheticScene{};
+
+  auto K = Matrix3d{};
+  K << 500, 0, 320,  //
+      0, 500, 240,   //
+      0, 0, 1;
+  for (auto v = 0; v < num_views; ++v)
+    scene.cameras.push_back(PinholeCamera{
+        K, rotation_y(0.15 * v) * rotation_x(0.05), Vector3d{0.1, -0.05, 6.}});
+
+  auto points = std::vector<Vector3d>(num_points);
+  for (auto& X : points)
+    X << 2 * uniform(gen) - 1, 2 * uniform(gen) - 1, 2 * uniform(gen) - 1;
+
+  // Each view observes about 70% of the points.
+  auto& views = scene.views;
+  views.cameras.resize(num_views);
+  views.keypoints.resize(num_views);
+  auto visibility = std::vector<std::vector<int>>(num_points);
+  for (auto v = 0; v < num_views; ++v)
+  {
+    views.cameras[v].K = K;
+    auto& f = features(views.keypoints[v]);
+    for (auto p = 0; p < num_points; ++p)
+    {
+      if (uniform(gen) > 0.7)
+        continue;
+      const Vector2d x = (scene.cameras[v].matrix() * points[p].homogeneous())
+                             .hnormalized() +
+                         pixel_noise * Vector2d{gaussian(gen), gaussian(gen)};
+      visibility[p].push_back(static_cast<int>(f.size()));
+      visibility[p].push_back(v);
+      f.emplace_back(x.cast<float>().eval());
+    }
+  }
+
+  for (const auto& obs : visibility)
+  {
+    auto track = std::set<FeatureGID>{};
+    for (auto i = 0u; i < obs.size(); i += 2)
+      track.insert({obs[i + 1], obs[i]});
+    if (track.size() >= 2)
+      scene.tracks.insert(track);
+  }
+
+  // Relative motions with noisy rotations.
+  auto& pose_graph = scene.pose_graph;
+  pose_graph = PoseGraph(num_views);
+  auto& edges = scene.epipolar_edges;
+  for (auto i = 0; i < num_views; ++i)
+  {
+    for (auto j = i + 1; j < std::min(i + 4, num_views); ++j)
+    {
+      const auto& Ci = scene.cameras[i];
+      const auto& Cj = scene.cameras[j];
+      const Vector3d w = rotation_noise * Vector3d{gaussian(gen), gaussian(gen),
+                                                   gaussian(gen)};
+      const Matrix3d Rij =
+          Eigen::AngleAxisd{w.norm(), w.normalized()}.toRotationMatrix() *
+          Cj.R * Ci.R.transpose();
+      const Vector3d tij = (Cj.t - Rij * Ci.t).normalized();
+
+      const auto ij = static_cast<int>(edges.edges.size());
+      edges.edges.emplace_back(i, j);
+      auto g = TwoViewGeometry{};
+      g.C2 = normalized_camera(Rij, tij);
+      edges.two_view_geometries.push_back(g);
+
+      const auto weight = 100. - 10 * (j - i);
+      boost::add_edge(i, j, {ij, weight}, pose_graph);
+      pose_graph[i].weight += weight;
+      pose_graph[j].weight += weight;
+    }
+  }
+
+  return scene;
+}
+
+auto angular_distance(const Matrix3d& R1, const Matrix3d& R2) -> double
+{
+  return Eigen::AngleAxisd{R1 * R2.transpose()}.angle();
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestIncrementalReconstruction)
+
+BOOST_AUTO_TEST_CASE(test_maximum_spanning_tree)
+{
+  auto graph = PoseGraph(4);
+  boost::add_edge(0, 1, {0, 10.}, graph);
+  boost::add_edge(1, 2, {1, 1.}, graph);
+  boost::add_edge(0, 2, {2, 5.}, graph);
+  boost::add_edge(2, 3, {3, 7.}, graph);
+  boost::add_edge(1, 3, {4, 2.}, graph);
+
+  auto ids = std::vector<int>{};
+  for (const auto& e : maximum_spanning_tree(graph))
+    ids.push_back(graph[e].id);
+  std::sort(ids.begin(), ids.end());
+  BOOST_CHECK(ids == std::vector<int>({0, 2, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(test_rotation_averaging)
+{
+  auto gen = std::mt19937{0};
+  auto scene = make_synthetic_scene(10, 10, 0., 0.01, gen);
+
+  // Corrupt one relative rotation of the spanning tree, which the averaging
+  // must correct.
+  scene.epipolar_edges.two_view_geometries[0].C2.R =
+      rotation_z(0.5) * scene.epipolar_edges.two_view_geometries[0].C2.R;
+
+  const auto root = 4;
+  const auto R = average_rotations(scene.pose_graph, scene.epipolar_edges,
+                                   root);
+  BOOST_REQUIRE_EQUAL(R.size(), 10u);
+  BOOST_CHECK_SMALL(angular_distance(R[root], Matrix3d::Identity()), 1e-12);
+
+  const Matrix3d& R_root = scene.cameras[root].R;
+  for (auto v = 0; v < 10; ++v)
+    BOOST_CHECK_LT(
+        angular_distance(R[v], scene.cameras[v].R * R_root.transpose()),
+        0.02);
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental_reconstruction)
+{
+  auto gen = std::mt19937{1};
+  const auto scene = make_synthetic_scene(12, 300, 0.5, 0.005, gen);
+
+  auto options = IncrementalReconstructionOptions{};
+  options.local_window_size = 4;
+  auto reconstruction =
+      IncrementalReconstruction{scene.views, scene.epipolar_edges,
+                                scene.pose_graph, scene.tracks, options};
+  reconstruction.run();
+
+  BOOST_CHECK_EQUAL(reconstruction.num_registered_views(), 12);
+  BOOST_CHECK_LT(reconstruction.rms_reprojection_error(), 1.);
+  BOOST_CHECK_GT(reconstruction.point_cloud().rows(), 250);
+
+  // The reconstruction is expressed in the frame of the root camera up to
+  // scale. The root has the largest weight.
+  auto root = 0;
+  for (auto v = 0; v < 12; ++v)
+    if (scene.pose_graph[v].weight > scene.pose_graph[root].weight)
+      root = v;
+  const auto& C_root = scene.cameras[root];
+
+  const auto& cameras = reconstruction.cameras();
+  auto centers = std::vector<Vector3d>{};
+  auto true_centers = std::vector<Vector3d>{};
+  auto num = 0.;
+  auto den = 0.;
+  for (auto v = 0; v < 12; ++v)
+  {
+    BOOST_CHECK(reconstruction.is_registered(v));
+    BOOST_CHECK_LT(angular_distance(cameras[v].R,
+                                    scene.cameras[v].R * C_root.R.transpose()),
+                   0.01);
+
+    centers.push_back(-cameras[v].R.transpose() * cameras[v].t);
+    const Vector3d c = -scene.cameras[v].R.transpose() * scene.cameras[v].t;
+    true_centers.push_back(C_root.R * c + C_root.t);
+    num += centers.back().dot(true_centers.back());
+    den += true_centers.back().squaredNorm();
+  }
+
+  const auto scale = num / den;
+  BOOST_CHECK_GT(scale, 0);
+  for (auto v = 0; v < 12; ++v)
+    BOOST_CHECK_LT((centers[v] - scale * true_centers[v]).norm(),
+                   0.02 * scale * true_centers[v].norm() + 1e-9);
+
+  // The bundle adjustments keep the unit baseline between the root and its
+  // neighbor of the initial pair, i.e., the scale does not drift.
+  auto baseline_error = std::numeric_limits<double>::infinity();
+  for (const auto v : {root - 1, root + 1})
+    if (0 <= v && v < 12)
+      baseline_error = std::min(baseline_error,
+                                std::abs((centers[v] - centers[root]).norm() - 1));
+  BOOST_CHECK_SMALL(baseline_error, 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_input)
+{
+  auto gen = std::mt19937{2};
+  auto scene = make_synthetic_scene(4, 10, 0., 0., gen);
+  scene.views.cameras.pop_back();
+  BOOST_CHECK_THROW(IncrementalReconstruction(scene.views,
+                                              scene.epipolar_edges,
+                                              scene.pose_graph, scene.tracks),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+// ========================================================================== //
+// This file is part of Sara, a basic set of libraries in C++ for computer
+// vision.
+//
+// Copyright (C) 2019 David Ok <david.ok8@gmail.com>
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License v. 2.0. If a copy of the MPL was not distributed with this file,
+// you can obtain one at http://mozilla.org/MPL/2.0/.
+// ========================================================================== //
+
+#define BOOST_TEST_MODULE "SfM/SIFT Backends"
+
+#include <boost/test/unit_test.hpp>
+
+#include <DO/Sara/SfM/Detectors/SIFT.hpp>
+
+#include <algorithm>
+
+
+using namespace std;
+using namespace DO::Sara;
+
+
+// Blobs of different sizes on a smooth background.
+auto make_blob_image() -> Image<float>
+{
+  auto image = Image<float>{128, 96};
+  for (auto y = 0; y < image.height(); ++y)
+  {
+    for (auto x = 0; x < image.width(); ++x)
+    {
+      auto v = 0.1f * std::sin(0.05f * x) * std::cos(0.07f * y);
+      for (auto i = 0; i < 6; ++i)
+      {
+        const auto cx = 20.f + 18.f * i;
+        const auto cy = 25.f + 10.f * (i % 3);
+        const auto r = 2.f + i;
+        const auto d2 = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+        v += std::exp(-d2 / (2 * r * r));
+      }
+      image(x, y) = v;
+    }
+  }
+  return image;
+}
+
+
+BOOST_AUTO_TEST_SUITE(TestSIFTBackends)
+
+BOOST_AUTO_TEST_CASE(test_reference_backend)
+{
+  BOOST_CHECK(sift_backend_available(SIFTBackend::Reference));
+
+  const auto image = make_blob_image();
+  const auto keys = compute_sift_keypoints(image);
+  const auto& [features, descriptors] = keys;
+
+  BOOST_CHECK(!features.empty());
+  BOOST_CHECK_EQUAL(descriptors.rows(), static_cast<int>(features.size()));
+  BOOST_CHECK_EQUAL(descriptors.cols(), 128);
+}
+
+BOOST_AUTO_TEST_CASE(test_halide_cpu_backend_parity)
+{
+  const auto image = make_blob_image();
+
+  if (!sift_backend_available(SIFTBackend::HalideCPU))
+  {
+    BOOST_CHECK_THROW(compute_sift_keypoints(image, ImagePyramidParams{},
+                                             false, SIFTBackend::HalideCPU),
+                      std::runtime_error);
+    return;
+  }
+
+  const auto keys_ref = compute_sift_keypoints(image);
+  const auto keys_halide = compute_sift_keypoints(
+      image, ImagePyramidParams{}, true, SIFTBackend::HalideCPU);
+
+  const auto& [f_ref, d_ref] = keys_ref;
+  const auto& [f_halide, d_halide] = keys_halide;
+
+  // The detection is shared by the two backends.
+  BOOST_REQUIRE_EQUAL(f_ref.size(), f_halide.size());
+  for (auto i = 0u; i < f_ref.size(); ++i)
+  {
+    BOOST_CHECK_SMALL((f_ref[i].center() - f_halide[i].center()).norm(),
+                      1e-5f);
+    BOOST_CHECK_CLOSE(f_ref[i].orientation, f_halide[i].orientation, 1e-4f);
+  }
+
+  // The two backends sample the normalized patch differently, so the
+  // descriptors are compared by their cosine similarity. A parity test must
+  // reject a single broken descriptor, hence the bound on the worst one.
+  BOOST_REQUIRE_EQUAL(d_ref.sizes(), d_halide.sizes());
+  auto mean_cosine = 0.f;
+  auto min_cosine = 1.f;
+  for (auto i = 0; i < d_ref.rows(); ++i)
+  {
+    const Eigen::VectorXf a = d_ref.matrix().row(i).transpose();
+    const Eigen::VectorXf b = d_halide.matrix().row(i).transpose();
+    BOOST_CHECK_LE(b.maxCoeff(), 255.f);
+    const auto cosine = a.dot(b) / (a.norm() * b.norm());
+    mean_cosine += cosine;
+    min_cosine = std::min(min_cosine, cosine);
+  }
+  mean_cosine /= d_ref.rows();
+  BOOST_CHECK_GE(mean_cosine, 0.99f);
+  BOOST_CHECK_GE(min_cosine, 0.95f);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
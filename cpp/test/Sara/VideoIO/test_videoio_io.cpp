@@ -1,5 +1,6 @@
 #define BOOST_TEST_MODULE "VideoIO/VideoStream Class"
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
 
 #include <DO/Sara/Core.hpp>
@@ -77,4 +78,178 @@ BOOST_AUTO_TEST_CASE(test_seek_frame)
     BOOST_REQUIRE_EQUAL(*p, *p2);
 }
 
+BOOST_AUTO_TEST_CASE(test_prefetch_frames)
+{
+  VideoStream sync_video_stream{video_filename};
+  VideoStream async_video_stream{video_filename};
+  async_video_stream.start_prefetching(3);
+  BOOST_CHECK(async_video_stream.prefetching());
+
+  // Read the frames with the synchronous API.
+  for (auto i = 0; i < 5; ++i)
+  {
+    BOOST_REQUIRE(sync_video_stream.read());
+    BOOST_REQUIRE(async_video_stream.read());
+
+    const auto frame = sync_video_stream.frame();
+    const auto async_frame = async_video_stream.frame();
+    BOOST_REQUIRE(
+        std::equal(frame.begin(), frame.end(), async_frame.begin()));
+  }
+
+  // Borrow several frames at once.
+  auto f1 = async_video_stream.acquire_frame();
+  auto f2 = async_video_stream.acquire_frame();
+  BOOST_REQUIRE(!f1.empty() && !f2.empty());
+  BOOST_CHECK(f1.data() != f2.data());
+
+  for (const auto& async_frame : {f1, f2})
+  {
+    BOOST_REQUIRE(sync_video_stream.read());
+    const auto frame = sync_video_stream.frame();
+    BOOST_REQUIRE(
+        std::equal(frame.begin(), frame.end(), async_frame.begin()));
+  }
+
+  async_video_stream.release_frame(f1);
+  async_video_stream.release_frame(f2);
+  BOOST_CHECK_THROW(async_video_stream.release_frame(f2), std::runtime_error);
+
+  async_video_stream.stop_prefetching();
+  BOOST_CHECK(!async_video_stream.prefetching());
+}
+
+BOOST_AUTO_TEST_CASE(test_seek_mid_stream)
+{
+  // Reference frames.
+  VideoStream video_stream{video_filename};
+  auto frames = std::vector<Image<Rgb8>>{};
+  for (auto i = 0; i < 4 && video_stream.read(); ++i)
+    frames.emplace_back(video_stream.frame());
+  BOOST_REQUIRE_EQUAL(frames.size(), 4u);
+
+  // Rewinding in the middle of the stream must drop the frames that the
+  // decoder and the prefetcher hold.
+  for (const auto num_buffered_frames : {0, 3})
+  {
+    VideoStream seeked_video_stream{video_filename};
+    if (num_buffered_frames > 0)
+      seeked_video_stream.start_prefetching(num_buffered_frames);
+
+    for (auto i = 0; i < 8; ++i)
+      BOOST_REQUIRE(seeked_video_stream.read());
+
+    seeked_video_stream.seek(0);
+    BOOST_CHECK_EQUAL(seeked_video_stream.prefetching(),
+                      num_buffered_frames > 0);
+
+    for (const auto& frame : frames)
+    {
+      BOOST_REQUIRE(seeked_video_stream.read());
+      BOOST_REQUIRE(seeked_video_stream.frame() == frame);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_grayscale_output)
+{
+  VideoStream gray8_video_stream{video_filename};
+  gray8_video_stream.set_output_format(VideoPixelFormat::Gray8);
+
+  VideoStream gray32f_video_stream{video_filename};
+  gray32f_video_stream.set_output_format(VideoPixelFormat::Gray32f);
+  gray32f_video_stream.start_prefetching(2);
+
+  BOOST_CHECK_THROW(gray8_video_stream.frame(), std::runtime_error);
+
+  for (auto i = 0; i < 3; ++i)
+  {
+    BOOST_REQUIRE(gray8_video_stream.read());
+    BOOST_REQUIRE(gray32f_video_stream.read());
+
+    const auto gray8 = gray8_video_stream.frame_as<std::uint8_t>();
+    const auto gray32f = gray32f_video_stream.frame_as<float>();
+    BOOST_REQUIRE(gray8.sizes() == gray8_video_stream.sizes());
+    BOOST_REQUIRE(gray32f.sizes() == gray32f_video_stream.sizes());
+
+    // The output buffer is aligned on cache lines.
+    BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(gray32f.data()) % 64,
+                      0u);
+
+    for (auto p = 0u; p < gray8.size(); ++p)
+      BOOST_REQUIRE_EQUAL(gray8.data()[p] / 255.f, gray32f.data()[p]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_resized_output)
+{
+  VideoStream video_stream{video_filename};
+  video_stream.set_output_format(VideoPixelFormat::Rgb8, Vector2i{160, 120},
+                                 VideoScaler::Area);
+  BOOST_CHECK_EQUAL(video_stream.output_sizes(), Vector2i(160, 120));
+
+  BOOST_REQUIRE(video_stream.read());
+  BOOST_CHECK_EQUAL(video_stream.frame().sizes(), Vector2i(160, 120));
+
+  BOOST_CHECK_THROW(video_stream.set_output_format(VideoPixelFormat::Rgb8,
+                                                   Vector2i{160, 0}),
+                    std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_frame_accurate_access)
+{
+  // Read the first frames sequentially.
+  VideoStream video_stream{video_filename};
+  auto frames = std::vector<Image<Rgb8>>{};
+  for (auto i = 0; i < 12 && video_stream.read(); ++i)
+    frames.emplace_back(video_stream.frame());
+  BOOST_REQUIRE_EQUAL(frames.size(), 12u);
+
+  const auto cache_filepath =
+      (boost::filesystem::temp_directory_path() / "hale_bopp_1.frame_index")
+          .string();
+  boost::filesystem::remove(cache_filepath);
+
+  VideoStream indexed_video_stream{video_filename};
+  indexed_video_stream.build_frame_index(cache_filepath);
+  BOOST_REQUIRE_GE(indexed_video_stream.num_frames(), 12);
+  BOOST_REQUIRE(!indexed_video_stream.frame_index().keyframes.empty());
+  BOOST_CHECK(boost::filesystem::exists(cache_filepath));
+
+  // The cached index is identical.
+  auto cached_index = VideoFrameIndex{};
+  BOOST_REQUIRE(cached_index.load(cache_filepath));
+  BOOST_CHECK(cached_index.timestamps ==
+              indexed_video_stream.frame_index().timestamps);
+  BOOST_CHECK(cached_index.keyframes ==
+              indexed_video_stream.frame_index().keyframes);
+  BOOST_CHECK(cached_index.keyframe_packet_numbers ==
+              indexed_video_stream.frame_index().keyframe_packet_numbers);
+  BOOST_CHECK_EQUAL(cached_index.keyframe_packet_numbers.size(),
+                    cached_index.keyframes.size());
+
+  // Random access.
+  for (const auto i : {7, 2, 11, 0})
+  {
+    BOOST_REQUIRE(indexed_video_stream.read_frame(i));
+    BOOST_CHECK_EQUAL(indexed_video_stream.frame_position(), i);
+    BOOST_REQUIRE(indexed_video_stream.frame() == frames[i]);
+  }
+
+  // Sequential reading resumes after the frame.
+  BOOST_REQUIRE(indexed_video_stream.read());
+  BOOST_REQUIRE(indexed_video_stream.frame() == frames[1]);
+
+  // Batch extraction.
+  const auto positions = std::vector<int>{9, 3, 9, 4};
+  const auto extracted_frames = indexed_video_stream.extract_frames(positions);
+  BOOST_REQUIRE_EQUAL(extracted_frames.size(), positions.size());
+  for (auto i = 0u; i < positions.size(); ++i)
+    BOOST_REQUIRE(extracted_frames[i] == frames[positions[i]]);
+
+  BOOST_CHECK_THROW(indexed_video_stream.read_frame(-1), std::out_of_range);
+
+  boost::filesystem::remove(cache_filepath);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,77 +9,143 @@
 // you can obtain one at http://mozilla.org/MPL/2.0/.
 // ========================================================================== //
 
-#include "IPC.hpp"
+#include <DO/Sara/Core/SharedFrameRing.hpp>
 
-#include <boost/interprocess/containers/vector.hpp>
-#include <boost/interprocess/managed_shared_memory.hpp>
-#include <boost/interprocess/shared_memory_object.hpp>
-#include <boost/interprocess/sync/interprocess_condition.hpp>
-#include <boost/interprocess/sync/interprocess_mutex.hpp>
-#include <boost/interprocess/sync/scoped_lock.hpp>
+#include "IPC.hpp"
 
-#include <pybind11/eigen.h>
 #include <pybind11/numpy.h>
 
-#include <iostream>
+#include <cstring>
 
 
-namespace bip = boost::interprocess;
 namespace py = pybind11;
+namespace sara = DO::Sara;
 
 
-template <typename T>
-using ipc_allocator =
-    bip::allocator<T, bip::managed_shared_memory::segment_manager>;
+static auto to_dtype(sara::FrameElementType type) -> py::dtype
+{
+  switch (type)
+  {
+  case sara::FrameElementType::UInt8:
+    return py::dtype::of<std::uint8_t>();
+  case sara::FrameElementType::UInt16:
+    return py::dtype::of<std::uint16_t>();
+  case sara::FrameElementType::Int32:
+    return py::dtype::of<std::int32_t>();
+  case sara::FrameElementType::Float32:
+    return py::dtype::of<float>();
+  case sara::FrameElementType::Float64:
+    return py::dtype::of<double>();
+  default:
+    throw std::runtime_error{"Invalid frame element type!"};
+  }
+}
 
-template <typename T>
-using ipc_vector = bip::vector<T, ipc_allocator<T>>;
+static auto to_frame_layout(const py::array& array) -> sara::FrameLayout
+{
+  auto layout = sara::FrameLayout{};
 
+  const auto dtype = array.dtype();
+  if (dtype.is(py::dtype::of<std::uint8_t>()))
+    layout.element_type = sara::FrameElementType::UInt8;
+  else if (dtype.is(py::dtype::of<std::uint16_t>()))
+    layout.element_type = sara::FrameElementType::UInt16;
+  else if (dtype.is(py::dtype::of<std::int32_t>()))
+    layout.element_type = sara::FrameElementType::Int32;
+  else if (dtype.is(py::dtype::of<float>()))
+    layout.element_type = sara::FrameElementType::Float32;
+  else if (dtype.is(py::dtype::of<double>()))
+    layout.element_type = sara::FrameElementType::Float64;
+  else
+    throw std::runtime_error{"Unsupported frame dtype!"};
 
-template <class T>
-auto to_py_list(const ipc_vector<T>& v) -> std::vector<T>
-{
-  auto l = std::vector<T>{};
-  for (const auto& c : v)
-    l.push_back(c);
-  return l;
+  if (array.ndim() > sara::FrameLayout::max_dims)
+    throw std::runtime_error{"Too many frame dimensions!"};
+  layout.num_dims = static_cast<int>(array.ndim());
+  for (auto i = 0; i < layout.num_dims; ++i)
+    layout.shape[i] = array.shape(i);
+
+  return layout;
 }
 
 
-// class IpcMedium
-// {
-// public:
-//   IpcMedium(const std::string& segment_name)
-//     : _segment{bip::open_only, segment_name.c_str()}
-//   {
-//   }
-//
-//   py::array_t<float> tensor(const std::string& name)
-//   {
-//     const auto image_shape_name = name + "_shape";
-//     const auto image_data_name = name + "_data";
-//
-//     auto image_shape =
-//         _segment.find<ipc_vector<int>>(image_shape_name.c_str()).first;
-//     auto image_data =
-//         _segment.find<ipc_vector<float>>(image_data_name.c_str()).first;
-//
-//     const auto shape = to_py_list(*image_shape);
-//     const auto strides =
-//         bp::make_tuple(sizeof(float) * (*image_shape)[1], sizeof(float));
-//
-//     return np::from_data(image_data->data(), np::dtype::get_builtin<float>(),
-//                          shape, strides, bp::object());
-//   }
-//
-// private:
-//   bip::managed_shared_memory _segment;
-// };
-//
-//
-// void expose_ipc()
-// {
-//   bp::class_<IpcMedium, boost::noncopyable>("IpcMedium",
-//                                             bp::init<const std::string&>())
-//       .def("tensor", &IpcMedium::tensor);
-// }
+// Producer end of the ring, mostly useful to test the Python consumers.
+class SharedFrameProducer : public sara::SharedFrameProducer
+{
+public:
+  using sara::SharedFrameProducer::SharedFrameProducer;
+
+  auto publish_array(py::array array) -> std::uint64_t
+  {
+    array = py::array::ensure(array, py::array::c_style);
+    if (!array)
+      throw std::runtime_error{"Could not make the frame contiguous!"};
+
+    const auto layout = to_frame_layout(array);
+    auto data = begin_frame(layout);
+    {
+      py::gil_scoped_release release;
+      std::memcpy(data, array.data(), layout.num_bytes());
+    }
+    return end_frame();
+  }
+};
+
+// The frames are read-only NumPy arrays viewing the shared memory. They keep
+// the consumer alive so that the shared memory stays mapped.
+class SharedFrameConsumer : public sara::SharedFrameConsumer
+{
+public:
+  using sara::SharedFrameConsumer::SharedFrameConsumer;
+
+  static auto next_array(py::object self, double timeout_ms) -> py::object
+  {
+    auto& consumer = self.cast<SharedFrameConsumer&>();
+
+    auto frame = std::optional<sara::SharedFrame>{};
+    {
+      py::gil_scoped_release release;
+      frame = consumer.next(std::chrono::microseconds{
+          static_cast<std::int64_t>(timeout_ms * 1e3)});
+    }
+    if (!frame)
+      return py::none();
+
+    const auto& layout = frame->layout;
+    const auto shape = std::vector<py::ssize_t>(
+        layout.shape.begin(), layout.shape.begin() + layout.num_dims);
+    auto array = py::array{to_dtype(layout.element_type), shape,
+                           frame->data, self};
+    array.attr("setflags")(py::arg("write") = false);
+
+    return py::make_tuple(frame->sequence, array);
+  }
+};
+
+
+auto expose_ipc(pybind11::module& m) -> void
+{
+  py::class_<SharedFrameProducer>(m, "SharedFrameProducer")
+      .def(py::init<const std::string&, int, std::size_t>(), py::arg("name"),
+           py::arg("num_slots"), py::arg("slot_capacity"))
+      .def("publish", &SharedFrameProducer::publish_array,
+           "Copy the frame into the next slot and return its sequence number")
+      .def("name", &SharedFrameProducer::name)
+      .def("num_slots", &SharedFrameProducer::num_slots)
+      .def("slot_capacity", &SharedFrameProducer::slot_capacity)
+      .def("num_published", &SharedFrameProducer::num_published);
+
+  py::class_<SharedFrameConsumer>(m, "SharedFrameConsumer")
+      .def(py::init<const std::string&>(), py::arg("name"))
+      .def("next", &SharedFrameConsumer::next_array,
+           py::arg("timeout_ms") = 1000.,
+           "Wait for the next frame and return (sequence, array), or None on "
+           "timeout")
+      .def("is_valid",
+           py::overload_cast<std::uint64_t>(&SharedFrameConsumer::is_valid,
+                                            py::const_),
+           "Check that the frame has not been overwritten by the producer")
+      .def("num_slots", &SharedFrameConsumer::num_slots)
+      .def("slot_capacity", &SharedFrameConsumer::slot_capacity)
+      .def("num_dropped", &SharedFrameConsumer::num_dropped);
+}
@@ -9,45 +9,33 @@
 // you can obtain one at http://mozilla.org/MPL/2.0/.
 // ========================================================================== //
 
-#include <boost/python.hpp>
-
 #include <DO/Sara/ImageIO.hpp>
 
 #include "ImageIO.hpp"
+#include "Utilities.hpp"
+
 
+namespace py = pybind11;
 namespace sara = DO::Sara;
 
 
-// bp::object imread(const std::string& filepath)
-// {
-//   using namespace sara;
-// 
-//   auto image = imread<double>(filepath);
-//   auto data = image.data();
-// 
-// #if BOOST_VERSION <= 106300
-//   auto ndims = 2;
-//   npy_intp sizes[] = {image.height(), image.width()};
-//   auto py_obj = PyArray_SimpleNewFromData(ndims, sizes, NPY_DOUBLE, data);
-// 
-//   bp::handle<> handle{py_obj};
-//   bp::numeric::array arr{handle};
-// #else
-//   namespace np = bp::numpy;
-// 
-//   const auto shape = bp::make_tuple(image.height(), image.width());
-//   const auto dtype = np::dtype::get_builtin<double>();
-//   const auto stride = bp::make_tuple(sizeof(double));
-// 
-//   auto arr_owner = bp::object{};
-//   auto arr = np::from_data(data, dtype, shape, stride, arr_owner);
-// #endif
-// 
-//   return arr.copy();
-// }
-
-
-auto expose_image_io(pybind11::module& /* m */) -> void
+//! @brief Read an RGB image as a NumPy array of shape (h, w, 3) which owns the
+//! decoded pixels, i.e., without any copy.
+auto imread_rgb(const std::string& filepath)
+{
+  return as_pyarray_view(sara::imread<sara::Rgb8>(filepath));
+}
+
+//! @brief Read a grayscale image as a NumPy array of shape (h, w) with values
+//! in [0, 1].
+auto imread_gray(const std::string& filepath)
+{
+  return as_pyarray_view(sara::imread<float>(filepath));
+}
+
+
+auto expose_image_io(pybind11::module& m) -> void
 {
-  // m.def("imread", &imread);
+  m.def("imread", &imread_rgb, "Read an RGB image.");
+  m.def("imread_gray", &imread_gray, "Read a grayscale image.");
 }
@@ -6,6 +6,10 @@
 #include <DO/Sara/Core/Image.hpp>
 #include <DO/Sara/Core/Tensor.hpp>
 
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 
 template <typename Sequence>
 inline auto as_pyarray(Sequence&& seq)
@@ -32,29 +36,111 @@ inline auto to_pyarray(const Sequence& seq)
 }
 
 
+//! @brief Shape and strides in bytes of a NumPy array viewing a Sara array.
+//!
+//! NumPy arrays are indexed in row-major order, so the axes of column-major
+//! arrays such as images are reversed, i.e., an image of sizes (w, h) is
+//! viewed as an array of shape (h, w). Pixels with multiple channels add a
+//! trailing channel axis.
+template <typename MultiArrayView>
+inline auto numpy_layout(const MultiArrayView& array)
+    -> std::pair<std::vector<pybind11::ssize_t>, std::vector<pybind11::ssize_t>>
+{
+  namespace sara = DO::Sara;
+
+  using value_type = typename MultiArrayView::value_type;
+  using channel_type = typename sara::PixelTraits<value_type>::channel_type;
+  constexpr auto num_channels = sara::PixelTraits<value_type>::num_channels;
+  constexpr auto N = MultiArrayView::Dimension;
+  constexpr auto row_major =
+      MultiArrayView::StorageOrder == static_cast<int>(sara::RowMajor);
+
+  auto shape = std::vector<pybind11::ssize_t>{};
+  auto strides = std::vector<pybind11::ssize_t>{};
+  for (auto k = 0; k < N; ++k)
+  {
+    const auto i = row_major ? k : N - 1 - k;
+    shape.push_back(array.size(i));
+    strides.push_back(array.stride(i) * sizeof(value_type));
+  }
+
+  if (num_channels > 1)
+  {
+    shape.push_back(num_channels);
+    strides.push_back(sizeof(channel_type));
+  }
+
+  return {shape, strides};
+}
+
+//! @brief Move an image or a tensor into a NumPy array without copying it.
+//!
+//! The NumPy array owns the C++ array through a capsule.
+template <typename MultiArray>
+inline auto as_pyarray_view(MultiArray&& array)
+    -> pybind11::array_t<typename DO::Sara::PixelTraits<
+        typename std::decay_t<MultiArray>::value_type>::channel_type>
+{
+  static_assert(!std::is_lvalue_reference<MultiArray>::value,
+                "The array must be moved into the NumPy array!");
+
+  namespace sara = DO::Sara;
+  using array_type = std::decay_t<MultiArray>;
+  using channel_type =
+      typename sara::PixelTraits<typename array_type::value_type>::channel_type;
+
+  auto array_ptr = new array_type{std::move(array)};
+  auto capsule = pybind11::capsule{
+      array_ptr,                                                //
+      [](void* p) { delete reinterpret_cast<array_type*>(p); }  //
+  };
+
+  const auto [shape, strides] = numpy_layout(*array_ptr);
+  return pybind11::array_t<channel_type>{
+      shape, strides, reinterpret_cast<channel_type*>(array_ptr->data()),
+      capsule};
+}
+
+//! @brief View the memory of an array owned by another Python object.
+//!
+//! The NumPy array keeps the owner alive but the view is invalidated if the
+//! owner reallocates its memory.
+template <typename MultiArrayView>
+inline auto to_pyarray_view(const MultiArrayView& array, pybind11::handle owner)
+    -> pybind11::array_t<typename DO::Sara::PixelTraits<
+        typename MultiArrayView::value_type>::channel_type>
+{
+  namespace sara = DO::Sara;
+  using channel_type = typename sara::PixelTraits<
+      typename MultiArrayView::value_type>::channel_type;
+
+  const auto [shape, strides] = numpy_layout(array);
+  return pybind11::array_t<channel_type>{
+      shape, strides, reinterpret_cast<const channel_type*>(array.data()),
+      owner};
+}
+
+
+//! @brief Expose a tensor class with the buffer protocol, so that
+//! `numpy.asarray(tensor)` shares the memory of the tensor.
 template <typename T, int N>
 auto wrap_tensor_class(pybind11::module& m, const std::string& name)
 {
   namespace py = pybind11;
   namespace sara = DO::Sara;
 
-  auto to_vector = [](const auto& vec) {
-    auto v = std::vector<py::ssize_t>(vec.size());
-    std::transform(vec.data(), vec.data() + vec.size(),
-                   [](const auto& x) { return static_cast<py::ssize_t>(x); });
-  };
-
-  py::class_<sara::Tensor_<T, N>>(m, name, py::buffer_protocol())
-      .def_buffer([&](sara::Tensor_<T, N>& m) -> py::buffer_info {
+  return py::class_<sara::Tensor_<T, N>>(m, name.c_str(),
+                                         py::buffer_protocol())
+      .def_buffer([](sara::Tensor_<T, N>& t) -> py::buffer_info {
+        const auto [shape, strides] = numpy_layout(t);
         return py::buffer_info(
-            m.data(),                           /* Pointer to buffer */
+            t.data(),                           /* Pointer to buffer */
             sizeof(T),                          /* Size of one scalar */
             py::format_descriptor<T>::format(), /* Python struct-style format
                                                    descriptor */
             N,                                  /* Number of dimensions */
-            to_vector(m.sizes()),               /* Buffer dimensions */
-            to_vector((m.strides() * sizeof(T))
-                          .eval()) /* Strides (in bytes) for each index */
+            shape,                              /* Buffer dimensions */
+            strides /* Strides (in bytes) for each index */
         );
       });
 }
@@ -19,6 +19,9 @@ namespace py = pybind11;
 namespace sara = DO::Sara;
 
 
+// The long-running methods release the GIL so that Python threads can decode
+// several streams at the same time. A stream must not be used concurrently by
+// two threads.
 class VideoStream : public sara::VideoStream
 {
 public:
@@ -28,6 +31,8 @@ public:
 
     auto imview = to_interleaved_rgb_image_view(image);
 
+    py::gil_scoped_release release;
+
     if (!read())
       return false;
 
@@ -35,6 +40,86 @@ public:
     return true;
   }
 
+  bool read_rgb_frame_at(int frame_position, py::array_t<std::uint8_t> image)
+  {
+    using namespace sara;
+
+    auto imview = to_interleaved_rgb_image_view(image);
+
+    py::gil_scoped_release release;
+
+    if (!read_frame(frame_position))
+      return false;
+
+    imview = this->frame();
+    return true;
+  }
+
+  bool read_frame_in_place()
+  {
+    return read();
+  }
+
+  //! @brief Decode at most 'max_frames' frames into an array of shape
+  //! (n, h, w, 3).
+  auto read_rgb_frames(int max_frames)
+  {
+    using namespace sara;
+
+    if (max_frames < 0)
+      throw std::domain_error{"The number of frames must be nonnegative!"};
+
+    auto frames = Tensor_<Rgb8, 3>{};
+    {
+      py::gil_scoped_release release;
+
+      const auto sizes = output_sizes();
+      frames.resize(max_frames, sizes.y(), sizes.x());
+
+      auto num_frames_read = 0;
+      while (num_frames_read < max_frames && read())
+      {
+        const auto f = frame();
+        std::copy(f.begin(), f.end(), frames[num_frames_read].data());
+        ++num_frames_read;
+      }
+
+      // The end of the stream has been reached.
+      if (num_frames_read < max_frames)
+      {
+        auto truncated =
+            Tensor_<Rgb8, 3>{num_frames_read, sizes.y(), sizes.x()};
+        std::copy(frames.begin(), frames.begin() + truncated.size(),
+                  truncated.begin());
+        frames = std::move(truncated);
+      }
+    }
+
+    return as_pyarray_view(std::move(frames));
+  }
+
+  //! @brief Decode the frames at the given positions into an array of shape
+  //! (n, h, w, 3).
+  auto read_rgb_frames_at(const std::vector<int>& frame_positions)
+  {
+    using namespace sara;
+
+    auto frames = Tensor_<Rgb8, 3>{};
+    {
+      py::gil_scoped_release release;
+
+      const auto sizes = output_sizes();
+      frames.resize(static_cast<int>(frame_positions.size()), sizes.y(),
+                    sizes.x());
+      extract_frames(frame_positions, [&](std::size_t i) {
+        const auto f = frame();
+        std::copy(f.begin(), f.end(), frames[static_cast<int>(i)].data());
+      });
+    }
+
+    return as_pyarray_view(std::move(frames));
+  }
+
   auto numpy_sizes() const
   {
     return Eigen::Vector3i{height(), width(), 3};
@@ -44,12 +129,38 @@ public:
 
 auto expose_video_io(pybind11::module& m) -> void
 {
+  using release_gil = py::call_guard<py::gil_scoped_release>;
+
   py::class_<VideoStream>(m, "VideoStream")
       .def(py::init<>())
-      .def("open", &VideoStream::open)
-      .def("close", &VideoStream::close)
-      .def("seek", &VideoStream::seek)
+      .def("open", &VideoStream::open, release_gil())
+      .def("close", &VideoStream::close, release_gil())
+      .def("seek", &VideoStream::seek, release_gil())
+      .def("build_frame_index", &VideoStream::build_frame_index,
+           py::arg("cache_filepath") = std::string{}, release_gil())
+      .def("num_frames", &VideoStream::num_frames)
       .def("read", &VideoStream::read_rgb_frame)
+      .def("read", &VideoStream::read_frame_in_place,
+           "Decode the next frame without copying it. Access it with the "
+           "'frame' method.",
+           release_gil())
+      .def(
+          "frame",
+          [](py::object self) {
+            const auto& video_stream = self.cast<const VideoStream&>();
+            return to_pyarray_view(video_stream.frame(), self);
+          },
+          "Return a NumPy view on the current frame, which is only valid "
+          "until the next call to 'read'.")
+      .def("read_frame", &VideoStream::read_rgb_frame_at)
+      .def("read_frames", &VideoStream::read_rgb_frames,
+           py::arg("max_frames"),
+           "Decode the next frames into an array of shape (n, h, w, 3). "
+           "Fewer frames are returned at the end of the stream.")
+      .def("read_frames", &VideoStream::read_rgb_frames_at,
+           py::arg("frame_positions"),
+           "Decode the frames at the given positions into an array of shape "
+           "(n, h, w, 3).")
       .def("width", &VideoStream::width)
       .def("height", &VideoStream::height)
       .def("sizes", py::overload_cast<>(&VideoStream::numpy_sizes, py::const_));
@@ -0,0 +1,38 @@
+# Consume the frames streamed by the C++ example 'core_shared_frames_example'.
+#
+# Usage:
+#   core_shared_frames_example sara_frames &
+#   python shared_frames_example.py sara_frames
+import sys
+import time
+
+from pysara_pybind11 import SharedFrameConsumer
+
+
+name = sys.argv[1] if len(sys.argv) > 1 else 'sara_frames'
+consumer = SharedFrameConsumer(name)
+
+num_frames = 0
+start = time.time()
+while True:
+    frame = consumer.next(timeout_ms=2000)
+    if frame is None:
+        print('[Python] No frame received, stopping.')
+        break
+    sequence, image = frame
+
+    # Process the zero-copy view here, then check that the producer did not
+    # overwrite it in the meantime.
+    mean = image.mean()
+    if not consumer.is_valid(sequence):
+        print('[Python] Frame {} was overwritten'.format(sequence))
+        continue
+
+    num_frames += 1
+    elapsed = time.time() - start
+    if elapsed > 1:
+        print('[Python] frame {} shape={} mean={:.2f} fps={:.1f} dropped={}'
+              .format(sequence, image.shape, mean, num_frames / elapsed,
+                      consumer.num_dropped()))
+        num_frames = 0
+        start = time.time()
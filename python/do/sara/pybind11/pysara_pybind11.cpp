@@ -2,6 +2,8 @@
 
 #include "DisjointSets.hpp"
 #include "Geometry.hpp"
+#include "IPC.hpp"
+#include "ImageIO.hpp"
 #include "VideoIO.hpp"
 #include "sfm.hpp"
 
@@ -10,6 +12,8 @@ PYBIND11_MODULE(pysara_pybind11, m)
 {
   expose_disjoint_sets(m);
   expose_geometry(m);
+  expose_ipc(m);
+  expose_image_io(m);
 #ifdef PYSARA_BUILD_VIDEOIO
   expose_video_io(m);
 #endif
@@ -19,25 +19,127 @@
 #include <pybind11/numpy.h>
 #include <pybind11/operators.h>
 #include <pybind11/stl.h>
+#include <pybind11/stl_bind.h>
+
+#include <exception>
 
 
 namespace py = pybind11;
 namespace sara = DO::Sara;
 
 
+// The list of features is moved as a whole into an opaque Python object
+// instead of being converted to a Python list of 'OERegion' objects one by
+// one. The features are only converted when they are accessed.
+PYBIND11_MAKE_OPAQUE(std::vector<sara::OERegion>)
+
+
+// The NumPy buffers are accessed while holding the GIL, then the GIL is
+// released during the feature extraction so that other Python threads can run.
 auto compute_sift_keypoints(py::array_t<float> image)
 {
   const auto imview = to_image_view<float>(image);
+  py::gil_scoped_release release;
   return sara::compute_sift_keypoints(imview);
 }
 
+//! @brief Extract the SIFT keypoints of a batch of images in parallel.
+auto compute_sift_keypoints_batch(const std::vector<py::array_t<float>>& images)
+    -> std::vector<sara::KeypointList<sara::OERegion, float>>
+{
+  auto imviews = std::vector<sara::ImageView<float>>{};
+  imviews.reserve(images.size());
+  for (const auto& image : images)
+    imviews.push_back(to_image_view<float>(image));
+
+  auto keys = std::vector<sara::KeypointList<sara::OERegion, float>>(
+      imviews.size());
+  {
+    py::gil_scoped_release release;
+
+    const auto num_images = static_cast<int>(imviews.size());
+    // Exceptions must not escape the OpenMP parallel region.
+    auto errors = std::vector<std::exception_ptr>(imviews.size());
+#pragma omp parallel for
+    for (auto i = 0; i < num_images; ++i)
+    {
+      try
+      {
+        keys[i] = sara::compute_sift_keypoints(imviews[i]);
+      }
+      catch (...)
+      {
+        errors[i] = std::current_exception();
+      }
+    }
+
+    for (const auto& error : errors)
+      if (error)
+        std::rethrow_exception(error);
+  }
+
+  return keys;
+}
+
+//! @brief Return the keypoints as a structure of NumPy arrays, which is much
+//! cheaper than converting each 'OERegion' object to Python.
+auto to_keypoint_arrays(sara::KeypointList<sara::OERegion, float>&& keys)
+    -> py::dict
+{
+  auto& [features, descriptors] = keys;
+
+  const auto num_keypoints = static_cast<int>(features.size());
+  auto x = sara::Tensor_<float, 1>{num_keypoints};
+  auto y = sara::Tensor_<float, 1>{num_keypoints};
+  auto scale = sara::Tensor_<float, 1>{num_keypoints};
+  auto orientation = sara::Tensor_<float, 1>{num_keypoints};
+  for (auto i = 0; i < num_keypoints; ++i)
+  {
+    x(i) = features[i].x();
+    y(i) = features[i].y();
+    scale(i) = features[i].scale();
+    orientation(i) = features[i].orientation;
+  }
+
+  auto arrays = py::dict{};
+  arrays["x"] = as_pyarray_view(std::move(x));
+  arrays["y"] = as_pyarray_view(std::move(y));
+  arrays["scale"] = as_pyarray_view(std::move(scale));
+  arrays["orientation"] = as_pyarray_view(std::move(orientation));
+  arrays["descriptors"] = as_pyarray_view(std::move(descriptors));
+  return arrays;
+}
+
+auto compute_sift_keypoint_arrays(py::array_t<float> image) -> py::dict
+{
+  const auto imview = to_image_view<float>(image);
+  auto keys = sara::KeypointList<sara::OERegion, float>{};
+  {
+    py::gil_scoped_release release;
+    keys = sara::compute_sift_keypoints(imview);
+  }
+  return to_keypoint_arrays(std::move(keys));
+}
+
+auto compute_sift_keypoint_arrays_batch(
+    const std::vector<py::array_t<float>>& images) -> py::list
+{
+  auto keys = compute_sift_keypoints_batch(images);
+  auto arrays = py::list{};
+  for (auto& k : keys)
+    arrays.append(to_keypoint_arrays(std::move(k)));
+  return arrays;
+}
+
 
 auto expose_sfm(pybind11::module& m) -> void
 {
   m.doc() = "Sara Python API";  // optional module docstring
 
   // TODO: move this to somewhere else.
-  py::class_<sara::Tensor_<float, 2>>(m, "Tensor2f")
+  //
+  // `numpy.asarray(tensor)` shares the memory of the tensor.
+  wrap_tensor_class<float, 2>(m, "Tensor2f")
       .def(py::init<>())
       .def("data",
            py::overload_cast<>(&sara::Tensor_<float, 2>::data, py::const_))
@@ -53,6 +155,22 @@ auto expose_sfm(pybind11::module& m) -> void
       .def_readwrite("extremum_type", &sara::OERegion::extremum_type)
       .def(py::self == py::self);
 
+  py::bind_vector<std::vector<sara::OERegion>>(m, "OERegionList");
+
   m.def("compute_sift_keypoints", &compute_sift_keypoints,
         "Compute SIFT keypoints for an input float image.");
+
+  m.def("compute_sift_keypoint_arrays", &compute_sift_keypoint_arrays,
+        "Compute SIFT keypoints for an input float image and return them as "
+        "a dictionary of NumPy arrays: 'x', 'y', 'scale', 'orientation' and "
+        "'descriptors'.");
+
+  m.def("compute_sift_keypoints_batch", &compute_sift_keypoints_batch,
+        "Compute SIFT keypoints for a list of float images in parallel. The "
+        "GIL is released during the computation.");
+
+  m.def("compute_sift_keypoint_arrays_batch",
+        &compute_sift_keypoint_arrays_batch,
+        "Compute SIFT keypoints for a list of float images in parallel and "
+        "return a list of dictionaries of NumPy arrays.");
 }
@@ -20,3 +20,76 @@ class TestPybind11(unittest.TestCase):
     def test_compute_sift_keypoints(self):
         image = np.zeros((24, 32), dtype=float)
         features, descriptors = sara.compute_sift_keypoints(image)
+
+    def test_descriptors_share_memory(self):
+        y, x = np.mgrid[0:64, 0:64]
+        image = np.exp(-((x - 32.) ** 2 + (y - 32.) ** 2) / (2 * 4. ** 2))
+        image = image.astype(np.float32)
+
+        keys = sara.compute_sift_keypoints(image)
+        features, descriptors = keys
+
+        array = np.asarray(descriptors)
+        self.assertEqual(array.dtype, np.float32)
+        self.assertEqual(array.shape, (len(features), 128))
+        self.assertGreater(len(features), 0)
+
+        # The NumPy array is a view on the memory owned by the C++ tensor...
+        self.assertFalse(array.flags.owndata)
+        self.assertIsNotNone(array.base)
+
+        # ... so writing through it modifies the tensor, as seen from another
+        # reference to the tensor.
+        array[0, 0] = -1.
+        self.assertEqual(np.asarray(keys[1])[0, 0], -1.)
+
+    def test_features_are_not_converted(self):
+        y, x = np.mgrid[0:64, 0:64]
+        image = np.exp(-((x - 32.) ** 2 + (y - 32.) ** 2) / (2 * 4. ** 2))
+        image = image.astype(np.float32)
+
+        features, descriptors = sara.compute_sift_keypoints(image)
+
+        # The features are an opaque C++ vector, not a Python list.
+        self.assertIsInstance(features, sara.OERegionList)
+        self.assertGreater(len(features), 0)
+        self.assertIsInstance(features[0], sara.OERegion)
+
+    def test_compute_sift_keypoint_arrays(self):
+        y, x = np.mgrid[0:64, 0:64]
+        image = np.exp(-((x - 32.) ** 2 + (y - 32.) ** 2) / (2 * 4. ** 2))
+        image = image.astype(np.float32)
+
+        keys = sara.compute_sift_keypoint_arrays(image)
+        features, descriptors = sara.compute_sift_keypoints(image)
+
+        n = len(features)
+        for key in ['x', 'y', 'scale', 'orientation']:
+            self.assertEqual(keys[key].shape, (n,))
+            self.assertEqual(keys[key].dtype, np.float32)
+        self.assertEqual(keys['descriptors'].shape, (n, 128))
+
+        for i, f in enumerate(features):
+            self.assertAlmostEqual(keys['x'][i], f.coords[0], places=4)
+            self.assertAlmostEqual(keys['y'][i], f.coords[1], places=4)
+            self.assertAlmostEqual(keys['orientation'][i], f.orientation,
+                                   places=4)
+        np.testing.assert_allclose(keys['descriptors'],
+                                   np.asarray(descriptors))
+
+    def test_compute_sift_keypoints_batch(self):
+        y, x = np.mgrid[0:64, 0:64]
+        images = [
+            np.exp(-((x - c) ** 2 + (y - c) ** 2) / (2 * 4. ** 2))
+            .astype(np.float32)
+            for c in [24., 32., 40.]
+        ]
+
+        keys_batch = sara.compute_sift_keypoint_arrays_batch(images)
+        self.assertEqual(len(keys_batch), len(images))
+
+        for image, keys in zip(images, keys_batch):
+            features, descriptors = sara.compute_sift_keypoints(image)
+            self.assertEqual(keys['x'].shape, (len(features),))
+            np.testing.assert_allclose(keys['descriptors'],
+                                       np.asarray(descriptors))
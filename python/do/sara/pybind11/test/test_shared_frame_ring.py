@@ -0,0 +1,89 @@
+import multiprocessing as mp
+import os
+import unittest
+
+import numpy as np
+
+from do.sara import SharedFrameConsumer, SharedFrameProducer
+
+
+NUM_FRAMES = 100
+
+
+def ring_name(test_name):
+    return 'sara_pytest_{}_{}'.format(test_name, os.getpid())
+
+
+def make_frame(n):
+    return np.full((240, 320, 3), n % 256, dtype=np.uint8)
+
+
+def consume(name, ready, results):
+    consumer = SharedFrameConsumer(name)
+    ready.set()
+
+    num_received = 0
+    num_corrupted = 0
+    while num_received + consumer.num_dropped() < NUM_FRAMES:
+        frame = consumer.next(timeout_ms=5000)
+        if frame is None:
+            break
+        sequence, image = frame
+        intact = (image == sequence % 256).all()
+        if not intact and consumer.is_valid(sequence):
+            num_corrupted += 1
+        num_received += 1
+
+    results.put((num_received, consumer.num_dropped(), num_corrupted))
+
+
+class TestSharedFrameRing(unittest.TestCase):
+
+    def test_publish_and_read(self):
+        name = ring_name('publish_and_read')
+        producer = SharedFrameProducer(name, 4, 320 * 240 * 3)
+        consumer = SharedFrameConsumer(name)
+
+        self.assertIsNone(consumer.next(timeout_ms=0))
+
+        self.assertEqual(producer.publish(make_frame(7)), 0)
+        sequence, image = consumer.next()
+        self.assertEqual(sequence, 0)
+        self.assertEqual(image.shape, (240, 320, 3))
+        self.assertEqual(image.dtype, np.uint8)
+        self.assertTrue((image == 7).all())
+        self.assertTrue(consumer.is_valid(sequence))
+
+        # The frames are read-only views on the shared memory.
+        self.assertFalse(image.flags.writeable)
+
+        # Non-contiguous arrays are copied into the ring.
+        tensor = np.arange(12, dtype=np.float32).reshape(3, 4).T
+        producer.publish(tensor)
+        _, view = consumer.next()
+        self.assertEqual(view.dtype, np.float32)
+        self.assertTrue((view == tensor).all())
+
+    def test_two_processes(self):
+        name = ring_name('two_processes')
+        producer = SharedFrameProducer(name, 8, 320 * 240 * 3)
+
+        ready = mp.Event()
+        results = mp.Queue()
+        process = mp.Process(target=consume, args=(name, ready, results))
+        process.start()
+        self.assertTrue(ready.wait(10))
+
+        for n in range(NUM_FRAMES):
+            producer.publish(make_frame(n))
+
+        num_received, num_dropped, num_corrupted = results.get(timeout=10)
+        process.join()
+
+        self.assertGreater(num_received, 0)
+        self.assertEqual(num_received + num_dropped, NUM_FRAMES)
+        self.assertEqual(num_corrupted, 0)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -23,6 +23,19 @@ class TestVideoStream(unittest.TestCase):
 
         video_stream.read(video_frame)
 
+    def test_read_frames(self):
+        video_stream = pysara.VideoStream()
+
+        video_stream.open(path.join(str(pathlib.Path.home()),
+                                    'GitLab/DO-CV',
+                                    'sara/cpp/examples/Sara/VideoIO',
+                                    'orion_1.mpg'))
+
+        h, w, _ = video_stream.sizes()
+        frames = video_stream.read_frames(4)
+        self.assertEqual(frames.shape, (4, h, w, 3))
+        self.assertEqual(frames.dtype, np.uint8)
+
 
 if __name__ == '__main__':
     unittest.main()